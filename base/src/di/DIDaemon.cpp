@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <vector>
 
+#include <Poco/Clock.h>
 #include <Poco/Environment.h>
 #include <Poco/Exception.h>
 #include <Poco/Logger.h>
@@ -82,6 +85,13 @@ DIDaemon::DIDaemon(const About &about):
 	m_noEarlyOption.noArgument();
 	m_noEarlyOption.callback(OptionCallback<DIDaemon>(
 			this, &DIDaemon::handleNoEarly));
+
+	m_traceStartupOption.fullName("trace-startup");
+	m_traceStartupOption.required(false);
+	m_traceStartupOption.repeatable(false);
+	m_traceStartupOption.argument("<file>", true);
+	m_traceStartupOption.binding(
+			"di.daemon.trace.startup", &config());
 }
 
 DIDaemon::~DIDaemon()
@@ -186,8 +196,14 @@ void DIDaemon::startRunner(const string &name)
 	logger().notice("starting runner " + name,
 			__FILE__, __LINE__);
 
+	const Clock started;
 	runner->start();
 
+	try {
+		reportStartup(name, di, started.elapsed());
+	}
+	BEEEON_CATCH_CHAIN(logger())
+
 	try {
 		notifyStarted();
 
@@ -199,6 +215,56 @@ void DIDaemon::startRunner(const string &name)
 	}
 }
 
+void DIDaemon::reportStartup(
+		const string &name,
+		const DependencyInjector &di,
+		const Timespan &runnerStart) const
+{
+	vector<DependencyInjector::InstanceTrace> trace = di.trace();
+	Timespan total = runnerStart;
+
+	for (const auto &one : trace)
+		total += one.total();
+
+	logger().notice("startup took "
+		+ to_string(total.totalMilliseconds()) + " ms (runner start "
+		+ to_string(runnerStart.totalMilliseconds()) + " ms)",
+		__FILE__, __LINE__);
+
+	sort(trace.begin(), trace.end(),
+		[](const DependencyInjector::InstanceTrace &a,
+				const DependencyInjector::InstanceTrace &b) {
+			return a.total() > b.total();
+		});
+
+	if (trace.size() > 5)
+		trace.resize(5);
+
+	for (const auto &one : trace) {
+		logger().information("instance " + one.name
+			+ " took " + to_string(one.total().totalMilliseconds()) + " ms"
+			+ " (create " + to_string(one.create.totalMilliseconds())
+			+ " ms, inject " + to_string(one.inject.totalMilliseconds())
+			+ " ms, done " + to_string(one.done.totalMilliseconds()) + " ms)",
+			__FILE__, __LINE__);
+	}
+
+	const string path = config().getString("di.daemon.trace.startup", "");
+	if (path.empty())
+		return;
+
+	ofstream out(path);
+	out << "# runner " << name << " start_us "
+		<< runnerStart.totalMicroseconds() << endl;
+	di.dumpTrace(out);
+
+	if (!out)
+		throw WriteFileException("failed to write startup trace " + path);
+
+	logger().notice("startup trace written into " + path,
+		__FILE__, __LINE__);
+}
+
 void DIDaemon::defineOptions(OptionSet &options)
 {
 	options.addOption(m_helpOption);
@@ -208,6 +274,7 @@ void DIDaemon::defineOptions(OptionSet &options)
 	options.addOption(m_configOption);
 	options.addOption(m_notifyStartedOption);
 	options.addOption(m_noEarlyOption);
+	options.addOption(m_traceStartupOption);
 }
 
 void DIDaemon::handleHelp(const string &, const string &)
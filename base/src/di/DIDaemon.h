@@ -6,6 +6,7 @@
 #include <Poco/ErrorHandler.h>
 #include <Poco/Exception.h>
 #include <Poco/Util/ServerApplication.h>
+#include <Poco/Timespan.h>
 #include <Poco/Util/Option.h>
 
 #include "util/About.h"
@@ -21,6 +22,8 @@ class OptionSet;
 
 namespace BeeeOn {
 
+class DependencyInjector;
+
 class DIDaemon : public Poco::Util::ServerApplication {
 public:
 	DIDaemon(const About &about);
@@ -49,6 +52,15 @@ protected:
 	void handleConfig(const std::string &name, const std::string &value);
 	void handleNoEarly(const std::string &name, const std::string &value);
 	void startRunner(const std::string &name);
+
+	/**
+	 * @brief Log the slowest instances and write the startup trace
+	 * into the file given by option --trace-startup (if any).
+	 */
+	void reportStartup(
+		const std::string &name,
+		const DependencyInjector &di,
+		const Poco::Timespan &runnerStart) const;
 	void printHelp() const;
 	void printVersion() const;
 	void notifyStarted() const;
@@ -75,6 +87,7 @@ private:
 	Poco::Util::Option m_configOption;
 	Poco::Util::Option m_notifyStartedOption;
 	Poco::Util::Option m_noEarlyOption;
+	Poco::Util::Option m_traceStartupOption;
 };
 
 }
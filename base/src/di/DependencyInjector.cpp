@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <cmath>
 #include <list>
+#include <ostream>
 
+#include <Poco/Clock.h>
 #include <Poco/Exception.h>
 #include <Poco/Path.h>
 #include <Poco/StringTokenizer.h>
@@ -386,17 +389,72 @@ void DependencyInjector::castImpl(
 DIWrapper *DependencyInjector::createNoAlias(
 		const InstanceInfo &info, bool disown)
 {
-	DIWrapper *t = createNew(info);
-	if (t == NULL)
-		throw Poco::NullPointerException("failed to create target "
-				+ info.name());
+	const Clock started;
+	InstanceTrace trace;
+	trace.name = info.name();
 
-	if (!disown) {
-		m_set.insert(make_pair(info.name(), t));
-		m_free.push_back(t);
+	m_nested.push_back(0);
+	DIWrapper *t;
+
+	try {
+		t = createNew(info);
+		if (t == NULL)
+			throw Poco::NullPointerException("failed to create target "
+					+ info.name());
+
+		trace.cls = ClassInfo(t->type()).name();
+		trace.create = started.elapsed();
+
+		if (!disown) {
+			m_set.insert(make_pair(info.name(), t));
+			m_free.push_back(t);
+		}
+
+		injectDependencies(info, t, trace);
 	}
+	catch (...) {
+		m_nested.pop_back();
+		throw;
+	}
+
+	m_nested.pop_back();
+	if (!m_nested.empty())
+		m_nested.back() += started.elapsed();
+
+	m_trace.emplace_back(trace);
+	return t;
+}
 
-	return injectDependencies(info, t);
+Timespan DependencyInjector::InstanceTrace::total() const
+{
+	return create + inject + done;
+}
+
+const vector<DependencyInjector::InstanceTrace> &DependencyInjector::trace() const
+{
+	return m_trace;
+}
+
+void DependencyInjector::dumpTrace(ostream &out) const
+{
+	vector<InstanceTrace> sorted = m_trace;
+
+	stable_sort(sorted.begin(), sorted.end(),
+		[](const InstanceTrace &a, const InstanceTrace &b) {
+			return a.total() > b.total();
+		});
+
+	out << "# total_us create_us inject_us done_us name class" << endl;
+
+	for (const auto &one : sorted) {
+		out << one.total().totalMicroseconds()
+			<< " " << one.create.totalMicroseconds()
+			<< " " << one.inject.totalMicroseconds()
+			<< " " << one.done.totalMicroseconds()
+			<< " " << one.name
+			<< " " << one.cls
+			<< endl;
+	}
 }
 
 void DependencyInjector::loadLibrary(SharedLibrary &library, const string &name) const
@@ -674,8 +732,12 @@ void DependencyInjector::injectValue(
 
 DIWrapper *DependencyInjector::injectDependencies(
 		const InstanceInfo &info,
-		DIWrapper *target)
+		DIWrapper *target,
+		InstanceTrace &trace)
 {
+	const Clock injectStarted;
+	const Timespan injectNested = m_nested.back();
+
 	AbstractConfiguration::Keys keys;
 	info.resolveKeys(m_conf, keys);
 
@@ -704,9 +766,15 @@ DIWrapper *DependencyInjector::injectDependencies(
 		logger().trace("next key after " + key);
 	}
 
+	trace.inject = Timespan(injectStarted.elapsed())
+		- (m_nested.back() - injectNested);
+
 	logger().notice("successfully created " + info.name(),
 			__FILE__, __LINE__);
 
+	const Clock doneStarted;
+	const Timespan doneNested = m_nested.back();
+
 	try {
 		if (!target->hasHook("done")) {
 			logger().debug("no such hook 'done' defined for "
@@ -722,5 +790,8 @@ DIWrapper *DependencyInjector::injectDependencies(
 		e.rethrow();
 	}
 
+	trace.done = Timespan(doneStarted.elapsed())
+		- (m_nested.back() - doneNested);
+
 	return target;
 }
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <iosfwd>
 #include <map>
+#include <vector>
 
 #include <Poco/Exception.h>
 #include <Poco/AutoPtr.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/SharedLibrary.h>
 #include <Poco/Logger.h>
+#include <Poco/Timespan.h>
 #include <Poco/Util/AbstractConfiguration.h>
 
 #include "di/DIFactory.h"
@@ -106,12 +109,27 @@ class InstanceInfo;
  * DependencyInjector di(config.createView("factory"));
  * Poco::SharedPtr<Main> main = di.create<Main>("main");
  * </pre>
+ *
+ * Creation of every instance is traced. The trace records how long it
+ * took to construct the instance, to inject its properties and to call
+ * its hook "done". Time spent by creating referenced instances is not
+ * included, those instances have their own trace entries.
  */
 class DependencyInjector : public DIFactory, protected Loggable {
 public:
 	typedef std::map<std::string, DIWrapper *> WrapperMap;
 	typedef std::vector<DIWrapper *> WrapperVector;
 
+	struct InstanceTrace {
+		std::string name;
+		std::string cls;
+		Poco::Timespan create;
+		Poco::Timespan inject;
+		Poco::Timespan done;
+
+		Poco::Timespan total() const;
+	};
+
 	DependencyInjector(
 		Poco::AutoPtr<Poco::Util::AbstractConfiguration> conf,
 		const std::vector<std::string> &libraryPaths = {},
@@ -119,6 +137,17 @@ public:
 
 	~DependencyInjector();
 
+	/**
+	 * @returns trace entries in order of finished creation
+	 */
+	const std::vector<InstanceTrace> &trace() const;
+
+	/**
+	 * @brief Write the trace as a text report. Each line describes
+	 * a single instance, the slowest instances come first.
+	 */
+	void dumpTrace(std::ostream &out) const;
+
 private:
 	/**
 	 * @brief Implement instance lookup by name.
@@ -188,7 +217,8 @@ private:
 
 	DIWrapper *injectDependencies(
 			const InstanceInfo &info,
-			DIWrapper *target);
+			DIWrapper *target,
+			InstanceTrace &trace);
 	void injectValue(const InstanceInfo &info,
 			DIWrapper *target,
 			const std::string &key,
@@ -236,6 +266,13 @@ private:
 	Poco::AutoPtr<Poco::Util::AbstractConfiguration> m_conf;
 	std::vector<std::string> m_librariesPaths;
 	std::map<std::string, Poco::SharedLibrary> m_libraries;
+	std::vector<InstanceTrace> m_trace;
+
+	/**
+	 * Time spent by creating referenced instances for each instance
+	 * that is being created.
+	 */
+	std::vector<Poco::Timespan> m_nested;
 };
 
 }
@@ -25,6 +25,19 @@ DevicePrefix GWDeviceListRequest::devicePrefix() const
 	return DevicePrefix::parse(json()->getValue<string>("device_prefix"));
 }
 
+void GWDeviceListRequest::setKnownVersion(const string &version)
+{
+	if (version.empty())
+		json()->remove("known_version");
+	else
+		json()->set("known_version", version);
+}
+
+string GWDeviceListRequest::knownVersion() const
+{
+	return json()->optValue<string>("known_version", "");
+}
+
 GWResponse::Ptr GWDeviceListRequest::deriveResponse() const
 {
 	GWDeviceListResponse::Ptr response(new GWDeviceListResponse);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <Poco/SharedPtr.h>
 #include <Poco/JSON/Object.h>
 
@@ -22,6 +24,10 @@ namespace BeeeOn {
  *   "device_prefix": "vdev"
  * }
  * </pre>
+ *
+ * The optional key "known_version" contains the version of the list
+ * as received by the gateway in the last GWDeviceListResponse. It allows
+ * the server to skip sending the list when it has not changed since then.
  */
 class GWDeviceListRequest : public GWRequest {
 public:
@@ -33,6 +39,18 @@ public:
 	void setDevicePrefix(const DevicePrefix &prefix);
 	DevicePrefix devicePrefix() const;
 
+	/**
+	 * @brief Set version of the device list known by the gateway.
+	 * An empty version removes the key from the message.
+	 */
+	void setKnownVersion(const std::string &version);
+
+	/**
+	 * @returns version of the device list known by the gateway
+	 * or an empty string if it is unknown
+	 */
+	std::string knownVersion() const;
+
 protected:
 	GWResponse::Ptr deriveResponse() const override;
 };
@@ -33,6 +33,10 @@ vector<DeviceID> GWDeviceListResponse::devices() const
 {
 	vector<DeviceID> devices;
 	JSON::Array::Ptr array = json()->getArray("devices");
+	if (array.isNull())
+		return devices;
+
+	devices.reserve(array->size());
 
 	for (size_t i = 0; i < array->size(); i++) {
 		JSON::Object::Ptr object = array->getObject(i);
@@ -182,3 +186,29 @@ map<string, string> GWDeviceListResponse::properties(
 
 	return properties;
 }
+
+void GWDeviceListResponse::setVersion(const string &version)
+{
+	if (version.empty())
+		json()->remove("version");
+	else
+		json()->set("version", version);
+}
+
+string GWDeviceListResponse::version() const
+{
+	return json()->optValue<string>("version", "");
+}
+
+void GWDeviceListResponse::setUnchanged(bool unchanged)
+{
+	if (unchanged)
+		json()->set("unchanged", true);
+	else
+		json()->remove("unchanged");
+}
+
+bool GWDeviceListResponse::unchanged() const
+{
+	return json()->optValue<bool>("unchanged", false);
+}
@@ -49,6 +49,21 @@ namespace BeeeOn {
  *   }
  * }
  * </pre>
+ *
+ * A server supporting incremental synchronization includes an opaque
+ * "version" of the list. When the gateway sends the same version as
+ * "known_version" in its request and the list has not changed since,
+ * the server responds with "unchanged": true and omits the devices,
+ * values and config:
+ * <pre>
+ * {
+ *   "id": "60775a50-d91c-4325-89b1-283e38bd60b2",
+ *   "message_type": "device_list_response",
+ *   "status": 1,
+ *   "version": "17",
+ *   "unchanged": true
+ * }
+ * </pre>
  */
 class GWDeviceListResponse : public GWResponse, Loggable {
 public:
@@ -60,7 +75,8 @@ public:
 	void setDevices(const std::vector<DeviceID> &devices);
 
 	/**
-	 * @returns device IDs of paired devices
+	 * @returns device IDs of paired devices, the list is empty
+	 * if the response contains no devices (e.g. when unchanged)
 	 */
 	std::vector<DeviceID> devices() const;
 
@@ -81,6 +97,26 @@ public:
 		const std::map<std::string, std::string> &properties);
 	std::map<std::string, std::string> properties(
 		const DeviceID &device) const;
+
+	/**
+	 * @brief Set version of the list. An empty version removes
+	 * the key from the message.
+	 */
+	void setVersion(const std::string &version);
+
+	/**
+	 * @returns version of the list or an empty string if the server
+	 * does not support incremental synchronization
+	 */
+	std::string version() const;
+
+	void setUnchanged(bool unchanged);
+
+	/**
+	 * @returns true if the list has not changed since the version
+	 * given in the request, thus the devices are not included
+	 */
+	bool unchanged() const;
 };
 
 }
@@ -228,12 +228,17 @@ string SerialPort::readDirect(int fd)
 {
 	char buf[BUFFER_SIZE];
 
-	ssize_t ret = ::read(fd, buf, sizeof(buf));
+	return string(buf, readDirect(fd, buf, sizeof(buf)));
+}
+
+size_t SerialPort::readDirect(int fd, char *buffer, size_t size)
+{
+	ssize_t ret = ::read(fd, buffer, size);
 
 	if (ret < 0) {
 		switch (Error::last()) {
 		case EAGAIN:
-			return "";
+			return 0;
 		case EIO:
 			throw ReadFileException("read: " + Error::getMessage(Error::last()));
 		default:
@@ -241,14 +246,27 @@ string SerialPort::readDirect(int fd)
 		}
 	}
 
-	return string(buf, ret);
+	return ret;
 }
 
 string SerialPort::read(const Timespan &timeout = Timespan(0))
 {
-	if (timeout.totalMilliseconds() == 0)
-		return readDirect(m_fd);
+	if (timeout.totalMilliseconds() != 0)
+		waitReadable(timeout);
+
+	return readDirect(m_fd);
+}
+
+size_t SerialPort::read(char *buffer, size_t size, const Timespan &timeout)
+{
+	if (timeout.totalMilliseconds() != 0)
+		waitReadable(timeout);
 
+	return readDirect(m_fd, buffer, size);
+}
+
+void SerialPort::waitReadable(const Timespan &timeout)
+{
 	struct pollfd pfd[1];
 	pfd[0].fd = m_fd;
 	pfd[0].events = POLLIN | POLLERR | POLLRDBAND;
@@ -266,7 +284,7 @@ string SerialPort::read(const Timespan &timeout = Timespan(0))
 			throw IOException("serial port seems to be closed");
 
 		if (pfd[0].revents & (POLLRDBAND | POLLIN))
-			return readDirect(m_fd);
+			return;
 	}
 }
 
@@ -40,6 +40,13 @@ public:
 
 	void open();
 	std::string read(const Poco::Timespan &timeout);
+
+	/**
+	 * @brief Read at most size bytes directly into the given buffer.
+	 * @returns number of bytes read, 0 if no data are available
+	 * @throws Poco::TimeoutException if no data arrive in time
+	 */
+	size_t read(char *buffer, size_t size, const Poco::Timespan &timeout);
 	size_t write(const char* buffer, size_t size);
 	size_t write(const std::string &data);
 	void close();
@@ -49,6 +56,8 @@ public:
 
 private:
 	static std::string readDirect(int fd);
+	static size_t readDirect(int fd, char *buffer, size_t size);
+	void waitReadable(const Poco::Timespan &timeout);
 	void installNonBlocking();
 	void installBlocking();
 
@@ -1,5 +1,6 @@
 #include <string>
 
+#include <Poco/Clock.h>
 #include <Poco/Logger.h>
 #include <Poco/Thread.h>
 
@@ -18,6 +19,7 @@ BEEEON_OBJECT_PROPERTY("runnables", &LoopRunner::addRunnable)
 BEEEON_OBJECT_PROPERTY("loops", &LoopRunner::addLoop)
 BEEEON_OBJECT_PROPERTY("autoStart", &LoopRunner::setAutoStart)
 BEEEON_OBJECT_PROPERTY("stopParallel", &LoopRunner::setStopParallel)
+BEEEON_OBJECT_PROPERTY("startParallel", &LoopRunner::setStartParallel)
 BEEEON_OBJECT_HOOK("done", &LoopRunner::autoStart)
 BEEEON_OBJECT_END(BeeeOn, LoopRunner)
 
@@ -33,7 +35,8 @@ static string repr(const StoppableLoop::Ptr loop)
 
 LoopRunner::LoopRunner():
 	m_autoStart(false),
-	m_stopParallel(false)
+	m_stopParallel(false),
+	m_startParallel(false)
 {
 }
 
@@ -64,6 +67,11 @@ void LoopRunner::setStopParallel(bool parallel)
 	m_stopParallel = parallel;
 }
 
+void LoopRunner::setStartParallel(bool parallel)
+{
+	m_startParallel = parallel;
+}
+
 void LoopRunner::stop()
 {
 	if (m_started.empty())
@@ -131,19 +139,84 @@ void LoopRunner::start()
 {
 	FastMutex::ScopedLock guard(m_lock);
 
+	const Clock started;
+
+	if (m_startParallel)
+		startParallel();
+	else
+		startSequential();
+
+	logger().notice("started " + to_string(m_started.size()) + " loops"
+			+ (m_startParallel? " (parallel)" : "")
+			+ " in " + to_string(started.elapsed() / 1000) + " ms",
+			__FILE__, __LINE__);
+}
+
+void LoopRunner::startSequential()
+{
 	for (auto &loop : m_loops) {
+		Starter starter(loop);
+		starter.run();
+
+		if (starter.failed()) {
+			try {
+				starter.rethrow();
+			}
+			BEEEON_CATCH_CHAIN_ACTION_RETHROW(logger(), stopAll(m_started));
+		}
+
+		m_started.push_back(Stopper(loop));
+	}
+}
+
+void LoopRunner::startParallel()
+{
+	vector<Starter> starters;
+	for (auto &loop : m_loops)
+		starters.emplace_back(loop);
+
+	vector<Thread> threads(starters.size());
+	vector<bool> running(starters.size(), false);
+
+	for (size_t i = 0; i < starters.size(); ++i) {
 		try {
-			if (logger().debug())
-				logger().debug("start " + repr(loop), __FILE__, __LINE__);
+			threads[i].start(starters[i]);
+			running[i] = true;
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	}
 
-			loop->start();
-			m_started.push_back(Stopper(loop));
+	for (size_t i = 0; i < starters.size(); ++i) {
+		if (running[i]) {
+			threads[i].join();
+		}
+		else {
+			logger().warning("fallback to single-thread start for "
+				+ repr(starters[i].loop()),
+				__FILE__, __LINE__);
+
+			starters[i].run();
 		}
-		BEEEON_CATCH_CHAIN_ACTION_RETHROW(logger(), stopAll(m_started));
 	}
 
-	logger().notice("started " + to_string(m_started.size()) + " loops",
-			__FILE__, __LINE__);
+	const Starter *failed = nullptr;
+
+	for (auto &starter : starters) {
+		if (starter.failed()) {
+			if (failed == nullptr)
+				failed = &starter;
+		}
+		else {
+			m_started.push_back(Stopper(starter.loop()));
+		}
+	}
+
+	if (failed != nullptr) {
+		try {
+			failed->rethrow();
+		}
+		BEEEON_CATCH_CHAIN_ACTION_RETHROW(logger(), stopAll(m_started));
+	}
 }
 
 void LoopRunner::autoStart()
@@ -154,6 +227,65 @@ void LoopRunner::autoStart()
 	}
 }
 
+LoopRunner::Starter::Starter(StoppableLoop::Ptr loop):
+	Loggable(typeid(LoopRunner)),
+	m_loop(loop)
+{
+}
+
+void LoopRunner::Starter::run()
+{
+	ThreadNamer namer("starter-of-" + repr(m_loop));
+
+	if (logger().debug())
+		logger().debug("start " + repr(m_loop), __FILE__, __LINE__);
+
+	const Clock started;
+
+	try {
+		m_loop->start();
+	}
+	catch (const Exception &e) {
+		m_error = e.clone();
+	}
+	catch (const exception &e) {
+		m_error = new Exception(e.what());
+	}
+	catch (...) {
+		m_error = new Exception("unknown failure");
+	}
+
+	m_duration = started.elapsed();
+
+	if (logger().information()) {
+		logger().information((m_error.isNull()? "started " : "failed to start ")
+			+ repr(m_loop) + " in "
+			+ to_string(m_duration.totalMilliseconds()) + " ms",
+			__FILE__, __LINE__);
+	}
+}
+
+StoppableLoop::Ptr LoopRunner::Starter::loop() const
+{
+	return m_loop;
+}
+
+Timespan LoopRunner::Starter::duration() const
+{
+	return m_duration;
+}
+
+bool LoopRunner::Starter::failed() const
+{
+	return !m_error.isNull();
+}
+
+void LoopRunner::Starter::rethrow() const
+{
+	if (!m_error.isNull())
+		m_error->rethrow();
+}
+
 LoopRunner::Stopper::Stopper():
 	Loggable(typeid(LoopRunner))
 {
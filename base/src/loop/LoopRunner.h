@@ -1,9 +1,12 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
+#include <Poco/Exception.h>
 #include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
 
 #include "loop/StoppableRunnable.h"
 #include "loop/StoppableLoop.h"
@@ -11,6 +14,18 @@
 
 namespace BeeeOn {
 
+/**
+ * @brief LoopRunner starts the given loops in the order as they were added
+ * and stops them in the reverse order.
+ *
+ * If the property startParallel is true, all loops are started
+ * concurrently (each in a separate thread) and the runner waits until
+ * all of them are started. Dependencies among loops must then be
+ * expressed by nesting: loops that must be started in a certain order
+ * are to be grouped into another (sequential) LoopRunner.
+ *
+ * Duration of start() of each loop is logged.
+ */
 class LoopRunner : public StoppableLoop, public Loggable {
 public:
 	typedef Poco::SharedPtr<LoopRunner> Ptr;
@@ -27,6 +42,11 @@ public:
 	 */
 	void setStopParallel(bool parallel);
 
+	/**
+	 * @brief Set whether start() should start all loops in parallel.
+	 */
+	void setStartParallel(bool parallel);
+
 	void start() override;
 	void stop() override;
 	void autoStart();
@@ -47,6 +67,45 @@ protected:
 		StoppableLoop::Ptr m_loop;
 	};
 
+	/**
+	 * @brief Wrapper around StoppableLoop that allows to
+	 * start it from inside a thread. It measures duration
+	 * of the start and records its failure.
+	 */
+	class Starter : public Poco::Runnable, Loggable {
+	public:
+		Starter(StoppableLoop::Ptr loop);
+
+		void run() override;
+
+		StoppableLoop::Ptr loop() const;
+		Poco::Timespan duration() const;
+
+		/**
+		 * @brief Rethrow the recorded failure if any.
+		 */
+		void rethrow() const;
+		bool failed() const;
+
+	private:
+		StoppableLoop::Ptr m_loop;
+		Poco::Timespan m_duration;
+		Poco::SharedPtr<Poco::Exception> m_error;
+	};
+
+	/**
+	 * @brief Start all loops sequentially in the given order.
+	 */
+	void startSequential();
+
+	/**
+	 * @brief Start all loops in parallel. If a thread cannot be started,
+	 * the appropriate loops are started sequentially as a fallback.
+	 * When any loop fails to start, the started ones are stopped
+	 * and the failure is rethrown.
+	 */
+	void startParallel();
+
 	/**
 	 * @brief Stop all loop in reverse order. If the property stopParallel
 	 * is true then the loops are stopped in parallel (multiple threads).
@@ -65,6 +124,7 @@ protected:
 private:
 	bool m_autoStart;
 	bool m_stopParallel;
+	bool m_startParallel;
 	Poco::FastMutex m_lock;
 	std::list<StoppableLoop::Ptr> m_loops;
 	std::list<Stopper> m_started;
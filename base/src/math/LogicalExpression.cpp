@@ -2,6 +2,7 @@
 #include <Poco/RegularExpression.h>
 
 #include "math/LogicalExpression.h"
+#include "util/BoundedCache.h"
 
 using namespace std;
 using namespace Poco;
@@ -13,18 +14,17 @@ LogicalExpression::LogicalExpression(
 		const Op op):
 	m_left(left),
 	m_right(right),
-	m_op(op)
+	m_op(op),
+	m_result(compute())
 {
-	switch (op) {
-	case OP_EQUAL:
-	case OP_NOT_EQUAL:
-		return;
-	}
-
-	throw InvalidArgumentException("unknown operation " + to_string(op));
 }
 
 bool LogicalExpression::result() const
+{
+	return m_result;
+}
+
+bool LogicalExpression::compute() const
 {
 	switch (m_op) {
 	case OP_EQUAL:
@@ -34,7 +34,7 @@ bool LogicalExpression::result() const
 		return !computeEqual();
 	}
 
-	throw IllegalStateException("illegal op: " + to_string(m_op));
+	throw InvalidArgumentException("unknown operation " + to_string(m_op));
 }
 
 bool LogicalExpression::computeEqual() const
@@ -57,7 +57,16 @@ LogicalExpression::Op LogicalExpression::op() const
 	return m_op;
 }
 
+static const size_t PARSE_CACHE_LIMIT = 256;
+
 LogicalExpression LogicalExpression::parse(const string &input)
+{
+	static BoundedCache<string, LogicalExpression> cache(PARSE_CACHE_LIMIT);
+
+	return cache.get(input, [&]() { return parseUncached(input); });
+}
+
+LogicalExpression LogicalExpression::parseUncached(const string &input)
 {
 	static const RegularExpression re("^(\\w+)\\s*(==|!=)\\s*(\\w+)$");
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace BeeeOn {
 
 /**
@@ -11,7 +13,8 @@ namespace BeeeOn {
  * - != - not equals
  *
  * The <code>left</code> and <code>right</code> parts are
- * strings without whitespace.
+ * strings without whitespace. The result is computed once
+ * during construction.
  */
 class LogicalExpression {
 public:
@@ -35,15 +38,27 @@ public:
 	std::string right() const;
 	Op op() const;
 
+	/**
+	 * @brief Parse the given input. The parsed expressions are
+	 * cached (up to a limit) because the same expressions are
+	 * usually parsed repeatedly.
+	 */
 	static LogicalExpression parse(const std::string &input);
 
+	/**
+	 * @brief Parse the given input without using the cache.
+	 */
+	static LogicalExpression parseUncached(const std::string &input);
+
 private:
 	bool computeEqual() const;
+	bool compute() const;
 
 private:
 	const std::string m_left;
 	const std::string m_right;
 	const Op m_op;
+	const bool m_result;
 };
 
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 
 #include <Poco/Ascii.h>
@@ -6,12 +7,68 @@
 #include <Poco/String.h>
 
 #include "math/SimpleCalc.h"
+#include "util/BoundedCache.h"
 
 using namespace std;
 using namespace Poco;
 using namespace BeeeOn;
 
+static const size_t COMPILED_CACHE_LIMIT = 256;
+
+double SimpleCalc::Program::evaluate(initializer_list<double> values) const
+{
+	if (values.size() < m_required) {
+		throw InvalidArgumentException(
+			"expected " + to_string(m_required)
+			+ " values but got " + to_string(values.size()));
+	}
+
+	const double *variables = values.begin();
+	double result = NAN;
+
+	for (const auto &step : m_steps) {
+		const double operand = step.variable < 0?
+			step.value : variables[step.variable];
+
+		if (step.op == '\0')
+			result = operand;
+		else
+			apply(result, step.op, operand);
+	}
+
+	return result;
+}
+
+const vector<string> &SimpleCalc::Program::variables() const
+{
+	return m_variables;
+}
+
+SimpleCalc::SimpleCalc(const vector<string> &variables):
+	m_variables(variables)
+{
+}
+
 double SimpleCalc::evaluate(const string &input) const
+{
+	return compiled(input)->evaluate();
+}
+
+SimpleCalc::Program::Ptr SimpleCalc::compiled(const string &input) const
+{
+	static BoundedCache<string, Program::Ptr> cache(COMPILED_CACHE_LIMIT);
+
+	string key;
+	for (const auto &name : m_variables)
+		key += name + ",";
+	key += ":" + input;
+
+	return cache.get(key, [&]() {
+		return Program::Ptr(new Program(compile(input)));
+	});
+}
+
+SimpleCalc::Program SimpleCalc::compile(const string &input) const
 {
 	enum State {
 		S_INIT,
@@ -27,25 +84,34 @@ double SimpleCalc::evaluate(const string &input) const
 	if (at == end)
 		throw SyntaxException("expected <term> but got nothing");
 
-	double result = NAN;
-	double tmp = NAN;
+	Program program;
+	program.m_variables = m_variables;
+	program.m_required = 0;
+
 	char op = '\0';
 
 	while (at != end) {
+		Program::Step step = {'\0', -1, NAN};
+
 		switch (state) {
 		case S_INIT:
-			result = parseTerm(at, end);
+			parseOperand(at, end, step);
 			break;
 
 		case S_TERM_OP_TERM:
-			tmp = parseTerm(at, end);
-			apply(result, op, tmp);
+			step.op = op;
+			parseOperand(at, end, step);
 			break;
 		}
 
+		if (step.variable >= 0)
+			program.m_required = max<size_t>(program.m_required, step.variable + 1);
+
+		program.m_steps.emplace_back(step);
+
 		op = parseOpOrEOF(at, end);
 		if (op == '\0')
-			return result;
+			return program;
 
 		state = S_TERM_OP_TERM;
 	}
@@ -53,7 +119,44 @@ double SimpleCalc::evaluate(const string &input) const
 	if (op != '\0')
 		throw SyntaxException("missing <term> after <op>: " + to_string(op));
 
-	return result;
+	return program;
+}
+
+void SimpleCalc::parseOperand(
+	string::const_iterator &at,
+	string::const_iterator end,
+	Program::Step &step) const
+{
+	skipWhitespace(at, end);
+
+	if (at == end || !(Ascii::isAlpha(*at) || *at == '_')) {
+		step.value = parseTerm(at, end);
+		return;
+	}
+
+	const string::const_iterator begin = at;
+
+	for (; at != end; ++at) {
+		const char c = *at;
+
+		if (Ascii::isAlphaNumeric(c) || c == '_')
+			continue;
+		else if (isWhitespace(c) || isOperator(c))
+			break;
+		else
+			throw SyntaxException("unexpected content after <variable>: " + string(1, c));
+	}
+
+	const string name(begin, at);
+
+	for (size_t i = 0; i < m_variables.size(); ++i) {
+		if (m_variables[i] == name) {
+			step.variable = i;
+			return;
+		}
+	}
+
+	throw SyntaxException("unknown variable: " + name);
 }
 
 double SimpleCalc::parseTerm(
@@ -156,7 +259,7 @@ char SimpleCalc::parseOpOrEOF(
 	throw SyntaxException("unexpected character: " + string(1, op) + " for <op>");
 }
 
-void SimpleCalc::apply(double &result, char op, double tmp) const
+void SimpleCalc::apply(double &result, char op, double tmp)
 {
 	switch (op) {
 	case '+':
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <Poco/SharedPtr.h>
+
 namespace BeeeOn {
 
 /**
@@ -13,12 +19,79 @@ namespace BeeeOn {
  *    -> 4 / 2 * 5
  *    -> 2 * 5
  *    -> 10
+ *
+ * An expression can refer to variables when their names are given
+ * to the constructor. Values of the variables are given to the
+ * Program::evaluate() in the same order:
+ *
+ *  SimpleCalc calc({"x"});
+ *  calc.compile("x * 9 / 5 + 32").evaluate({21.5});
  */
 class SimpleCalc {
 public:
+	/**
+	 * @brief Compiled expression. Evaluation of a Program does not
+	 * parse anything and does not allocate any memory.
+	 */
+	class Program {
+		friend class SimpleCalc;
+	public:
+		typedef Poco::SharedPtr<const Program> Ptr;
+
+		/**
+		 * @brief Evaluate the program with the given values of variables.
+		 * The values are given in order of variables() but only values up
+		 * to the last variable referenced by the expression are required.
+		 * Thus, a constant expression is evaluated without any values.
+		 * @throws Poco::InvalidArgumentException when not enough values are given
+		 * @throws Poco::IllegalStateException on division by zero
+		 */
+		double evaluate(std::initializer_list<double> values = {}) const;
+
+		const std::vector<std::string> &variables() const;
+
+	private:
+		/**
+		 * Single operation applied to the intermediate result.
+		 * The first step has no op as it just loads its operand.
+		 */
+		struct Step {
+			char op;
+			int variable;
+			double value;
+		};
+
+		std::vector<Step> m_steps;
+		std::vector<std::string> m_variables;
+		size_t m_required;
+	};
+
+	SimpleCalc(const std::vector<std::string> &variables = {});
+
+	/**
+	 * @brief Evaluate the given expression that must not refer
+	 * to any variable. The compiled expression is cached.
+	 */
 	double evaluate(const std::string &input) const;
 
+	/**
+	 * @brief Compile the given expression. Use this for expressions
+	 * that are evaluated repeatedly.
+	 */
+	Program compile(const std::string &input) const;
+
+	/**
+	 * @brief Compile the given expression or reuse a previously compiled
+	 * one. The cache is shared by all SimpleCalc instances and it is
+	 * keyed by the expression text and the known variables.
+	 */
+	Program::Ptr compiled(const std::string &input) const;
+
 protected:
+	void parseOperand(
+		std::string::const_iterator &at,
+		std::string::const_iterator end,
+		Program::Step &step) const;
 	double parseTerm(
 		std::string::const_iterator &at,
 		std::string::const_iterator end) const;
@@ -29,11 +102,14 @@ protected:
 		std::string::const_iterator &at,
 		std::string::const_iterator end) const;
 
-	void apply(double &result, char op, double tmp) const;
+	static void apply(double &result, char op, double tmp);
 
 	bool isWhitespace(const char c) const;
 	bool isOperator(const char c) const;
 	bool isTerm(const char c) const;
+
+private:
+	std::vector<std::string> m_variables;
 };
 
 }
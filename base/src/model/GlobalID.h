@@ -15,7 +15,7 @@ public:
 	};
 
 	struct Hash {
-		unsigned int operator() (const GlobalID &id)
+		unsigned int operator() (const GlobalID &id) const
 		{
 			return id.hash();
 		}
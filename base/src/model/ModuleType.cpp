@@ -5,6 +5,7 @@
 #include <Poco/StringTokenizer.h>
 
 #include "model/ModuleType.h"
+#include "util/BoundedCache.h"
 
 using namespace BeeeOn;
 using namespace Poco;
@@ -373,7 +374,16 @@ CustomTypeID ModuleType::customTypeID() const
 	return m_customID;
 }
 
+static const size_t PARSE_CACHE_LIMIT = 256;
+
 ModuleType ModuleType::parse(string input)
+{
+	static BoundedCache<string, ModuleType> cache(PARSE_CACHE_LIMIT);
+
+	return cache.get(input, [&]() { return parseUncached(input); });
+}
+
+ModuleType ModuleType::parseUncached(const string &input)
 {
 	set<ModuleType::Attribute> attributes;
 
@@ -395,8 +405,8 @@ ModuleType ModuleType::parse(string input)
 
 	assureValidAttributes(attributes);
 
+	static const RegularExpression re("(enum|bitmap):(.+)");
 	RegularExpression::MatchVec matches;
-	RegularExpression re("(enum|bitmap):(.+)");
 
 	string typeName;
 	string idValue;
@@ -322,8 +322,18 @@ public:
 	void setCustomTypeID(CustomTypeID id);
 	CustomTypeID customTypeID() const;
 
+	/**
+	 * @brief Parse the given input. Successfully parsed inputs are
+	 * cached (up to a limit) because the same strings are parsed
+	 * repeatedly (type mappings, server messages).
+	 */
 	static ModuleType parse(std::string input);
 
+	/**
+	 * @brief Parse the given input without using the cache.
+	 */
+	static ModuleType parseUncached(const std::string &input);
+
 protected:
 	static bool hasCombination(
 		const std::set<Attribute> &attributes,
@@ -1,5 +1,7 @@
 #include "util/AsyncExecutor.h"
 
+using namespace std;
+using namespace Poco;
 using namespace BeeeOn;
 
 AsyncExecutor::AsyncExecutor()
@@ -9,3 +11,11 @@ AsyncExecutor::AsyncExecutor()
 AsyncExecutor::~AsyncExecutor()
 {
 }
+
+void AsyncExecutor::invoke(
+		const string &,
+		const Timespan &,
+		function<void()> f)
+{
+	invoke(f);
+}
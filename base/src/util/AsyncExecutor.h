@@ -1,8 +1,10 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
 
 namespace BeeeOn {
 
@@ -20,6 +22,17 @@ public:
 	 * Add task to queue for executing
 	 */
 	virtual void invoke(std::function<void()> f) = 0;
+
+	/**
+	 * Add task of the given group to queue for executing. The task
+	 * should be finished within the given budget (measured since now),
+	 * a non-positive budget means no deadline. The default implementation
+	 * ignores the group and the budget.
+	 */
+	virtual void invoke(
+		const std::string &group,
+		const Poco::Timespan &budget,
+		std::function<void()> f);
 };
 
 }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+
+#include <Poco/Exception.h>
+#include <Poco/Mutex.h>
+
+namespace BeeeOn {
+
+/**
+ * BoundedCache is a thread-safe memoization cache of results of some
+ * expensive operation (e.g. parsing). The number of cached entries
+ * is bounded. When the cache is full, new results are not cached
+ * anymore but they are still computed and returned. This is suitable
+ * for inputs that come from a small set of values (configuration).
+ *
+ * Common usage:
+ *
+ *   Type Type::parse(const string &input)
+ *   {
+ *      static BoundedCache<string, Type> cache(256);
+ *      return cache.get(input, [&]() { return parseUncached(input); });
+ *   }
+ *
+ * The create function is called without holding the lock. Thus, it can
+ * be called concurrently for the same key and it might throw.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class BoundedCache {
+public:
+	BoundedCache(size_t limit);
+
+	/**
+	 * Return the cached value for the given key. If there is no
+	 * such value, it is created by the given create function and
+	 * cached if the limit has not been reached yet.
+	 */
+	template <typename Create>
+	Value get(const Key &key, const Create &create);
+
+	/**
+	 * Return count of cached values.
+	 */
+	size_t size() const;
+
+	/**
+	 * Return the maximal count of cached values.
+	 */
+	size_t limit() const;
+
+private:
+	const size_t m_limit;
+	std::unordered_map<Key, Value, Hash> m_cache;
+	mutable Poco::FastMutex m_lock;
+};
+
+template <typename Key, typename Value, typename Hash>
+BoundedCache<Key, Value, Hash>::BoundedCache(size_t limit):
+	m_limit(limit)
+{
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Create>
+Value BoundedCache<Key, Value, Hash>::get(const Key &key, const Create &create)
+{
+	{
+		Poco::FastMutex::ScopedLock guard(m_lock);
+
+		auto it = m_cache.find(key);
+		if (it != m_cache.end())
+			return it->second;
+	}
+
+	const Value value = create();
+
+	Poco::FastMutex::ScopedLock guard(m_lock);
+
+	if (m_cache.size() < m_limit)
+		m_cache.emplace(key, value);
+
+	return value;
+}
+
+template <typename Key, typename Value, typename Hash>
+size_t BoundedCache<Key, Value, Hash>::size() const
+{
+	Poco::FastMutex::ScopedLock guard(m_lock);
+	return m_cache.size();
+}
+
+template <typename Key, typename Value, typename Hash>
+size_t BoundedCache<Key, Value, Hash>::limit() const
+{
+	return m_limit;
+}
+
+}
@@ -7,6 +7,8 @@
 #include <map>
 #include <string>
 
+#include "util/PerfectHashIndex.h"
+
 namespace BeeeOn {
 
 /**
@@ -100,6 +102,10 @@ struct EnumNamesInitializer {
  *   typedef Enum<TestEnum> Test;
  *
  * Use Test class as the target enum's type.
+ *
+ * Parsing does not search the NamesMap directly. A PerfectHashIndex
+ * is built from it on the first use, thus parsing of a name needs
+ * just a single hash computation and string comparison.
  */
 template <typename Base, typename RawType = typename Base::Raw,
 	typename NamesMapInitializer = EnumNamesInitializer<RawType>>
@@ -206,6 +212,12 @@ protected:
 		return initializer.namesMap;
 	}
 
+	static const PerfectHashIndex<Value> &namesIndex()
+	{
+		static const PerfectHashIndex<Value> index(namesMap());
+		return index;
+	}
+
 public:
 	Raw raw() const
 	{
@@ -225,13 +237,13 @@ public:
 
 	static ThisEnum parse(const std::string &input)
 	{
-		auto it = namesMap().find(input);
-		if (it == namesMap().end()) {
+		const Value *value = namesIndex().find(input);
+		if (value == nullptr) {
 			throw Poco::InvalidArgumentException(
 				"failed to parse '" + input + "'");
 		}
 
-		return ThisEnum(it->second);
+		return ThisEnum(*value);
 	}
 
 	static ThisEnum fromRaw(const Raw &raw)
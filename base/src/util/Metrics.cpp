@@ -0,0 +1,146 @@
+#include <algorithm>
+
+#include <Poco/Exception.h>
+
+#include "util/Metrics.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+Metric::~Metric()
+{
+}
+
+CounterMetric::CounterMetric():
+	m_value(0)
+{
+}
+
+void CounterMetric::add(uint64_t count)
+{
+	m_value.fetch_add(count, memory_order_relaxed);
+}
+
+uint64_t CounterMetric::value() const
+{
+	return m_value.load(memory_order_relaxed);
+}
+
+void CounterMetric::collect(const Collector &collector) const
+{
+	collector("", value());
+}
+
+GaugeMetric::GaugeMetric():
+	m_value(0)
+{
+}
+
+void GaugeMetric::set(int64_t value)
+{
+	m_value.store(value, memory_order_relaxed);
+}
+
+void GaugeMetric::add(int64_t value)
+{
+	m_value.fetch_add(value, memory_order_relaxed);
+}
+
+void GaugeMetric::sub(int64_t value)
+{
+	m_value.fetch_sub(value, memory_order_relaxed);
+}
+
+int64_t GaugeMetric::value() const
+{
+	return m_value.load(memory_order_relaxed);
+}
+
+void GaugeMetric::collect(const Collector &collector) const
+{
+	collector("", value());
+}
+
+HistogramMetric::HistogramMetric(const vector<int64_t> &bounds):
+	m_bounds(bounds),
+	m_buckets(bounds.size() + 1),
+	m_count(0),
+	m_sum(0)
+{
+	if (m_bounds.empty())
+		throw InvalidArgumentException("histogram must have at least one bucket");
+
+	for (size_t i = 1; i < m_bounds.size(); ++i) {
+		if (m_bounds[i - 1] >= m_bounds[i])
+			throw InvalidArgumentException("histogram bounds must be ascending");
+	}
+
+	for (auto &bucket : m_buckets)
+		bucket.store(0, memory_order_relaxed);
+}
+
+void HistogramMetric::observe(int64_t value)
+{
+	const auto it = lower_bound(m_bounds.begin(), m_bounds.end(), value);
+	const size_t index = it - m_bounds.begin();
+
+	m_buckets[index].fetch_add(1, memory_order_relaxed);
+	m_count.fetch_add(1, memory_order_relaxed);
+	m_sum.fetch_add(value, memory_order_relaxed);
+}
+
+const vector<int64_t> &HistogramMetric::bounds() const
+{
+	return m_bounds;
+}
+
+uint64_t HistogramMetric::bucket(size_t index) const
+{
+	return m_buckets.at(index).load(memory_order_relaxed);
+}
+
+uint64_t HistogramMetric::count() const
+{
+	return m_count.load(memory_order_relaxed);
+}
+
+int64_t HistogramMetric::sum() const
+{
+	return m_sum.load(memory_order_relaxed);
+}
+
+void HistogramMetric::collect(const Collector &collector) const
+{
+	collector(".count", count());
+	collector(".sum", sum());
+
+	for (size_t i = 0; i < m_bounds.size(); ++i)
+		collector(".le_" + to_string(m_bounds[i]), bucket(i));
+
+	collector(".inf", bucket(m_bounds.size()));
+}
+
+IOStatsMetric::IOStatsMetric(SharedPtr<IOStats> stats):
+	m_stats(stats)
+{
+	if (m_stats.isNull())
+		throw InvalidArgumentException("IOStats must not be null");
+}
+
+SharedPtr<IOStats> IOStatsMetric::stats() const
+{
+	return m_stats;
+}
+
+void IOStatsMetric::collect(const Collector &collector) const
+{
+	const IOStats::Data data = m_stats->data();
+
+	collector(".written.pdu", data.writtenPdu);
+	collector(".written.bytes", data.writtenBytes);
+	collector(".read.pdu", data.readPdu);
+	collector(".read.bytes", data.readBytes);
+	collector(".lost.pdu", data.lostPdu);
+	collector(".lost.bytes", data.lostBytes);
+}
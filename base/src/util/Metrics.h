@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Poco/SharedPtr.h>
+
+#include "io/IOStats.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief Metric is a named source of numeric samples. Each metric
+ * provides one or more samples via collect(). Every sample is
+ * identified by a suffix that is appended to the name of the metric
+ * (an empty suffix denotes the metric itself).
+ *
+ * Updating of all the metrics is lock-free (based on std::atomic).
+ * Thus, they can be used on hot paths without any significant
+ * overhead.
+ */
+class Metric {
+public:
+	typedef Poco::SharedPtr<Metric> Ptr;
+	typedef std::function<void(const std::string &, int64_t)> Collector;
+
+	virtual ~Metric();
+
+	/**
+	 * @brief Report all samples of the metric via the given collector.
+	 */
+	virtual void collect(const Collector &collector) const = 0;
+};
+
+/**
+ * @brief Monotonic counter of events.
+ */
+class CounterMetric : public Metric {
+public:
+	typedef Poco::SharedPtr<CounterMetric> Ptr;
+
+	CounterMetric();
+
+	void add(uint64_t count = 1);
+	uint64_t value() const;
+
+	void collect(const Collector &collector) const override;
+
+private:
+	std::atomic<uint64_t> m_value;
+};
+
+/**
+ * @brief Gauge represents a value that can go up and down
+ * (e.g. queue depth).
+ */
+class GaugeMetric : public Metric {
+public:
+	typedef Poco::SharedPtr<GaugeMetric> Ptr;
+
+	GaugeMetric();
+
+	void set(int64_t value);
+	void add(int64_t value = 1);
+	void sub(int64_t value = 1);
+	int64_t value() const;
+
+	void collect(const Collector &collector) const override;
+
+private:
+	std::atomic<int64_t> m_value;
+};
+
+/**
+ * @brief Histogram with a fixed set of buckets. The buckets are given
+ * by their upper bounds (inclusive) in an ascending order. Values
+ * greater than the last bound fall into an implicit overflow bucket.
+ *
+ * The collected samples are:
+ *
+ * - .count - number of observed values
+ * - .sum - sum of all observed values
+ * - .le_<bound> - number of values that fell into the particular bucket
+ * - .inf - number of values greater than the last bound
+ */
+class HistogramMetric : public Metric {
+public:
+	typedef Poco::SharedPtr<HistogramMetric> Ptr;
+
+	/**
+	 * @throws Poco::InvalidArgumentException when the bounds are
+	 * empty or not in a strictly ascending order
+	 */
+	HistogramMetric(const std::vector<int64_t> &bounds);
+
+	void observe(int64_t value);
+
+	const std::vector<int64_t> &bounds() const;
+
+	/**
+	 * @returns count of values in the bucket of the given index,
+	 * index equal to bounds().size() denotes the overflow bucket
+	 */
+	uint64_t bucket(size_t index) const;
+	uint64_t count() const;
+	int64_t sum() const;
+
+	void collect(const Collector &collector) const override;
+
+private:
+	const std::vector<int64_t> m_bounds;
+	std::vector<std::atomic<uint64_t>> m_buckets;
+	std::atomic<uint64_t> m_count;
+	std::atomic<int64_t> m_sum;
+};
+
+/**
+ * @brief Exposes an IOStats instance as a metric. The collected
+ * samples are .written.pdu, .written.bytes, .read.pdu, .read.bytes,
+ * .lost.pdu and .lost.bytes.
+ */
+class IOStatsMetric : public Metric {
+public:
+	typedef Poco::SharedPtr<IOStatsMetric> Ptr;
+
+	IOStatsMetric(Poco::SharedPtr<IOStats> stats);
+
+	Poco::SharedPtr<IOStats> stats() const;
+
+	void collect(const Collector &collector) const override;
+
+private:
+	Poco::SharedPtr<IOStats> m_stats;
+};
+
+}
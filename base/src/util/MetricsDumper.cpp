@@ -0,0 +1,79 @@
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+
+#include "di/Injectable.h"
+#include "io/SafeWriter.h"
+#include "util/MetricsDumper.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, MetricsDumper)
+BEEEON_OBJECT_CASTABLE(StoppableLoop)
+BEEEON_OBJECT_PROPERTY("file", &MetricsDumper::setFile)
+BEEEON_OBJECT_PROPERTY("interval", &MetricsDumper::setInterval)
+BEEEON_OBJECT_PROPERTY("prefix", &MetricsDumper::setPrefix)
+BEEEON_OBJECT_END(BeeeOn, MetricsDumper)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+MetricsDumper::MetricsDumper()
+{
+	m_runner.setInterval(1 * Timespan::MINUTES);
+}
+
+void MetricsDumper::setFile(const string &path)
+{
+	m_file = path;
+}
+
+void MetricsDumper::setInterval(const Timespan &interval)
+{
+	if (interval <= 0)
+		throw InvalidArgumentException("interval must be a positive number");
+
+	m_runner.setInterval(interval);
+}
+
+void MetricsDumper::setPrefix(const string &prefix)
+{
+	m_prefix = prefix;
+}
+
+void MetricsDumper::dump()
+{
+	const auto snapshot = MetricsRegistry::global().snapshot(m_prefix);
+
+	SafeWriter writer(m_file, "tmp");
+
+	for (const auto &pair : snapshot)
+		writer.stream() << pair.first << " " << pair.second << "\n";
+
+	writer.commitAs(m_file);
+
+	if (logger().debug()) {
+		logger().debug(
+			"dumped " + to_string(snapshot.size())
+			+ " metrics into " + m_file.path(),
+			__FILE__, __LINE__);
+	}
+}
+
+void MetricsDumper::start()
+{
+	if (m_file.path().empty()) {
+		logger().warning("no file to dump metrics into", __FILE__, __LINE__);
+		return;
+	}
+
+	m_runner.start([&]() {
+		try {
+			dump();
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	});
+}
+
+void MetricsDumper::stop()
+{
+	m_runner.stop();
+}
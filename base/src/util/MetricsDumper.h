@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+#include <Poco/File.h>
+#include <Poco/Timespan.h>
+
+#include "loop/StoppableLoop.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+#include "util/PeriodicRunner.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief MetricsDumper periodically writes snapshot of the global
+ * MetricsRegistry into the configured file. Each line of the file
+ * contains a metric name and its value separated by a space. The file
+ * is always rewritten atomically (via SafeWriter) so readers never see
+ * a partially written snapshot.
+ */
+class MetricsDumper : public StoppableLoop, Loggable {
+public:
+	MetricsDumper();
+
+	/**
+	 * @brief Set path to the file to write snapshots into.
+	 */
+	void setFile(const std::string &path);
+
+	/**
+	 * @brief Set interval of dumping the metrics.
+	 */
+	void setInterval(const Poco::Timespan &interval);
+
+	/**
+	 * @brief Set prefix of metrics to be dumped. Empty prefix
+	 * (default) means to dump all metrics.
+	 */
+	void setPrefix(const std::string &prefix);
+
+	/**
+	 * @brief Write the current snapshot into the file immediately.
+	 */
+	void dump();
+
+	void start() override;
+	void stop() override;
+
+private:
+	Poco::File m_file;
+	std::string m_prefix;
+	PeriodicRunner m_runner;
+};
+
+}
@@ -0,0 +1,141 @@
+#include <Poco/Exception.h>
+
+#include "util/MetricsRegistry.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+MetricsRegistry::MetricsRegistry()
+{
+}
+
+MetricsRegistry &MetricsRegistry::global()
+{
+	// never destroyed to avoid issues with static destruction order
+	static MetricsRegistry *registry = new MetricsRegistry;
+	return *registry;
+}
+
+void MetricsRegistry::add(const string &name, Metric::Ptr metric)
+{
+	if (name.empty())
+		throw InvalidArgumentException("metric name must not be empty");
+	if (metric.isNull())
+		throw InvalidArgumentException("metric must not be null");
+
+	FastMutex::ScopedLock guard(m_lock);
+	m_metrics.emplace(name, metric);
+}
+
+void MetricsRegistry::remove(Metric::Ptr metric)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	for (auto it = m_metrics.begin(); it != m_metrics.end();) {
+		if (it->second == metric)
+			it = m_metrics.erase(it);
+		else
+			++it;
+	}
+}
+
+CounterMetric::Ptr MetricsRegistry::counter(const string &name)
+{
+	CounterMetric::Ptr metric = new CounterMetric;
+	add(name, metric);
+	return metric;
+}
+
+GaugeMetric::Ptr MetricsRegistry::gauge(const string &name)
+{
+	GaugeMetric::Ptr metric = new GaugeMetric;
+	add(name, metric);
+	return metric;
+}
+
+HistogramMetric::Ptr MetricsRegistry::histogram(
+		const string &name,
+		const vector<int64_t> &bounds)
+{
+	HistogramMetric::Ptr metric = new HistogramMetric(bounds);
+	add(name, metric);
+	return metric;
+}
+
+IOStatsMetric::Ptr MetricsRegistry::ioStats(
+		const string &name,
+		SharedPtr<IOStats> stats)
+{
+	IOStatsMetric::Ptr metric = new IOStatsMetric(stats);
+	add(name, metric);
+	return metric;
+}
+
+MetricsRegistry::Snapshot MetricsRegistry::snapshot(const string &prefix) const
+{
+	Snapshot result;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	for (auto it = m_metrics.lower_bound(prefix); it != m_metrics.end(); ++it) {
+		if (it->first.compare(0, prefix.size(), prefix) != 0)
+			break;
+
+		const string &name = it->first;
+
+		it->second->collect([&](const string &suffix, int64_t value) {
+			result[name + suffix] += value;
+		});
+	}
+
+	return result;
+}
+
+size_t MetricsRegistry::size() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_metrics.size();
+}
+
+MetricsScope::MetricsScope(MetricsRegistry &registry):
+	m_registry(registry)
+{
+}
+
+MetricsScope::~MetricsScope()
+{
+	clear();
+}
+
+CounterMetric::Ptr MetricsScope::counter(const string &name)
+{
+	return track(m_registry.counter(name));
+}
+
+GaugeMetric::Ptr MetricsScope::gauge(const string &name)
+{
+	return track(m_registry.gauge(name));
+}
+
+HistogramMetric::Ptr MetricsScope::histogram(
+		const string &name,
+		const vector<int64_t> &bounds)
+{
+	return track(m_registry.histogram(name, bounds));
+}
+
+IOStatsMetric::Ptr MetricsScope::ioStats(
+		const string &name,
+		SharedPtr<IOStats> stats)
+{
+	return track(m_registry.ioStats(name, stats));
+}
+
+void MetricsScope::clear()
+{
+	for (auto metric : m_metrics)
+		m_registry.remove(metric);
+
+	m_metrics.clear();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+
+#include "util/Metrics.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief MetricsRegistry maintains named metrics of the running
+ * application. Components create (or add) their metrics during
+ * initialization and update them directly afterwards. The registry
+ * is locked only when a metric is added, removed or when a snapshot
+ * is being created. Updates of metrics never touch the registry.
+ *
+ * Multiple metrics can be registered under the same name (e.g. when
+ * there are more instances of the same component). Their samples are
+ * summed together in the snapshot.
+ *
+ * There is a global instance available via MetricsRegistry::global()
+ * but other instances can be created (e.g. for testing).
+ */
+class MetricsRegistry {
+public:
+	typedef std::map<std::string, int64_t> Snapshot;
+
+	MetricsRegistry();
+
+	/**
+	 * @returns the application-wide registry
+	 */
+	static MetricsRegistry &global();
+
+	void add(const std::string &name, Metric::Ptr metric);
+
+	/**
+	 * @brief Remove the given metric instance (if registered).
+	 */
+	void remove(Metric::Ptr metric);
+
+	CounterMetric::Ptr counter(const std::string &name);
+	GaugeMetric::Ptr gauge(const std::string &name);
+	HistogramMetric::Ptr histogram(
+		const std::string &name,
+		const std::vector<int64_t> &bounds);
+	IOStatsMetric::Ptr ioStats(
+		const std::string &name,
+		Poco::SharedPtr<IOStats> stats);
+
+	/**
+	 * @brief Collect samples of all registered metrics whose
+	 * names start with the given prefix.
+	 */
+	Snapshot snapshot(const std::string &prefix = "") const;
+
+	size_t size() const;
+
+private:
+	std::multimap<std::string, Metric::Ptr> m_metrics;
+	mutable Poco::FastMutex m_lock;
+};
+
+/**
+ * @brief MetricsScope creates metrics in the given registry and
+ * removes all of them on destruction. It is intended to be a member
+ * of a component that is registering metrics and thus the lifetime
+ * of the metrics follows the lifetime of the component.
+ */
+class MetricsScope {
+public:
+	MetricsScope(MetricsRegistry &registry = MetricsRegistry::global());
+	~MetricsScope();
+
+	CounterMetric::Ptr counter(const std::string &name);
+	GaugeMetric::Ptr gauge(const std::string &name);
+	HistogramMetric::Ptr histogram(
+		const std::string &name,
+		const std::vector<int64_t> &bounds);
+	IOStatsMetric::Ptr ioStats(
+		const std::string &name,
+		Poco::SharedPtr<IOStats> stats);
+
+	/**
+	 * @brief Remove all metrics created via this scope.
+	 */
+	void clear();
+
+private:
+	MetricsScope(const MetricsScope &) = delete;
+	MetricsScope &operator =(const MetricsScope &) = delete;
+
+	template <typename M>
+	Poco::SharedPtr<M> track(Poco::SharedPtr<M> metric)
+	{
+		m_metrics.emplace_back(metric);
+		return metric;
+	}
+
+private:
+	MetricsRegistry &m_registry;
+	std::vector<Metric::Ptr> m_metrics;
+};
+
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BeeeOn {
+
+/**
+ * PerfectHashIndex is an immutable string-keyed lookup table built once
+ * (typically at startup) from a std::map. It uses open addressing with
+ * a seeded hash function. During construction, the table size and seed
+ * are searched for such combination that every key occupies its home
+ * slot. A successful lookup then needs a single hash computation and
+ * a single string comparison without any heap allocation.
+ *
+ * When no perfect combination is found within reasonable limits (which
+ * is not expected for small tables like enum names), the best found
+ * combination is used and lookups probe at most maxProbe() slots.
+ *
+ *   std::map<std::string, int> names = {{"first", 1}, {"second", 2}};
+ *   PerfectHashIndex<int> index(names);
+ *
+ *   const int *value = index.find("second");
+ *   if (value == nullptr)
+ *       throw NotFoundException("no such name");
+ */
+template <typename Value>
+class PerfectHashIndex {
+public:
+	PerfectHashIndex(const std::map<std::string, Value> &entries);
+
+	/**
+	 * @returns pointer to the value of the given key or nullptr
+	 */
+	const Value *find(const std::string &key) const;
+
+	/**
+	 * @returns maximal number of slots examined by a lookup,
+	 * 1 means that the index is perfect
+	 */
+	std::size_t maxProbe() const
+	{
+		return m_maxProbe;
+	}
+
+	std::size_t tableSize() const
+	{
+		return m_table.size();
+	}
+
+	static uint64_t hash(const char *data, std::size_t length, uint64_t seed);
+
+protected:
+	struct Slot {
+		bool used;
+		std::string key;
+		Value value;
+	};
+
+	/**
+	 * @brief Build table of the given size (power of 2) with the given
+	 * seed. The table is filled only when its longest probe sequence
+	 * is shorter than limit.
+	 *
+	 * @returns the longest probe sequence or limit when exceeded
+	 */
+	static std::size_t build(
+		const std::map<std::string, Value> &entries,
+		std::size_t size,
+		uint64_t seed,
+		std::size_t limit,
+		std::vector<Slot> &table);
+
+private:
+	std::vector<Slot> m_table;
+	uint64_t m_seed;
+	uint64_t m_mask;
+	std::size_t m_maxProbe;
+};
+
+template <typename Value>
+PerfectHashIndex<Value>::PerfectHashIndex(
+		const std::map<std::string, Value> &entries):
+	m_seed(0),
+	m_mask(0),
+	m_maxProbe(0)
+{
+	static const unsigned int SEEDS = 64;
+	static const unsigned int GROWTHS = 4;
+
+	std::size_t size = 1;
+	while (size < entries.size() * 2)
+		size <<= 1;
+
+	std::size_t best = entries.size() + 1;
+
+	for (unsigned int growth = 0; growth < GROWTHS; ++growth, size <<= 1) {
+		for (uint64_t seed = 0; seed < SEEDS; ++seed) {
+			std::vector<Slot> table;
+			const std::size_t probe = build(entries, size, seed, best, table);
+
+			if (probe < best) {
+				best = probe;
+				m_table.swap(table);
+				m_seed = seed;
+				m_mask = size - 1;
+				m_maxProbe = probe;
+			}
+
+			if (best <= 1)
+				return;
+		}
+	}
+}
+
+template <typename Value>
+std::size_t PerfectHashIndex<Value>::build(
+		const std::map<std::string, Value> &entries,
+		std::size_t size,
+		uint64_t seed,
+		std::size_t limit,
+		std::vector<Slot> &table)
+{
+	table.assign(size, Slot{false, {}, {}});
+	const uint64_t mask = size - 1;
+	std::size_t longest = entries.empty() ? 1 : 0;
+
+	for (const auto &entry : entries) {
+		uint64_t i = hash(entry.first.data(), entry.first.size(), seed) & mask;
+		std::size_t probe = 1;
+
+		while (table[i].used) {
+			i = (i + 1) & mask;
+			probe += 1;
+		}
+
+		if (probe >= limit)
+			return limit;
+
+		table[i] = Slot{true, entry.first, entry.second};
+
+		if (probe > longest)
+			longest = probe;
+	}
+
+	return longest;
+}
+
+template <typename Value>
+const Value *PerfectHashIndex<Value>::find(const std::string &key) const
+{
+	if (m_table.empty())
+		return nullptr;
+
+	uint64_t i = hash(key.data(), key.size(), m_seed) & m_mask;
+
+	for (std::size_t probe = 0; probe < m_maxProbe; ++probe) {
+		const Slot &slot = m_table[i];
+
+		if (!slot.used)
+			return nullptr;
+
+		if (slot.key == key)
+			return &slot.value;
+
+		i = (i + 1) & m_mask;
+	}
+
+	return nullptr;
+}
+
+/**
+ * FNV-1a with the seed mixed into the offset basis, followed
+ * by the 64-bit finalizer of MurmurHash3 to spread short keys
+ * over the low bits used for indexing.
+ */
+template <typename Value>
+uint64_t PerfectHashIndex<Value>::hash(
+		const char *data,
+		std::size_t length,
+		uint64_t seed)
+{
+	uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+
+	for (std::size_t i = 0; i < length; ++i) {
+		h ^= static_cast<unsigned char>(data[i]);
+		h *= 0x100000001b3ULL;
+	}
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Exception.h>
+#include <Poco/Timespan.h>
+
+namespace BeeeOn {
+
+/**
+ * @brief TimingWheel is a hashed timing wheel useful to expire
+ * a large number of items with cost proportional to the number
+ * of expired items instead of the number of all items.
+ *
+ * The time is divided into ticks of the given resolution. Each
+ * scheduled item is placed into a slot (bucket) selected by its
+ * deadline tick modulo the number of slots. When the wheel is
+ * advanced, only the slots of the passed ticks are visited.
+ * Items scheduled further than the wheel size remain in their slot
+ * until their deadline tick is reached.
+ *
+ * The expiration is precise up to the resolution. The TimingWheel
+ * is not thread-safe, it is expected to be protected by a lock of
+ * its owner.
+ *
+ *   TimingWheel<GlobalID> wheel(100 * Timespan::MILLISECONDS, 64);
+ *
+ *   wheel.schedule(id, 10 * Timespan::SECONDS);
+ *   ...
+ *   wheel.advance(Clock(), [&](const GlobalID &id) {
+ *       m_data.erase(id);
+ *   });
+ */
+template <typename T>
+class TimingWheel {
+public:
+	TimingWheel(
+		const Poco::Timespan &resolution,
+		size_t slots,
+		const Poco::Clock &start = Poco::Clock());
+
+	/**
+	 * @brief Schedule the given item to expire after the given delay
+	 * relative to the given time.
+	 */
+	void schedule(
+		const T &item,
+		const Poco::Timespan &delay,
+		const Poco::Clock &now = Poco::Clock());
+
+	/**
+	 * @brief Advance the wheel up to the given time and call
+	 * the given function for each expired item. Expired items
+	 * are removed from the wheel.
+	 *
+	 * @returns count of expired items
+	 */
+	template <typename Func>
+	size_t advance(const Poco::Clock &now, Func expired);
+
+	/**
+	 * @returns count of scheduled items
+	 */
+	size_t size() const;
+
+	bool empty() const;
+
+	void clear();
+
+protected:
+	struct Entry {
+		uint64_t deadline;
+		T item;
+	};
+
+	uint64_t tickOf(const Poco::Clock &at) const;
+
+private:
+	Poco::Clock m_start;
+	Poco::Clock::ClockDiff m_resolution;
+	uint64_t m_current;
+	size_t m_size;
+	std::vector<std::vector<Entry>> m_slots;
+};
+
+template <typename T>
+TimingWheel<T>::TimingWheel(
+		const Poco::Timespan &resolution,
+		size_t slots,
+		const Poco::Clock &start):
+	m_start(start),
+	m_resolution(resolution.totalMicroseconds()),
+	m_current(0),
+	m_size(0),
+	m_slots(slots)
+{
+	if (m_resolution <= 0)
+		throw Poco::InvalidArgumentException("resolution must be positive");
+
+	if (slots == 0)
+		throw Poco::InvalidArgumentException("slots must be at least 1");
+}
+
+template <typename T>
+uint64_t TimingWheel<T>::tickOf(const Poco::Clock &at) const
+{
+	const Poco::Clock::ClockDiff diff = at - m_start;
+	if (diff <= 0)
+		return 0;
+
+	return (diff + m_resolution - 1) / m_resolution;
+}
+
+template <typename T>
+void TimingWheel<T>::schedule(
+		const T &item,
+		const Poco::Timespan &delay,
+		const Poco::Clock &now)
+{
+	uint64_t deadline = tickOf(now + delay.totalMicroseconds());
+	if (deadline <= m_current)
+		deadline = m_current + 1;
+
+	m_slots[deadline % m_slots.size()].push_back({deadline, item});
+	m_size += 1;
+}
+
+template <typename T>
+template <typename Func>
+size_t TimingWheel<T>::advance(const Poco::Clock &now, Func expired)
+{
+	const uint64_t target = now - m_start < 0 ?
+		0 : (now - m_start) / m_resolution;
+
+	if (target <= m_current)
+		return 0;
+
+	const uint64_t steps = target - m_current < m_slots.size() ?
+		target - m_current : m_slots.size();
+	size_t count = 0;
+
+	for (uint64_t i = 1; i <= steps; ++i) {
+		auto &slot = m_slots[(m_current + i) % m_slots.size()];
+
+		for (size_t k = 0; k < slot.size();) {
+			if (slot[k].deadline > target) {
+				++k;
+				continue;
+			}
+
+			const T item = slot[k].item;
+			slot[k] = slot.back();
+			slot.pop_back();
+			m_size -= 1;
+			count += 1;
+
+			expired(item);
+		}
+	}
+
+	m_current = target;
+	return count;
+}
+
+template <typename T>
+size_t TimingWheel<T>::size() const
+{
+	return m_size;
+}
+
+template <typename T>
+bool TimingWheel<T>::empty() const
+{
+	return m_size == 0;
+}
+
+template <typename T>
+void TimingWheel<T>::clear()
+{
+	for (auto &slot : m_slots)
+		slot.clear();
+
+	m_size = 0;
+}
+
+}
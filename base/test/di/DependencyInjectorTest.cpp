@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include <Poco/AutoPtr.h>
 #include <Poco/Timespan.h>
 #include <Poco/Util/XMLConfiguration.h>
@@ -24,6 +26,7 @@ class DependencyInjectorTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testExternalVariables);
 	CPPUNIT_TEST(testEarly);
 	CPPUNIT_TEST(testCircularDependency);
+	CPPUNIT_TEST(testTrace);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -43,6 +46,7 @@ public:
 	void testExternalVariables();
 	void testEarly();
 	void testCircularDependency();
+	void testTrace();
 
 private:
 	AutoPtr<XMLConfiguration> m_config;
@@ -428,4 +432,42 @@ void DependencyInjectorTest::testCircularDependency()
 	CPPUNIT_ASSERT(secondDestroyed);
 }
 
+/**
+ * Each created instance has its trace entry. Referenced instances are
+ * created (and thus traced) before the instance referring to them.
+ */
+void DependencyInjectorTest::testTrace()
+{
+	m_config->setString("instance[5][@name]", "parent");
+	m_config->setString("instance[5][@class]", "BeeeOn::FakeObject");
+	m_config->setString("instance[5].set[1][@name]", "self");
+	m_config->setString("instance[5].set[1][@ref]", "variable");
+
+	DependencyInjector injector(m_config, {}, true);
+	CPPUNIT_ASSERT(injector.trace().empty());
+
+	injector.create<FakeObject>("parent");
+
+	const auto &trace = injector.trace();
+	CPPUNIT_ASSERT_EQUAL(2, trace.size());
+
+	CPPUNIT_ASSERT_EQUAL("variable", trace[0].name);
+	CPPUNIT_ASSERT_EQUAL("BeeeOn::FakeObject", trace[0].cls);
+	CPPUNIT_ASSERT_EQUAL("parent", trace[1].name);
+
+	for (const auto &one : trace) {
+		CPPUNIT_ASSERT(one.create >= 0);
+		CPPUNIT_ASSERT(one.inject >= 0);
+		CPPUNIT_ASSERT(one.done >= 0);
+	}
+
+	ostringstream report;
+	injector.dumpTrace(report);
+
+	const string text = report.str();
+	CPPUNIT_ASSERT(text.find("# total_us") == 0);
+	CPPUNIT_ASSERT(text.find(" variable BeeeOn::FakeObject\n") != string::npos);
+	CPPUNIT_ASSERT(text.find(" parent BeeeOn::FakeObject\n") != string::npos);
+}
+
 }
@@ -67,6 +67,7 @@ class GWMessageTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testParseDeviceListWithValues);
 	CPPUNIT_TEST(testCreateDeviceList);
 	CPPUNIT_TEST(testCreateDeviceListWithValues);
+	CPPUNIT_TEST(testDeviceListVersion);
 	CPPUNIT_TEST(testParseListen);
 	CPPUNIT_TEST(testCreateListen);
 	CPPUNIT_TEST(testParseSearchIP);
@@ -112,6 +113,7 @@ public:
 	void testParseDeviceListWithValues();
 	void testCreateDeviceList();
 	void testCreateDeviceListWithValues();
+	void testDeviceListVersion();
 	void testParseListen();
 	void testCreateListen();
 	void testParseSearchIP();
@@ -1111,6 +1113,58 @@ void GWMessageTest::testCreateDeviceListWithValues()
 	);
 }
 
+/**
+ * The keys related to incremental synchronization of the device list
+ * are optional. An unchanged response contains no devices.
+ */
+void GWMessageTest::testDeviceListVersion()
+{
+	GWDeviceListRequest::Ptr request(new GWDeviceListRequest);
+	request->setID(GlobalID::parse("a08c356b-316d-4690-84d4-b77d95b403fe"));
+	request->setDevicePrefix(DevicePrefix::parse("Fitprotocol"));
+
+	CPPUNIT_ASSERT(request->knownVersion().empty());
+
+	request->setKnownVersion("17");
+
+	CPPUNIT_ASSERT_EQUAL(
+		jsonReformat(R"({
+			"message_type": "device_list_request",
+			"id": "a08c356b-316d-4690-84d4-b77d95b403fe",
+			"device_prefix": "fitp",
+			"known_version": "17"
+		})"),
+		request->toString()
+	);
+
+	GWMessage::Ptr message = GWMessage::fromJSON(
+	R"({
+			"message_type": "device_list_response",
+			"id": "a08c356b-316d-4690-84d4-b77d95b403fe",
+			"status": 1,
+			"version": "17",
+			"unchanged": true
+	})");
+
+	GWDeviceListResponse::Ptr response = message.cast<GWDeviceListResponse>();
+	CPPUNIT_ASSERT(!response.isNull());
+	CPPUNIT_ASSERT_EQUAL("17", response->version());
+	CPPUNIT_ASSERT(response->unchanged());
+	CPPUNIT_ASSERT(response->devices().empty());
+
+	message = GWMessage::fromJSON(
+	R"({
+			"message_type": "device_list_response",
+			"id": "a08c356b-316d-4690-84d4-b77d95b403fe",
+			"status": 1,
+			"devices": []
+	})");
+
+	response = message.cast<GWDeviceListResponse>();
+	CPPUNIT_ASSERT(response->version().empty());
+	CPPUNIT_ASSERT(!response->unchanged());
+}
+
 void GWMessageTest::testParseListen()
 {
 	GWMessage::Ptr message = GWMessage::fromJSON(
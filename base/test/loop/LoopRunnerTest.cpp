@@ -1,6 +1,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <Poco/Event.h>
+#include <Poco/Exception.h>
 #include <Poco/RunnableAdapter.h>
 #include <Poco/Thread.h>
 
@@ -19,12 +20,16 @@ class LoopRunnerTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testAddLoop);
 	CPPUNIT_TEST(testAddRunnable);
 	CPPUNIT_TEST(testAutoStart);
+	CPPUNIT_TEST(testStartParallel);
+	CPPUNIT_TEST(testStartParallelFailure);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testStartNothing();
 	void testAddLoop();
 	void testAddRunnable();
 	void testAutoStart();
+	void testStartParallel();
+	void testStartParallelFailure();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(LoopRunnerTest);
@@ -143,4 +148,103 @@ void LoopRunnerTest::testAutoStart()
 	CPPUNIT_ASSERT(!works->m_works);
 }
 
+/**
+ * Loop that waits in start() until the given number of loops
+ * is being started at the same time.
+ */
+class LoopMeets : public StoppableLoop {
+public:
+	LoopMeets(AtomicCounter &arrived, int expected):
+		m_arrived(arrived),
+		m_expected(expected),
+		m_met(false),
+		m_stopped(false)
+	{
+	}
+
+	void start() override
+	{
+		++m_arrived;
+
+		for (int i = 0; i < 100 && m_arrived.value() < m_expected; ++i)
+			Thread::sleep(10);
+
+		m_met = m_arrived.value() >= m_expected;
+	}
+
+	void stop() override
+	{
+		m_stopped = true;
+	}
+
+	AtomicCounter &m_arrived;
+	const int m_expected;
+	bool m_met;
+	bool m_stopped;
+};
+
+class LoopFails : public StoppableLoop {
+public:
+	void start() override
+	{
+		throw IllegalStateException("cannot start");
+	}
+
+	void stop() override
+	{
+	}
+};
+
+/**
+ * All loops are being started at the same time when
+ * startParallel is enabled.
+ */
+void LoopRunnerTest::testStartParallel()
+{
+	AtomicCounter arrived;
+
+	LoopRunner runner;
+	runner.setStartParallel(true);
+
+	SharedPtr<LoopMeets> first(new LoopMeets(arrived, 3));
+	SharedPtr<LoopMeets> second(new LoopMeets(arrived, 3));
+	SharedPtr<LoopMeets> third(new LoopMeets(arrived, 3));
+
+	runner.addLoop(first);
+	runner.addLoop(second);
+	runner.addLoop(third);
+
+	runner.start();
+
+	CPPUNIT_ASSERT(first->m_met);
+	CPPUNIT_ASSERT(second->m_met);
+	CPPUNIT_ASSERT(third->m_met);
+
+	runner.stop();
+
+	CPPUNIT_ASSERT(first->m_stopped);
+	CPPUNIT_ASSERT(second->m_stopped);
+	CPPUNIT_ASSERT(third->m_stopped);
+}
+
+/**
+ * When a loop fails to start, the others are stopped and
+ * the failure is propagated.
+ */
+void LoopRunnerTest::testStartParallelFailure()
+{
+	AtomicCounter arrived;
+
+	LoopRunner runner;
+	runner.setStartParallel(true);
+
+	SharedPtr<LoopMeets> works(new LoopMeets(arrived, 1));
+
+	runner.addLoop(works);
+	runner.addLoop(new LoopFails);
+
+	CPPUNIT_ASSERT_THROW(runner.start(), IllegalStateException);
+	CPPUNIT_ASSERT(works->m_stopped);
+}
+
 }
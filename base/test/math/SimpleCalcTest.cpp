@@ -20,6 +20,9 @@ class SimpleCalcTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testMissingTerm);
 	CPPUNIT_TEST(testDoubleSign);
 	CPPUNIT_TEST(testGarbage);
+	CPPUNIT_TEST(testVariables);
+	CPPUNIT_TEST(testUnknownVariable);
+	CPPUNIT_TEST(testCompiledCache);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testConstant();
@@ -30,6 +33,9 @@ public:
 	void testMissingTerm();
 	void testDoubleSign();
 	void testGarbage();
+	void testVariables();
+	void testUnknownVariable();
+	void testCompiledCache();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SimpleCalcTest);
@@ -235,4 +241,82 @@ void SimpleCalcTest::testGarbage()
 	);
 }
 
+void SimpleCalcTest::testVariables()
+{
+	SimpleCalc calc({"x", "offset"});
+
+	const auto program = calc.compile("x * 9 / 5 + 32");
+	CPPUNIT_ASSERT_EQUAL(2, program.variables().size());
+	CPPUNIT_ASSERT_EQUAL(32.0, program.evaluate({0, 0}));
+	CPPUNIT_ASSERT_EQUAL(212.0, program.evaluate({100, 0}));
+
+	CPPUNIT_ASSERT_EQUAL(10.5, calc.compile("x+offset").evaluate({10, 0.5}));
+	CPPUNIT_ASSERT_EQUAL(-9.5, calc.compile("offset - x").evaluate({10, 0.5}));
+
+	// values of unreferenced trailing variables are not required
+	CPPUNIT_ASSERT_EQUAL(212.0, program.evaluate({100}));
+	CPPUNIT_ASSERT_EQUAL(5.0, calc.compile("2 + 3").evaluate());
+	CPPUNIT_ASSERT_EQUAL(5.0, calc.evaluate("2 + 3"));
+
+	CPPUNIT_ASSERT_THROW(
+		program.evaluate(),
+		InvalidArgumentException
+	);
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("offset + 1").evaluate({1}),
+		InvalidArgumentException
+	);
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("1 / x").evaluate({0, 0}),
+		IllegalStateException
+	);
+}
+
+void SimpleCalcTest::testUnknownVariable()
+{
+	SimpleCalc calc({"x"});
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("y + 1"),
+		SyntaxException
+	);
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("x1 + 1"),
+		SyntaxException
+	);
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("x# + 1"),
+		SyntaxException
+	);
+
+	CPPUNIT_ASSERT_THROW(
+		calc.compile("x +"),
+		SyntaxException
+	);
+}
+
+void SimpleCalcTest::testCompiledCache()
+{
+	SimpleCalc calc({"x"});
+	SimpleCalc other({"y"});
+
+	const auto program = calc.compiled("x / 10");
+	CPPUNIT_ASSERT(program == calc.compiled("x / 10"));
+	CPPUNIT_ASSERT(program == SimpleCalc({"x"}).compiled("x / 10"));
+	CPPUNIT_ASSERT_EQUAL(2.5, program->evaluate({25}));
+
+	// the same text with different variables is a different program
+	CPPUNIT_ASSERT_THROW(
+		other.compiled("x / 10"),
+		SyntaxException
+	);
+
+	CPPUNIT_ASSERT_EQUAL(2.0, calc.evaluate("20 / 10"));
+	CPPUNIT_ASSERT_EQUAL(2.0, calc.evaluate("20 / 10"));
+}
+
 }
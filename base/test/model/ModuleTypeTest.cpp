@@ -14,6 +14,7 @@ class ModuleTypeTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testParse);
 	CPPUNIT_TEST(testParseInvalidEnum);
 	CPPUNIT_TEST(testParseInvalidBitmap);
+	CPPUNIT_TEST(testParseCached);
 	CPPUNIT_TEST(testInvalidArgumentType);
 	CPPUNIT_TEST(testInvalidArgumentAttribute);
 	CPPUNIT_TEST(testInvalidAttributeDuplication);
@@ -27,6 +28,7 @@ public:
 	void testParse();
 	void testParseInvalidEnum();
 	void testParseInvalidBitmap();
+	void testParseCached();
 	void testInvalidArgumentType();
 	void testInvalidArgumentAttribute();
 	void testInvalidAttributeDuplication();
@@ -127,6 +129,34 @@ void ModuleTypeTest::testParseInvalidBitmap()
 	);
 }
 
+/**
+ * Parsing of the same input repeatedly (served from the cache) must lead
+ * to the same result as the uncached parsing. Invalid inputs must always
+ * fail.
+ */
+void ModuleTypeTest::testParseCached()
+{
+	for (const auto &input : {"temperature,inner", "enum:custom1,outer", "battery"}) {
+		const ModuleType uncached = ModuleType::parseUncached(input);
+
+		for (int i = 0; i < 3; ++i) {
+			const ModuleType cached = ModuleType::parse(input);
+
+			CPPUNIT_ASSERT_EQUAL(uncached.type().toString(), cached.type().toString());
+			CPPUNIT_ASSERT(uncached.attributes() == cached.attributes());
+			CPPUNIT_ASSERT_EQUAL(
+				uncached.customTypeID().toString(),
+				cached.customTypeID().toString());
+		}
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT_THROW(
+			ModuleType::parse("temperature,inner,inner"),
+			InvalidArgumentException);
+	}
+}
+
 void ModuleTypeTest::testInvalidArgumentType()
 {
 	CPPUNIT_ASSERT_THROW(ModuleType::parse("undefined-type,inner"), InvalidArgumentException);
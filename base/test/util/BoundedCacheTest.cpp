@@ -0,0 +1,77 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+
+#include "cppunit/BetterAssert.h"
+#include "util/BoundedCache.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class BoundedCacheTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(BoundedCacheTest);
+	CPPUNIT_TEST(testCached);
+	CPPUNIT_TEST(testLimit);
+	CPPUNIT_TEST(testCreateFails);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testCached();
+	void testLimit();
+	void testCreateFails();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BoundedCacheTest);
+
+/**
+ * The create function is called only once per key.
+ */
+void BoundedCacheTest::testCached()
+{
+	BoundedCache<string, int> cache(4);
+	int calls = 0;
+
+	CPPUNIT_ASSERT_EQUAL(1, cache.get("a", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(1, cache.get("a", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(2, cache.get("b", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(1, cache.get("a", [&]() { return ++calls; }));
+
+	CPPUNIT_ASSERT_EQUAL(2, calls);
+	CPPUNIT_ASSERT_EQUAL(2, cache.size());
+}
+
+/**
+ * When the limit is reached, values of new keys are computed
+ * on every call and not cached.
+ */
+void BoundedCacheTest::testLimit()
+{
+	BoundedCache<string, int> cache(1);
+	int calls = 0;
+
+	CPPUNIT_ASSERT_EQUAL(1, cache.get("a", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(2, cache.get("b", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(3, cache.get("b", [&]() { return ++calls; }));
+	CPPUNIT_ASSERT_EQUAL(1, cache.get("a", [&]() { return ++calls; }));
+
+	CPPUNIT_ASSERT_EQUAL(1, cache.size());
+	CPPUNIT_ASSERT_EQUAL(1, cache.limit());
+}
+
+/**
+ * Failures of the create function are propagated and nothing is cached.
+ */
+void BoundedCacheTest::testCreateFails()
+{
+	BoundedCache<string, int> cache(4);
+
+	CPPUNIT_ASSERT_THROW(
+		cache.get("a", []() -> int { throw SyntaxException("invalid"); }),
+		SyntaxException);
+
+	CPPUNIT_ASSERT_EQUAL(0, cache.size());
+	CPPUNIT_ASSERT_EQUAL(5, cache.get("a", []() { return 5; }));
+}
+
+}
@@ -63,6 +63,9 @@ void EnumTest::testParse()
 	CPPUNIT_ASSERT_EQUAL(TestType::TEST_X3, TestType::parse("x3"));
 
 	CPPUNIT_ASSERT_THROW(TestType::parse("x4"), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(TestType::parse("x"), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(TestType::parse("x00"), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(TestType::parse(""), InvalidArgumentException);
 }
 
 void EnumTest::testFromRaw()
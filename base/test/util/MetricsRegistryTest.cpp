@@ -0,0 +1,168 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+
+#include "cppunit/BetterAssert.h"
+#include "util/MetricsRegistry.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class MetricsRegistryTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(MetricsRegistryTest);
+	CPPUNIT_TEST(testCounterAndGauge);
+	CPPUNIT_TEST(testHistogram);
+	CPPUNIT_TEST(testInvalidHistogram);
+	CPPUNIT_TEST(testIOStats);
+	CPPUNIT_TEST(testSnapshotPrefixAndSum);
+	CPPUNIT_TEST(testScopeRemovesMetrics);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testCounterAndGauge();
+	void testHistogram();
+	void testInvalidHistogram();
+	void testIOStats();
+	void testSnapshotPrefixAndSum();
+	void testScopeRemovesMetrics();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MetricsRegistryTest);
+
+void MetricsRegistryTest::testCounterAndGauge()
+{
+	MetricsRegistry registry;
+
+	auto counter = registry.counter("test.counter");
+	auto gauge = registry.gauge("test.gauge");
+
+	counter->add();
+	counter->add(4);
+	gauge->add(10);
+	gauge->sub(3);
+
+	CPPUNIT_ASSERT_EQUAL(5, counter->value());
+	CPPUNIT_ASSERT_EQUAL(7, gauge->value());
+
+	gauge->set(-2);
+
+	const auto snapshot = registry.snapshot();
+	CPPUNIT_ASSERT_EQUAL(2, snapshot.size());
+	CPPUNIT_ASSERT_EQUAL(5, snapshot.at("test.counter"));
+	CPPUNIT_ASSERT_EQUAL(-2, snapshot.at("test.gauge"));
+}
+
+/**
+ * Bucket bounds are inclusive, values over the last bound
+ * are counted in the overflow bucket.
+ */
+void MetricsRegistryTest::testHistogram()
+{
+	MetricsRegistry registry;
+
+	auto histogram = registry.histogram("latency", {10, 100, 1000});
+
+	histogram->observe(1);
+	histogram->observe(10);
+	histogram->observe(11);
+	histogram->observe(1000);
+	histogram->observe(5000);
+
+	CPPUNIT_ASSERT_EQUAL(2, histogram->bucket(0));
+	CPPUNIT_ASSERT_EQUAL(1, histogram->bucket(1));
+	CPPUNIT_ASSERT_EQUAL(1, histogram->bucket(2));
+	CPPUNIT_ASSERT_EQUAL(1, histogram->bucket(3));
+	CPPUNIT_ASSERT_EQUAL(5, histogram->count());
+	CPPUNIT_ASSERT_EQUAL(6022, histogram->sum());
+
+	const auto snapshot = registry.snapshot();
+	CPPUNIT_ASSERT_EQUAL(6, snapshot.size());
+	CPPUNIT_ASSERT_EQUAL(5, snapshot.at("latency.count"));
+	CPPUNIT_ASSERT_EQUAL(6022, snapshot.at("latency.sum"));
+	CPPUNIT_ASSERT_EQUAL(2, snapshot.at("latency.le_10"));
+	CPPUNIT_ASSERT_EQUAL(1, snapshot.at("latency.le_100"));
+	CPPUNIT_ASSERT_EQUAL(1, snapshot.at("latency.le_1000"));
+	CPPUNIT_ASSERT_EQUAL(1, snapshot.at("latency.inf"));
+}
+
+void MetricsRegistryTest::testInvalidHistogram()
+{
+	CPPUNIT_ASSERT_THROW(
+		HistogramMetric({}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		HistogramMetric({10, 10}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		HistogramMetric({100, 10}),
+		InvalidArgumentException);
+}
+
+void MetricsRegistryTest::testIOStats()
+{
+	MetricsRegistry registry;
+	SharedPtr<IOStats> stats = new IOStats;
+
+	registry.ioStats("io", stats);
+
+	stats->written(10);
+	stats->written(20);
+	stats->read(5);
+	stats->lost(7);
+
+	const auto snapshot = registry.snapshot();
+	CPPUNIT_ASSERT_EQUAL(2, snapshot.at("io.written.pdu"));
+	CPPUNIT_ASSERT_EQUAL(30, snapshot.at("io.written.bytes"));
+	CPPUNIT_ASSERT_EQUAL(1, snapshot.at("io.read.pdu"));
+	CPPUNIT_ASSERT_EQUAL(5, snapshot.at("io.read.bytes"));
+	CPPUNIT_ASSERT_EQUAL(1, snapshot.at("io.lost.pdu"));
+	CPPUNIT_ASSERT_EQUAL(7, snapshot.at("io.lost.bytes"));
+}
+
+/**
+ * Snapshot can be restricted by a prefix. Metrics registered
+ * under the same name are summed together.
+ */
+void MetricsRegistryTest::testSnapshotPrefixAndSum()
+{
+	MetricsRegistry registry;
+
+	registry.counter("exporter.a.shipped")->add(3);
+	registry.counter("exporter.a.shipped")->add(4);
+	registry.counter("exporter.b.shipped")->add(1);
+	registry.counter("poller.polls")->add(2);
+
+	const auto exporters = registry.snapshot("exporter.");
+	CPPUNIT_ASSERT_EQUAL(2, exporters.size());
+	CPPUNIT_ASSERT_EQUAL(7, exporters.at("exporter.a.shipped"));
+	CPPUNIT_ASSERT_EQUAL(1, exporters.at("exporter.b.shipped"));
+
+	const auto all = registry.snapshot();
+	CPPUNIT_ASSERT_EQUAL(3, all.size());
+	CPPUNIT_ASSERT_EQUAL(2, all.at("poller.polls"));
+
+	CPPUNIT_ASSERT(registry.snapshot("none").empty());
+}
+
+void MetricsRegistryTest::testScopeRemovesMetrics()
+{
+	MetricsRegistry registry;
+
+	registry.counter("global");
+
+	{
+		MetricsScope scope(registry);
+		scope.counter("scoped.counter")->add();
+		scope.gauge("scoped.gauge");
+
+		CPPUNIT_ASSERT_EQUAL(3, registry.size());
+	}
+
+	CPPUNIT_ASSERT_EQUAL(1, registry.size());
+	CPPUNIT_ASSERT_EQUAL(1, registry.snapshot().count("global"));
+}
+
+}
@@ -0,0 +1,93 @@
+#include <map>
+#include <string>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "cppunit/BetterAssert.h"
+#include "util/PerfectHashIndex.h"
+
+using namespace std;
+
+namespace BeeeOn {
+
+class PerfectHashIndexTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(PerfectHashIndexTest);
+	CPPUNIT_TEST(testEmpty);
+	CPPUNIT_TEST(testFind);
+	CPPUNIT_TEST(testNotFound);
+	CPPUNIT_TEST(testManyKeys);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testEmpty();
+	void testFind();
+	void testNotFound();
+	void testManyKeys();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PerfectHashIndexTest);
+
+void PerfectHashIndexTest::testEmpty()
+{
+	const PerfectHashIndex<int> index(map<string, int>{});
+
+	CPPUNIT_ASSERT(index.find("") == nullptr);
+	CPPUNIT_ASSERT(index.find("any") == nullptr);
+}
+
+void PerfectHashIndexTest::testFind()
+{
+	const PerfectHashIndex<int> index({
+		{"temperature", 1},
+		{"humidity", 2},
+		{"pressure", 3},
+		{"", 4},
+	});
+
+	CPPUNIT_ASSERT_EQUAL(1, index.maxProbe());
+
+	CPPUNIT_ASSERT(index.find("temperature") != nullptr);
+	CPPUNIT_ASSERT_EQUAL(1, *index.find("temperature"));
+	CPPUNIT_ASSERT(index.find("humidity") != nullptr);
+	CPPUNIT_ASSERT_EQUAL(2, *index.find("humidity"));
+	CPPUNIT_ASSERT(index.find("pressure") != nullptr);
+	CPPUNIT_ASSERT_EQUAL(3, *index.find("pressure"));
+	CPPUNIT_ASSERT(index.find("") != nullptr);
+	CPPUNIT_ASSERT_EQUAL(4, *index.find(""));
+}
+
+void PerfectHashIndexTest::testNotFound()
+{
+	const PerfectHashIndex<int> index({
+		{"temperature", 1},
+		{"humidity", 2},
+	});
+
+	CPPUNIT_ASSERT(index.find("Temperature") == nullptr);
+	CPPUNIT_ASSERT(index.find("temperatur") == nullptr);
+	CPPUNIT_ASSERT(index.find("temperature ") == nullptr);
+	CPPUNIT_ASSERT(index.find("") == nullptr);
+}
+
+/**
+ * Even if no perfect table is found, all keys must be found.
+ */
+void PerfectHashIndexTest::testManyKeys()
+{
+	map<string, int> entries;
+
+	for (int i = 0; i < 500; ++i)
+		entries.emplace("key-" + to_string(i), i);
+
+	const PerfectHashIndex<int> index(entries);
+
+	for (const auto &entry : entries) {
+		const int *value = index.find(entry.first);
+
+		CPPUNIT_ASSERT(value != nullptr);
+		CPPUNIT_ASSERT_EQUAL(entry.second, *value);
+	}
+
+	CPPUNIT_ASSERT(index.find("key-500") == nullptr);
+}
+
+}
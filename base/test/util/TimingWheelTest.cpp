@@ -0,0 +1,134 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+
+#include "cppunit/BetterAssert.h"
+#include "util/TimingWheel.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class TimingWheelTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(TimingWheelTest);
+	CPPUNIT_TEST(testInvalidSetup);
+	CPPUNIT_TEST(testExpireInOrder);
+	CPPUNIT_TEST(testExpireBeyondWheelSize);
+	CPPUNIT_TEST(testScheduleIntoPast);
+	CPPUNIT_TEST(testClear);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testInvalidSetup();
+	void testExpireInOrder();
+	void testExpireBeyondWheelSize();
+	void testScheduleIntoPast();
+	void testClear();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimingWheelTest);
+
+void TimingWheelTest::testInvalidSetup()
+{
+	CPPUNIT_ASSERT_THROW(
+		TimingWheel<int>(0, 8),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		TimingWheel<int>(1 * Timespan::SECONDS, 0),
+		InvalidArgumentException);
+}
+
+/**
+ * Items must never expire before their deadline and must expire
+ * as soon as the wheel is advanced past their deadline.
+ */
+void TimingWheelTest::testExpireInOrder()
+{
+	const Clock start;
+	TimingWheel<int> wheel(100 * Timespan::MILLISECONDS, 8, start);
+	vector<int> expired;
+
+	const auto collect = [&](int item) {
+		expired.emplace_back(item);
+	};
+
+	wheel.schedule(1, 250 * Timespan::MILLISECONDS, start);
+	wheel.schedule(2, 450 * Timespan::MILLISECONDS, start);
+	wheel.schedule(3, 300 * Timespan::MILLISECONDS, start);
+	CPPUNIT_ASSERT_EQUAL(3, wheel.size());
+
+	CPPUNIT_ASSERT_EQUAL(0, wheel.advance(start + 200000, collect));
+	CPPUNIT_ASSERT(expired.empty());
+
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 299000, collect));
+	CPPUNIT_ASSERT_EQUAL(1, expired.size());
+	CPPUNIT_ASSERT_EQUAL(1, expired[0]);
+
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 300000, collect));
+	CPPUNIT_ASSERT_EQUAL(2, expired.size());
+	CPPUNIT_ASSERT_EQUAL(3, expired[1]);
+
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 500000, collect));
+	CPPUNIT_ASSERT_EQUAL(3, expired.size());
+	CPPUNIT_ASSERT_EQUAL(2, expired[2]);
+
+	CPPUNIT_ASSERT(wheel.empty());
+}
+
+/**
+ * Items scheduled further than the wheel covers stay in their slot
+ * for multiple rotations and expire only when reaching the deadline.
+ */
+void TimingWheelTest::testExpireBeyondWheelSize()
+{
+	const Clock start;
+	TimingWheel<int> wheel(100 * Timespan::MILLISECONDS, 4, start);
+	size_t count = 0;
+
+	const auto collect = [&](int) {
+		count += 1;
+	};
+
+	wheel.schedule(1, 1 * Timespan::SECONDS, start);
+	wheel.schedule(2, 100 * Timespan::MILLISECONDS, start);
+
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 500000, collect));
+	CPPUNIT_ASSERT_EQUAL(1, wheel.size());
+
+	CPPUNIT_ASSERT_EQUAL(0, wheel.advance(start + 900000, collect));
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 5000000, collect));
+	CPPUNIT_ASSERT_EQUAL(2, count);
+	CPPUNIT_ASSERT(wheel.empty());
+}
+
+void TimingWheelTest::testScheduleIntoPast()
+{
+	const Clock start;
+	TimingWheel<int> wheel(100 * Timespan::MILLISECONDS, 4, start);
+	size_t count = 0;
+
+	const auto collect = [&](int) {
+		count += 1;
+	};
+
+	CPPUNIT_ASSERT_EQUAL(0, wheel.advance(start + 1000000, collect));
+
+	wheel.schedule(1, -1 * Timespan::SECONDS, start);
+	CPPUNIT_ASSERT_EQUAL(1, wheel.advance(start + 1100000, collect));
+	CPPUNIT_ASSERT_EQUAL(1, count);
+}
+
+void TimingWheelTest::testClear()
+{
+	TimingWheel<int> wheel(100 * Timespan::MILLISECONDS, 4);
+
+	wheel.schedule(1, 1 * Timespan::SECONDS);
+	wheel.schedule(2, 2 * Timespan::SECONDS);
+	CPPUNIT_ASSERT_EQUAL(2, wheel.size());
+
+	wheel.clear();
+	CPPUNIT_ASSERT(wheel.empty());
+}
+
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <Poco/Environment.h>
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/Process.h>
+
+#include "Benchmark.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+static atomic<uint64_t> g_allocations(0);
+
+/*
+ * Replace the global allocation functions to count heap allocations
+ * performed by the benchmarks.
+ */
+
+void *operator new(size_t size)
+{
+	g_allocations.fetch_add(1, memory_order_relaxed);
+
+	void *p = malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw bad_alloc();
+
+	return p;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+	g_allocations.fetch_add(1, memory_order_relaxed);
+	return malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const nothrow_t &tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept
+{
+	free(p);
+}
+
+BenchmarkContext::BenchmarkContext(size_t iterations):
+	m_iterations(iterations),
+	m_elapsed(0),
+	m_allocationsStart(0),
+	m_allocations(0),
+	m_paused(false)
+{
+}
+
+size_t BenchmarkContext::iterations() const
+{
+	return m_iterations;
+}
+
+void BenchmarkContext::pauseTiming()
+{
+	if (m_paused)
+		return;
+
+	m_elapsed += m_start.elapsed();
+	m_allocations += Benchmark::allocations() - m_allocationsStart;
+	m_paused = true;
+}
+
+void BenchmarkContext::resumeTiming()
+{
+	if (!m_paused)
+		return;
+
+	m_allocationsStart = Benchmark::allocations();
+	m_start.update();
+	m_paused = false;
+}
+
+Timespan BenchmarkContext::elapsed() const
+{
+	if (m_paused)
+		return m_elapsed;
+
+	return m_elapsed + m_start.elapsed();
+}
+
+uint64_t BenchmarkContext::allocations() const
+{
+	if (m_paused)
+		return m_allocations;
+
+	return m_allocations + Benchmark::allocations() - m_allocationsStart;
+}
+
+Benchmark::Benchmark(const string &name, const Body &body):
+	m_name(name),
+	m_body(body)
+{
+}
+
+string Benchmark::name() const
+{
+	return m_name;
+}
+
+Timespan Benchmark::run(size_t iterations) const
+{
+	uint64_t allocations;
+	return run(iterations, allocations);
+}
+
+Timespan Benchmark::run(size_t iterations, uint64_t &allocations) const
+{
+	BenchmarkContext context(iterations);
+
+	context.resumeTiming();
+	m_body(context);
+	context.pauseTiming();
+
+	allocations = context.allocations();
+	return context.elapsed();
+}
+
+vector<Benchmark> &Benchmark::registry()
+{
+	static vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+uint64_t Benchmark::allocations()
+{
+	return g_allocations.load(memory_order_relaxed);
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(
+		const string &name,
+		const Benchmark::Body &body)
+{
+	Benchmark::registry().emplace_back(name, body);
+}
+
+BenchmarkDir::BenchmarkDir(const string &name)
+{
+	string root = Environment::get("BENCH_TMPDIR", "");
+
+	if (root.empty())
+		root = File("/dev/shm").exists() ? "/dev/shm" : Path::temp();
+
+	static unsigned int counter = 0;
+
+	m_path = Path::forDirectory(root);
+	m_path.pushDirectory(
+		"beeeon-bench-" + name + "-"
+		+ to_string(Process::id()) + "-"
+		+ to_string(counter++));
+
+	File(m_path).createDirectories();
+}
+
+BenchmarkDir::~BenchmarkDir()
+{
+	try {
+		File(m_path).remove(true);
+	}
+	catch (...) {
+	}
+}
+
+const Path &BenchmarkDir::path() const
+{
+	return m_path;
+}
+
+BenchmarkRunner::BenchmarkRunner():
+	m_minTime(200 * Timespan::MILLISECONDS),
+	m_repeat(5)
+{
+}
+
+void BenchmarkRunner::setMinTime(const Timespan &time)
+{
+	if (time <= 0)
+		throw InvalidArgumentException("minTime must be positive");
+
+	m_minTime = time;
+}
+
+void BenchmarkRunner::setRepeat(size_t repeat)
+{
+	if (repeat == 0)
+		throw InvalidArgumentException("repeat must be at least 1");
+
+	m_repeat = repeat;
+}
+
+void BenchmarkRunner::setFilter(const string &filter)
+{
+	m_filter = filter;
+}
+
+size_t BenchmarkRunner::calibrate(const Benchmark &benchmark) const
+{
+	size_t iterations = 1;
+
+	while (true) {
+		const Timespan elapsed = benchmark.run(iterations);
+		if (elapsed >= m_minTime)
+			break;
+
+		size_t next = iterations * 10;
+
+		if (elapsed.totalMicroseconds() > 0) {
+			const double estimate = 1.2 * iterations
+				* m_minTime.totalMicroseconds()
+				/ elapsed.totalMicroseconds();
+
+			next = min<size_t>(next, estimate);
+		}
+
+		iterations = max(next, iterations + 1);
+	}
+
+	return iterations;
+}
+
+BenchmarkResult BenchmarkRunner::measure(const Benchmark &benchmark) const
+{
+	const size_t iterations = calibrate(benchmark);
+	vector<double> nsPerOp;
+	uint64_t allocations = 0;
+
+	for (size_t i = 0; i < m_repeat; ++i) {
+		uint64_t runAllocations;
+
+		const Timespan elapsed = benchmark.run(iterations, runAllocations);
+		nsPerOp.emplace_back(1000.0 * elapsed.totalMicroseconds() / iterations);
+		allocations += runAllocations;
+	}
+
+	sort(nsPerOp.begin(), nsPerOp.end());
+
+	return {
+		benchmark.name(),
+		iterations,
+		m_repeat,
+		nsPerOp.front(),
+		nsPerOp[nsPerOp.size() / 2],
+		nsPerOp.back(),
+		double(allocations) / (m_repeat * iterations),
+	};
+}
+
+vector<BenchmarkResult> BenchmarkRunner::run(
+		const vector<Benchmark> &benchmarks) const
+{
+	vector<BenchmarkResult> results;
+
+	for (const auto &benchmark : benchmarks) {
+		if (benchmark.name().find(m_filter) == string::npos)
+			continue;
+
+		results.emplace_back(measure(benchmark));
+	}
+
+	return results;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Path.h>
+#include <Poco/Timespan.h>
+
+namespace BeeeOn {
+
+/**
+ * @brief BenchmarkContext is passed to each benchmark body. The body
+ * is expected to execute the measured operation iterations() times.
+ * Any expensive preparation that should not be measured can be
+ * surrounded by pauseTiming() and resumeTiming().
+ */
+class BenchmarkContext {
+public:
+	BenchmarkContext(size_t iterations);
+
+	size_t iterations() const;
+
+	void pauseTiming();
+	void resumeTiming();
+
+	/**
+	 * @returns time spent in the benchmark body excluding
+	 * the paused periods
+	 */
+	Poco::Timespan elapsed() const;
+
+	/**
+	 * @returns count of heap allocations performed in the benchmark
+	 * body excluding the paused periods
+	 */
+	uint64_t allocations() const;
+
+private:
+	size_t m_iterations;
+	Poco::Clock m_start;
+	Poco::Clock::ClockDiff m_elapsed;
+	uint64_t m_allocationsStart;
+	uint64_t m_allocations;
+	bool m_paused;
+};
+
+/**
+ * @brief Benchmark represents a single named microbenchmark.
+ * Benchmarks are registered statically via the BEEEON_BENCHMARK
+ * macro and executed by the BenchmarkRunner.
+ */
+class Benchmark {
+public:
+	typedef std::function<void(BenchmarkContext &)> Body;
+
+	Benchmark(const std::string &name, const Body &body);
+
+	std::string name() const;
+
+	/**
+	 * @brief Execute the benchmark body with the given
+	 * number of iterations.
+	 *
+	 * @returns the measured elapsed time
+	 */
+	Poco::Timespan run(size_t iterations) const;
+
+	/**
+	 * @brief Execute the benchmark body with the given number
+	 * of iterations and count the heap allocations it performs.
+	 */
+	Poco::Timespan run(size_t iterations, uint64_t &allocations) const;
+
+	/**
+	 * @brief Prevent the compiler from optimizing out computation
+	 * of the given value.
+	 */
+	template <typename T>
+	static void keep(const T &value)
+	{
+		__asm__ __volatile__("" : : "g"(&value) : "memory");
+	}
+
+	static std::vector<Benchmark> &registry();
+
+	/**
+	 * @returns count of heap allocations (via operator new) performed
+	 * by the process so far
+	 */
+	static uint64_t allocations();
+
+private:
+	std::string m_name;
+	Body m_body;
+};
+
+/**
+ * @brief Helper for static registration of benchmarks.
+ */
+class BenchmarkRegistrar {
+public:
+	BenchmarkRegistrar(const std::string &name, const Benchmark::Body &body);
+};
+
+/**
+ * @brief BenchmarkDir creates a unique empty directory for benchmarks
+ * that operate on a filesystem and removes it on destruction. The
+ * directory is created inside of $BENCH_TMPDIR or inside of /dev/shm
+ * (tmpfs) when available to avoid measuring of a physical storage.
+ */
+class BenchmarkDir {
+public:
+	BenchmarkDir(const std::string &name);
+	~BenchmarkDir();
+
+	const Poco::Path &path() const;
+
+private:
+	Poco::Path m_path;
+};
+
+/**
+ * @brief Result of a single benchmark execution.
+ */
+struct BenchmarkResult {
+	std::string name;
+	size_t iterations;
+	size_t repeats;
+	double minNsPerOp;
+	double medianNsPerOp;
+	double maxNsPerOp;
+	double allocsPerOp;
+};
+
+/**
+ * @brief BenchmarkRunner executes benchmarks. For each benchmark,
+ * the number of iterations is calibrated to make a single run last
+ * at least minTime. Then, the benchmark is executed repeat times
+ * and the min, median and max times per operation are recorded
+ * together with the average count of heap allocations per operation.
+ */
+class BenchmarkRunner {
+public:
+	BenchmarkRunner();
+
+	void setMinTime(const Poco::Timespan &time);
+	void setRepeat(size_t repeat);
+
+	/**
+	 * @brief Run only benchmarks whose name contains the filter.
+	 */
+	void setFilter(const std::string &filter);
+
+	std::vector<BenchmarkResult> run(
+		const std::vector<Benchmark> &benchmarks) const;
+
+protected:
+	size_t calibrate(const Benchmark &benchmark) const;
+	BenchmarkResult measure(const Benchmark &benchmark) const;
+
+private:
+	Poco::Timespan m_minTime;
+	size_t m_repeat;
+	std::string m_filter;
+};
+
+}
+
+#define BEEEON_BENCHMARK(group, name)                                   \
+	static void group##_##name##_bench(BeeeOn::BenchmarkContext &); \
+	static BeeeOn::BenchmarkRegistrar                               \
+		group##_##name##_registrar(                             \
+			#group "::" #name, &group##_##name##_bench);    \
+	static void group##_##name##_bench(BeeeOn::BenchmarkContext &context)
@@ -0,0 +1,148 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/Environment.h>
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+#include <Poco/NumberParser.h>
+#include <Poco/Timestamp.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+
+#include "Benchmark.h"
+
+using namespace std;
+using namespace Poco;
+using namespace Poco::JSON;
+using namespace BeeeOn;
+
+static void printHuman(const vector<BenchmarkResult> &results, ostream &out)
+{
+	for (const auto &result : results) {
+		out << left << setw(56) << result.name
+			<< right << fixed << setprecision(1)
+			<< setw(14) << result.medianNsPerOp << " ns/op"
+			<< " (min " << result.minNsPerOp
+			<< ", max " << result.maxNsPerOp
+			<< ", " << result.iterations << " iterations)"
+			<< setprecision(2)
+			<< " " << result.allocsPerOp << " allocs/op"
+			<< endl;
+	}
+}
+
+/**
+ * Print results as CSV with a header line. The benchmark names
+ * never contain the separator.
+ */
+static void printCSV(const vector<BenchmarkResult> &results, ostream &out)
+{
+	out << "name,iterations,repeats,min_ns_per_op,median_ns_per_op,max_ns_per_op,"
+		<< "allocs_per_op" << endl;
+
+	for (const auto &result : results) {
+		out << result.name
+			<< "," << result.iterations
+			<< "," << result.repeats
+			<< fixed << setprecision(3)
+			<< "," << result.minNsPerOp
+			<< "," << result.medianNsPerOp
+			<< "," << result.maxNsPerOp
+			<< "," << result.allocsPerOp
+			<< endl;
+	}
+}
+
+/**
+ * Print results as a JSON document together with information
+ * about the run so that results of different runs can be compared.
+ */
+static void printJSON(
+		const vector<BenchmarkResult> &results,
+		const Timespan &minTime,
+		size_t repeat,
+		ostream &out)
+{
+	Object::Ptr context = new Object;
+	context->set("date", DateTimeFormatter::format(
+		Timestamp(), DateTimeFormat::ISO8601_FORMAT));
+	context->set("host", Environment::nodeName());
+	context->set("os", Environment::osName() + " " + Environment::osVersion());
+	context->set("arch", Environment::osArchitecture());
+	context->set("cpus", Environment::processorCount());
+	context->set("min_time_ms", minTime.totalMilliseconds());
+	context->set("repeat", repeat);
+
+	Array::Ptr benchmarks = new Array;
+
+	for (const auto &result : results) {
+		Object::Ptr entry = new Object;
+		entry->set("name", result.name);
+		entry->set("iterations", result.iterations);
+		entry->set("repeats", result.repeats);
+		entry->set("min_ns_per_op", result.minNsPerOp);
+		entry->set("median_ns_per_op", result.medianNsPerOp);
+		entry->set("max_ns_per_op", result.maxNsPerOp);
+		entry->set("allocs_per_op", result.allocsPerOp);
+
+		benchmarks->add(entry);
+	}
+
+	Object::Ptr root = new Object;
+	root->set("context", context);
+	root->set("benchmarks", benchmarks);
+
+	root->stringify(out, 2);
+	out << endl;
+}
+
+int main()
+{
+	Logger::setLevel("", Logger::parseLevel(
+		Environment::get("BENCH_LOG_LEVEL", "error")));
+
+	BenchmarkRunner runner;
+
+	const Timespan minTime = NumberParser::parseUnsigned(
+		Environment::get("BENCH_MIN_TIME_MS", "200")) * Timespan::MILLISECONDS;
+	const size_t repeat = NumberParser::parseUnsigned(
+		Environment::get("BENCH_REPEAT", "5"));
+
+	runner.setMinTime(minTime);
+	runner.setRepeat(repeat);
+	runner.setFilter(Environment::get("BENCH_FILTER", ""));
+
+	const string format = Environment::get("BENCH_FORMAT", "human");
+	const string output = Environment::get("BENCH_OUTPUT", "");
+
+	if (format != "human" && format != "csv" && format != "json") {
+		cerr << "unsupported BENCH_FORMAT: " << format << endl;
+		return 1;
+	}
+
+	ofstream file;
+
+	if (!output.empty()) {
+		file.open(output);
+
+		if (!file) {
+			cerr << "failed to open " << output << endl;
+			return 1;
+		}
+	}
+
+	ostream &out = output.empty() ? cout : file;
+	const auto results = runner.run(Benchmark::registry());
+
+	if (format == "csv")
+		printCSV(results, out);
+	else if (format == "json")
+		printJSON(results, minTime, repeat, out);
+	else
+		printHuman(results, out);
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <Poco/Thread.h>
+
+#include "Benchmark.h"
+#include "commands/GatewayListenCommand.h"
+#include "core/AnswerQueue.h"
+#include "core/AsyncCommandDispatcher.h"
+#include "core/CommandHandler.h"
+#include "core/Result.h"
+#include "util/ParallelExecutor.h"
+
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * Dispatching of commands from the remote server and the TestingCenter
+ * to the registered handlers (usually device managers).
+ */
+
+class AcceptingCommandHandler : public CommandHandler {
+public:
+	AcceptingCommandHandler(bool accepting):
+		m_accepting(accepting)
+	{
+	}
+
+	bool accept(const Command::Ptr) override
+	{
+		return m_accepting;
+	}
+
+	void handle(Command::Ptr, Answer::Ptr answer) override
+	{
+		Result::Ptr result = new Result(answer);
+		result->setStatus(Result::Status::SUCCESS);
+	}
+
+private:
+	bool m_accepting;
+};
+
+static void dispatchAndWait(
+		BenchmarkContext &context,
+		size_t accepting,
+		size_t nonAccepting)
+{
+	context.pauseTiming();
+
+	ParallelExecutor::Ptr executor = new ParallelExecutor;
+	Thread thread;
+	thread.start(*executor);
+
+	AsyncCommandDispatcher dispatcher;
+	dispatcher.setCommandsExecutor(executor);
+
+	for (size_t i = 0; i < nonAccepting; ++i)
+		dispatcher.registerHandler(new AcceptingCommandHandler(false));
+
+	for (size_t i = 0; i < accepting; ++i)
+		dispatcher.registerHandler(new AcceptingCommandHandler(true));
+
+	AnswerQueue queue;
+	const Command::Ptr cmd = new GatewayListenCommand(5 * Timespan::SECONDS);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		Answer::Ptr answer = new Answer(queue);
+
+		dispatcher.dispatch(cmd, answer);
+		answer->waitNotPending(5 * Timespan::SECONDS);
+
+		queue.remove(answer);
+	}
+
+	context.pauseTiming();
+
+	executor->stop();
+	thread.join();
+}
+
+BEEEON_BENCHMARK(AsyncCommandDispatcher, dispatchNoHandler)
+{
+	dispatchAndWait(context, 0, 16);
+}
+
+BEEEON_BENCHMARK(AsyncCommandDispatcher, dispatch1Handler)
+{
+	dispatchAndWait(context, 1, 15);
+}
+
+BEEEON_BENCHMARK(AsyncCommandDispatcher, dispatch4Handlers)
+{
+	dispatchAndWait(context, 4, 12);
+}
@@ -0,0 +1,113 @@
+#include <vector>
+
+#include <Poco/Timestamp.h>
+
+#include "Benchmark.h"
+#include "exporters/JournalQueuingStrategy.h"
+#include "model/SensorData.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * JournalQueuingStrategy persists data that cannot be exported
+ * immediately. The benchmarks are executed on tmpfs (if available)
+ * to measure the strategy itself instead of the storage.
+ */
+
+static vector<SensorData> makeBatch(size_t seq, size_t count)
+{
+	vector<SensorData> batch;
+
+	for (size_t i = 0; i < count; ++i) {
+		batch.emplace_back(
+			DeviceID(0xa300000000000000 | i),
+			Timestamp(),
+			vector<SensorValue>{
+				SensorValue(ModuleID(0), seq),
+				SensorValue(ModuleID(1), 45.0),
+			});
+	}
+
+	return batch;
+}
+
+BEEEON_BENCHMARK(JournalQueuingStrategy, push8)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal-strategy");
+	JournalQueuingStrategy strategy;
+	strategy.setRootDir(dir.path().toString());
+	strategy.setup();
+
+	vector<vector<SensorData>> batches;
+	for (size_t i = 0; i < context.iterations(); ++i)
+		batches.emplace_back(makeBatch(i, 8));
+
+	context.resumeTiming();
+
+	for (const auto &batch : batches)
+		strategy.push(batch);
+
+	context.pauseTiming();
+}
+
+BEEEON_BENCHMARK(JournalQueuingStrategy, pushPeekPop8)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal-strategy");
+	JournalQueuingStrategy strategy;
+	strategy.setRootDir(dir.path().toString());
+	strategy.setup();
+
+	vector<vector<SensorData>> batches;
+	for (size_t i = 0; i < context.iterations(); ++i)
+		batches.emplace_back(makeBatch(i, 8));
+
+	vector<SensorData> peeked;
+	peeked.reserve(8);
+
+	context.resumeTiming();
+
+	for (const auto &batch : batches) {
+		strategy.push(batch);
+
+		peeked.clear();
+		const size_t count = strategy.peek(peeked, batch.size());
+		strategy.pop(count);
+	}
+
+	context.pauseTiming();
+}
+
+/**
+ * Drain a backlog of queued data as the GWServerConnector does after
+ * a connection to the remote server is reestablished.
+ */
+BEEEON_BENCHMARK(JournalQueuingStrategy, drainBacklog)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal-strategy");
+	JournalQueuingStrategy strategy;
+	strategy.setRootDir(dir.path().toString());
+	strategy.setup();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		strategy.push(makeBatch(i, 8));
+
+	vector<SensorData> peeked;
+
+	context.resumeTiming();
+
+	while (!strategy.empty()) {
+		peeked.clear();
+		const size_t count = strategy.peek(peeked, 8);
+		strategy.pop(count);
+	}
+
+	context.pauseTiming();
+}
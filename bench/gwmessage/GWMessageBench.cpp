@@ -0,0 +1,103 @@
+#include <vector>
+
+#include <Poco/Timestamp.h>
+
+#include "Benchmark.h"
+#include "gwmessage/GWMessage.h"
+#include "gwmessage/GWSensorDataExport.h"
+#include "model/GlobalID.h"
+#include "model/SensorData.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * Serialization and parsing of messages exchanged with the remote
+ * server. The GWSensorDataExport is the most frequent message.
+ */
+
+static vector<SensorData> makeBatch(size_t count)
+{
+	vector<SensorData> batch;
+
+	for (size_t i = 0; i < count; ++i) {
+		batch.emplace_back(
+			DeviceID(0xa300000000000000 | i),
+			Timestamp(),
+			vector<SensorValue>{
+				SensorValue(ModuleID(0), 21.5),
+				SensorValue(ModuleID(1), 45.0),
+			});
+	}
+
+	return batch;
+}
+
+static string makeExportJSON(size_t count)
+{
+	GWSensorDataExport message;
+	message.setID(GlobalID::random());
+	message.setData(makeBatch(count));
+
+	return message.toString();
+}
+
+BEEEON_BENCHMARK(GWSensorDataExport, toString1)
+{
+	GWSensorDataExport message;
+	message.setID(GlobalID::random());
+	message.setData(makeBatch(1));
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(message.toString());
+}
+
+BEEEON_BENCHMARK(GWSensorDataExport, toString32)
+{
+	GWSensorDataExport message;
+	message.setID(GlobalID::random());
+	message.setData(makeBatch(32));
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(message.toString());
+}
+
+BEEEON_BENCHMARK(GWSensorDataExport, setDataAndToString32)
+{
+	const auto batch = makeBatch(32);
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		GWSensorDataExport message;
+		message.setID(GlobalID::random());
+		message.setData(batch);
+
+		Benchmark::keep(message.toString());
+	}
+}
+
+BEEEON_BENCHMARK(GWMessage, fromJSONSensorDataExport1)
+{
+	const string json = makeExportJSON(1);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(GWMessage::fromJSON(json));
+}
+
+BEEEON_BENCHMARK(GWMessage, fromJSONSensorDataExport32)
+{
+	const string json = makeExportJSON(32);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(GWMessage::fromJSON(json));
+}
+
+BEEEON_BENCHMARK(GWMessage, fromJSONSensorDataConfirm)
+{
+	GWSensorDataExport message;
+	message.setID(GlobalID::random());
+	const string json = message.confirm()->toString();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(GWMessage::fromJSON(json));
+}
@@ -0,0 +1,84 @@
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "math/LogicalExpression.h"
+#include "math/SimpleCalc.h"
+
+using namespace std;
+using namespace BeeeOn;
+
+/**
+ * Typical conversion formulas of raw sensor values. The Interpreted
+ * benchmarks parse the expression on every evaluation as SimpleCalc
+ * used to do. The Compiled benchmarks evaluate a prepared program,
+ * the Cached benchmarks look it up by text first.
+ */
+
+static const vector<string> FORMULAS = {
+	"x * 9 / 5 + 32",
+	"x - 273.15",
+	"x / 10",
+	"x * 100 / 1023",
+	"x * 0.0625 - 40",
+};
+
+BEEEON_BENCHMARK(SimpleCalc, evaluateInterpreted)
+{
+	const SimpleCalc calc({"x"});
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const auto &formula = FORMULAS[i % FORMULAS.size()];
+		Benchmark::keep(calc.compile(formula).evaluate({double(i)}));
+	}
+}
+
+BEEEON_BENCHMARK(SimpleCalc, evaluateCompiled)
+{
+	context.pauseTiming();
+
+	const SimpleCalc calc({"x"});
+	vector<SimpleCalc::Program> programs;
+
+	for (const auto &formula : FORMULAS)
+		programs.emplace_back(calc.compile(formula));
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const auto &program = programs[i % programs.size()];
+		Benchmark::keep(program.evaluate({double(i)}));
+	}
+}
+
+BEEEON_BENCHMARK(SimpleCalc, evaluateCached)
+{
+	const SimpleCalc calc({"x"});
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const auto &formula = FORMULAS[i % FORMULAS.size()];
+		Benchmark::keep(calc.compiled(formula)->evaluate({double(i)}));
+	}
+}
+
+static const vector<string> CONDITIONS = {
+	"yes == yes",
+	"enabled != disabled",
+	"zwave == bluetooth",
+};
+
+BEEEON_BENCHMARK(LogicalExpression, parseUncached)
+{
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const auto &condition = CONDITIONS[i % CONDITIONS.size()];
+		Benchmark::keep(LogicalExpression::parseUncached(condition).result());
+	}
+}
+
+BEEEON_BENCHMARK(LogicalExpression, parseCached)
+{
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const auto &condition = CONDITIONS[i % CONDITIONS.size()];
+		Benchmark::keep(LogicalExpression::parse(condition).result());
+	}
+}
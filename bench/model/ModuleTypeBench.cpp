@@ -0,0 +1,97 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "model/DevicePrefix.h"
+#include "model/ModuleType.h"
+
+using namespace std;
+using namespace BeeeOn;
+
+/**
+ * Enum names and ModuleType strings are parsed for every inbound
+ * server message and every lookup of a type mapping. The *Map
+ * benchmarks search a std::map of names as Enum::parse used to do
+ * and serve as a baseline for the perfect hash lookups.
+ */
+
+template <typename T>
+static vector<string> enumNames()
+{
+	vector<string> names;
+
+	for (const auto &value : T::all())
+		names.emplace_back(value.toString());
+
+	return names;
+}
+
+template <typename T>
+static map<string, typename T::Raw> enumNamesMap()
+{
+	map<string, typename T::Raw> namesMap;
+
+	for (const auto &value : T::all())
+		namesMap.emplace(value.toString(), value.raw());
+
+	return namesMap;
+}
+
+BEEEON_BENCHMARK(Enum, parseModuleTypeTypeMap)
+{
+	const auto names = enumNames<ModuleType::Type>();
+	const auto namesMap = enumNamesMap<ModuleType::Type>();
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		auto it = namesMap.find(names[i % names.size()]);
+		Benchmark::keep(it->second);
+	}
+}
+
+BEEEON_BENCHMARK(Enum, parseModuleTypeType)
+{
+	const auto names = enumNames<ModuleType::Type>();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(ModuleType::Type::parse(names[i % names.size()]));
+}
+
+BEEEON_BENCHMARK(Enum, parseDevicePrefixMap)
+{
+	const auto names = enumNames<DevicePrefix>();
+	const auto namesMap = enumNamesMap<DevicePrefix>();
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		auto it = namesMap.find(names[i % names.size()]);
+		Benchmark::keep(it->second);
+	}
+}
+
+BEEEON_BENCHMARK(Enum, parseDevicePrefix)
+{
+	const auto names = enumNames<DevicePrefix>();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(DevicePrefix::parse(names[i % names.size()]));
+}
+
+static const vector<string> MODULE_TYPES = {
+	"temperature,inner",
+	"humidity,outer",
+	"enum:OPEN_CLOSE",
+	"on_off,controllable",
+	"battery",
+};
+
+BEEEON_BENCHMARK(ModuleType, parseUncached)
+{
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(ModuleType::parseUncached(MODULE_TYPES[i % MODULE_TYPES.size()]));
+}
+
+BEEEON_BENCHMARK(ModuleType, parseCached)
+{
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(ModuleType::parse(MODULE_TYPES[i % MODULE_TYPES.size()]));
+}
@@ -0,0 +1,81 @@
+#include <vector>
+
+#include <Poco/Timestamp.h>
+
+#include "Benchmark.h"
+#include "model/SensorData.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * SensorData are created and copied for each exported measurement
+ * (distributor, exporter queues, persistent strategies).
+ */
+
+static SensorData makeSensorData(size_t count)
+{
+	SensorData data(DeviceID(0xa300000000000001), Timestamp(), {});
+
+	for (size_t i = 0; i < count; ++i)
+		data.insertValue(SensorValue(ModuleID(i), 21.5 + i));
+
+	return data;
+}
+
+BEEEON_BENCHMARK(SensorData, create1)
+{
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(makeSensorData(1));
+}
+
+BEEEON_BENCHMARK(SensorData, create8)
+{
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(makeSensorData(8));
+}
+
+BEEEON_BENCHMARK(SensorData, createWithValues8)
+{
+	const Timestamp now;
+	vector<SensorValue> values;
+
+	for (size_t i = 0; i < 8; ++i)
+		values.emplace_back(ModuleID(i), 21.5 + i);
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const SensorData data(DeviceID(0xa300000000000001), now, values);
+		Benchmark::keep(data);
+	}
+}
+
+BEEEON_BENCHMARK(SensorData, copy1)
+{
+	const SensorData data = makeSensorData(1);
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const SensorData copy(data);
+		Benchmark::keep(copy);
+	}
+}
+
+BEEEON_BENCHMARK(SensorData, copy8)
+{
+	const SensorData data = makeSensorData(8);
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const SensorData copy(data);
+		Benchmark::keep(copy);
+	}
+}
+
+BEEEON_BENCHMARK(SensorData, copyVector32x8)
+{
+	const vector<SensorData> batch(32, makeSensorData(8));
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const vector<SensorData> copy(batch);
+		Benchmark::keep(copy);
+	}
+}
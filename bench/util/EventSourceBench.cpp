@@ -0,0 +1,63 @@
+#include <Poco/SharedPtr.h>
+
+#include "Benchmark.h"
+#include "util/EventSource.h"
+#include "util/NonAsyncExecutor.h"
+
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * EventSource delivers events (e.g. exported SensorData, dispatched
+ * commands) to the registered listeners. The NonAsyncExecutor is used
+ * to measure the fan-out itself without the thread hand-over.
+ */
+
+class CountingListener {
+public:
+	typedef SharedPtr<CountingListener> Ptr;
+
+	void onEvent(const int &value)
+	{
+		m_sum += value;
+	}
+
+	size_t sum() const
+	{
+		return m_sum;
+	}
+
+private:
+	size_t m_sum = 0;
+};
+
+static void fanOut(BenchmarkContext &context, size_t listeners)
+{
+	context.pauseTiming();
+
+	EventSource<CountingListener> source;
+	source.setAsyncExecutor(new NonAsyncExecutor);
+
+	for (size_t i = 0; i < listeners; ++i)
+		source.addListener(new CountingListener);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		source.fireEvent(int(i), &CountingListener::onEvent);
+}
+
+BEEEON_BENCHMARK(EventSource, fanOut1)
+{
+	fanOut(context, 1);
+}
+
+BEEEON_BENCHMARK(EventSource, fanOut8)
+{
+	fanOut(context, 8);
+}
+
+BEEEON_BENCHMARK(EventSource, fanOut64)
+{
+	fanOut(context, 64);
+}
@@ -0,0 +1,85 @@
+#include <Poco/Path.h>
+
+#include "Benchmark.h"
+#include "util/Journal.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * Journal is used as an index of the JournalQueuingStrategy. Each
+ * push and pop of the strategy results in an append.
+ */
+
+static void prepareJournal(Journal &journal, size_t keys)
+{
+	journal.createEmpty();
+	journal.load();
+
+	for (size_t i = 0; i < keys; ++i)
+		journal.append("key" + to_string(i), "0", false);
+
+	journal.flush();
+}
+
+BEEEON_BENCHMARK(Journal, appendFlush)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal");
+	Journal journal(Path(dir.path(), "index"));
+	prepareJournal(journal, 16);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		journal.append("key" + to_string(i % 16), to_string(i));
+
+	context.pauseTiming();
+}
+
+BEEEON_BENCHMARK(Journal, appendNoFlush)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal");
+	Journal journal(Path(dir.path(), "index"));
+	prepareJournal(journal, 16);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		journal.append("key" + to_string(i % 16), to_string(i), false);
+
+	journal.flush();
+	context.pauseTiming();
+}
+
+BEEEON_BENCHMARK(Journal, lookup16)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal");
+	Journal journal(Path(dir.path(), "index"));
+	prepareJournal(journal, 16);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(journal["key" + to_string(i % 16)]);
+}
+
+BEEEON_BENCHMARK(Journal, lookup1024)
+{
+	context.pauseTiming();
+
+	BenchmarkDir dir("journal");
+	Journal journal(Path(dir.path(), "index"));
+	prepareJournal(journal, 1024);
+
+	context.resumeTiming();
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(journal["key" + to_string(i % 1024)]);
+}
@@ -0,0 +1,113 @@
+#include <string>
+
+#include <Poco/Timestamp.h>
+
+#include "Benchmark.h"
+#include "model/SensorData.h"
+#include "util/CSVSensorDataFormatter.h"
+#include "util/ChecksumSensorDataFormatter.h"
+#include "util/JSONSensorDataFormatter.h"
+
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * Formatters are called for each exported SensorData by the
+ * NamedPipeExporter and the MqttExporter. The format* benchmarks
+ * use the string API, the formatTo* benchmarks append into a reused
+ * buffer and should report (almost) no allocations per record.
+ */
+
+static SensorData makeSensorData(size_t count)
+{
+	SensorData data(DeviceID(0xa300000000000001), Timestamp(), {});
+
+	for (size_t i = 0; i < count; ++i)
+		data.insertValue(SensorValue(ModuleID(i), 21.5 + i));
+
+	return data;
+}
+
+BEEEON_BENCHMARK(JSONSensorDataFormatter, format1)
+{
+	JSONSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(1);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(formatter.format(data));
+}
+
+BEEEON_BENCHMARK(JSONSensorDataFormatter, format8)
+{
+	JSONSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(8);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(formatter.format(data));
+}
+
+BEEEON_BENCHMARK(CSVSensorDataFormatter, format1)
+{
+	CSVSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(1);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(formatter.format(data));
+}
+
+BEEEON_BENCHMARK(CSVSensorDataFormatter, format8)
+{
+	CSVSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(8);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(formatter.format(data));
+}
+
+BEEEON_BENCHMARK(JSONSensorDataFormatter, formatTo8)
+{
+	JSONSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(8);
+	std::string buffer;
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		buffer.clear();
+		formatter.formatTo(data, buffer);
+		Benchmark::keep(buffer);
+	}
+}
+
+BEEEON_BENCHMARK(CSVSensorDataFormatter, formatTo8)
+{
+	CSVSensorDataFormatter formatter;
+	const SensorData data = makeSensorData(8);
+	std::string buffer;
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		buffer.clear();
+		formatter.formatTo(data, buffer);
+		Benchmark::keep(buffer);
+	}
+}
+
+BEEEON_BENCHMARK(ChecksumSensorDataFormatter, format8)
+{
+	ChecksumSensorDataFormatter formatter(new JSONSensorDataFormatter);
+	const SensorData data = makeSensorData(8);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(formatter.format(data));
+}
+
+BEEEON_BENCHMARK(ChecksumSensorDataFormatter, formatTo8)
+{
+	ChecksumSensorDataFormatter formatter(new JSONSensorDataFormatter);
+	const SensorData data = makeSensorData(8);
+	std::string buffer;
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		buffer.clear();
+		formatter.formatTo(data, buffer);
+		Benchmark::keep(buffer);
+	}
+}
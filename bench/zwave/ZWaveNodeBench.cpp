@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "zwave/ZWaveNode.h"
+
+using namespace BeeeOn;
+
+/**
+ * Compare conversions of ZWaveNode::Value as received from OZW
+ * formerly (always string) and now (natively typed).
+ */
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asDoubleFromString)
+{
+	const ZWaveNode::Value value({0x1000, 2}, {49, 1, 1}, "21.30", "C");
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asCelsius());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asDoubleFromDecimal)
+{
+	const auto value = ZWaveNode::Value::fromDecimal(
+		{0x1000, 2}, {49, 1, 1}, 21.3f, 2, "C");
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asCelsius());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asIntFromString)
+{
+	const ZWaveNode::Value value({0x1000, 2}, {128, 0, 1}, "87", "%");
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asInt());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asIntFromByte)
+{
+	const auto value = ZWaveNode::Value::fromByte(
+		{0x1000, 2}, {128, 0, 1}, 87, "%");
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asInt());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asBoolFromString)
+{
+	const ZWaveNode::Value value({0x1000, 2}, {37, 0, 1}, "True");
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asBool());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, asBoolFromBool)
+{
+	const auto value = ZWaveNode::Value::fromBool(
+		{0x1000, 2}, {37, 0, 1}, true);
+
+	for (size_t i = 0; i < context.iterations(); ++i)
+		Benchmark::keep(value.asBool());
+}
+
+BEEEON_BENCHMARK(ZWaveNodeValue, copyDecimal)
+{
+	const auto value = ZWaveNode::Value::fromDecimal(
+		{0x1000, 2}, {50, 8, 1}, 1250.5f, 1, "W");
+
+	for (size_t i = 0; i < context.iterations(); ++i) {
+		const ZWaveNode::Value copy(value);
+		Benchmark::keep(copy);
+	}
+}
@@ -30,6 +30,8 @@ BEEEON_OBJECT_PROPERTY("scanTimeout", &BLESmartDeviceManager::setScanTimeout)
 BEEEON_OBJECT_PROPERTY("deviceTimeout", &BLESmartDeviceManager::setDeviceTimeout)
 BEEEON_OBJECT_PROPERTY("refresh", &BLESmartDeviceManager::setRefresh)
 BEEEON_OBJECT_PROPERTY("numberOfExaminationThreads", &BLESmartDeviceManager::setNumberOfExaminationThreads)
+BEEEON_OBJECT_PROPERTY("unsupportedCacheTTL", &BLESmartDeviceManager::setUnsupportedCacheTTL)
+BEEEON_OBJECT_PROPERTY("failureCacheTTL", &BLESmartDeviceManager::setFailureCacheTTL)
 BEEEON_OBJECT_PROPERTY("attemptsCount", &BLESmartDeviceManager::setAttemptsCount)
 BEEEON_OBJECT_PROPERTY("retryTimeout", &BLESmartDeviceManager::setRetryTimeout)
 BEEEON_OBJECT_END(BeeeOn, BLESmartDeviceManager)
@@ -49,8 +51,7 @@ BLESmartDeviceManager::BLESmartDeviceManager():
 	}),
 	m_scanTimeout(10 * Timespan::SECONDS),
 	m_deviceTimeout(5 * Timespan::SECONDS),
-	m_refresh(RefreshTime::fromSeconds(30)),
-	m_numberOfExaminationThreads(3)
+	m_refresh(RefreshTime::fromSeconds(30))
 {
 	m_watchCallback = new HciInterface::WatchCallback(
 		[&](const MACAddress& address, vector<unsigned char>& data) {
@@ -93,7 +94,17 @@ void BLESmartDeviceManager::setNumberOfExaminationThreads(
 	if (numberOfExaminationThreads <= 0)
 		throw InvalidArgumentException("number of examination threads must be at least one");
 
-	m_numberOfExaminationThreads = numberOfExaminationThreads;
+	m_examinationPool.setWorkers(numberOfExaminationThreads);
+}
+
+void BLESmartDeviceManager::setUnsupportedCacheTTL(const Timespan &ttl)
+{
+	m_examinationPool.setUnsupportedTTL(ttl);
+}
+
+void BLESmartDeviceManager::setFailureCacheTTL(const Timespan &ttl)
+{
+	m_examinationPool.setFailureTTL(ttl);
 }
 
 void BLESmartDeviceManager::setHciManager(HciInterfaceManager::Ptr manager)
@@ -106,6 +117,9 @@ void BLESmartDeviceManager::dongleAvailable()
 	logger().information("starting BLE Smart device manager", __FILE__, __LINE__);
 
 	m_hci = m_hciManager->lookup(dongleName());
+	m_examinationPool.start([this](const MACAddress &address) {
+		return createDevice(address);
+	});
 
 	while (!m_stopControl.shouldStop()) {
 		seekPairedDevices();
@@ -123,6 +137,7 @@ void BLESmartDeviceManager::dongleAvailable()
 		m_stopControl.waitStoppable(m_refresh);
 	}
 
+	m_examinationPool.stop();
 	m_pollingKeeper.cancelAll();
 	logger().information("stopping BLE Smart device manager", __FILE__, __LINE__);
 }
@@ -139,6 +154,7 @@ string BLESmartDeviceManager::dongleMatch(const HotplugEvent &e)
 
 void BLESmartDeviceManager::dongleFailed(const FailDetector &dongleStatus)
 {
+	m_examinationPool.stop();
 	eraseAllDevices();
 	DongleDeviceManager::dongleFailed(dongleStatus);
 }
@@ -146,11 +162,13 @@ void BLESmartDeviceManager::dongleFailed(const FailDetector &dongleStatus)
 void BLESmartDeviceManager::stop()
 {
 	DongleDeviceManager::stop();
+	m_examinationPool.stop();
 	answerQueue().dispose();
 }
 
 bool BLESmartDeviceManager::dongleMissing()
 {
+	m_examinationPool.stop();
 	eraseAllDevices();
 	return true;
 }
@@ -280,7 +298,7 @@ void BLESmartDeviceManager::seekPairedDevices()
 	logger().information("discovering of paired BLE devices...", __FILE__, __LINE__);
 
 	m_hci->up();
-	map<MACAddress, string> foundDevices = m_hci->lescan(m_scanTimeout);
+	map<MACAddress, string> foundDevices = HciUtil::leDevices(*m_hci, m_scanTimeout);
 
 	for (const auto &device : foundDevices) {
 		if (m_stopControl.shouldStop())
@@ -322,95 +340,27 @@ void BLESmartDeviceManager::seekDevices(vector<BLESmartDevice::Ptr>& foundDevice
 
 	// Only a new devices are examined.
 	ScopedLockWithUnlock<FastMutex> lock(m_devicesMutex);
-	map<MACAddress, string> newDevices;
+	vector<MACAddress> newDevices;
 	for (const auto &device : devices) {
 		auto it = m_devices.find(DeviceID(DevicePrefix::PREFIX_BLE_SMART, device.first));
 		if (it != m_devices.end())
 			foundDevices.emplace_back(it->second);
 		else
-			newDevices.emplace(device);
+			newDevices.emplace_back(device.first);
 	}
 	lock.unlock();
 
-	FastMutex foundDevicesMutex;
-	if (newDevices.size() <= 1) {
-		examineBatchOfDevices(
-			newDevices,
-			foundDevicesMutex,
-			foundDevices,
-			stop);
-	}
-	else {
-		threadedExaminationOfDevices(
-			newDevices,
-			foundDevicesMutex,
-			foundDevices,
-			stop);
-	}
-}
-
-void BLESmartDeviceManager::threadedExaminationOfDevices(
-		const map<MACAddress, string>& devices,
-		FastMutex& foundDevicesMutex,
-		vector<BLESmartDevice::Ptr>& foundDevices,
-		const StopControl& stop)
-{
-	uint32_t numberOfThreads = m_numberOfExaminationThreads;
-	if (devices.size() < m_numberOfExaminationThreads)
-		numberOfThreads = devices.size();
-
-	vector<map<MACAddress, string>> splitDevices(numberOfThreads);
-	vector<SharedPtr<Thread>> threads;
-
-	uint32_t i = 0;
-	for (const auto &device : devices) {
-		splitDevices.at(i % numberOfThreads).emplace(device);
-		i++;
-	}
-
-	for (const auto &batchDevices : splitDevices) {
-		SharedPtr<Thread> thread = new Thread;
-		threads.push_back(thread);
-
-		thread->startFunc(
-			[&]() {
-				examineBatchOfDevices(
-					batchDevices,
-					foundDevicesMutex,
-					foundDevices,
-					stop);
-			}
-		);
-	}
+	if (newDevices.empty())
+		return;
 
-	for (auto thread : threads)
-		thread->join();
-}
+	BLESmartExaminationPool::Batch::Ptr batch = m_examinationPool.examine(newDevices);
 
-void BLESmartDeviceManager::examineBatchOfDevices(
-		const map<MACAddress, string>& devices,
-		FastMutex& foundDevicesMutex,
-		vector<BLESmartDevice::Ptr>& foundDevices,
-		const StopControl& stop)
-{
-	for (const auto &device : devices) {
+	while (!batch->wait(200 * Timespan::MILLISECONDS)) {
 		if (stop.shouldStop())
-			break;
-
-		BLESmartDevice::Ptr newDevice;
-		try {
-			newDevice = createDevice(device.first);
-		}
-		catch (const NotFoundException&) {
-			// unsupported device
-			continue;
-		}
-		catch (const Exception& e) {
-			logger().log(e, __FILE__, __LINE__);
-			continue;
-		}
+			return;
+	}
 
-		ScopedLock<FastMutex> guard(foundDevicesMutex);
+	for (const auto &newDevice : batch->devices()) {
 		foundDevices.push_back(newDevice);
 
 		logger().information("found " + newDevice->productName() + " " + newDevice->id().toString(),
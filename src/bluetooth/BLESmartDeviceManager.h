@@ -4,11 +4,11 @@
 #include <vector>
 
 #include <Poco/Mutex.h>
-#include <Poco/Thread.h>
 #include <Poco/Timespan.h>
 #include <Poco/UUID.h>
 
 #include "bluetooth/BLESmartDevice.h"
+#include "bluetooth/BLESmartExaminationPool.h"
 #include "bluetooth/HciInterface.h"
 #include "commands/DeviceAcceptCommand.h"
 #include "commands/DeviceSetValueCommand.h"
@@ -27,6 +27,11 @@ namespace BeeeOn {
  * @brief The class implements the work with Bluetooth Low Energy devices.
  * Allows us to process and execute the commands from server and gather
  * data from the devices.
+ *
+ * Newly scanned devices are examined by BLESmartExaminationPool which
+ * is running while the dongle is available. Devices that turn out to be
+ * unsupported are not examined again for unsupportedCacheTTL, devices
+ * that failed to be examined for failureCacheTTL.
  */
 class BLESmartDeviceManager : public DongleDeviceManager {
 public:
@@ -77,6 +82,8 @@ public:
 	void setDeviceTimeout(const Poco::Timespan &timeout);
 	void setRefresh(const Poco::Timespan &refresh);
 	void setNumberOfExaminationThreads(const int numberOfExaminationThreads);
+	void setUnsupportedCacheTTL(const Poco::Timespan &ttl);
+	void setFailureCacheTTL(const Poco::Timespan &ttl);
 	void setHciManager(HciInterfaceManager::Ptr manager);
 
 protected:
@@ -121,34 +128,13 @@ protected:
 	 * In the first step, it is determined wheter the device name
 	 * is in set of names of potentially supported device. If so,
 	 * then the model id of device is obtained according to which
-	 * the device is identified.
+	 * the device is identified. The identification is performed by
+	 * the examination pool.
 	 */
 	void seekDevices(
 		std::vector<BLESmartDevice::Ptr>& foundDevices,
 		const StopControl& stop);
 
-	/**
-	 * @brief Splits the map of devices into smaller maps whose number
-	 * is determined by the attribute m_numberOfExaminationThreads.
-	 * These maps of devices are then examines in the seperated threads.
-	 */
-	void threadedExaminationOfDevices(
-		const std::map<MACAddress, std::string>& devices,
-		Poco::FastMutex& foundDevicesMutex,
-		std::vector<BLESmartDevice::Ptr>& foundDevices,
-		const StopControl& stop);
-
-	/**
-	 * @brief Finds out if the given devices are supported. In the
-	 * positive case, a specific instance of the device is created
-	 * for it.
-	 */
-	void examineBatchOfDevices(
-		const std::map<MACAddress, std::string>& devices,
-		Poco::FastMutex& foundDevicesMutex,
-		std::vector<BLESmartDevice::Ptr>& foundDevices,
-		const StopControl& stop);
-
 	/**
 	 * @brief Creates BLE device based on its Model ID.
 	 */
@@ -165,7 +151,7 @@ private:
 	Poco::Timespan m_scanTimeout;
 	Poco::Timespan m_deviceTimeout;
 	RefreshTime m_refresh;
-	uint32_t m_numberOfExaminationThreads;
+	BLESmartExaminationPool m_examinationPool;
 	HciInterfaceManager::Ptr m_hciManager;
 	HciInterface::Ptr m_hci;
 };
@@ -0,0 +1,328 @@
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+
+#include "bluetooth/BLESmartExaminationPool.h"
+#include "util/ThreadNamer.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+BLESmartExaminationPool::Batch::Batch(size_t count):
+	m_remaining(count),
+	m_event(false)
+{
+	if (m_remaining == 0)
+		m_event.set();
+}
+
+bool BLESmartExaminationPool::Batch::wait(const Timespan &timeout)
+{
+	return m_event.tryWait(timeout.totalMilliseconds());
+}
+
+vector<BLESmartDevice::Ptr> BLESmartExaminationPool::Batch::devices() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_devices;
+}
+
+size_t BLESmartExaminationPool::Batch::remaining() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_remaining;
+}
+
+void BLESmartExaminationPool::Batch::done(BLESmartDevice::Ptr device)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_remaining == 0)
+		return;
+
+	if (!device.isNull())
+		m_devices.emplace_back(device);
+
+	if (--m_remaining == 0)
+		m_event.set();
+}
+
+BLESmartExaminationPool::BLESmartExaminationPool():
+	m_workers(3),
+	m_unsupportedTTL(1 * Timespan::HOURS),
+	m_failureTTL(1 * Timespan::MINUTES),
+	m_running(false),
+	m_stop(false)
+{
+	const string prefix = "blesmart.examination";
+
+	m_queueMetric = m_metrics.gauge(prefix + ".queue");
+	m_waitMetric = m_metrics.histogram(prefix + ".wait_us",
+		{1000, 10000, 100000, 1000000, 10000000});
+	m_latencyMetric = m_metrics.histogram(prefix + ".latency_us",
+		{1000, 10000, 100000, 1000000, 10000000});
+	m_foundMetric = m_metrics.counter(prefix + ".found");
+	m_unsupportedMetric = m_metrics.counter(prefix + ".unsupported");
+	m_failedMetric = m_metrics.counter(prefix + ".failed");
+	m_skippedMetric = m_metrics.counter(prefix + ".skipped");
+	m_deduplicatedMetric = m_metrics.counter(prefix + ".deduplicated");
+}
+
+BLESmartExaminationPool::~BLESmartExaminationPool()
+{
+	try {
+		stop();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void BLESmartExaminationPool::setWorkers(int workers)
+{
+	if (workers < 1)
+		throw InvalidArgumentException("workers must be at least 1");
+
+	FastMutex::ScopedLock guard(m_lock);
+	m_workers = workers;
+}
+
+void BLESmartExaminationPool::setUnsupportedTTL(const Timespan &ttl)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_unsupportedTTL = ttl;
+}
+
+void BLESmartExaminationPool::setFailureTTL(const Timespan &ttl)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_failureTTL = ttl;
+}
+
+void BLESmartExaminationPool::start(Examine examine)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_running)
+		throw IllegalStateException("examination pool is already running");
+
+	m_examine = examine;
+	m_stop = false;
+	m_running = true;
+
+	for (size_t i = 0; i < m_workers; ++i) {
+		m_threads.emplace_back();
+		m_threads.back().startFunc([this]() {workerLoop();});
+	}
+
+	logger().information(
+		"started " + to_string(m_workers) + " examination workers",
+		__FILE__, __LINE__);
+}
+
+void BLESmartExaminationPool::stop()
+{
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		// not running or being stopped by another thread
+		if (!m_running || m_stop)
+			return;
+
+		m_stop = true;
+		m_condition.broadcast();
+	}
+
+	for (auto &thread : m_threads)
+		thread.join();
+
+	map<MACAddress, Pending> dropped;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		m_threads.clear();
+		m_pending.swap(dropped);
+		m_queue.clear();
+		m_queueMetric->set(0);
+		m_running = false;
+	}
+
+	if (!dropped.empty()) {
+		logger().warning(
+			"dropped " + to_string(dropped.size()) + " queued examinations",
+			__FILE__, __LINE__);
+	}
+
+	for (auto &pair : dropped) {
+		for (auto &batch : pair.second.waiters)
+			batch->done(BLESmartDevice::Ptr());
+	}
+}
+
+BLESmartExaminationPool::Batch::Ptr BLESmartExaminationPool::examine(
+		const vector<MACAddress> &addresses)
+{
+	Batch::Ptr batch = new Batch(addresses.size());
+	size_t skipped = 0;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		if (!m_running || m_stop)
+			throw IllegalStateException("examination pool is not running");
+
+		sweepNegative();
+
+		for (const auto &address : addresses) {
+			if (m_negative.find(address) != m_negative.end()) {
+				m_skippedMetric->add();
+				skipped += 1;
+				continue;
+			}
+
+			auto it = m_pending.find(address);
+			if (it != m_pending.end()) {
+				m_deduplicatedMetric->add();
+				it->second.waiters.emplace_back(batch);
+				continue;
+			}
+
+			Pending &pending = m_pending[address];
+			pending.waiters.emplace_back(batch);
+
+			m_queue.emplace_back(address);
+			m_condition.signal();
+		}
+
+		m_queueMetric->set(m_queue.size());
+	}
+
+	for (size_t i = 0; i < skipped; ++i)
+		batch->done(BLESmartDevice::Ptr());
+
+	return batch;
+}
+
+size_t BLESmartExaminationPool::queued() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_queue.size();
+}
+
+bool BLESmartExaminationPool::cachedNegative(const MACAddress &address) const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	auto it = m_negative.find(address);
+	if (it == m_negative.end())
+		return false;
+
+	return it->second > Clock();
+}
+
+void BLESmartExaminationPool::sweepNegative()
+{
+	const Clock now;
+
+	for (auto it = m_negative.begin(); it != m_negative.end();) {
+		if (it->second <= now)
+			it = m_negative.erase(it);
+		else
+			++it;
+	}
+}
+
+void BLESmartExaminationPool::remember(
+		const MACAddress &address,
+		const Timespan &ttl)
+{
+	if (ttl <= 0)
+		return;
+
+	m_negative[address] = Clock() + ttl.totalMicroseconds();
+}
+
+void BLESmartExaminationPool::finish(
+		const MACAddress &address,
+		BLESmartDevice::Ptr device)
+{
+	list<Batch::Ptr> waiters;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		auto it = m_pending.find(address);
+		if (it == m_pending.end())
+			return;
+
+		waiters.swap(it->second.waiters);
+		m_pending.erase(it);
+	}
+
+	for (auto &batch : waiters)
+		batch->done(device);
+}
+
+void BLESmartExaminationPool::workerLoop()
+{
+	ThreadNamer namer("ble-exam-" + to_string(Thread::currentTid()));
+
+	while (true) {
+		MACAddress address;
+
+		{
+			FastMutex::ScopedLock guard(m_lock);
+
+			while (!m_stop && m_queue.empty())
+				m_condition.wait(m_lock);
+
+			if (m_stop)
+				break;
+
+			address = m_queue.front();
+			m_queue.pop_front();
+			m_queueMetric->set(m_queue.size());
+
+			m_waitMetric->observe(
+				m_pending.at(address).enqueued.elapsed());
+		}
+
+		const Clock started;
+		BLESmartDevice::Ptr device;
+		Timespan ttl = 0;
+
+		try {
+			device = m_examine(address);
+			m_foundMetric->add();
+		}
+		catch (const NotFoundException &) {
+			// unsupported device
+			m_unsupportedMetric->add();
+
+			FastMutex::ScopedLock guard(m_lock);
+			ttl = m_unsupportedTTL;
+		}
+		catch (const Exception &e) {
+			logger().log(e, __FILE__, __LINE__);
+			m_failedMetric->add();
+
+			FastMutex::ScopedLock guard(m_lock);
+			ttl = m_failureTTL;
+		}
+		catch (const exception &e) {
+			logger().critical(e.what(), __FILE__, __LINE__);
+			m_failedMetric->add();
+
+			FastMutex::ScopedLock guard(m_lock);
+			ttl = m_failureTTL;
+		}
+
+		m_latencyMetric->observe(started.elapsed());
+
+		if (device.isNull()) {
+			FastMutex::ScopedLock guard(m_lock);
+			remember(address, ttl);
+		}
+
+		finish(address, device);
+	}
+}
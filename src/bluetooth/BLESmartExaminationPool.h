@@ -0,0 +1,174 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Condition.h>
+#include <Poco/Event.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Thread.h>
+#include <Poco/Timespan.h>
+
+#include "bluetooth/BLESmartDevice.h"
+#include "net/MACAddress.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief BLESmartExaminationPool examines BLE devices (finds out whether
+ * they are supported and creates their instances) by a fixed set of
+ * long-lived worker threads fed from a single work queue.
+ *
+ * Examination of a MAC address that is already pending is not queued
+ * again, the caller just waits for the running one. Devices found to be
+ * unsupported are remembered for unsupportedTTL, devices that failed to
+ * be examined (e.g. connection failure) for failureTTL. Such devices are
+ * not examined again until the TTL expires.
+ *
+ * The pool reports metrics blesmart.examination.queue (gauge),
+ * blesmart.examination.{wait_us,latency_us} (histograms) and counters
+ * blesmart.examination.{found,unsupported,failed,skipped,deduplicated}.
+ */
+class BLESmartExaminationPool : Loggable {
+public:
+	/**
+	 * @brief Examination of a single device. It returns the created
+	 * device, throws Poco::NotFoundException for unsupported devices
+	 * or any other Poco::Exception on failure.
+	 */
+	typedef std::function<BLESmartDevice::Ptr(const MACAddress &)> Examine;
+
+	/**
+	 * @brief Set of examinations requested together via examine().
+	 */
+	class Batch {
+	public:
+		typedef Poco::SharedPtr<Batch> Ptr;
+
+		Batch(size_t count);
+
+		/**
+		 * @brief Wait until all examinations of the batch finish.
+		 * @returns false on timeout
+		 */
+		bool wait(const Poco::Timespan &timeout);
+
+		/**
+		 * @returns devices found to be supported so far
+		 */
+		std::vector<BLESmartDevice::Ptr> devices() const;
+
+		size_t remaining() const;
+
+		/**
+		 * @brief Report a finished examination. The device is null
+		 * when it is not supported or the examination failed.
+		 */
+		void done(BLESmartDevice::Ptr device);
+
+	private:
+		size_t m_remaining;
+		std::vector<BLESmartDevice::Ptr> m_devices;
+		mutable Poco::FastMutex m_lock;
+		Poco::Event m_event;
+	};
+
+	BLESmartExaminationPool();
+	~BLESmartExaminationPool();
+
+	/**
+	 * @brief Number of worker threads. Applied on the next start().
+	 */
+	void setWorkers(int workers);
+
+	/**
+	 * @brief How long to remember unsupported devices. Non-positive
+	 * value disables caching of unsupported devices.
+	 */
+	void setUnsupportedTTL(const Poco::Timespan &ttl);
+
+	/**
+	 * @brief How long to remember devices whose examination failed.
+	 * Non-positive value disables caching of failures.
+	 */
+	void setFailureTTL(const Poco::Timespan &ttl);
+
+	/**
+	 * @brief Start the worker threads examining devices by the given
+	 * function.
+	 */
+	void start(Examine examine);
+
+	/**
+	 * @brief Stop the worker threads. Running examinations are finished,
+	 * the queued ones are dropped and their batches are completed without
+	 * any device. The negative cache is preserved.
+	 */
+	void stop();
+
+	/**
+	 * @brief Enqueue examinations of the given devices.
+	 * @throws Poco::IllegalStateException when the pool is not running
+	 */
+	Batch::Ptr examine(const std::vector<MACAddress> &addresses);
+
+	/**
+	 * @returns number of queued (not yet running) examinations
+	 */
+	size_t queued() const;
+
+	/**
+	 * @returns true if the device is remembered as unsupported or failed
+	 */
+	bool cachedNegative(const MACAddress &address) const;
+
+protected:
+	struct Pending {
+		std::list<Batch::Ptr> waiters;
+		Poco::Clock enqueued;
+	};
+
+	/**
+	 * @brief Drop expired entries of the negative cache.
+	 * The m_lock must be held.
+	 */
+	void sweepNegative();
+
+	void finish(const MACAddress &address, BLESmartDevice::Ptr device);
+	void remember(const MACAddress &address, const Poco::Timespan &ttl);
+	void workerLoop();
+
+private:
+	size_t m_workers;
+	Poco::Timespan m_unsupportedTTL;
+	Poco::Timespan m_failureTTL;
+	Examine m_examine;
+
+	std::map<MACAddress, Pending> m_pending;
+	std::deque<MACAddress> m_queue;
+	std::map<MACAddress, Poco::Clock> m_negative;
+	std::list<Poco::Thread> m_threads;
+	bool m_running;
+	bool m_stop;
+	mutable Poco::FastMutex m_lock;
+	Poco::Condition m_condition;
+
+	MetricsScope m_metrics;
+	GaugeMetric::Ptr m_queueMetric;
+	HistogramMetric::Ptr m_waitMetric;
+	HistogramMetric::Ptr m_latencyMetric;
+	CounterMetric::Ptr m_foundMetric;
+	CounterMetric::Ptr m_unsupportedMetric;
+	CounterMetric::Ptr m_failedMetric;
+	CounterMetric::Ptr m_skippedMetric;
+	CounterMetric::Ptr m_deduplicatedMetric;
+};
+
+}
@@ -198,7 +198,7 @@ list<DeviceID> BluetoothAvailabilityManager::detectClassic(const HciInterface &h
 void BluetoothAvailabilityManager::detectLE(const HciInterface &hci)
 {
 	m_leScanCache.clear();
-	m_leScanCache = hci.lescan(m_leScanTime);
+	m_leScanCache = HciUtil::leDevices(hci, m_leScanTime);
 
 	for (auto &device : m_deviceList) {
 		if (!device.second.isLE())
@@ -84,6 +84,8 @@ private:
 
 	/*
 	 * Scan for BLE devices.
+	 * The devices are taken from the advertisement stream of
+	 * the interface when available (see HciUtil::leDevices()).
 	 * There is no inactive list.
 	 * The last BLE scan result is stored in m_leScanCache.
 	 * m_leScanCache exists for fast result of listen command.
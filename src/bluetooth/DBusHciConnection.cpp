@@ -22,9 +22,11 @@ static void throwErrorIfAny(const GlibPtr<GError> error)
 
 DBusHciConnection::DBusHciConnection(
 		const string& hciName,
+		GlibPtr<GDBusObjectManager> objectManager,
 		GlibPtr<OrgBluezDevice1> device,
 		const Timespan& timeout):
 	m_hciName(hciName),
+	m_objectManager(objectManager),
 	m_device(device),
 	m_timeout(timeout)
 {
@@ -46,6 +48,9 @@ DBusHciConnection::~DBusHciConnection()
 
 vector<unsigned char> DBusHciConnection::read(const UUID& uuid)
 {
+	ScopedLock<FastMutex> lock(m_lock);
+	updateLastUsed();
+
 	if (logger().debug()) {
 		logger().debug("sending read request to device " + m_address.toString(':'),
 			__FILE__, __LINE__);
@@ -78,7 +83,8 @@ void DBusHciConnection::write(
 		const UUID& uuid,
 		const vector<unsigned char>& value)
 {
-	ScopedLock<FastMutex> lock(m_writeMutex);
+	ScopedLock<FastMutex> lock(m_lock);
+	updateLastUsed();
 
 	if (logger().debug()) {
 		logger().debug("sending write request to device " + m_address.toString(':'),
@@ -94,7 +100,8 @@ vector<unsigned char> DBusHciConnection::notifiedWrite(
 		const vector<unsigned char>& value,
 		const Poco::Timespan& notifyTimeout)
 {
-	ScopedLock<FastMutex> lock(m_writeMutex);
+	ScopedLock<FastMutex> lock(m_lock);
+	updateLastUsed();
 
 	if (logger().debug()) {
 		logger().debug("sending notified write request to device " + m_address.toString(':'),
@@ -128,6 +135,152 @@ vector<unsigned char> DBusHciConnection::notifiedWrite(
 	return callbackData.second;
 }
 
+vector<vector<unsigned char>> DBusHciConnection::execute(
+		const vector<Request>& requests)
+{
+	if (requests.empty())
+		return {};
+
+	ScopedLock<FastMutex> lock(m_lock);
+	updateLastUsed();
+
+	if (logger().debug()) {
+		logger().debug("sending " + to_string(requests.size())
+			+ " pipelined requests to device " + m_address.toString(':'),
+			__FILE__, __LINE__);
+	}
+
+	vector<GlibPtr<OrgBluezGattCharacteristic1>> characteristics;
+
+	for (const auto &request : requests) {
+		GlibPtr<OrgBluezGattCharacteristic1> characteristic = findGATTCharacteristic(request.uuid);
+		if (characteristic.isNull())
+			throw NotFoundException("no such GATT characteristic " + request.uuid.toString());
+
+		::g_dbus_proxy_set_default_timeout(G_DBUS_PROXY(characteristic.raw()), m_timeout.totalMilliseconds());
+		characteristics.emplace_back(characteristic);
+	}
+
+	Pipeline::Ptr pipeline = new Pipeline(requests, characteristics);
+
+	// only the first request to each characteristic is sent now,
+	// the following ones are sent by onRequestFinished()
+	for (const auto index : pipeline->first())
+		send(pipeline, index);
+
+	if (!pipeline->wait(m_timeout.totalMicroseconds() * requests.size())) {
+		const string message = "pipelined requests to "
+			+ m_address.toString(':') + " did not finish in time";
+
+		// prevent sending of the rest of requests
+		pipeline->fail(message);
+		throw TimeoutException(message);
+	}
+
+	return pipeline->results();
+}
+
+bool DBusHciConnection::isConnected()
+{
+	return ::org_bluez_device1_get_connected(m_device.raw());
+}
+
+void DBusHciConnection::setTimeout(const Timespan& timeout)
+{
+	ScopedLock<FastMutex> lock(m_lock);
+	m_timeout = timeout;
+}
+
+void DBusHciConnection::updateLastUsed()
+{
+	ScopedLock<FastMutex> guard(m_lastUsedLock);
+	m_lastUsed.update();
+}
+
+Timestamp DBusHciConnection::lastUsed() const
+{
+	ScopedLock<FastMutex> guard(m_lastUsedLock);
+	return m_lastUsed;
+}
+
+void DBusHciConnection::send(Pipeline::Ptr pipeline, size_t index)
+{
+	const Request &request = pipeline->request(index);
+	OrgBluezGattCharacteristic1 *characteristic = pipeline->characteristics[index].raw();
+	PendingRequest *pending = new PendingRequest{pipeline, index};
+
+	GVariantBuilder args;
+	::g_variant_builder_init(&args, G_VARIANT_TYPE("a{sv}"));
+
+	switch (request.operation) {
+	case Request::READ:
+		::org_bluez_gatt_characteristic1_call_read_value(
+			characteristic, ::g_variant_builder_end(&args),
+			nullptr, onRequestFinished, pending);
+		break;
+
+	case Request::WRITE:
+		::org_bluez_gatt_characteristic1_call_write_value(
+			characteristic,
+			::g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE,
+				request.value.data(), request.value.size(), sizeof(unsigned char)),
+			::g_variant_builder_end(&args),
+			nullptr, onRequestFinished, pending);
+		break;
+	}
+}
+
+void DBusHciConnection::onRequestFinished(
+		GObject* source,
+		GAsyncResult* result,
+		gpointer userData)
+{
+	PendingRequest *pending = reinterpret_cast<PendingRequest*>(userData);
+	OrgBluezGattCharacteristic1 *characteristic =
+		reinterpret_cast<OrgBluezGattCharacteristic1*>(source);
+
+	GlibPtr<GError> error;
+	vector<unsigned char> value;
+
+	switch (pending->pipeline->request(pending->index).operation) {
+	case Request::READ: {
+		GlibPtr<GVariant> readValue;
+		::org_bluez_gatt_characteristic1_call_read_value_finish(
+			characteristic, &readValue, result, &error);
+
+		if (error.isNull()) {
+			gsize size = 0;
+			const unsigned char* data = reinterpret_cast<const unsigned char*>(
+				::g_variant_get_fixed_array(readValue.raw(), &size, sizeof(unsigned char)));
+			value.assign(data, data + size);
+		}
+		break;
+	}
+	case Request::WRITE:
+		::org_bluez_gatt_characteristic1_call_write_value_finish(
+			characteristic, result, &error);
+		break;
+	}
+
+	Pipeline::Ptr pipeline = pending->pipeline;
+	const size_t index = pending->index;
+	delete pending;
+
+	const size_t next = pipeline->finish(
+		index, value, error.isNull() ? "" : error->message);
+
+	if (next < pipeline->size())
+		send(pipeline, next);
+}
+
+DBusHciConnection::Pipeline::Pipeline(
+		const vector<Request>& requests,
+		const vector<GlibPtr<OrgBluezGattCharacteristic1>>& characteristics):
+	HciRequestPipeline(requests),
+	characteristics(characteristics)
+{
+}
+
 void DBusHciConnection::resolveServices()
 {
 	if (logger().debug()) {
@@ -247,9 +400,14 @@ void DBusHciConnection::disconnect()
 GlibPtr<OrgBluezGattCharacteristic1> DBusHciConnection::findGATTCharacteristic(
 		const UUID& uuid)
 {
-	GlibPtr<OrgBluezGattCharacteristic1> characteristic;
+	auto it = m_characteristics.find(uuid.toString());
+	if (it != m_characteristics.end())
+		return it->second;
+
+	// the characteristics are resolved all at once, there is nothing more to find
+	if (!m_characteristics.empty())
+		return nullptr;
 
-	GlibPtr<GDBusObjectManager> objectManager = DBusHciInterface::createBluezObjectManager();
 	function<bool(const string& path)> pathFilter =
 		[&](const string& path)-> bool {
 			if (path.find(m_hciName + "/dev_" + m_address.toString('_')) == string::npos)
@@ -258,7 +416,9 @@ GlibPtr<OrgBluezGattCharacteristic1> DBusHciConnection::findGATTCharacteristic(
 				return false;
 		};
 
-	for (auto path : DBusHciInterface::retrievePathsOfBluezObjects(objectManager, pathFilter, GATT_CHARACTERISTIC)) {
+	for (auto path : DBusHciInterface::retrievePathsOfBluezObjects(m_objectManager, pathFilter, GATT_CHARACTERISTIC)) {
+		GlibPtr<OrgBluezGattCharacteristic1> characteristic;
+
 		try {
 			characteristic = retrieveBluezGATTCharacteristic(path);
 		}
@@ -266,10 +426,19 @@ GlibPtr<OrgBluezGattCharacteristic1> DBusHciConnection::findGATTCharacteristic(
 			continue);
 
 		const string charUUID = ::org_bluez_gatt_characteristic1_get_uuid(characteristic.raw());
-		if (charUUID == uuid.toString())
-			return characteristic;
+		m_characteristics.emplace(charUUID, characteristic);
+	}
+
+	if (logger().debug()) {
+		logger().debug("resolved " + to_string(m_characteristics.size())
+			+ " GATT characteristics of device " + m_address.toString(':'),
+			__FILE__, __LINE__);
 	}
 
+	it = m_characteristics.find(uuid.toString());
+	if (it != m_characteristics.end())
+		return it->second;
+
 	return nullptr;
 }
 
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include <Poco/Event.h>
 #include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
 #include <Poco/UUID.h>
 
 #include "bluetooth/GlibPtr.h"
 #include "bluetooth/HciConnection.h"
+#include "bluetooth/HciRequestPipeline.h"
 #include "bluetooth/org-bluez-device1.h"
 #include "bluetooth/org-bluez-gattcharacteristic1.h"
 #include "net/MACAddress.h"
@@ -20,6 +24,12 @@ namespace BeeeOn {
 /**
  * @brief The class represents connection with Bluetooth Low energy device.
  * It allows sending read/write requests.
+ *
+ * The GATT characteristics are looked up only once per connection and
+ * their D-Bus proxies are cached by UUID. Requests given to execute()
+ * are pipelined: requests to different characteristics are sent to BlueZ
+ * without waiting for each other while requests to the same characteristic
+ * are sent one after another in the given order.
  */
 class DBusHciConnection:
 	public HciConnection,
@@ -29,6 +39,7 @@ public:
 
 	DBusHciConnection(
 		const std::string& hciName,
+		GlibPtr<GDBusObjectManager> objectManager,
 		GlibPtr<OrgBluezDevice1> device,
 		const Poco::Timespan& timeout);
 	~DBusHciConnection();
@@ -61,7 +72,70 @@ public:
 		const std::vector<unsigned char>& value,
 		const Poco::Timespan& notifyTimeout) override;
 
+	/**
+	 * @brief Sends the requests asynchronously and waits until all
+	 * of them are finished. A request is sent when the previous request
+	 * to the same characteristic has finished. When a request fails,
+	 * no other request is sent. The total wait time is limited by
+	 * the connection timeout for each request.
+	 */
+	std::vector<std::vector<unsigned char>> execute(
+		const std::vector<Request>& requests) override;
+
+	/**
+	 * @returns true if the device is still connected
+	 */
+	bool isConnected();
+
+	/**
+	 * @brief Change timeout of the following operations. It is used
+	 * when the cached connection is reused by a caller that requires
+	 * a different timeout. It waits for the current operation.
+	 */
+	void setTimeout(const Poco::Timespan& timeout);
+
+	/**
+	 * @brief Record that the connection is being used. It is called
+	 * for every operation and when the cached connection is reused.
+	 */
+	void updateLastUsed();
+
+	/**
+	 * @returns time of the last operation with the connection
+	 */
+	Poco::Timestamp lastUsed() const;
+
 protected:
+	/**
+	 * @brief Requests being executed by execute() together with
+	 * the proxies of their GATT characteristics.
+	 */
+	struct Pipeline : public HciRequestPipeline {
+		typedef Poco::SharedPtr<Pipeline> Ptr;
+
+		Pipeline(
+			const std::vector<Request>& requests,
+			const std::vector<GlibPtr<OrgBluezGattCharacteristic1>>& characteristics);
+
+		const std::vector<GlibPtr<OrgBluezGattCharacteristic1>> characteristics;
+	};
+
+	struct PendingRequest {
+		Pipeline::Ptr pipeline;
+		size_t index;
+	};
+
+	/**
+	 * @brief Send the request at the given index asynchronously.
+	 * The onRequestFinished() is called when it finishes.
+	 */
+	static void send(Pipeline::Ptr pipeline, size_t index);
+
+	static void onRequestFinished(
+		GObject* source,
+		GAsyncResult* result,
+		gpointer userData);
+
 	static gboolean onDeviceServicesResolved(
 		OrgBluezDevice1* device,
 		GVariant* properties,
@@ -97,6 +171,8 @@ private:
 	/**
 	 * @brief Tries to find GATT characteristic defined by UUID for
 	 * the given device. If the characteristic is not found it returns nullptr.
+	 * Proxies of all characteristics of the device are created and cached
+	 * during the first lookup.
 	 */
 	GlibPtr<OrgBluezGattCharacteristic1> findGATTCharacteristic(
 		const Poco::UUID& uuid);
@@ -110,11 +186,16 @@ private:
 
 private:
 	std::string m_hciName;
+	GlibPtr<GDBusObjectManager> m_objectManager;
 	GlibPtr<OrgBluezDevice1> m_device;
 	MACAddress m_address;
 	Poco::Timespan m_timeout;
+	std::map<std::string, GlibPtr<OrgBluezGattCharacteristic1>> m_characteristics;
+
+	Poco::FastMutex m_lock;
 
-	Poco::FastMutex m_writeMutex;
+	Poco::Timestamp m_lastUsed;
+	mutable Poco::FastMutex m_lastUsedLock;
 };
 
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Poco/DateTimeFormatter.h>
 #include <Poco/Exception.h>
 #include <Poco/Logger.h>
@@ -14,6 +16,7 @@ BEEEON_OBJECT_CASTABLE(HciInterfaceManager)
 BEEEON_OBJECT_PROPERTY("leMaxAgeRssi", &DBusHciInterfaceManager::setLeMaxAgeRssi)
 BEEEON_OBJECT_PROPERTY("leMaxUnavailabilityTime", &DBusHciInterfaceManager::setLeMaxUnavailabilityTime)
 BEEEON_OBJECT_PROPERTY("classicArtificialAvaibilityTimeout", &DBusHciInterfaceManager::setClassicArtificialAvaibilityTimeout)
+BEEEON_OBJECT_PROPERTY("leConnectionIdleTimeout", &DBusHciInterfaceManager::setLeConnectionIdleTimeout)
 BEEEON_OBJECT_END(BeeeOn, DBusHciInterfaceManager)
 
 using namespace BeeeOn;
@@ -24,21 +27,34 @@ static int CHANGE_POWER_ATTEMPTS = 5;
 static Timespan CHANGE_POWER_DELAY = 200 * Timespan::MILLISECONDS;
 static int GERROR_IN_PROGRESS = 36;
 static uint16_t RSSI_DEVICE_UNAVAILABLE = 0;
+static unsigned int CONNECT_LOCKS = 31;
+static Timespan PRUNE_DEVICES_PERIOD = 1 * Timespan::HOURS;
 
 DBusHciInterface::DBusHciInterface(
 		const string& name,
 		const Timespan& leMaxAgeRssi,
 		const Timespan& leMaxUnavailabilityTime,
-		const Timespan& classicArtificialAvaibilityTimeout):
+		const Timespan& classicArtificialAvaibilityTimeout,
+		const Timespan& leConnectionIdleTimeout):
 	m_name(name),
 	m_loopThread(*this, &DBusHciInterface::runLoop),
+	m_advertisements(new HciAdvertisementStream(leMaxAgeRssi)),
 	m_leMaxAgeRssi(leMaxAgeRssi),
 	m_leMaxUnavailabilityTime(leMaxUnavailabilityTime),
-	m_classicArtificialAvaibilityTimeout(classicArtificialAvaibilityTimeout)
+	m_classicArtificialAvaibilityTimeout(classicArtificialAvaibilityTimeout),
+	m_leConnectionIdleTimeout(leConnectionIdleTimeout),
+	m_connectLock(CONNECT_LOCKS),
+	m_sweepCallback(*this, &DBusHciInterface::onSweepConnections),
+	m_pruneCallback(*this, &DBusHciInterface::onPruneDevices)
 {
 	poco_assert(leMaxAgeRssi > 0);
 	poco_assert(leMaxUnavailabilityTime > 0);
 	poco_assert(classicArtificialAvaibilityTimeout > 0);
+	poco_assert(leConnectionIdleTimeout >= 0);
+
+	m_connectionsCreatedMetric = m_metrics.counter("bluetooth.connections.created");
+	m_connectionsReusedMetric = m_metrics.counter("bluetooth.connections.reused");
+	m_connectionsOpenMetric = m_metrics.gauge("bluetooth.connections.open");
 
 	m_adapter = retrieveBluezAdapter(createAdapterPath(m_name));
 	m_objectManager = createBluezObjectManager();
@@ -47,8 +63,8 @@ DBusHciInterface::DBusHciInterface(
 		const auto handle = ::g_signal_connect(
 			one.raw(),
 			"g-properties-changed",
-			G_CALLBACK(onDeviceRSSIChanged),
-			&m_devices);
+			G_CALLBACK(onDevicePropertiesChanged),
+			this);
 
 		Device device(one, handle);
 		m_devices.second.emplace(device.macAddress(), device);
@@ -58,13 +74,33 @@ DBusHciInterface::DBusHciInterface(
 		G_DBUS_OBJECT_MANAGER(m_objectManager.raw()),
 		"object-added",
 		G_CALLBACK(onDBusObjectAdded),
-		&m_devices);
+		this);
 
 	m_thread.start(m_loopThread);
+
+	if (m_leConnectionIdleTimeout > 0) {
+		m_sweepTimer.setStartInterval(m_leConnectionIdleTimeout.totalMilliseconds());
+		m_sweepTimer.setPeriodicInterval(m_leConnectionIdleTimeout.totalMilliseconds());
+		m_sweepTimer.start(m_sweepCallback);
+	}
+
+	// lescan() is not called regularly when the advertisements are used
+	const Timespan prunePeriod = std::min(m_leMaxUnavailabilityTime, PRUNE_DEVICES_PERIOD);
+	m_pruneTimer.setStartInterval(prunePeriod.totalMilliseconds());
+	m_pruneTimer.setPeriodicInterval(prunePeriod.totalMilliseconds());
+	m_pruneTimer.start(m_pruneCallback);
 }
 
 DBusHciInterface::~DBusHciInterface()
 {
+	m_pruneTimer.stop();
+	m_sweepTimer.stop();
+
+	{
+		ScopedLock<FastMutex> guard(m_connectionsMutex);
+		m_connections.clear();
+	}
+
 	stopDiscovery(m_adapter);
 
 	::g_signal_handler_disconnect(m_objectManager.raw(), m_objectManagerHandle);
@@ -224,6 +260,47 @@ HciConnection::Ptr DBusHciInterface::connect(
 		const MACAddress& address,
 		const Timespan& timeout) const
 {
+	ScopedLock<FastMutex> connectGuard(m_connectLock.find(address));
+
+	if (m_leConnectionIdleTimeout > 0) {
+		DBusHciConnection::Ptr cached;
+		bool stale = false;
+
+		{
+			ScopedLock<FastMutex> guard(m_connectionsMutex);
+
+			auto it = m_connections.find(address);
+			if (it != m_connections.end()) {
+				cached = it->second;
+
+				if (!cached->isConnected()) {
+					stale = true;
+					m_connections.erase(it);
+					m_connectionsOpenMetric->set(m_connections.size());
+				}
+			}
+		}
+
+		if (stale) {
+			// disconnect outside of the lock
+			try {
+				cached = nullptr;
+			}
+			BEEEON_CATCH_CHAIN(logger())
+		}
+		else if (!cached.isNull()) {
+			if (logger().debug()) {
+				logger().debug("reusing connection to device " + address.toString(':'),
+					__FILE__, __LINE__);
+			}
+
+			cached->setTimeout(timeout);
+			cached->updateLastUsed();
+			m_connectionsReusedMetric->add();
+			return cached;
+		}
+	}
+
 	if (logger().debug())
 		logger().debug("connecting to device " + address.toString(':'), __FILE__, __LINE__);
 
@@ -243,7 +320,63 @@ HciConnection::Ptr DBusHciInterface::connect(
 		throwErrorIfAny(error);
 	}
 
-	return new DBusHciConnection(m_name, device, timeout);
+	DBusHciConnection::Ptr connection = new DBusHciConnection(
+		m_name, m_objectManager, device, timeout);
+	m_connectionsCreatedMetric->add();
+
+	if (m_leConnectionIdleTimeout > 0) {
+		ScopedLock<FastMutex> guard(m_connectionsMutex);
+
+		m_connections[address] = connection;
+		m_connectionsOpenMetric->set(m_connections.size());
+	}
+
+	return connection;
+}
+
+void DBusHciInterface::onSweepConnections(Timer &)
+{
+	vector<DBusHciConnection::Ptr> idle;
+
+	{
+		ScopedLock<FastMutex> guard(m_connectionsMutex);
+
+		for (auto it = m_connections.begin(); it != m_connections.end();) {
+			const auto &cached = it->second;
+
+			// connections still held by somebody must not be closed
+			if (cached.referenceCount() == 1
+					&& cached->lastUsed().isElapsed(m_leConnectionIdleTimeout.totalMicroseconds())) {
+				idle.emplace_back(cached);
+				it = m_connections.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+
+		m_connectionsOpenMetric->set(m_connections.size());
+	}
+
+	if (!idle.empty() && logger().debug()) {
+		logger().debug("closing " + to_string(idle.size()) + " idle connections",
+			__FILE__, __LINE__);
+	}
+
+	// disconnect outside of the lock
+	try {
+		idle.clear();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void DBusHciInterface::onPruneDevices(Timer &)
+{
+	try {
+		ScopedLock<FastMutex> guard(m_devices.first);
+		removeUnvailableDevices();
+	}
+	BEEEON_CATCH_CHAIN(logger())
 }
 
 void DBusHciInterface::watch(
@@ -262,16 +395,9 @@ void DBusHciInterface::watch(
 	if (logger().debug())
 		logger().debug("watch the device " + address.toString(':'), __FILE__, __LINE__);
 
-	uint64_t handle = ::g_signal_connect(
-		it->second.device().raw(),
-		"g-properties-changed",
-		G_CALLBACK(onDeviceManufacturerDataRecieved),
-		callBack.get());
-
-	if (handle == 0)
-		throw IOException("failed to watch device " + address.toString());
-
-	it->second.watch(handle, callBack);
+	HciAdvertisementListener::Ptr listener = new WatchListener(callBack);
+	m_advertisements->subscribe(address, listener);
+	it->second.watch(listener);
 }
 
 void DBusHciInterface::unwatch(const MACAddress& address)
@@ -288,9 +414,13 @@ void DBusHciInterface::unwatch(const MACAddress& address)
 	if (logger().debug())
 		logger().debug("unwatch the device " + address.toString(':'), __FILE__, __LINE__);
 
-	const auto handle = it->second.watchHandle();
+	m_advertisements->unsubscribe(it->second.watchListener());
 	it->second.unwatch();
-	::g_signal_handler_disconnect(it->second.device().raw(), handle);
+}
+
+HciAdvertisementStream::Ptr DBusHciInterface::advertisements() const
+{
+	return m_advertisements;
 }
 
 void DBusHciInterface::waitUntilPoweredChange(GlibPtr<OrgBluezAdapter1> adapter, const bool powered) const
@@ -318,6 +448,9 @@ void DBusHciInterface::startDiscovery(
 	initDiscoveryFilter(adapter, trasport);
 	::org_bluez_adapter1_call_start_discovery_sync(adapter.raw(), nullptr, &error);
 	throwErrorIfAny(error);
+
+	// advertisements received before are not relevant anymore
+	m_advertisements->restart();
 }
 
 void DBusHciInterface::stopDiscovery(GlibPtr<OrgBluezAdapter1> adapter) const
@@ -456,17 +589,17 @@ void DBusHciInterface::onDBusObjectAdded(
 	const auto handle = ::g_signal_connect(
 		device.raw(),
 		"g-properties-changed",
-		G_CALLBACK(onDeviceRSSIChanged),
+		G_CALLBACK(onDevicePropertiesChanged),
 		userData);
 
-	ThreadSafeDevices &devices = *(reinterpret_cast<ThreadSafeDevices*>(userData));
+	ThreadSafeDevices &devices = reinterpret_cast<DBusHciInterface*>(userData)->m_devices;
 
 	ScopedLock<FastMutex> guard(devices.first);
 	Device newDevice(device, handle);
 	devices.second.emplace(newDevice.macAddress(), newDevice);
 }
 
-gboolean DBusHciInterface::onDeviceRSSIChanged(
+gboolean DBusHciInterface::onDevicePropertiesChanged(
 		OrgBluezDevice1* device,
 		GVariant* properties,
 		const gchar* const*,
@@ -478,53 +611,54 @@ gboolean DBusHciInterface::onDeviceRSSIChanged(
 	GVariantIter* iter;
 	const char* property;
 	GVariant* value;
-	ThreadSafeDevices &devices = *(reinterpret_cast<ThreadSafeDevices*>(userData));
+	bool rssiChanged = false;
+	vector<vector<unsigned char>> manufacturerData;
+	DBusHciInterface &self = *(reinterpret_cast<DBusHciInterface*>(userData));
 
 	::g_variant_get(properties, "a{sv}", &iter);
 	while (::g_variant_iter_loop(iter, "{&sv}", &property, &value)) {
-		if (string(property) == "RSSI") {
-			ScopedLock<FastMutex> guard(devices.first);
-			MACAddress mac = MACAddress::parse(::org_bluez_device1_get_address(device), ':');
-			auto it = devices.second.find(mac);
-			if (it != devices.second.end())
-				it->second.updateLastSeen();
-
-			break;
-		}
+		if (string(property) == "RSSI")
+			rssiChanged = true;
+		else if (string(property) == "ManufacturerData")
+			collectManufacturerData(value, manufacturerData);
 	}
+	::g_variant_iter_free(iter);
 
-	return true;
-}
-
-gboolean DBusHciInterface::onDeviceManufacturerDataRecieved(
-		OrgBluezDevice1* device,
-		GVariant* properties,
-		const gchar* const*,
-		gpointer userData)
-{
-	if (::g_variant_n_children(properties) == 0)
+	if (!rssiChanged && manufacturerData.empty())
 		return true;
 
-	GVariantIter* iter;
-	const char* property;
-	GVariant* value;
+	const MACAddress mac = MACAddress::parse(::org_bluez_device1_get_address(device), ':');
 
-	::g_variant_get(properties, "a{sv}", &iter);
-	while (::g_variant_iter_loop(iter, "{&sv}", &property, &value)) {
-		if (string(property) == "ManufacturerData") {
-			processManufacturerData(device, value, userData);
+	if (rssiChanged) {
+		ScopedLock<FastMutex> guard(self.m_devices.first);
+		auto it = self.m_devices.second.find(mac);
+		if (it != self.m_devices.second.end())
+			it->second.updateLastSeen();
+	}
 
-			break;
-		}
+	const char* name = ::org_bluez_device1_get_name(device);
+
+	HciAdvertisement advertisement;
+	advertisement.address = mac;
+	advertisement.name = name == nullptr ? "unknown" : name;
+	advertisement.rssi = ::org_bluez_device1_get_rssi(device);
+
+	if (manufacturerData.empty()) {
+		self.m_advertisements->publish(advertisement);
+		return true;
+	}
+
+	for (auto &data : manufacturerData) {
+		advertisement.manufacturerData = data;
+		self.m_advertisements->publish(advertisement);
 	}
 
 	return true;
 }
 
-void DBusHciInterface::processManufacturerData(
-		OrgBluezDevice1* device,
+void DBusHciInterface::collectManufacturerData(
 		GVariant* value,
-		gpointer userData)
+		vector<vector<unsigned char>> &result)
 {
 	GVariantIter* iter;
 	GVariant* data;
@@ -535,12 +669,9 @@ void DBusHciInterface::processManufacturerData(
 		const unsigned char* tmpData = reinterpret_cast<const unsigned char*>(
 			::g_variant_get_fixed_array(data, &size, sizeof(unsigned char)));
 
-		vector<unsigned char> result(tmpData, tmpData + size);
-		const auto mac = MACAddress::parse(::org_bluez_device1_get_address(device), ':');
-
-		WatchCallback &func = *(reinterpret_cast<WatchCallback*>(userData));
-		func(mac, result);
+		result.emplace_back(tmpData, tmpData + size);
 	}
+	::g_variant_iter_free(iter);
 }
 
 const string DBusHciInterface::createAdapterPath(const string& name)
@@ -627,11 +758,27 @@ int16_t DBusHciInterface::Device::rssi()
 	return ::org_bluez_device1_get_rssi(m_device.raw());
 }
 
+DBusHciInterface::WatchListener::WatchListener(SharedPtr<WatchCallback> callBack):
+	m_callBack(callBack)
+{
+}
+
+void DBusHciInterface::WatchListener::onAdvertisement(
+		const HciAdvertisement &advertisement)
+{
+	if (advertisement.manufacturerData.empty())
+		return;
+
+	vector<unsigned char> data = advertisement.manufacturerData;
+	(*m_callBack)(advertisement.address, data);
+}
+
 
 DBusHciInterfaceManager::DBusHciInterfaceManager():
 	m_leMaxAgeRssi(30 * Timespan::SECONDS),
 	m_leMaxUnavailabilityTime(7 * Timespan::DAYS),
-	m_classicArtificialAvaibilityTimeout(30 * Timespan::SECONDS)
+	m_classicArtificialAvaibilityTimeout(30 * Timespan::SECONDS),
+	m_leConnectionIdleTimeout(0)
 {
 }
 
@@ -661,6 +808,14 @@ void DBusHciInterfaceManager::setClassicArtificialAvaibilityTimeout(const Timesp
 	m_classicArtificialAvaibilityTimeout = time;
 }
 
+void DBusHciInterfaceManager::setLeConnectionIdleTimeout(const Timespan& time)
+{
+	if (time < 0)
+		throw InvalidArgumentException("LE connection idle timeout must not be negative");
+
+	m_leConnectionIdleTimeout = time;
+}
+
 HciInterface::Ptr DBusHciInterfaceManager::lookup(const string &name)
 {
 	ScopedLock<FastMutex> guard(m_mutex);
@@ -673,7 +828,8 @@ HciInterface::Ptr DBusHciInterfaceManager::lookup(const string &name)
 		name,
 		m_leMaxAgeRssi,
 		m_leMaxUnavailabilityTime,
-		m_classicArtificialAvaibilityTimeout);
+		m_classicArtificialAvaibilityTimeout,
+		m_leConnectionIdleTimeout);
 	m_interfaces.emplace(name, newHci);
 	return newHci;
 }
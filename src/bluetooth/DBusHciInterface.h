@@ -13,17 +13,22 @@
 #include <Poco/RunnableAdapter.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Thread.h>
+#include <Poco/Timer.h>
 #include <Poco/Timespan.h>
 #include <Poco/Timestamp.h>
 
+#include "bluetooth/HciAdvertisementStream.h"
 #include "bluetooth/HciInfo.h"
 #include "bluetooth/HciInterface.h"
+#include "bluetooth/DBusHciConnection.h"
 #include "bluetooth/GlibPtr.h"
 #include "bluetooth/org-bluez-adapter1.h"
 #include "bluetooth/org-bluez-device1.h"
 #include "bluetooth/org-bluez-gattcharacteristic1.h"
 #include "net/MACAddress.h"
+#include "util/HashedLock.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 #include "util/WaitCondition.h"
 
 namespace BeeeOn {
@@ -39,6 +44,17 @@ namespace BeeeOn {
  * D-Bus device objects (defined by path "/org/bluez/hci0/dev_FF_FF_FF_FF_FF_FF").
  * The D-Bus device objects provide methods to perform actions as connect, read,
  * write and disconnect.
+ *
+ * The LE discovery is kept running since the interface is brought up. Every
+ * change of RSSI or manufacturer data of a device is published as an advertisement
+ * via the HciAdvertisementStream. Watching of devices is implemented on top of
+ * the stream. The stream remembers advertisements for leMaxAgeRssi. Devices
+ * unavailable for leMaxUnavailabilityTime are removed from BlueZ periodically.
+ *
+ * LE connections are cached and reused by subsequent calls of connect()
+ * until they are idle (no operation was performed with them) for longer
+ * than the connection idle timeout.
+ * Connecting to the same device is serialized.
  */
 class DBusHciInterface : public HciInterface, Loggable {
 public:
@@ -53,14 +69,14 @@ public:
 	 * @brief The class represents the Bluetooth Low Energy device and
 	 * stores necessary data about device such as instance of device,
 	 * handle of signal and timestamp of last rssi update. Also the class
-	 * allows to store necessary data (signal handle, pointer to callback)
+	 * allows to store the listener subscribed to the advertisement stream
 	 * when the device is watched.
 	 */
 	class Device {
 	public:
 		/**
 		 * @param rssiHandle handle of signal on which is connected
-		 * onDeviceRSSIChanged callback.
+		 * onDevicePropertiesChanged callback.
 		 */
 		Device(
 			const GlibPtr<OrgBluezDevice1> device,
@@ -86,28 +102,24 @@ public:
 			return m_lastSeen;
 		}
 
-		uint64_t watchHandle() const
+		HciAdvertisementListener::Ptr watchListener() const
 		{
-			return m_watchHandle;
+			return m_watchListener;
 		}
 
-		void watch(
-			uint64_t watchHandle,
-			Poco::SharedPtr<WatchCallback> callBack)
+		void watch(HciAdvertisementListener::Ptr listener)
 		{
-			m_watchHandle = watchHandle;
-			m_callBack = callBack;
+			m_watchListener = listener;
 		}
 
 		void unwatch()
 		{
-			m_watchHandle = 0;
-			m_callBack = nullptr;
+			m_watchListener = nullptr;
 		}
 
 		bool isWatched() const
 		{
-			return !m_callBack.isNull();
+			return !m_watchListener.isNull();
 		}
 
 		std::string name();
@@ -118,8 +130,7 @@ public:
 		GlibPtr<OrgBluezDevice1> m_device;
 		Poco::Timestamp m_lastSeen;
 		uint64_t m_rssiHandle;
-		uint64_t m_watchHandle;
-		Poco::SharedPtr<WatchCallback> m_callBack;
+		HciAdvertisementListener::Ptr m_watchListener;
 	};
 
 
@@ -131,12 +142,15 @@ public:
 	 * time for device to be deleted
 	 * @param classicArtificialAvaibilityTimeout maximum time from the
 	 * last seen of the device to declare the device is available
+	 * @param leConnectionIdleTimeout time after which an unused LE
+	 * connection is closed, zero disables reusing of connections
 	 */
 	DBusHciInterface(
 		const std::string& name,
 		const Poco::Timespan& leMaxAgeRssi,
 		const Poco::Timespan& leMaxUnavailabilityTime,
-		const Poco::Timespan& classicArtificialAvaibilityTimeout);
+		const Poco::Timespan& classicArtificialAvaibilityTimeout,
+		const Poco::Timespan& leConnectionIdleTimeout = 0);
 	~DBusHciInterface();
 
 	/**
@@ -175,6 +189,10 @@ public:
 	 */
 	HciInfo info() const override;
 
+	/**
+	 * @brief Returns a cached connection to the device if it is still
+	 * connected. Otherwise, a new connection is created and cached.
+	 */
 	HciConnection::Ptr connect(
 		const MACAddress& address,
 		const Poco::Timespan& timeout) const override;
@@ -184,7 +202,23 @@ public:
 		Poco::SharedPtr<WatchCallback> callBack) override;
 	void unwatch(const MACAddress& address) override;
 
+	HciAdvertisementStream::Ptr advertisements() const override;
+
 protected:
+	/**
+	 * @brief Delivers manufacturer data of advertisements of a watched
+	 * device to its WatchCallback.
+	 */
+	class WatchListener : public HciAdvertisementListener {
+	public:
+		WatchListener(Poco::SharedPtr<WatchCallback> callBack);
+
+		void onAdvertisement(const HciAdvertisement &advertisement) override;
+
+	private:
+		Poco::SharedPtr<WatchCallback> m_callBack;
+	};
+
 	/**
 	 * @brief Callback handling the timeout event which stops
 	 * the given GMainLoop.
@@ -194,7 +228,7 @@ protected:
 	/**
 	 * @brief Callback handling the event of creating new device.
 	 * The method adds the new device to m_devices and register
-	 * onDeviceRSSIChanged callback.
+	 * onDevicePropertiesChanged callback.
 	 */
 	static void onDBusObjectAdded(
 		GDBusObjectManager* objectManager,
@@ -202,32 +236,24 @@ protected:
 		gpointer userData);
 
 	/**
-	 * @brief Callback handling the event of RSSI changed. It is used
-	 * to detecting that the device is available.
-	 */
-	static gboolean onDeviceRSSIChanged(
-		OrgBluezDevice1* device,
-		GVariant* properties,
-		const gchar* const* invalidatedProperties,
-		gpointer userData);
-
-	/**
-	 * @brief Callback handling the event of receiving advertising data.
+	 * @brief Callback handling the event of changed properties of
+	 * a device. Change of RSSI is used to detect that the device is
+	 * available. Changes of RSSI and manufacturer data are published
+	 * as advertisements.
 	 */
-	static gboolean onDeviceManufacturerDataRecieved(
+	static gboolean onDevicePropertiesChanged(
 		OrgBluezDevice1* device,
 		GVariant* properties,
 		const gchar* const* invalidatedProperties,
 		gpointer userData);
 
 	/**
-	 * @brief Process the single advertising data and call callback
-	 * stored in userData.
+	 * @brief Extracts all entries of the given ManufacturerData
+	 * property value.
 	 */
-	static void processManufacturerData(
-		OrgBluezDevice1* device,
+	static void collectManufacturerData(
 		GVariant* value,
-		gpointer userData);
+		std::vector<std::vector<unsigned char>> &data);
 
 private:
 	/**
@@ -269,9 +295,22 @@ private:
 
 	/**
 	 * @brief Removes the unavailable devices for specific time except watched devices.
+	 * This method must be always called while holding the m_devices.first.
 	 */
 	void removeUnvailableDevices() const;
 
+	/**
+	 * @brief Removes the unavailable devices periodically because
+	 * lescan() is not called when the advertisements are used instead.
+	 */
+	void onPruneDevices(Poco::Timer &);
+
+	/**
+	 * @brief Closes cached connections that have not been used for
+	 * the connection idle timeout and are not held by anybody else.
+	 */
+	void onSweepConnections(Poco::Timer &);
+
 	/**
 	 * @brief The purpose of the method is to run GMainLoop that handles
 	 * asynchronous events such as add new device during lescan() in separated thread.
@@ -328,6 +367,7 @@ private:
 	GlibPtr<GDBusObjectManager> m_objectManager;
 	uint64_t m_objectManagerHandle;
 	mutable ThreadSafeDevices m_devices;
+	mutable HciAdvertisementStream::Ptr m_advertisements;
 	mutable GlibPtr<OrgBluezAdapter1> m_adapter;
 	Poco::Timespan m_leMaxAgeRssi;
 	Poco::Timespan m_leMaxUnavailabilityTime;
@@ -339,6 +379,20 @@ private:
 	mutable Poco::Condition m_condition;
 	mutable Poco::FastMutex m_statusMutex;
 	mutable Poco::FastMutex m_discoveringMutex;
+
+	Poco::Timespan m_leConnectionIdleTimeout;
+	mutable std::map<MACAddress, DBusHciConnection::Ptr> m_connections;
+	mutable Poco::FastMutex m_connectionsMutex;
+	mutable HashedLock<Poco::FastMutex, MACAddress, std::hash<uint64_t>> m_connectLock;
+	Poco::Timer m_sweepTimer;
+	Poco::TimerCallback<DBusHciInterface> m_sweepCallback;
+	Poco::Timer m_pruneTimer;
+	Poco::TimerCallback<DBusHciInterface> m_pruneCallback;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_connectionsCreatedMetric;
+	CounterMetric::Ptr m_connectionsReusedMetric;
+	GaugeMetric::Ptr m_connectionsOpenMetric;
 };
 
 class DBusHciInterfaceManager : public HciInterfaceManager {
@@ -354,6 +408,12 @@ public:
 	 */
 	void setClassicArtificialAvaibilityTimeout(const Poco::Timespan& time);
 
+	/**
+	 * @brief Sets the time after which an unused LE connection is closed.
+	 * Zero disables reusing of LE connections.
+	 */
+	void setLeConnectionIdleTimeout(const Poco::Timespan& time);
+
 	HciInterface::Ptr lookup(const std::string &name) override;
 
 private:
@@ -362,6 +422,7 @@ private:
 	Poco::Timespan m_leMaxAgeRssi;
 	Poco::Timespan m_leMaxUnavailabilityTime;
 	Poco::Timespan m_classicArtificialAvaibilityTimeout;
+	Poco::Timespan m_leConnectionIdleTimeout;
 };
 
 }
@@ -0,0 +1,180 @@
+#include <algorithm>
+
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+
+#include "bluetooth/HciAdvertisementStream.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+HciAdvertisementListener::~HciAdvertisementListener()
+{
+}
+
+HciAdvertisementStream::HciAdvertisementStream(const Timespan &maxAge):
+	m_maxAge(maxAge)
+{
+	if (maxAge <= 0)
+		throw InvalidArgumentException("maxAge of advertisements must be positive");
+
+	m_receivedMetric = m_metrics.counter("bluetooth.advertisements.received");
+	m_devicesMetric = m_metrics.gauge("bluetooth.advertisements.devices");
+}
+
+void HciAdvertisementStream::subscribe(HciAdvertisementListener::Ptr listener)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_listeners.emplace_back(listener);
+}
+
+void HciAdvertisementStream::subscribe(
+		const MACAddress &address,
+		HciAdvertisementListener::Ptr listener)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_subscriptions.emplace(address, listener);
+}
+
+void HciAdvertisementStream::unsubscribe(HciAdvertisementListener::Ptr listener)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_listeners.remove(listener);
+
+	for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
+		if (it->second == listener)
+			it = m_subscriptions.erase(it);
+		else
+			++it;
+	}
+}
+
+void HciAdvertisementStream::unsubscribe(const MACAddress &address)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_subscriptions.erase(address);
+}
+
+void HciAdvertisementStream::publish(const HciAdvertisement &advertisement)
+{
+	list<HciAdvertisementListener::Ptr> targets;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		auto it = m_last.find(advertisement.address);
+		if (it != m_last.end()) {
+			m_ages.erase(it->second.age);
+			it->second.advertisement = advertisement;
+			it->second.age = m_ages.emplace(advertisement.at, advertisement.address);
+		}
+		else {
+			m_last.emplace(advertisement.address, Last{
+				advertisement,
+				m_ages.emplace(advertisement.at, advertisement.address)});
+		}
+
+		prune();
+
+		targets = m_listeners;
+
+		const auto range = m_subscriptions.equal_range(advertisement.address);
+		for (auto it = range.first; it != range.second; ++it)
+			targets.emplace_back(it->second);
+	}
+
+	m_receivedMetric->add();
+
+	for (auto &listener : targets) {
+		try {
+			listener->onAdvertisement(advertisement);
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	}
+}
+
+void HciAdvertisementStream::restart()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_last.clear();
+	m_ages.clear();
+	m_devicesMetric->set(0);
+	m_started.update();
+}
+
+Timespan HciAdvertisementStream::coverage() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return std::min(Timespan(m_started.elapsed()), m_maxAge);
+}
+
+map<MACAddress, string> HciAdvertisementStream::seen(const Timespan &window) const
+{
+	map<MACAddress, string> devices;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	prune();
+
+	for (const auto &pair : m_last) {
+		const HciAdvertisement &advertisement = pair.second.advertisement;
+
+		if (advertisement.at.isElapsed(window.totalMicroseconds()))
+			continue;
+
+		devices.emplace(pair.first, advertisement.name);
+	}
+
+	return devices;
+}
+
+map<MACAddress, string> HciAdvertisementStream::available() const
+{
+	map<MACAddress, string> devices;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	prune();
+
+	for (const auto &pair : m_last) {
+		const HciAdvertisement &advertisement = pair.second.advertisement;
+
+		if (advertisement.rssi == HciAdvertisement::RSSI_UNAVAILABLE)
+			continue;
+
+		devices.emplace(pair.first, advertisement.name);
+	}
+
+	return devices;
+}
+
+bool HciAdvertisementStream::last(
+		const MACAddress &address,
+		HciAdvertisement &advertisement) const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	auto it = m_last.find(address);
+	if (it == m_last.end())
+		return false;
+
+	advertisement = it->second.advertisement;
+	return true;
+}
+
+void HciAdvertisementStream::prune() const
+{
+	while (!m_ages.empty()) {
+		auto oldest = m_ages.begin();
+		if (!oldest->first.isElapsed(m_maxAge.totalMicroseconds()))
+			break;
+
+		m_last.erase(oldest->second);
+		m_ages.erase(oldest);
+	}
+
+	m_devicesMetric->set(m_last.size());
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
+
+#include "net/MACAddress.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief Single advertisement (or scan response) received from a BLE
+ * device. The manufacturerData are empty when the advertisement does
+ * not carry any. The rssi is RSSI_UNAVAILABLE when unknown.
+ */
+struct HciAdvertisement {
+	static const int16_t RSSI_UNAVAILABLE = 0;
+
+	MACAddress address;
+	std::string name;
+	int16_t rssi;
+	std::vector<unsigned char> manufacturerData;
+	Poco::Timestamp at;
+};
+
+class HciAdvertisementListener {
+public:
+	typedef Poco::SharedPtr<HciAdvertisementListener> Ptr;
+
+	virtual ~HciAdvertisementListener();
+
+	/**
+	 * @brief Called from the thread receiving the advertisements,
+	 * thus it must not block.
+	 */
+	virtual void onAdvertisement(const HciAdvertisement &advertisement) = 0;
+};
+
+/**
+ * @brief HciAdvertisementStream distributes advertisements received by
+ * an always-on LE scan of a HCI interface. Listeners can subscribe for
+ * advertisements of all devices or of a single MAC address.
+ *
+ * The stream remembers the most recent advertisement of each device
+ * for at most maxAge (devices using random or rotating addresses would
+ * grow it without bound otherwise). Thus, availability of devices can
+ * be determined by seen() without running a dedicated scan window as
+ * long as the stream covers the requested period (see coverage()).
+ *
+ * The stream reports metrics bluetooth.advertisements.received (counter)
+ * and bluetooth.advertisements.devices (gauge).
+ */
+class HciAdvertisementStream : Loggable {
+public:
+	typedef Poco::SharedPtr<HciAdvertisementStream> Ptr;
+
+	/**
+	 * @param maxAge how long to remember the last advertisement
+	 * of a device
+	 */
+	HciAdvertisementStream(const Poco::Timespan &maxAge = 1 * Poco::Timespan::HOURS);
+
+	/**
+	 * @brief Subscribe for advertisements of all devices.
+	 */
+	void subscribe(HciAdvertisementListener::Ptr listener);
+
+	/**
+	 * @brief Subscribe for advertisements of the given device.
+	 */
+	void subscribe(
+		const MACAddress &address,
+		HciAdvertisementListener::Ptr listener);
+
+	/**
+	 * @brief Remove all subscriptions of the given listener.
+	 */
+	void unsubscribe(HciAdvertisementListener::Ptr listener);
+
+	/**
+	 * @brief Remove all subscriptions for the given device.
+	 */
+	void unsubscribe(const MACAddress &address);
+
+	/**
+	 * @brief Remember the given advertisement and deliver it
+	 * to the subscribed listeners.
+	 */
+	void publish(const HciAdvertisement &advertisement);
+
+	/**
+	 * @brief Forget all remembered advertisements. It should be called
+	 * when the underlying scan (re)starts.
+	 */
+	void restart();
+
+	/**
+	 * @returns time elapsed since the last restart() but at most maxAge
+	 */
+	Poco::Timespan coverage() const;
+
+	/**
+	 * @returns devices that have advertised within the given window
+	 * mapped to their names
+	 */
+	std::map<MACAddress, std::string> seen(const Poco::Timespan &window) const;
+
+	/**
+	 * @returns devices considered available mapped to their names,
+	 * i.e. devices that have advertised within maxAge with a known RSSI.
+	 * The RSSI of a stationary device might stay the same for a long
+	 * time, so no new advertisement is published for it.
+	 */
+	std::map<MACAddress, std::string> available() const;
+
+	/**
+	 * @brief Find the most recent advertisement of the given device.
+	 * @returns false if no advertisement is remembered
+	 */
+	bool last(const MACAddress &address, HciAdvertisement &advertisement) const;
+
+protected:
+	typedef std::multimap<Poco::Timestamp, MACAddress> AgeIndex;
+
+	struct Last {
+		HciAdvertisement advertisement;
+		AgeIndex::iterator age;
+	};
+
+	/**
+	 * @brief Forget advertisements older than maxAge. This method
+	 * must be always called while holding the m_lock.
+	 */
+	void prune() const;
+
+private:
+	Poco::Timespan m_maxAge;
+	std::list<HciAdvertisementListener::Ptr> m_listeners;
+	std::multimap<MACAddress, HciAdvertisementListener::Ptr> m_subscriptions;
+	mutable std::map<MACAddress, Last> m_last;
+	mutable AgeIndex m_ages;
+	Poco::Timestamp m_started;
+	mutable Poco::FastMutex m_lock;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_receivedMetric;
+	mutable GaugeMetric::Ptr m_devicesMetric;
+};
+
+}
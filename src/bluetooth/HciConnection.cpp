@@ -1,7 +1,41 @@
 #include "bluetooth/HciConnection.h"
 
 using namespace BeeeOn;
+using namespace Poco;
+using namespace std;
+
+HciConnection::Request HciConnection::Request::read(const UUID& uuid)
+{
+	return {READ, uuid, {}};
+}
+
+HciConnection::Request HciConnection::Request::write(
+		const UUID& uuid,
+		const vector<unsigned char>& value)
+{
+	return {WRITE, uuid, value};
+}
 
 HciConnection::~HciConnection()
 {
 }
+
+vector<vector<unsigned char>> HciConnection::execute(
+		const vector<Request>& requests)
+{
+	vector<vector<unsigned char>> results;
+
+	for (const auto &request : requests) {
+		switch (request.operation) {
+		case Request::READ:
+			results.emplace_back(read(request.uuid));
+			break;
+		case Request::WRITE:
+			write(request.uuid, request.value);
+			results.emplace_back();
+			break;
+		}
+	}
+
+	return results;
+}
@@ -17,6 +17,25 @@ class HciConnection {
 public:
 	typedef Poco::SharedPtr<HciConnection> Ptr;
 
+	/**
+	 * @brief Single read or write request to be executed via execute().
+	 */
+	struct Request {
+		enum Operation {
+			READ,
+			WRITE,
+		};
+
+		Operation operation;
+		Poco::UUID uuid;
+		std::vector<unsigned char> value;
+
+		static Request read(const Poco::UUID& uuid);
+		static Request write(
+			const Poco::UUID& uuid,
+			const std::vector<unsigned char>& value);
+	};
+
 	virtual ~HciConnection();
 
 	/**
@@ -53,6 +72,20 @@ public:
 		const Poco::UUID& writeUuid,
 		const std::vector<unsigned char>& value,
 		const Poco::Timespan& notifyTimeout) = 0;
+
+	/**
+	 * @brief Executes the given requests in the given order on this
+	 * connection. Implementations may pipeline the requests (send all
+	 * of them before waiting for the responses). The default
+	 * implementation executes them one by one via read() and write().
+	 * @returns values read by the requests, a written request results
+	 * in an empty value
+	 * @throws IOException in case of a failure of any request
+	 * @throws NotFoundException when a characteristic not found
+	 * @throws TimeoutException when the requests are not finished in time
+	 */
+	virtual std::vector<std::vector<unsigned char>> execute(
+		const std::vector<Request>& requests);
 };
 
 }
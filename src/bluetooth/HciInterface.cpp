@@ -6,6 +6,11 @@ HciInterface::~HciInterface()
 {
 }
 
+HciAdvertisementStream::Ptr HciInterface::advertisements() const
+{
+	return nullptr;
+}
+
 HciInterfaceManager::~HciInterfaceManager()
 {
 }
@@ -7,6 +7,7 @@
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
 
+#include "bluetooth/HciAdvertisementStream.h"
 #include "bluetooth/HciConnection.h"
 #include "bluetooth/HciInfo.h"
 #include "net/MACAddress.h"
@@ -82,6 +83,13 @@ public:
 	 * Unregister device to process advertising data.
 	 */
 	virtual void unwatch(const MACAddress& address) = 0;
+
+	/**
+	 * Stream of advertisements received by an always-on LE scan.
+	 * @return the stream or null when the interface does not
+	 * support continuous scanning
+	 */
+	virtual HciAdvertisementStream::Ptr advertisements() const;
 };
 
 class HciInterfaceManager {
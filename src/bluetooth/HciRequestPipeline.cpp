@@ -0,0 +1,115 @@
+#include <map>
+
+#include <Poco/Exception.h>
+
+#include "bluetooth/HciRequestPipeline.h"
+
+using namespace BeeeOn;
+using namespace Poco;
+using namespace std;
+
+HciRequestPipeline::HciRequestPipeline(
+		const vector<HciConnection::Request>& requests):
+	m_requests(requests),
+	m_next(requests.size(), requests.size()),
+	m_remaining(requests.size()),
+	m_results(requests.size())
+{
+	map<string, size_t> last;
+
+	for (size_t i = 0; i < m_requests.size(); ++i) {
+		const string uuid = m_requests[i].uuid.toString();
+
+		auto it = last.find(uuid);
+		if (it != last.end())
+			m_next[it->second] = i;
+
+		last[uuid] = i;
+	}
+
+	if (m_requests.empty())
+		m_done.set();
+}
+
+HciRequestPipeline::~HciRequestPipeline()
+{
+}
+
+size_t HciRequestPipeline::size() const
+{
+	return m_requests.size();
+}
+
+const HciConnection::Request& HciRequestPipeline::request(size_t index) const
+{
+	return m_requests.at(index);
+}
+
+vector<size_t> HciRequestPipeline::first() const
+{
+	vector<bool> following(m_requests.size(), false);
+
+	for (const auto index : m_next) {
+		if (index < following.size())
+			following[index] = true;
+	}
+
+	vector<size_t> indexes;
+
+	for (size_t i = 0; i < following.size(); ++i) {
+		if (!following[i])
+			indexes.emplace_back(i);
+	}
+
+	return indexes;
+}
+
+size_t HciRequestPipeline::next(size_t index) const
+{
+	return m_next.at(index);
+}
+
+size_t HciRequestPipeline::finish(
+		size_t index,
+		const vector<unsigned char>& value,
+		const string& error)
+{
+	ScopedLock<FastMutex> guard(m_lock);
+
+	m_results.at(index) = value;
+
+	if (!error.empty() && m_error.empty()) {
+		m_error = error;
+		m_done.set();
+	}
+
+	if (--m_remaining == 0)
+		m_done.set();
+
+	return m_error.empty() ? m_next[index] : m_requests.size();
+}
+
+void HciRequestPipeline::fail(const string& error)
+{
+	ScopedLock<FastMutex> guard(m_lock);
+
+	if (m_error.empty())
+		m_error = error;
+
+	m_done.set();
+}
+
+bool HciRequestPipeline::wait(const Timespan& timeout)
+{
+	return m_done.tryWait(timeout.totalMilliseconds());
+}
+
+vector<vector<unsigned char>> HciRequestPipeline::results() const
+{
+	ScopedLock<FastMutex> guard(m_lock);
+
+	if (!m_error.empty())
+		throw IOException(m_error);
+
+	return m_results;
+}
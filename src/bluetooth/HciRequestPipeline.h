@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Poco/Event.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "bluetooth/HciConnection.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief HciRequestPipeline holds the state of requests executed
+ * asynchronously by HciConnection::execute(). Requests to different
+ * characteristics can overlap while requests to the same characteristic
+ * are sent one after another in the given order.
+ *
+ * The requests returned by first() are to be sent immediately. When
+ * a request finishes, the request returned by finish() is to be sent.
+ * No more requests are sent after a failure. The instance must outlive
+ * the caller of execute() because pending requests can finish after
+ * the caller has given up waiting.
+ */
+class HciRequestPipeline {
+public:
+	typedef Poco::SharedPtr<HciRequestPipeline> Ptr;
+
+	HciRequestPipeline(const std::vector<HciConnection::Request>& requests);
+	virtual ~HciRequestPipeline();
+
+	size_t size() const;
+	const HciConnection::Request& request(size_t index) const;
+
+	/**
+	 * @returns indexes of the first request to each characteristic
+	 */
+	std::vector<size_t> first() const;
+
+	/**
+	 * @returns index of the next request to the same characteristic
+	 * as the given one or size() if there is none
+	 */
+	size_t next(size_t index) const;
+
+	/**
+	 * @brief Record result of the request at the given index.
+	 * The error is empty on success. The pipeline is done when
+	 * all requests finish or on the first error.
+	 * @returns index of the request to be sent now or size()
+	 * if there is none or the pipeline has failed
+	 */
+	size_t finish(
+		size_t index,
+		const std::vector<unsigned char>& value,
+		const std::string& error);
+
+	/**
+	 * @brief Fail the pipeline (e.g. on timeout) to prevent sending
+	 * of the rest of requests.
+	 */
+	void fail(const std::string& error);
+
+	/**
+	 * @returns false if the pipeline is not done within the timeout
+	 */
+	bool wait(const Poco::Timespan& timeout);
+
+	/**
+	 * @returns results of the requests in the given order
+	 * @throws IOException if any of the requests has failed
+	 */
+	std::vector<std::vector<unsigned char>> results() const;
+
+private:
+	const std::vector<HciConnection::Request> m_requests;
+	std::vector<size_t> m_next;
+
+	mutable Poco::FastMutex m_lock;
+	Poco::Event m_done;
+	size_t m_remaining;
+	std::vector<std::vector<unsigned char>> m_results;
+	std::string m_error;
+};
+
+}
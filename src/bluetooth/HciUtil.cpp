@@ -1,6 +1,7 @@
 #include "bluetooth/HciUtil.h"
 
 using namespace std;
+using namespace Poco;
 using namespace BeeeOn;
 
 string HciUtil::hotplugMatch(const HotplugEvent &e)
@@ -15,3 +16,15 @@ string HciUtil::hotplugMatch(const HotplugEvent &e)
 
 	return e.name();
 }
+
+map<MACAddress, string> HciUtil::leDevices(
+		const HciInterface &hci,
+		const Timespan &window)
+{
+	HciAdvertisementStream::Ptr stream = hci.advertisements();
+
+	if (!stream.isNull() && stream->coverage() >= window)
+		return stream->available();
+
+	return hci.lescan(window);
+}
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <map>
 #include <string>
 
+#include <Poco/Timespan.h>
+
+#include "bluetooth/HciInterface.h"
 #include "hotplug/HotplugEvent.h"
+#include "net/MACAddress.h"
 
 namespace BeeeOn {
 
@@ -14,6 +19,17 @@ public:
 	 * an empty string.
 	 */
 	static std::string hotplugMatch(const HotplugEvent &event);
+
+	/**
+	 * @brief Returns available LE devices. If the advertisement stream
+	 * of the interface covers the given window, no scan is performed
+	 * and the devices are taken from the stream with the same freshness
+	 * rule as lescan() uses (see HciAdvertisementStream::available()).
+	 * Otherwise, it falls back to lescan() for the given window.
+	 */
+	static std::map<MACAddress, std::string> leDevices(
+		const HciInterface &hci,
+		const Poco::Timespan &window);
 };
 
 }
@@ -162,8 +162,10 @@ void TabuLumenSmartLite::writeData(
 	vector<unsigned char> authMsg = authorizationMessage();
 
 	HciConnection::Ptr conn = hci->connect(m_address, m_timeout);
-	conn->write(WRITE_VALUES, authMsg);
-	conn->write(WRITE_VALUES, data);
+	conn->execute({
+		HciConnection::Request::write(WRITE_VALUES, authMsg),
+		HciConnection::Request::write(WRITE_VALUES, data),
+	});
 }
 
 vector<uint8_t> TabuLumenSmartLite::authorizationMessage() const
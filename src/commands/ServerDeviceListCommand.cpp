@@ -18,6 +18,16 @@ DevicePrefix ServerDeviceListCommand::devicePrefix() const
 	return m_prefix;
 }
 
+void ServerDeviceListCommand::setKnownVersion(const string &version)
+{
+	m_knownVersion = version;
+}
+
+string ServerDeviceListCommand::knownVersion() const
+{
+	return m_knownVersion;
+}
+
 string ServerDeviceListCommand::toString() const
 {
 	return name() + " " +  m_prefix.toString();
@@ -19,6 +19,14 @@ public:
 
 	DevicePrefix devicePrefix() const;
 
+	/**
+	 * @brief Set version of the device list already known by
+	 * the sender. Handlers supporting incremental synchronization
+	 * might respond with ServerDeviceListResult::unchanged() then.
+	 */
+	void setKnownVersion(const std::string &version);
+	std::string knownVersion() const;
+
 	std::string toString() const override;
 
 protected:
@@ -26,6 +34,7 @@ protected:
 
 private:
 	DevicePrefix m_prefix;
+	std::string m_knownVersion;
 };
 
 }
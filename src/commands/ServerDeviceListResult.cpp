@@ -6,7 +6,8 @@ using namespace std;
 
 ServerDeviceListResult::ServerDeviceListResult(
 		const Answer::Ptr answer):
-	Result(answer)
+	Result(answer),
+	m_unchanged(false)
 {
 }
 
@@ -69,3 +70,31 @@ Nullable<double> ServerDeviceListResult::value(
 	result = mit->second;
 	return result;
 }
+
+void ServerDeviceListResult::setVersion(const string &version)
+{
+	ScopedLock guard(*this);
+
+	m_version = version;
+}
+
+string ServerDeviceListResult::version() const
+{
+	ScopedLock guard(const_cast<ServerDeviceListResult &>(*this));
+
+	return m_version;
+}
+
+void ServerDeviceListResult::setUnchanged(bool unchanged)
+{
+	ScopedLock guard(*this);
+
+	m_unchanged = unchanged;
+}
+
+bool ServerDeviceListResult::unchanged() const
+{
+	ScopedLock guard(const_cast<ServerDeviceListResult &>(*this));
+
+	return m_unchanged;
+}
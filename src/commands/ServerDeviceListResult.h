@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <Poco/Mutex.h>
@@ -33,11 +34,28 @@ public:
 
 	Poco::Nullable<double> value(const DeviceID &id, const ModuleID &module) const;
 
+	/**
+	 * @brief Version of the device list as reported by the server.
+	 * It is empty when the server does not support versioning.
+	 */
+	void setVersion(const std::string &version);
+	std::string version() const;
+
+	/**
+	 * @brief Denote that the device list has not changed since
+	 * the version given by ServerDeviceListCommand::knownVersion().
+	 * The result contains no devices in such case.
+	 */
+	void setUnchanged(bool unchanged);
+	bool unchanged() const;
+
 protected:
 	~ServerDeviceListResult();
 
 private:
 	DeviceValues m_data;
+	std::string m_version;
+	bool m_unchanged;
 };
 
 }
@@ -8,6 +8,11 @@
 
 using namespace BeeeOn;
 
+AbstractDistributor::AbstractDistributor():
+	m_exported(m_metrics.counter("distributor.exported"))
+{
+}
+
 void AbstractDistributor::registerExporter(Poco::SharedPtr<Exporter> exporter)
 {
 	poco_debug(logger(), "registering new exporter");
@@ -16,9 +21,23 @@ void AbstractDistributor::registerExporter(Poco::SharedPtr<Exporter> exporter)
 
 void AbstractDistributor::notifyListeners(const SensorData &data)
 {
+	m_exported->add();
 	m_eventSource.fireEvent(data, &DistributorListener::onExport);
 }
 
+const SensorData *AbstractDistributor::applyFilter(
+		const SensorData &data,
+		SensorData &filtered)
+{
+	if (m_filter.isNull())
+		return &data;
+
+	if (!m_filter->apply(data, filtered))
+		return nullptr;
+
+	return &filtered;
+}
+
 void AbstractDistributor::registerListener(DistributorListener::Ptr listener)
 {
 	m_eventSource.addListener(listener);
@@ -28,3 +47,8 @@ void AbstractDistributor::setExecutor(AsyncExecutor::Ptr executor)
 {
 	m_eventSource.setAsyncExecutor(executor);
 }
+
+void AbstractDistributor::setFilter(SensorDataFilter::Ptr filter)
+{
+	m_filter = filter;
+}
@@ -6,8 +6,10 @@
 
 #include "core/Distributor.h"
 #include "core/DistributorListener.h"
+#include "core/SensorDataFilter.h"
 #include "util/EventSource.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
@@ -16,6 +18,8 @@ class SensorData;
 
 class AbstractDistributor : public Distributor, public Loggable {
 public:
+	AbstractDistributor();
+
 	/*
 	 * Register exporter. Received messages are resent to
 	 * all registered exporters.
@@ -30,15 +34,35 @@ public:
 	 */
 	void setExecutor(AsyncExecutor::Ptr executor);
 
+	/*
+	 * Set filter applied to data before passing them to exporters.
+	 * Listeners are notified about unfiltered data.
+	 */
+	void setFilter(SensorDataFilter::Ptr filter);
+
 protected:
 	/*
 	 * Notify registered listeners by calling onExport() method.
 	 * This is supposed to be called at the beginning of Distributor::export().
+	 * It also updates the distributor.exported metric.
 	 */
 	void notifyListeners(const SensorData &data);
 
+	/*
+	 * Apply the configured filter (if any) on the given data.
+	 * Returns a pointer to the data to be exported (either the
+	 * given data or the filtered) or nullptr when nothing is left
+	 * to be exported.
+	 */
+	const SensorData *applyFilter(const SensorData &data, SensorData &filtered);
+
 	std::vector<Poco::SharedPtr<Exporter>> m_exporters;
 	EventSource<DistributorListener> m_eventSource;
+
+private:
+	SensorDataFilter::Ptr m_filter;
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_exported;
 };
 
 }
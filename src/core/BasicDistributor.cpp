@@ -16,6 +16,7 @@ BEEEON_OBJECT_CASTABLE(Distributor)
 BEEEON_OBJECT_PROPERTY("exporters", &BasicDistributor::registerExporter)
 BEEEON_OBJECT_PROPERTY("listeners", &BasicDistributor::registerListener)
 BEEEON_OBJECT_PROPERTY("eventsExecutor", &BasicDistributor::setExecutor)
+BEEEON_OBJECT_PROPERTY("filter", &BasicDistributor::setFilter)
 BEEEON_OBJECT_END(BeeeOn, BasicDistributor)
 
 using namespace BeeeOn;
@@ -26,9 +27,14 @@ void BasicDistributor::exportData(const SensorData &sensorData)
 
 	notifyListeners(sensorData);
 
+	SensorData filtered;
+	const SensorData *data = applyFilter(sensorData, filtered);
+	if (data == nullptr)
+		return;
+
 	for (Poco::SharedPtr<Exporter> exporter : m_exporters) {
 		try {
-			exporter->ship(sensorData);
+			exporter->ship(*data);
 			poco_debug(logger(), "Data shipped successfully");
 
 		} catch (Poco::Exception &ex) {
@@ -17,7 +17,12 @@ using namespace Poco;
 using namespace BeeeOn;
 
 DevicePoller::DevicePoller():
-	m_warnThreshold(1 * Timespan::SECONDS)
+	m_warnThreshold(1 * Timespan::SECONDS),
+	m_polls(m_metrics.counter("poller.polls")),
+	m_failures(m_metrics.counter("poller.failures")),
+	m_overruns(m_metrics.counter("poller.overruns")),
+	m_pollDuration(m_metrics.histogram("poller.poll_us",
+		{1000, 10000, 100000, 1000000, 10000000}))
 {
 }
 
@@ -204,7 +209,7 @@ Timespan DevicePoller::pollNextIfOnSchedule(const Clock &now)
 
 void DevicePoller::doPoll(PollableDevice::Ptr device)
 {
-	m_pollExecutor->invoke([&, device]() mutable {
+	auto task = [&, device]() mutable {
 		const Clock started;
 
 		if (logger().debug()) {
@@ -216,12 +221,17 @@ void DevicePoller::doPoll(PollableDevice::Ptr device)
 		try {
 			device->poll(m_distributor);
 		}
-		BEEEON_CATCH_CHAIN(logger())
+		BEEEON_CATCH_CHAIN_ACTION(logger(), m_failures->add())
 
 		const Timespan elapsed = started.elapsed();
 		const auto diff = elapsed - device->refresh();
 
+		m_polls->add();
+		m_pollDuration->observe(elapsed.totalMicroseconds());
+
 		if (diff > m_warnThreshold) {
+			m_overruns->add();
+
 			logger().warning(
 				"polling of " + device->id().toString()
 				+ " took too long ("
@@ -233,7 +243,12 @@ void DevicePoller::doPoll(PollableDevice::Ptr device)
 		}
 
 		reschedule(device);
-	});
+	};
+
+	m_pollExecutor->invoke(
+		device->id().prefix().toString(),
+		device->refresh().time(),
+		task);
 }
 
 void DevicePoller::stop()
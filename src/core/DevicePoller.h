@@ -10,6 +10,7 @@
 #include "loop/StopControl.h"
 #include "util/AsyncExecutor.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
@@ -18,6 +19,10 @@ namespace BeeeOn {
  * Any number of devices can be scheduled for regular polling of
  * their state. Each device can be scheduled according to its
  * refresh time and later cancelled from being polled.
+ *
+ * The DevicePoller maintains metrics poller.polls, poller.failures,
+ * poller.overruns (polls exceeding the refresh time by more than
+ * the warnThreshold) and poller.poll_us (histogram of poll durations).
  */
 class DevicePoller : public StoppableRunnable, Loggable {
 public:
@@ -106,6 +111,10 @@ protected:
 	 * @brief Invoke the PollableDevice::poll() method via the configured
 	 * m_pollExecutor. Thus, the poll() is usually called asynchronously
 	 * and it can be parallelized with other devices.
+	 *
+	 * The poll is passed together with the device's prefix as its group
+	 * and the device's refresh time as its time budget. Executors like
+	 * PrefixPollExecutor use them to schedule the poll.
 	 */
 	void doPoll(PollableDevice::Ptr device);
 
@@ -121,6 +130,12 @@ private:
 	Poco::FastMutex m_lock;
 
 	StopControl m_stopControl;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_polls;
+	CounterMetric::Ptr m_failures;
+	CounterMetric::Ptr m_overruns;
+	HistogramMetric::Ptr m_pollDuration;
 };
 
 }
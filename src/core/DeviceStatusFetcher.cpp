@@ -12,6 +12,8 @@ BEEEON_OBJECT_CASTABLE(StoppableRunnable)
 BEEEON_OBJECT_PROPERTY("idleDuration", &DeviceStatusFetcher::setIdleDuration)
 BEEEON_OBJECT_PROPERTY("waitTimeout", &DeviceStatusFetcher::setWaitTimeout)
 BEEEON_OBJECT_PROPERTY("repeatTimeout", &DeviceStatusFetcher::setRepeatTimeout)
+BEEEON_OBJECT_PROPERTY("refreshPeriod", &DeviceStatusFetcher::setRefreshPeriod)
+BEEEON_OBJECT_PROPERTY("incremental", &DeviceStatusFetcher::setIncremental)
 BEEEON_OBJECT_PROPERTY("commandDispatcher", &DeviceStatusFetcher::setCommandDispatcher)
 BEEEON_OBJECT_PROPERTY("handlers", &DeviceStatusFetcher::registerHandler)
 BEEEON_OBJECT_HOOK("cleanup", &DeviceStatusFetcher::clearHandlers)
@@ -37,7 +39,8 @@ DevicePrefix DeviceStatusFetcher::PrefixAnswer::prefix() const
 DeviceStatusFetcher::PrefixStatus::PrefixStatus():
 	m_lastRequested(0),
 	m_started(false),
-	m_successful(false)
+	m_successful(false),
+	m_delivered(false)
 {
 }
 
@@ -72,10 +75,58 @@ bool DeviceStatusFetcher::PrefixStatus::shouldRepeat(
 	return true;
 }
 
+bool DeviceStatusFetcher::PrefixStatus::shouldRefresh(
+		const Timespan &refreshPeriod) const
+{
+	if (!m_successful || refreshPeriod <= 0)
+		return false;
+
+	return m_lastRequested.isElapsed(refreshPeriod.totalMicroseconds());
+}
+
+void DeviceStatusFetcher::PrefixStatus::restart()
+{
+	m_started = false;
+	m_successful = false;
+}
+
+Timespan DeviceStatusFetcher::PrefixStatus::sinceRequested() const
+{
+	return m_lastRequested.elapsed();
+}
+
+void DeviceStatusFetcher::PrefixStatus::setVersion(const string &version)
+{
+	m_version = version;
+}
+
+string DeviceStatusFetcher::PrefixStatus::version() const
+{
+	return m_version;
+}
+
+void DeviceStatusFetcher::PrefixStatus::deliverPaired(const set<DeviceID> &paired)
+{
+	m_paired = paired;
+	m_delivered = true;
+}
+
+const set<DeviceID> &DeviceStatusFetcher::PrefixStatus::paired() const
+{
+	return m_paired;
+}
+
+bool DeviceStatusFetcher::PrefixStatus::delivered() const
+{
+	return m_delivered;
+}
+
 DeviceStatusFetcher::DeviceStatusFetcher():
 	m_idleDuration(30 * Timespan::MINUTES),
 	m_waitTimeout(1 * Timespan::SECONDS),
-	m_repeatTimeout(5 * Timespan::MINUTES)
+	m_repeatTimeout(5 * Timespan::MINUTES),
+	m_refreshPeriod(0),
+	m_incremental(false)
 {
 }
 
@@ -103,6 +154,19 @@ void DeviceStatusFetcher::setRepeatTimeout(const Timespan &timeout)
 	m_repeatTimeout = timeout;
 }
 
+void DeviceStatusFetcher::setRefreshPeriod(const Timespan &period)
+{
+	if (period < 0)
+		throw InvalidArgumentException("refreshPeriod must not be negative");
+
+	m_refreshPeriod = period;
+}
+
+void DeviceStatusFetcher::setIncremental(bool incremental)
+{
+	m_incremental = incremental;
+}
+
 void DeviceStatusFetcher::registerHandler(DeviceStatusHandler::Ptr handler)
 {
 	auto result = m_handlers.emplace(handler->prefix(), set<DeviceStatusHandler::Ptr>{handler});
@@ -131,6 +195,9 @@ DeviceStatusFetcher::FetchStatus DeviceStatusFetcher::fetchUndone()
 		const auto &prefix = pair.first;
 		auto &status = pair.second;
 
+		if (status.shouldRefresh(m_refreshPeriod))
+			status.restart();
+
 		if (!status.needsRequest()) {
 			if (status.shouldRepeat(m_repeatTimeout))
 				wouldRepeat = true;
@@ -144,9 +211,13 @@ DeviceStatusFetcher::FetchStatus DeviceStatusFetcher::fetchUndone()
 		}
 
 		ServerDeviceListCommand::Ptr cmd = new ServerDeviceListCommand(prefix);
+		if (m_incremental)
+			cmd->setKnownVersion(status.version());
+
 		dispatch(cmd, new PrefixAnswer(answerQueue(), prefix));
 
 		status.startRequest();
+		recordRequest(prefix);
 		started = true;
 	}
 
@@ -214,7 +285,11 @@ void DeviceStatusFetcher::run()
 						__FILE__, __LINE__);
 				}
 
-				run.waitStoppable(m_idleDuration);
+				if (m_refreshPeriod > 0 && m_refreshPeriod < m_idleDuration)
+					run.waitStoppable(m_refreshPeriod);
+				else
+					run.waitStoppable(m_idleDuration);
+
 				continue;
 			}
 			break;
@@ -276,7 +351,12 @@ void DeviceStatusFetcher::processAnswer(
 		PrefixAnswer::Ptr answer,
 		set<DeviceStatusHandler::Ptr> handlers)
 {
+	auto status = m_status.find(answer->prefix());
+	poco_assert(status != m_status.end()); // it MUST be there
+
 	set<DeviceID> paired;
+	string version;
+	size_t received = 0;
 	bool failed = false;
 	bool success = false;
 
@@ -305,12 +385,23 @@ void DeviceStatusFetcher::processAnswer(
 			continue;
 		}
 
-		collectPaired(paired, data->deviceList(), answer->prefix());
-	}
+		if (version.empty())
+			version = data->version();
 
-	auto status = m_status.find(answer->prefix());
-	poco_assert(status != m_status.end()); // it MUST be there
+		if (data->unchanged()) {
+			// the list is the same as the last delivered one
+			const auto &last = status->second.paired();
+			paired.insert(last.begin(), last.end());
+			continue;
+		}
+
+		const auto list = data->deviceList();
+		received += list.size();
 
+		collectPaired(paired, list, answer->prefix());
+	}
+
+	const Timespan latency = status->second.sinceRequested();
 	status->second.deliverResponse(!failed);
 
 	if (success && failed) {
@@ -325,8 +416,25 @@ void DeviceStatusFetcher::processAnswer(
 	if (!success)
 		return;
 
+	if (!failed)
+		status->second.setVersion(version);
+
+	if (m_incremental && status->second.delivered()
+			&& status->second.paired() == paired) {
+		if (logger().debug()) {
+			logger().debug("remote status of " + answer->prefix().toString()
+				+ " is unchanged", __FILE__, __LINE__);
+		}
+
+		recordResponse(answer->prefix(), latency, received, false);
+		return;
+	}
+
 	logger().information("delivering remote status of " + answer->prefix().toString());
 
+	status->second.deliverPaired(paired);
+	recordResponse(answer->prefix(), latency, received, true);
+
 	for (auto handler : handlers) {
 		try {
 			handler->handleRemoteStatus(answer->prefix(), paired, {});
@@ -335,6 +443,74 @@ void DeviceStatusFetcher::processAnswer(
 	}
 }
 
+DeviceStatusFetcher::SyncMetrics &DeviceStatusFetcher::syncMetrics(
+		const DevicePrefix &prefix)
+{
+	auto it = m_syncMetrics.find(prefix);
+	if (it != m_syncMetrics.end())
+		return it->second;
+
+	const string name = "fetcher." + prefix.toString();
+
+	SyncMetrics &metrics = m_syncMetrics[prefix];
+	metrics.requests = m_metrics.counter(name + ".requests");
+	metrics.unchanged = m_metrics.counter(name + ".unchanged");
+	metrics.delivered = m_metrics.counter(name + ".delivered");
+	metrics.latency = m_metrics.histogram(name + ".latency_us",
+		{10000, 100000, 1000000, 10000000});
+	metrics.devices = m_metrics.histogram(name + ".devices",
+		{0, 10, 100, 1000, 10000});
+
+	return metrics;
+}
+
+void DeviceStatusFetcher::recordRequest(const DevicePrefix &prefix)
+{
+	FastMutex::ScopedLock guard(m_statsLock);
+
+	auto result = m_stats.emplace(prefix, SyncStats{0, 0, 0, 0, 0, 0});
+	result.first->second.requests += 1;
+
+	syncMetrics(prefix).requests->add();
+}
+
+void DeviceStatusFetcher::recordResponse(
+		const DevicePrefix &prefix,
+		const Timespan &latency,
+		size_t devices,
+		bool delivered)
+{
+	FastMutex::ScopedLock guard(m_statsLock);
+
+	auto result = m_stats.emplace(prefix, SyncStats{0, 0, 0, 0, 0, 0});
+	SyncStats &stats = result.first->second;
+	SyncMetrics &metrics = syncMetrics(prefix);
+
+	stats.lastDevices = devices;
+	stats.lastLatency = latency;
+
+	if (latency > stats.maxLatency)
+		stats.maxLatency = latency;
+
+	if (delivered) {
+		stats.delivered += 1;
+		metrics.delivered->add();
+	}
+	else {
+		stats.unchanged += 1;
+		metrics.unchanged->add();
+	}
+
+	metrics.latency->observe(latency.totalMicroseconds());
+	metrics.devices->observe(devices);
+}
+
+map<DevicePrefix, DeviceStatusFetcher::SyncStats> DeviceStatusFetcher::syncStats() const
+{
+	FastMutex::ScopedLock guard(m_statsLock);
+	return m_stats;
+}
+
 void DeviceStatusFetcher::collectPaired(
 		std::set<DeviceID> &paired,
 		const std::vector<DeviceID> &received,
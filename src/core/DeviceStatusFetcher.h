@@ -2,8 +2,10 @@
 
 #include <map>
 #include <set>
+#include <string>
 
 #include <Poco/Clock.h>
+#include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
 
@@ -12,6 +14,7 @@
 #include "loop/StoppableRunnable.h"
 #include "loop/StopControl.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
@@ -20,6 +23,14 @@ namespace BeeeOn {
  * devices for the registered status handlers. The fetching is performed
  * asynchronously and independently resulting in calling to the method
  * DeviceStatusHandler::handleRemoteStatus() on the appropriate handlers.
+ *
+ * When the refreshPeriod is set, the paired devices are re-fetched
+ * periodically. In the incremental mode, the fetcher sends the version
+ * of the list it already knows (as received from the server) and the
+ * server may respond that the list is unchanged without sending it
+ * again. Lists equal to the last delivered one are not delivered to the
+ * handlers again. The synchronization statistics per prefix are available
+ * via syncStats() and as metrics fetcher.<prefix>.*.
  */
 class DeviceStatusFetcher :
 	public CommandSender,
@@ -28,6 +39,15 @@ class DeviceStatusFetcher :
 public:
 	typedef Poco::SharedPtr<DeviceStatusFetcher> Ptr;
 
+	struct SyncStats {
+		uint64_t requests;
+		uint64_t unchanged;
+		uint64_t delivered;
+		size_t lastDevices;
+		Poco::Timespan lastLatency;
+		Poco::Timespan maxLatency;
+	};
+
 	DeviceStatusFetcher();
 
 	/**
@@ -46,6 +66,19 @@ public:
 	 */
 	void setRepeatTimeout(const Poco::Timespan &timeout);
 
+	/**
+	 * @brief Set period of re-fetching the paired devices after
+	 * a successful fetch. Zero disables the periodic re-fetching.
+	 */
+	void setRefreshPeriod(const Poco::Timespan &period);
+
+	/**
+	 * @brief Enable the incremental synchronization mode. It sends the
+	 * known version of the list with each request and it does not
+	 * deliver lists equal to the last delivered one.
+	 */
+	void setIncremental(bool incremental);
+
 	/**
 	 * @brief Register the given device status handler. The DeviceStatusFetcher
 	 * would request a remote pairing registry (server) for the paired devices
@@ -61,6 +94,8 @@ public:
 	void run() override;
 	void stop() override;
 
+	std::map<DevicePrefix, SyncStats> syncStats() const;
+
 protected:
 	/**
 	 * @brief To simplify Answer management, include the prefix
@@ -116,10 +151,47 @@ protected:
 		 */
 		bool shouldRepeat(const Poco::Timespan &repeatTimeout) const;
 
+		/**
+		 * @returns true if the last response was fully successful and
+		 * the given refresh period exceeded since the last request
+		 */
+		bool shouldRefresh(const Poco::Timespan &refreshPeriod) const;
+
+		/**
+		 * @brief Reset the status to be requested again.
+		 */
+		void restart();
+
+		/**
+		 * @returns time elapsed since the last request
+		 */
+		Poco::Timespan sinceRequested() const;
+
+		void setVersion(const std::string &version);
+		std::string version() const;
+
+		/**
+		 * @brief Remember the paired devices delivered to handlers.
+		 */
+		void deliverPaired(const std::set<DeviceID> &paired);
+		const std::set<DeviceID> &paired() const;
+		bool delivered() const;
+
 	private:
 		Poco::Clock m_lastRequested;
 		bool m_started;
 		bool m_successful;
+		bool m_delivered;
+		std::string m_version;
+		std::set<DeviceID> m_paired;
+	};
+
+	struct SyncMetrics {
+		CounterMetric::Ptr requests;
+		CounterMetric::Ptr unchanged;
+		CounterMetric::Ptr delivered;
+		HistogramMetric::Ptr latency;
+		HistogramMetric::Ptr devices;
 	};
 
 	/**
@@ -177,13 +249,32 @@ protected:
 		const std::vector<DeviceID> &received,
 		const DevicePrefix &prefix) const;
 
+	/**
+	 * @brief Update statistics of the given prefix.
+	 */
+	void recordRequest(const DevicePrefix &prefix);
+	void recordResponse(
+		const DevicePrefix &prefix,
+		const Poco::Timespan &latency,
+		size_t devices,
+		bool delivered);
+
+	SyncMetrics &syncMetrics(const DevicePrefix &prefix);
+
 private:
 	StopControl m_stopControl;
 	Poco::Timespan m_idleDuration;
 	Poco::Timespan m_waitTimeout;
 	Poco::Timespan m_repeatTimeout;
+	Poco::Timespan m_refreshPeriod;
+	bool m_incremental;
 	std::map<DevicePrefix, std::set<DeviceStatusHandler::Ptr>> m_handlers;
 	std::map<DevicePrefix, PrefixStatus> m_status;
+
+	std::map<DevicePrefix, SyncStats> m_stats;
+	std::map<DevicePrefix, SyncMetrics> m_syncMetrics;
+	mutable Poco::FastMutex m_statsLock;
+	MetricsScope m_metrics;
 };
 
 }
@@ -1,8 +1,11 @@
 #include <exception>
 
+#include <Poco/Clock.h>
 #include <Poco/Exception.h>
+#include <Poco/String.h>
 
 #include "core/ExporterQueue.h"
+#include "util/ClassInfo.h"
 
 using namespace BeeeOn;
 using namespace std;
@@ -20,6 +23,16 @@ ExporterQueue::ExporterQueue(
 	m_capacity(capacity),
 	m_batchSize(batchSize)
 {
+	const string name = "exporter." + Poco::replace(
+		ClassInfo::forPointer(m_exporter.get()).name(),
+		"BeeeOn::", "");
+
+	m_queueSize = m_metrics.gauge(name + ".queue");
+	m_shippedCount = m_metrics.counter(name + ".shipped");
+	m_droppedCount = m_metrics.counter(name + ".dropped");
+	m_failedCount = m_metrics.counter(name + ".failures");
+	m_shipLatency = m_metrics.histogram(name + ".ship_us",
+		{100, 1000, 10000, 100000, 1000000});
 }
 
 ExporterQueue::~ExporterQueue()
@@ -33,9 +46,11 @@ void ExporterQueue::enqueue(const SensorData &sensorData)
 	if (m_queue.size() >= m_capacity && m_capacity > 0) {
 		m_queue.pop();
 		++m_dropped;
+		m_droppedCount->add();
 	}
 
 	m_queue.push(sensorData);
+	m_queueSize->set(m_queue.size());
 }
 
 unsigned int ExporterQueue::exportBatch()
@@ -47,8 +62,13 @@ unsigned int ExporterQueue::exportBatch()
 
 	try {
 		for (i = 0; (i < m_batchSize || m_batchSize <= 0) && !isEmpty(); ++i) {
-			if (m_exporter->ship(front())) {
+			const Clock started;
+			const bool shipped = m_exporter->ship(front());
+			m_shipLatency->observe(started.elapsed());
+
+			if (shipped) {
 				++m_sent;
+				m_shippedCount->add();
 				pop();
 			}
 			else {
@@ -57,16 +77,19 @@ unsigned int ExporterQueue::exportBatch()
 		}
 	}
 	catch (const Exception &e) {
+		m_failedCount->add();
 		m_failDetector.fail();
 		logger().log(e, __FILE__, __LINE__);
 		return i;
 	}
 	catch (exception &e) {
+		m_failedCount->add();
 		m_failDetector.fail();
 		poco_critical(logger(), e.what());
 		return i;
 	}
 	catch (...) {
+		m_failedCount->add();
 		m_failDetector.fail();
 		poco_critical(logger(), "unknown error occured while shipping data");
 		return i;
@@ -123,4 +146,5 @@ void ExporterQueue::pop()
 {
 	FastMutex::ScopedLock lock(m_queueMutex);
 	m_queue.pop();
+	m_queueSize->set(m_queue.size());
 }
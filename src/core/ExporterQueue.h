@@ -10,9 +10,20 @@
 #include "model/SensorData.h"
 #include "util/Loggable.h"
 #include "util/FailDetector.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
+/**
+ * @brief ExporterQueue buffers data for a single exporter. It registers
+ * the following metrics under prefix exporter.<ExporterClass>:
+ *
+ * - .queue - current number of queued data
+ * - .shipped - number of successfully shipped data
+ * - .dropped - number of data dropped due to the queue capacity
+ * - .failures - number of failed ship attempts
+ * - .ship_us - histogram of ship() latency in microseconds
+ */
 class ExporterQueue : protected Loggable {
 public:
 	typedef Poco::SharedPtr<ExporterQueue> Ptr;
@@ -74,6 +85,13 @@ private:
 	std::queue<SensorData> m_queue;
 	unsigned int m_capacity;
 	unsigned int m_batchSize;
+
+	MetricsScope m_metrics;
+	GaugeMetric::Ptr m_queueSize;
+	CounterMetric::Ptr m_shippedCount;
+	CounterMetric::Ptr m_droppedCount;
+	CounterMetric::Ptr m_failedCount;
+	HistogramMetric::Ptr m_shipLatency;
 };
 
 }
@@ -0,0 +1,378 @@
+#include <fstream>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/Logger.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
+#include <Poco/StringTokenizer.h>
+
+#include "commands/ServerLastValueResult.h"
+#include "core/LastValueCache.h"
+#include "di/Injectable.h"
+#include "model/SensorData.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, LastValueCache)
+BEEEON_OBJECT_CASTABLE(CommandHandler)
+BEEEON_OBJECT_CASTABLE(DistributorListener)
+BEEEON_OBJECT_PROPERTY("fallback", &LastValueCache::setFallback)
+BEEEON_OBJECT_PROPERTY("maxAge", &LastValueCache::setMaxAge)
+BEEEON_OBJECT_PROPERTY("file", &LastValueCache::setFile)
+BEEEON_OBJECT_PROPERTY("saveDelay", &LastValueCache::setSaveDelay)
+BEEEON_OBJECT_HOOK("done", &LastValueCache::load)
+BEEEON_OBJECT_END(BeeeOn, LastValueCache)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+LastValueCache::LastValueCache():
+	m_maxAge(0),
+	m_size(0),
+	m_callback(*this, &LastValueCache::onSaveLater),
+	m_timerRunning(false),
+	m_saveDelay(5 * Timespan::MINUTES)
+{
+	m_hits = m_metrics.counter("lastvalue.cache.hits");
+	m_misses = m_metrics.counter("lastvalue.cache.misses");
+	m_stale = m_metrics.counter("lastvalue.cache.stale");
+	m_restore = m_metrics.gauge("lastvalue.cache.restore_ms");
+}
+
+LastValueCache::~LastValueCache()
+{
+	try {
+		m_timer.stop();
+
+		if (!m_file.empty())
+			save();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void LastValueCache::setFallback(SharedPtr<CommandHandler> handler)
+{
+	m_fallback = handler;
+}
+
+void LastValueCache::setMaxAge(const Timespan &maxAge)
+{
+	m_maxAge = maxAge;
+}
+
+void LastValueCache::setFile(const string &path)
+{
+	m_file = path;
+}
+
+void LastValueCache::setSaveDelay(const Timespan &delay)
+{
+	if (delay >= 0 && delay.totalSeconds() == 0)
+		throw InvalidArgumentException("saveDelay must be negative or at least 1 second");
+
+	FastMutex::ScopedLock guard(m_timerLock);
+
+	if (delay < 0 && m_timerRunning) {
+		m_timer.stop();
+		m_timerRunning = false;
+	}
+
+	m_saveDelay = delay;
+}
+
+void LastValueCache::load()
+{
+	m_started.update();
+
+	if (m_file.empty())
+		return;
+
+	ifstream in(m_file);
+	if (!in) {
+		logger().information("no last values to load from " + m_file,
+			__FILE__, __LINE__);
+		return;
+	}
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	string line;
+	size_t loaded = 0;
+
+	while (getline(in, line)) {
+		const StringTokenizer fields(line, " ",
+			StringTokenizer::TOK_IGNORE_EMPTY | StringTokenizer::TOK_TRIM);
+
+		if (fields.count() == 0)
+			continue;
+
+		try {
+			if (fields.count() != 4)
+				throw SyntaxException("expected 4 fields");
+
+			const DeviceID device = DeviceID::parse(fields[0]);
+			const ModuleID module = ModuleID::parse(fields[1]);
+			const double value = NumberParser::parseFloat(fields[2]);
+			const Timestamp at(NumberParser::parse64(fields[3]));
+
+			auto &modules = m_entries[device];
+			if (module.value() >= modules.size())
+				modules.resize(module.value() + 1, {false, 0, 0});
+
+			if (!modules[module.value()].valid)
+				m_size += 1;
+
+			modules[module.value()] = {true, value, at};
+			loaded += 1;
+		}
+		catch (const Exception &e) {
+			logger().warning("skipping invalid entry '" + line + "': "
+				+ e.displayText(), __FILE__, __LINE__);
+		}
+	}
+
+	logger().information("loaded " + to_string(loaded) + " last values from "
+		+ m_file, __FILE__, __LINE__);
+}
+
+void LastValueCache::save()
+{
+	{
+		// stopping waits for a running onSaveLater() that takes m_lock
+		FastMutex::ScopedLock guard(m_timerLock);
+
+		if (m_timerRunning) {
+			m_timer.stop();
+			m_timerRunning = false;
+		}
+	}
+
+	FastMutex::ScopedLock guard(m_lock);
+	saveUnlocked();
+}
+
+void LastValueCache::saveUnlocked() const
+{
+	if (m_file.empty())
+		return;
+
+	const string tmp = m_file + ".tmp";
+
+	{
+		ofstream out(tmp, ios::trunc);
+		string line;
+
+		for (const auto &pair : m_entries) {
+			const DeviceID device(pair.first);
+
+			for (size_t i = 0; i < pair.second.size(); ++i) {
+				const Entry &entry = pair.second[i];
+				if (!entry.valid)
+					continue;
+
+				line = device.toString();
+				line += " ";
+				line += to_string(i);
+				line += " ";
+				NumberFormatter::append(line, entry.value, 6);
+				line += " ";
+				line += to_string(entry.at.epochMicroseconds());
+				line += "\n";
+
+				out << line;
+			}
+		}
+
+		out.flush();
+		if (!out)
+			throw WriteFileException("failed to write " + tmp);
+	}
+
+	File(tmp).renameTo(m_file);
+
+	logger().debug("last values saved into " + m_file, __FILE__, __LINE__);
+}
+
+void LastValueCache::saveLater()
+{
+	if (m_file.empty())
+		return;
+
+	FastMutex::ScopedLock guard(m_timerLock);
+
+	if (!m_timerRunning && m_saveDelay >= Timespan(0)) {
+		m_timerRunning = true;
+
+		try {
+			m_timer.stop();
+			m_timer.setStartInterval(m_saveDelay.totalMilliseconds());
+			m_timer.setPeriodicInterval(0);
+			m_timer.start(m_callback);
+		}
+		BEEEON_CATCH_CHAIN_ACTION(logger(),
+			m_timerRunning = false)
+	}
+}
+
+void LastValueCache::onSaveLater(Timer &)
+{
+	try {
+		FastMutex::ScopedLock guard(m_lock);
+		saveUnlocked();
+		m_timerRunning = false;
+	}
+	BEEEON_CATCH_CHAIN_ACTION(logger(),
+		m_timerRunning = false)
+}
+
+void LastValueCache::restored(const DeviceID &device)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_restored.emplace(device).second)
+		m_restore->set(m_started.elapsed() / 1000);
+}
+
+bool LastValueCache::lookup(
+		const DeviceID &device,
+		const ModuleID &module,
+		double &value,
+		Timestamp &at) const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	auto it = m_entries.find(device);
+	if (it == m_entries.end())
+		return false;
+
+	if (module.value() >= it->second.size())
+		return false;
+
+	const Entry &entry = it->second[module.value()];
+	if (!entry.valid)
+		return false;
+
+	value = entry.value;
+	at = entry.at;
+	return true;
+}
+
+size_t LastValueCache::size() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_size;
+}
+
+void LastValueCache::onExport(const SensorData &data)
+{
+	const Timestamp at = data.timestamp().value();
+	bool changed = false;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		auto &modules = m_entries[data.deviceID()];
+
+		for (const auto &value : data) {
+			if (!value.isValid())
+				continue;
+
+			const size_t module = value.moduleID().value();
+			if (module >= modules.size())
+				modules.resize(module + 1, {false, 0, 0});
+
+			Entry &entry = modules[module];
+			if (!entry.valid)
+				m_size += 1;
+
+			entry = {true, value.value(), at};
+			changed = true;
+		}
+	}
+
+	if (changed)
+		saveLater();
+}
+
+bool LastValueCache::accept(const Command::Ptr cmd)
+{
+	if (cmd->is<ServerLastValueCommand>())
+		return true;
+
+	if (m_fallback.isNull() || m_fallback.get() == cmd->sendingHandler())
+		return false;
+
+	return m_fallback->accept(cmd);
+}
+
+void LastValueCache::handle(Command::Ptr cmd, Answer::Ptr answer)
+{
+	if (cmd->is<ServerLastValueCommand>()) {
+		restored(cmd.cast<ServerLastValueCommand>()->deviceID());
+
+		if (answerLocally(cmd.cast<ServerLastValueCommand>(), answer))
+			return;
+
+		if (m_fallback.isNull() || !m_fallback->accept(cmd)) {
+			failed(cmd, answer);
+			return;
+		}
+	}
+
+	if (m_fallback.isNull())
+		throw IllegalStateException("command " + cmd->toString() + " cannot be handled");
+
+	m_fallback->handle(cmd, answer);
+}
+
+bool LastValueCache::answerLocally(
+		ServerLastValueCommand::Ptr cmd,
+		Answer::Ptr answer)
+{
+	double value;
+	Timestamp at;
+
+	if (!lookup(cmd->deviceID(), cmd->moduleID(), value, at)) {
+		m_misses->add();
+		return false;
+	}
+
+	if (m_maxAge > 0 && at.isElapsed(m_maxAge.totalMicroseconds())) {
+		m_stale->add();
+		return false;
+	}
+
+	m_hits->add();
+
+	ServerLastValueResult::Ptr result = new ServerLastValueResult(answer);
+	result->setDeviceID(cmd->deviceID());
+	result->setModuleID(cmd->moduleID());
+	result->setValue(value);
+	result->setStatus(Result::Status::SUCCESS);
+
+	return true;
+}
+
+void LastValueCache::failed(Command::Ptr cmd, Answer::Ptr answer)
+{
+	logger().warning("no last value available for " + cmd->toString(),
+		__FILE__, __LINE__);
+
+	Result::Ptr result = new Result(answer);
+	result->setStatus(Result::Status::FAILED);
+}
+
+uint64_t LastValueCache::hits() const
+{
+	return m_hits->value();
+}
+
+uint64_t LastValueCache::misses() const
+{
+	return m_misses->value();
+}
+
+uint64_t LastValueCache::stale() const
+{
+	return m_stale->value();
+}
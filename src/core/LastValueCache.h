@@ -0,0 +1,156 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Poco/AtomicCounter.h>
+#include <Poco/Clock.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timer.h>
+#include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
+
+#include "commands/ServerLastValueCommand.h"
+#include "core/CommandHandler.h"
+#include "core/DistributorListener.h"
+#include "model/DeviceID.h"
+#include "model/ModuleID.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief LastValueCache remembers the last value of each module
+ * distributed by the Distributor (it is a DistributorListener)
+ * and answers ServerLastValueCommand locally without asking the
+ * remote server.
+ *
+ * The cache works as a proxy of the server command handler given
+ * as <code>fallback</code>. Commands other than ServerLastValueCommand
+ * are passed to the fallback handler as they are. ServerLastValueCommand
+ * is passed to the fallback handler only if the cache does not contain
+ * the requested value or the value is older than <code>maxAge</code>.
+ *
+ * The cache can be persisted in the given <code>file</code> to survive
+ * restarts of the gateway. The file is saved <code>saveDelay</code> after
+ * the first change and on destruction. It is loaded when the DI finishes
+ * the object construction.
+ *
+ * The cache reports metrics lastvalue.cache.{hits,misses,stale} and
+ * lastvalue.cache.restore_ms, which is the time elapsed since loading
+ * of the cache until the first ServerLastValueCommand of the most
+ * recently restored device. Later commands of already restored devices
+ * do not change it. After a restart, it approximates the time needed
+ * to restore all devices.
+ */
+class LastValueCache :
+	public CommandHandler,
+	public DistributorListener,
+	Loggable {
+public:
+	typedef Poco::SharedPtr<LastValueCache> Ptr;
+
+	LastValueCache();
+	~LastValueCache();
+
+	/**
+	 * @brief Handler to ask when the cache cannot answer.
+	 */
+	void setFallback(Poco::SharedPtr<CommandHandler> handler);
+
+	/**
+	 * @brief Values older than maxAge are considered stale and
+	 * the fallback handler is asked. Non-positive maxAge means
+	 * that the values never get stale.
+	 */
+	void setMaxAge(const Poco::Timespan &maxAge);
+
+	void setFile(const std::string &path);
+
+	/**
+	 * @brief Delay of saving the cache after the first change.
+	 * Negative delay disables the autosave.
+	 */
+	void setSaveDelay(const Poco::Timespan &delay);
+
+	void load();
+	void save();
+
+	/**
+	 * @brief Lookup the last value of the given module.
+	 * @returns false when no such value is cached
+	 */
+	bool lookup(
+		const DeviceID &device,
+		const ModuleID &module,
+		double &value,
+		Poco::Timestamp &at) const;
+
+	size_t size() const;
+
+	bool accept(const Command::Ptr cmd) override;
+	void handle(Command::Ptr cmd, Answer::Ptr answer) override;
+
+	void onExport(const SensorData &data) override;
+
+	uint64_t hits() const;
+	uint64_t misses() const;
+	uint64_t stale() const;
+
+protected:
+	struct Entry {
+		bool valid;
+		double value;
+		Poco::Timestamp at;
+	};
+
+	/**
+	 * @brief Answer the given command from the cache.
+	 * @returns false if the fallback handler should be asked
+	 */
+	bool answerLocally(ServerLastValueCommand::Ptr cmd, Answer::Ptr answer);
+
+	void failed(Command::Ptr cmd, Answer::Ptr answer);
+
+	/**
+	 * @brief Update the restore metric if this is the first
+	 * ServerLastValueCommand of the given device since loading.
+	 */
+	void restored(const DeviceID &device);
+
+	/**
+	 * This method must be never called while holding the m_lock
+	 * because restarting of the timer waits for onSaveLater().
+	 */
+	void saveLater();
+	void onSaveLater(Poco::Timer &);
+	void saveUnlocked() const;
+
+private:
+	Poco::SharedPtr<CommandHandler> m_fallback;
+	Poco::Timespan m_maxAge;
+	std::string m_file;
+	std::unordered_map<uint64_t, std::vector<Entry>> m_entries;
+	std::unordered_set<uint64_t> m_restored;
+	size_t m_size;
+	mutable Poco::FastMutex m_lock;
+
+	Poco::FastMutex m_timerLock;
+	Poco::Timer m_timer;
+	Poco::TimerCallback<LastValueCache> m_callback;
+	Poco::AtomicCounter m_timerRunning;
+	Poco::Timespan m_saveDelay;
+
+	Poco::Clock m_started;
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_hits;
+	CounterMetric::Ptr m_misses;
+	CounterMetric::Ptr m_stale;
+	GaugeMetric::Ptr m_restore;
+};
+
+}
@@ -13,6 +13,7 @@
 
 #ifdef HAVE_ZWAVE
 #include "zwave/ZWaveDriverEvent.h"
+#include "zwave/ZWaveMeshEvent.h"
 #include "zwave/ZWaveNodeEvent.h"
 #endif
 
@@ -93,6 +94,33 @@ void LoggingCollector::onNodeStats(const ZWaveNodeEvent &e)
 			+ "/"
 			+ to_string(e.quality()));
 }
+
+void LoggingCollector::onMeshStats(const ZWaveMeshEvent &e)
+{
+	const auto &summary = e.summary();
+
+	logger().information("Z-Wave Mesh: "
+			+ NumberFormatter::formatHex(e.homeID(), 8)
+			+ "/"
+			+ to_string(e.nodes().size())
+			+ "/"
+			+ to_string(summary.sentCount)
+			+ "/"
+			+ to_string(summary.sentFailed)
+			+ "/"
+			+ to_string(summary.retries)
+			+ "/"
+			+ to_string(summary.averageRTT)
+			+ "/"
+			+ to_string(summary.maxRTT)
+			+ "/"
+			+ to_string(summary.dropped)
+			+ " in "
+			+ to_string(e.duration().totalMilliseconds())
+			+ " ms");
+
+	AbstractCollector::onMeshStats(e);
+}
 #else
 void LoggingCollector::onDriverStats(const ZWaveDriverEvent &)
 {
@@ -101,6 +129,10 @@ void LoggingCollector::onDriverStats(const ZWaveDriverEvent &)
 void LoggingCollector::onNodeStats(const ZWaveNodeEvent &)
 {
 }
+
+void LoggingCollector::onMeshStats(const ZWaveMeshEvent &)
+{
+}
 #endif
 
 #ifdef HAVE_OPENZWAVE
@@ -15,6 +15,7 @@ public:
 	void onExport(const SensorData &data) override;
 	void onDriverStats(const ZWaveDriverEvent &event) override;
 	void onNodeStats(const ZWaveNodeEvent &event) override;
+	void onMeshStats(const ZWaveMeshEvent &event) override;
 	void onNotification(const OZWNotificationEvent &event) override;
 	void onHciStats(const HciInfo &info) override;
 	void onBulbStats(const PhilipsHueBulbInfo &info) override;
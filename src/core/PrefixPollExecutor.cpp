@@ -0,0 +1,300 @@
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+#include <Poco/NumberParser.h>
+#include <Poco/RunnableAdapter.h>
+#include <Poco/Thread.h>
+
+#include "core/PrefixPollExecutor.h"
+#include "di/Injectable.h"
+#include "util/ThreadNamer.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, PrefixPollExecutor)
+BEEEON_OBJECT_CASTABLE(AsyncExecutor)
+BEEEON_OBJECT_CASTABLE(StoppableRunnable)
+BEEEON_OBJECT_PROPERTY("workers", &PrefixPollExecutor::setWorkers)
+BEEEON_OBJECT_PROPERTY("laneLimit", &PrefixPollExecutor::setLaneLimit)
+BEEEON_OBJECT_PROPERTY("laneLimits", &PrefixPollExecutor::setLaneLimits)
+BEEEON_OBJECT_END(BeeeOn, PrefixPollExecutor)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+static const string DEFAULT_LANE = "default";
+
+PrefixPollExecutor::PrefixPollExecutor():
+	m_workers(4),
+	m_laneLimit(1),
+	m_stop(false)
+{
+}
+
+PrefixPollExecutor::~PrefixPollExecutor()
+{
+}
+
+void PrefixPollExecutor::setWorkers(int workers)
+{
+	if (workers < 1)
+		throw InvalidArgumentException("workers must be at least 1");
+
+	m_workers = workers;
+}
+
+void PrefixPollExecutor::setLaneLimit(int limit)
+{
+	if (limit < 1)
+		throw InvalidArgumentException("laneLimit must be at least 1");
+
+	m_laneLimit = limit;
+}
+
+void PrefixPollExecutor::setLaneLimits(const list<string> &limits)
+{
+	map<string, size_t> parsed;
+
+	for (const auto &entry : limits) {
+		if (entry.empty())
+			continue;
+
+		const auto sep = entry.find(':');
+		if (sep == string::npos)
+			throw InvalidArgumentException("invalid lane limit: " + entry);
+
+		const string name = entry.substr(0, sep);
+		const unsigned int limit = NumberParser::parseUnsigned(entry.substr(sep + 1));
+
+		if (name != DEFAULT_LANE)
+			(void) DevicePrefix::parse(name);
+
+		if (limit < 1)
+			throw InvalidArgumentException("lane limit must be at least 1: " + entry);
+
+		parsed[name] = limit;
+	}
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_laneLimits = parsed;
+
+	for (auto &pair : m_lanes) {
+		auto it = m_laneLimits.find(pair.first);
+		pair.second.limit = it == m_laneLimits.end() ? m_laneLimit : it->second;
+	}
+}
+
+void PrefixPollExecutor::invoke(function<void()> f)
+{
+	enqueue(DEFAULT_LANE, {{}, {}, false, f});
+}
+
+void PrefixPollExecutor::invoke(
+		const string &lane,
+		const Timespan &budget,
+		function<void()> f)
+{
+	const Clock now;
+	const bool hasDeadline = budget > 0;
+	const Clock deadline = hasDeadline ? now + budget.totalMicroseconds() : now;
+
+	enqueue(lane, {now, deadline, hasDeadline, f});
+}
+
+void PrefixPollExecutor::invoke(
+		const DeviceID &id,
+		const Timespan &budget,
+		function<void()> f)
+{
+	invoke(id.prefix().toString(), budget, f);
+}
+
+void PrefixPollExecutor::enqueue(const string &name, const Task &task)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	lane(name).queue.emplace_back(task);
+	m_condition.signal();
+}
+
+PrefixPollExecutor::Lane &PrefixPollExecutor::lane(const string &name)
+{
+	auto it = m_lanes.find(name);
+	if (it != m_lanes.end())
+		return it->second;
+
+	const auto limit = m_laneLimits.find(name);
+	const string prefix = "poller.lane." + name;
+
+	Lane &created = m_lanes[name];
+	created.running = 0;
+	created.limit = limit == m_laneLimits.end() ? m_laneLimit : limit->second;
+	created.stats = {0, 0, 0, 0, 0, 0};
+	created.executedMetric = m_metrics.counter(prefix + ".executed");
+	created.missesMetric = m_metrics.counter(prefix + ".deadline_misses");
+	created.waitMetric = m_metrics.histogram(prefix + ".wait_us",
+		{1000, 10000, 100000, 1000000, 10000000});
+
+	return created;
+}
+
+bool PrefixPollExecutor::pickNext(string &name, Task &task)
+{
+	if (m_lanes.empty())
+		return false;
+
+	auto start = m_lanes.upper_bound(m_cursor);
+	if (start == m_lanes.end())
+		start = m_lanes.begin();
+
+	auto it = start;
+
+	do {
+		Lane &candidate = it->second;
+
+		if (!candidate.queue.empty() && candidate.running < candidate.limit) {
+			name = it->first;
+			task = candidate.queue.front();
+
+			candidate.queue.pop_front();
+			candidate.running += 1;
+			m_cursor = name;
+			return true;
+		}
+
+		if (++it == m_lanes.end())
+			it = m_lanes.begin();
+	} while (it != start);
+
+	return false;
+}
+
+void PrefixPollExecutor::execute(const string &name, const Task &task)
+{
+	const Timespan wait = task.enqueued.elapsed();
+
+	try {
+		task.f();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+
+	const Clock finished;
+	const bool missed = task.hasDeadline && task.deadline < finished;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	Lane &current = m_lanes.at(name);
+	current.running -= 1;
+	current.stats.executed += 1;
+	current.executedMetric->add();
+	current.waitMetric->observe(wait.totalMicroseconds());
+
+	if (wait > current.stats.maxWait)
+		current.stats.maxWait = wait;
+
+	if (missed) {
+		const Timespan lateness = finished - task.deadline;
+
+		current.stats.deadlineMisses += 1;
+		current.missesMetric->add();
+
+		if (lateness > current.stats.maxLateness)
+			current.stats.maxLateness = lateness;
+
+		if (logger().debug()) {
+			logger().debug(
+				"poll in lane " + name + " missed its deadline by "
+				+ to_string(lateness.totalMilliseconds()) + " ms (waited "
+				+ to_string(wait.totalMilliseconds()) + " ms, "
+				+ to_string(current.stats.deadlineMisses) + " misses of "
+				+ to_string(current.stats.executed) + " polls)",
+				__FILE__, __LINE__);
+		}
+	}
+
+	// a slot of the lane has been released
+	m_condition.broadcast();
+}
+
+void PrefixPollExecutor::workerLoop()
+{
+	ThreadNamer namer("poll-" + to_string(Thread::currentTid()));
+
+	while (true) {
+		string name;
+		Task task;
+
+		{
+			FastMutex::ScopedLock guard(m_lock);
+
+			while (!m_stop && !pickNext(name, task))
+				m_condition.wait(m_lock);
+
+			if (m_stop)
+				break;
+		}
+
+		execute(name, task);
+	}
+}
+
+void PrefixPollExecutor::run()
+{
+	logger().information(
+		"starting " + to_string(m_workers) + " poll workers",
+		__FILE__, __LINE__);
+
+	RunnableAdapter<PrefixPollExecutor> worker(
+		*this, &PrefixPollExecutor::workerLoop);
+	list<Thread> threads;
+
+	for (size_t i = 1; i < m_workers; ++i) {
+		threads.emplace_back();
+		threads.back().start(worker);
+	}
+
+	workerLoop();
+
+	for (auto &thread : threads)
+		thread.join();
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	size_t dropped = 0;
+	for (auto &pair : m_lanes) {
+		dropped += pair.second.queue.size();
+		pair.second.queue.clear();
+	}
+
+	if (dropped > 0) {
+		logger().warning(
+			"dropped " + to_string(dropped) + " queued polls",
+			__FILE__, __LINE__);
+	}
+
+	m_stop = false;
+}
+
+void PrefixPollExecutor::stop()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_stop = true;
+	m_condition.broadcast();
+}
+
+map<string, PrefixPollExecutor::Stats> PrefixPollExecutor::stats() const
+{
+	map<string, Stats> result;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	for (const auto &pair : m_lanes) {
+		Stats stats = pair.second.stats;
+		stats.queued = pair.second.queue.size();
+		stats.running = pair.second.running;
+
+		result.emplace(pair.first, stats);
+	}
+
+	return result;
+}
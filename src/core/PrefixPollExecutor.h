@@ -0,0 +1,154 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "loop/StoppableRunnable.h"
+#include "model/DeviceID.h"
+#include "util/AsyncExecutor.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief PrefixPollExecutor executes polls of devices concurrently
+ * by a fixed set of worker threads. The polls are divided into lanes
+ * by the DevicePrefix of the polled device. Each lane has a limit
+ * of concurrently executed polls (1 by default) and the workers pick
+ * lanes in a round-robin fashion. Thus, a slow device (e.g. an HTTP
+ * device not responding) blocks only devices of its own lane and
+ * it cannot starve the other lanes.
+ *
+ * Each poll can be given a deadline. Polls finished after their
+ * deadline are counted as deadline misses of the lane. The statistics
+ * are available via stats() and as metrics poller.lane.<prefix>.*.
+ * The misses are not logged as warnings, reporting of slow polls
+ * is left to the caller (e.g. DevicePoller).
+ *
+ * Tasks submitted via the plain AsyncExecutor::invoke() fall into
+ * a common lane named "default".
+ */
+class PrefixPollExecutor :
+	public AsyncExecutor,
+	public StoppableRunnable,
+	Loggable {
+public:
+	typedef Poco::SharedPtr<PrefixPollExecutor> Ptr;
+
+	struct Stats {
+		uint64_t executed;
+		uint64_t deadlineMisses;
+		size_t queued;
+		size_t running;
+		Poco::Timespan maxWait;
+		Poco::Timespan maxLateness;
+	};
+
+	PrefixPollExecutor();
+	~PrefixPollExecutor();
+
+	/**
+	 * @brief Number of worker threads executing the polls.
+	 */
+	void setWorkers(int workers);
+
+	/**
+	 * @brief Default limit of concurrent polls per lane.
+	 */
+	void setLaneLimit(int limit);
+
+	/**
+	 * @brief Limits of concurrent polls for particular lanes given
+	 * as a list of entries in form <prefix>:<limit>.
+	 */
+	void setLaneLimits(const std::list<std::string> &limits);
+
+	void invoke(std::function<void()> f) override;
+
+	/**
+	 * @brief Enqueue poll into the lane of the given name that should
+	 * be finished within the given budget (measured since now).
+	 * A non-positive budget means that the poll has no deadline.
+	 */
+	void invoke(
+		const std::string &lane,
+		const Poco::Timespan &budget,
+		std::function<void()> f) override;
+
+	/**
+	 * @brief Enqueue poll of the given device into the lane of its prefix.
+	 */
+	void invoke(
+		const DeviceID &id,
+		const Poco::Timespan &budget,
+		std::function<void()> f);
+
+	/**
+	 * @brief Start the worker threads and serve as one of them.
+	 */
+	void run() override;
+
+	/**
+	 * @brief Stop all workers. Running polls are finished,
+	 * the queued ones are dropped.
+	 */
+	void stop() override;
+
+	std::map<std::string, Stats> stats() const;
+
+protected:
+	struct Task {
+		Poco::Clock enqueued;
+		Poco::Clock deadline;
+		bool hasDeadline;
+		std::function<void()> f;
+	};
+
+	struct Lane {
+		std::deque<Task> queue;
+		size_t running;
+		size_t limit;
+		Stats stats;
+		CounterMetric::Ptr executedMetric;
+		CounterMetric::Ptr missesMetric;
+		HistogramMetric::Ptr waitMetric;
+	};
+
+	void enqueue(const std::string &name, const Task &task);
+
+	Lane &lane(const std::string &name);
+
+	/**
+	 * @brief Find the next lane (after the recently picked one) that
+	 * has a queued task and has not reached its limit. The m_lock
+	 * must be held.
+	 */
+	bool pickNext(std::string &name, Task &task);
+
+	void execute(const std::string &name, const Task &task);
+	void workerLoop();
+
+private:
+	size_t m_workers;
+	size_t m_laneLimit;
+	std::map<std::string, size_t> m_laneLimits;
+	std::map<std::string, Lane> m_lanes;
+	std::string m_cursor;
+	bool m_stop;
+	mutable Poco::FastMutex m_lock;
+	Poco::Condition m_condition;
+	MetricsScope m_metrics;
+};
+
+}
@@ -15,6 +15,7 @@ BEEEON_OBJECT_PROPERTY("batchSize", &QueuingDistributor::setQueueBatchSize)
 BEEEON_OBJECT_PROPERTY("treshold", &QueuingDistributor::setQueueTreshold)
 BEEEON_OBJECT_PROPERTY("eventsExecutor", &QueuingDistributor::setExecutor)
 BEEEON_OBJECT_PROPERTY("listeners", &QueuingDistributor::registerListener)
+BEEEON_OBJECT_PROPERTY("filter", &QueuingDistributor::setFilter)
 BEEEON_OBJECT_END(BeeeOn, QueuingDistributor)
 
 using namespace BeeeOn;
@@ -137,8 +138,13 @@ void QueuingDistributor::exportData(const SensorData &sensorData)
 
 	notifyListeners(sensorData);
 
+	SensorData filtered;
+	const SensorData *data = applyFilter(sensorData, filtered);
+	if (data == nullptr)
+		return;
+
 	for (auto q : m_queues)
-		q->enqueue(sensorData);
+		q->enqueue(*data);
 
 	m_newData.set();
 }
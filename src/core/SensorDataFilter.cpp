@@ -0,0 +1,348 @@
+#include <cmath>
+#include <fstream>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/Logger.h>
+#include <Poco/StringTokenizer.h>
+
+#include "commands/NewDeviceCommand.h"
+#include "core/SensorDataFilter.h"
+#include "di/Injectable.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, SensorDataFilter)
+BEEEON_OBJECT_CASTABLE(CommandDispatcherListener)
+BEEEON_OBJECT_PROPERTY("rules", &SensorDataFilter::addRule)
+BEEEON_OBJECT_PROPERTY("typesFile", &SensorDataFilter::setTypesFile)
+BEEEON_OBJECT_PROPERTY("maxDevices", &SensorDataFilter::setMaxDevices)
+BEEEON_OBJECT_HOOK("done", &SensorDataFilter::load)
+BEEEON_OBJECT_END(BeeeOn, SensorDataFilter)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+SensorDataFilter::SensorDataFilter():
+	m_defaultRule(nullptr),
+	m_maxDevices(4096)
+{
+	m_passed = m_metrics.counter("distributor.filter.passed");
+	m_dropped = m_metrics.counter("distributor.filter.dropped");
+}
+
+void SensorDataFilter::addRule(SensorDataFilterRule::Ptr rule)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_rules.emplace_back(rule);
+
+	if (rule->isDefault()) {
+		m_defaultRule = rule.get();
+		return;
+	}
+
+	const size_t index = rule->type().raw();
+
+	if (index >= m_byType.size())
+		m_byType.resize(index + 1, nullptr);
+
+	if (m_byType[index] != nullptr) {
+		logger().warning(
+			"overriding filter rule for " + rule->type().toString(),
+			__FILE__, __LINE__);
+	}
+
+	m_byType[index] = rule.get();
+}
+
+void SensorDataFilter::setTypesFile(const string &path)
+{
+	m_typesFile = path;
+}
+
+void SensorDataFilter::setMaxDevices(int count)
+{
+	if (count < 1)
+		throw InvalidArgumentException("maxDevices must be at least 1");
+
+	m_maxDevices = count;
+}
+
+void SensorDataFilter::load()
+{
+	if (m_typesFile.empty())
+		return;
+
+	ifstream in(m_typesFile);
+	if (!in) {
+		logger().information("no module types to load from " + m_typesFile,
+			__FILE__, __LINE__);
+		return;
+	}
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	string line;
+
+	while (getline(in, line)) {
+		const StringTokenizer fields(line, " ",
+			StringTokenizer::TOK_IGNORE_EMPTY | StringTokenizer::TOK_TRIM);
+
+		if (fields.count() == 0)
+			continue;
+
+		try {
+			const DeviceID device = DeviceID::parse(fields[0]);
+			Types types;
+
+			for (size_t i = 1; i < fields.count(); ++i)
+				types.emplace_back(ModuleType::Type::parse(fields[i]));
+
+			m_types[device] = types;
+		}
+		catch (const Exception &e) {
+			logger().warning("skipping invalid entry '" + line + "': "
+				+ e.displayText(), __FILE__, __LINE__);
+		}
+	}
+
+	logger().information("loaded module types of " + to_string(m_types.size())
+		+ " devices from " + m_typesFile, __FILE__, __LINE__);
+}
+
+void SensorDataFilter::saveTypes()
+{
+	if (m_typesFile.empty())
+		return;
+
+	FastMutex::ScopedLock saveGuard(m_saveLock);
+	unordered_map<uint64_t, Types> types;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+		types = m_types;
+	}
+
+	const string tmp = m_typesFile + ".tmp";
+
+	{
+		ofstream out(tmp, ios::trunc);
+		string line;
+
+		for (const auto &pair : types) {
+			line = DeviceID(pair.first).toString();
+
+			for (const auto &type : pair.second) {
+				line += " ";
+				line += type.toString();
+			}
+
+			line += "\n";
+			out << line;
+		}
+
+		out.flush();
+		if (!out)
+			throw WriteFileException("failed to write " + tmp);
+	}
+
+	File(tmp).renameTo(m_typesFile);
+}
+
+void SensorDataFilter::registerDevice(
+		const DeviceID &id,
+		const list<ModuleType> &types)
+{
+	Types learnt;
+
+	for (const auto &type : types)
+		learnt.emplace_back(type.type());
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		auto it = m_types.find(id);
+		if (it != m_types.end() && it->second == learnt)
+			return;
+
+		m_types[id] = learnt;
+	}
+
+	try {
+		saveTypes();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void SensorDataFilter::onDispatch(const Command::Ptr cmd)
+{
+	if (!cmd->is<NewDeviceCommand>())
+		return;
+
+	const NewDeviceCommand::Ptr command = cmd.cast<NewDeviceCommand>();
+	registerDevice(command->deviceID(), command->dataTypes());
+}
+
+vector<SensorDataFilter::LastValue> &SensorDataFilter::lastValues(const DeviceID &id)
+{
+	auto it = m_last.find(id);
+	if (it != m_last.end())
+		return it->second;
+
+	// forgetting a device only causes its next values to be exported
+	if (m_last.size() >= m_maxDevices)
+		m_last.erase(m_last.begin());
+
+	return m_last[id];
+}
+
+ModuleType::Type SensorDataFilter::typeOf(
+		const Types *types,
+		const ModuleID &module) const
+{
+	if (types == nullptr || module.value() >= types->size())
+		return ModuleType::Type::TYPE_UNKNOWN;
+
+	return (*types)[module.value()];
+}
+
+const SensorDataFilterRule *SensorDataFilter::rule(
+		const ModuleType::Type &type) const
+{
+	const size_t index = type.raw();
+
+	if (index < m_byType.size() && m_byType[index] != nullptr)
+		return m_byType[index];
+
+	return m_defaultRule;
+}
+
+bool SensorDataFilter::isDiscrete(const ModuleType::Type &type)
+{
+	switch (type.raw()) {
+	case ModuleType::Type::TYPE_AVAILABILITY:
+	case ModuleType::Type::TYPE_BITMAP:
+	case ModuleType::Type::TYPE_COLOR:
+	case ModuleType::Type::TYPE_ENUM:
+	case ModuleType::Type::TYPE_FIRE:
+	case ModuleType::Type::TYPE_HEAT:
+	case ModuleType::Type::TYPE_MOTION:
+	case ModuleType::Type::TYPE_ON_OFF:
+	case ModuleType::Type::TYPE_OPEN_CLOSE:
+	case ModuleType::Type::TYPE_SECURITY_ALERT:
+	case ModuleType::Type::TYPE_SHAKE:
+	case ModuleType::Type::TYPE_SMOKE:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool SensorDataFilter::pass(
+		const SensorDataFilterRule &rule,
+		const ModuleType::Type &type,
+		LastValue &last,
+		const SensorValue &value,
+		const Timestamp &at) const
+{
+	bool accept = true;
+
+	if (last.exported && at >= last.at) {
+		const Timespan elapsed = at - last.at;
+		const bool changed = value.isValid() != last.valid
+			|| (value.isValid() && value.value() != last.value);
+		const bool unknown = type.raw() == ModuleType::Type::TYPE_UNKNOWN;
+
+		if (changed && isDiscrete(type))
+			accept = true;
+		else if (elapsed < rule.minInterval() && !(changed && unknown))
+			return false;
+		else if (value.isValid() != last.valid)
+			accept = true;
+		else if (!value.isValid())
+			accept = false;
+		else if (rule.deadband() > 0)
+			accept = fabs(value.value() - last.value) >= rule.deadband();
+
+		if (!accept && rule.heartbeat() > 0 && elapsed >= rule.heartbeat())
+			accept = true;
+	}
+
+	if (accept) {
+		last.exported = true;
+		last.valid = value.isValid();
+		last.value = value.value();
+		last.at = at;
+	}
+
+	return accept;
+}
+
+bool SensorDataFilter::apply(const SensorData &data, SensorData &filtered)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_rules.empty() || data.isEmpty()) {
+		filtered = data;
+		return true;
+	}
+
+	auto types = m_types.find(data.deviceID());
+	const Types *known = types == m_types.end() ? nullptr : &types->second;
+	vector<LastValue> &last = lastValues(data.deviceID());
+	const Timestamp at = data.timestamp().value();
+
+	vector<bool> keep(data.size(), true);
+	size_t dropped = 0;
+
+	for (size_t i = 0; i < data.size(); ++i) {
+		const SensorValue &value = data[i];
+		const ModuleType::Type type = typeOf(known, value.moduleID());
+		const SensorDataFilterRule *current = rule(type);
+
+		if (current == nullptr)
+			continue;
+
+		const size_t module = value.moduleID().value();
+		if (module >= last.size())
+			last.resize(module + 1, {false, false, 0, 0});
+
+		if (!pass(*current, type, last[module], value, at)) {
+			keep[i] = false;
+			dropped += 1;
+		}
+	}
+
+	m_passed->add(data.size() - dropped);
+	m_dropped->add(dropped);
+
+	if (dropped == 0) {
+		filtered = data;
+		return true;
+	}
+
+	if (dropped == data.size())
+		return false;
+
+	filtered = SensorData();
+	filtered.setDeviceID(data.deviceID());
+	filtered.setTimestamp(data.timestamp());
+
+	for (size_t i = 0; i < data.size(); ++i) {
+		if (keep[i])
+			filtered.insertValue(data[i]);
+	}
+
+	return true;
+}
+
+uint64_t SensorDataFilter::passed() const
+{
+	return m_passed->value();
+}
+
+uint64_t SensorDataFilter::dropped() const
+{
+	return m_dropped->value();
+}
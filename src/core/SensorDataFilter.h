@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timestamp.h>
+
+#include "core/CommandDispatcherListener.h"
+#include "core/SensorDataFilterRule.h"
+#include "model/DeviceID.h"
+#include "model/ModuleType.h"
+#include "model/SensorData.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief SensorDataFilter is a pre-export stage of a distributor that
+ * drops values not worth exporting according to the SensorDataFilterRule
+ * configured for their ModuleType (deadband, minimal interval, heartbeat).
+ * Values of types without a specific rule (including values of unknown
+ * types) are subject of the "default" rule only (if configured).
+ *
+ * The ModuleTypes of devices are learnt from the NewDeviceCommand
+ * dispatched by device managers (thus, the filter should be registered
+ * as a listener of the CommandDispatcher) or given explicitly via
+ * registerDevice(). The learnt types are persisted in the given
+ * <code>typesFile</code> to be known after restart.
+ *
+ * A changed value of a discrete type (on/off, open/close, enum, etc.)
+ * is always exported. A changed value of an unknown type is never
+ * dropped because of the minInterval as it might be such a value.
+ *
+ * Each value is evaluated in O(1) against a table of the last exported
+ * values. The table keeps at most <code>maxDevices</code> devices, when
+ * full an arbitrary device is forgotten (its next values are exported).
+ * The numbers of passed and dropped values are available as metrics
+ * distributor.filter.passed and distributor.filter.dropped.
+ */
+class SensorDataFilter :
+	public CommandDispatcherListener,
+	Loggable {
+public:
+	typedef Poco::SharedPtr<SensorDataFilter> Ptr;
+
+	SensorDataFilter();
+
+	void addRule(SensorDataFilterRule::Ptr rule);
+
+	void setTypesFile(const std::string &path);
+	void setMaxDevices(int count);
+
+	/**
+	 * @brief Load module types persisted in the typesFile.
+	 */
+	void load();
+
+	/**
+	 * @brief Register module types of the given device. The index
+	 * of a type in the list is its ModuleID. Changed types are
+	 * persisted immediately.
+	 */
+	void registerDevice(const DeviceID &id, const std::list<ModuleType> &types);
+
+	/**
+	 * @brief Filter values of the given data.
+	 * @returns false when no value is left to be exported, otherwise
+	 * the filtered contains the values to be exported
+	 */
+	bool apply(const SensorData &data, SensorData &filtered);
+
+	void onDispatch(const Command::Ptr cmd) override;
+
+	uint64_t passed() const;
+	uint64_t dropped() const;
+
+protected:
+	struct LastValue {
+		bool exported;
+		bool valid;
+		double value;
+		Poco::Timestamp at;
+	};
+
+	typedef std::vector<ModuleType::Type> Types;
+
+	std::vector<LastValue> &lastValues(const DeviceID &id);
+
+	/**
+	 * @returns type of the given module or TYPE_UNKNOWN
+	 */
+	ModuleType::Type typeOf(const Types *types, const ModuleID &module) const;
+
+	const SensorDataFilterRule *rule(const ModuleType::Type &type) const;
+
+	/**
+	 * @returns true for types whose values represent states
+	 * (not measurements), deadband makes no sense for them
+	 */
+	static bool isDiscrete(const ModuleType::Type &type);
+
+	bool pass(
+		const SensorDataFilterRule &rule,
+		const ModuleType::Type &type,
+		LastValue &last,
+		const SensorValue &value,
+		const Poco::Timestamp &at) const;
+
+	/**
+	 * Write the learnt module types into the types file. The types
+	 * are copied while holding the m_lock but the file is written
+	 * without it to not block apply(). Concurrent saves are serialized
+	 * by the m_saveLock. It must not be called while holding the m_lock.
+	 */
+	void saveTypes();
+
+private:
+	std::vector<SensorDataFilterRule::Ptr> m_rules;
+	std::vector<const SensorDataFilterRule *> m_byType;
+	const SensorDataFilterRule *m_defaultRule;
+	std::string m_typesFile;
+	size_t m_maxDevices;
+	std::unordered_map<uint64_t, Types> m_types;
+	std::unordered_map<uint64_t, std::vector<LastValue>> m_last;
+	Poco::FastMutex m_lock;
+	Poco::FastMutex m_saveLock;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_passed;
+	CounterMetric::Ptr m_dropped;
+};
+
+}
@@ -0,0 +1,85 @@
+#include <Poco/Exception.h>
+
+#include "core/SensorDataFilterRule.h"
+#include "di/Injectable.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, SensorDataFilterRule)
+BEEEON_OBJECT_PROPERTY("type", &SensorDataFilterRule::setType)
+BEEEON_OBJECT_PROPERTY("deadband", &SensorDataFilterRule::setDeadband)
+BEEEON_OBJECT_PROPERTY("minInterval", &SensorDataFilterRule::setMinInterval)
+BEEEON_OBJECT_PROPERTY("heartbeat", &SensorDataFilterRule::setHeartbeat)
+BEEEON_OBJECT_END(BeeeOn, SensorDataFilterRule)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+SensorDataFilterRule::SensorDataFilterRule():
+	m_default(true),
+	m_type(ModuleType::Type::TYPE_UNKNOWN),
+	m_deadband(0),
+	m_minInterval(0),
+	m_heartbeat(0)
+{
+}
+
+void SensorDataFilterRule::setType(const string &type)
+{
+	if (type == "default") {
+		m_default = true;
+		m_type = ModuleType::Type::TYPE_UNKNOWN;
+	}
+	else {
+		m_default = false;
+		m_type = ModuleType::Type::parse(type);
+	}
+}
+
+bool SensorDataFilterRule::isDefault() const
+{
+	return m_default;
+}
+
+ModuleType::Type SensorDataFilterRule::type() const
+{
+	return m_type;
+}
+
+void SensorDataFilterRule::setDeadband(double deadband)
+{
+	if (deadband < 0)
+		throw InvalidArgumentException("deadband must not be negative");
+
+	m_deadband = deadband;
+}
+
+double SensorDataFilterRule::deadband() const
+{
+	return m_deadband;
+}
+
+void SensorDataFilterRule::setMinInterval(const Timespan &interval)
+{
+	if (interval < 0)
+		throw InvalidArgumentException("minInterval must not be negative");
+
+	m_minInterval = interval;
+}
+
+Timespan SensorDataFilterRule::minInterval() const
+{
+	return m_minInterval;
+}
+
+void SensorDataFilterRule::setHeartbeat(const Timespan &heartbeat)
+{
+	if (heartbeat < 0)
+		throw InvalidArgumentException("heartbeat must not be negative");
+
+	m_heartbeat = heartbeat;
+}
+
+Timespan SensorDataFilterRule::heartbeat() const
+{
+	return m_heartbeat;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "model/ModuleType.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief SensorDataFilterRule describes how values of a certain
+ * ModuleType are filtered before exporting:
+ *
+ * - deadband - a value is exported only if it differs from the last
+ *   exported value by at least the deadband (0 disables the check)
+ * - minInterval - values coming sooner than minInterval after the last
+ *   exported value are never exported
+ * - heartbeat - a value is exported when the heartbeat has elapsed
+ *   since the last exported value even if it is within the deadband
+ *   (0 disables the heartbeat)
+ *
+ * The special type name "default" denotes a rule applied to values
+ * of types without any specific rule including unknown types.
+ */
+class SensorDataFilterRule {
+public:
+	typedef Poco::SharedPtr<SensorDataFilterRule> Ptr;
+
+	SensorDataFilterRule();
+
+	void setType(const std::string &type);
+
+	/**
+	 * @returns true if the rule is applied to values of unknown type
+	 */
+	bool isDefault() const;
+	ModuleType::Type type() const;
+
+	void setDeadband(double deadband);
+	double deadband() const;
+
+	void setMinInterval(const Poco::Timespan &interval);
+	Poco::Timespan minInterval() const;
+
+	void setHeartbeat(const Poco::Timespan &heartbeat);
+	Poco::Timespan heartbeat() const;
+
+private:
+	bool m_default;
+	ModuleType::Type m_type;
+	double m_deadband;
+	Poco::Timespan m_minInterval;
+	Poco::Timespan m_heartbeat;
+};
+
+}
@@ -26,6 +26,7 @@
 #include "model/RefreshTime.h"
 #include "net/MACAddress.h"
 #include "util/ArgsParser.h"
+#include "util/MetricsRegistry.h"
 
 BEEEON_OBJECT_BEGIN(BeeeOn, TestingCenter)
 BEEEON_OBJECT_CASTABLE(CommandHandler)
@@ -474,6 +475,22 @@ static void credentialsAction(TestingCenter::ActionContext &context)
 	}
 }
 
+/**
+ * Print snapshot of the global metrics registry. An optional argument
+ * restricts the output to metrics with the given name prefix.
+ */
+static void metricsAction(TestingCenter::ActionContext &context)
+{
+	ConsoleSession &console = context.console;
+	auto &args = context.args;
+
+	const string prefix = args.size() > 1 ? args[1] : "";
+	const auto snapshot = MetricsRegistry::global().snapshot(prefix);
+
+	for (const auto &pair : snapshot)
+		console.print(pair.first + " " + to_string(pair.second));
+}
+
 TestingCenter::TestingCenter():
 	m_stop(0)
 {
@@ -482,6 +499,7 @@ TestingCenter::TestingCenter():
 	registerAction("wait-queue", waitQueueAction, "wait for new command answers");
 	registerAction("device", deviceAction, "simulate device in server database");
 	registerAction("credentials", credentialsAction, "manage credentials storage");
+	registerAction("metrics", metricsAction, "print metrics with optional name prefix");
 }
 
 void TestingCenter::registerAction(
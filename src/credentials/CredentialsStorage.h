@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <map>
+#include <unordered_map>
 
 #include <Poco/Util/AbstractConfiguration.h>
 #include <Poco/StringTokenizer.h>
@@ -80,11 +81,18 @@ protected:
 	void removeUnlocked(const DeviceID &device);
 	void clearUnlocked();
 
-private:
 	Poco::SharedPtr<Credentials> createCredential(
 		Poco::AutoPtr<Poco::Util::AbstractConfiguration> conf);
 
-	std::map<DeviceID, Poco::SharedPtr<Credentials>> m_credentialsMap;
+private:
+	struct DeviceIDHash {
+		size_t operator ()(const DeviceID &id) const
+		{
+			return std::hash<uint64_t>()(id);
+		}
+	};
+
+	std::unordered_map<DeviceID, Poco::SharedPtr<Credentials>, DeviceIDHash> m_credentialsMap;
 	std::map<std::string, CredentialsFactory> m_factory;
 	mutable Poco::RWLock m_lock;
 };
@@ -1,6 +1,10 @@
+#include <Poco/File.h>
 #include <Poco/Path.h>
+#include <Poco/StringTokenizer.h>
 #include <Poco/Timer.h>
+#include <Poco/URI.h>
 #include <Poco/Util/AbstractConfiguration.h>
+#include <Poco/Util/MapConfiguration.h>
 
 #include "FileCredentialsStorage.h"
 #include "util/ConfigurationLoader.h"
@@ -12,6 +16,7 @@ BEEEON_OBJECT_CASTABLE(CredentialsStorage)
 BEEEON_OBJECT_PROPERTY("file", &FileCredentialsStorage::setFile)
 BEEEON_OBJECT_PROPERTY("configurationRoot", &FileCredentialsStorage::setConfigRoot)
 BEEEON_OBJECT_PROPERTY("saveDelayTime", &FileCredentialsStorage::setSaveDelay)
+BEEEON_OBJECT_PROPERTY("journalMaxSize", &FileCredentialsStorage::setJournalMaxSize)
 BEEEON_OBJECT_HOOK("done", &FileCredentialsStorage::load)
 BEEEON_OBJECT_END(BeeeOn, FileCredentialsStorage)
 
@@ -20,11 +25,17 @@ using namespace Poco;
 using namespace Poco::Util;
 using namespace std;
 
+/**
+ * Journal record denoting removed credentials.
+ */
+static const string REMOVED = "";
+
 FileCredentialsStorage::FileCredentialsStorage():
 	m_confRoot("credentials"),
 	m_callback(*this, &FileCredentialsStorage::onSaveLater),
 	m_timerRunning(false),
-	m_saveDelayTime(30 * Timespan::MINUTES)
+	m_saveDelayTime(30 * Timespan::MINUTES),
+	m_journalMaxSize(64 * 1024)
 {
 }
 
@@ -51,6 +62,14 @@ void FileCredentialsStorage::setSaveDelay(const Timespan &delay)
 	m_saveDelayTime = delay;
 }
 
+void FileCredentialsStorage::setJournalMaxSize(int bytes)
+{
+	if (bytes < 0)
+		throw InvalidArgumentException("journalMaxSize must not be negative");
+
+	m_journalMaxSize = bytes;
+}
+
 void FileCredentialsStorage::setFile(const string &path)
 {
 	m_file = path;
@@ -67,21 +86,32 @@ void FileCredentialsStorage::insertOrUpdate(
 {
 	RWLock::ScopedWriteLock guard(lock());
 	insertOrUpdateUnlocked(device, credentials);
-	saveLater();
+	journalChange(device, credentials);
 }
 
 void FileCredentialsStorage::remove(const DeviceID &device)
 {
 	RWLock::ScopedWriteLock guard(lock());
 	removeUnlocked(device);
-	saveLater();
+	journalChange(device, nullptr);
 }
 
 void FileCredentialsStorage::clear()
 {
 	RWLock::ScopedWriteLock guard(lock());
 	clearUnlocked();
-	saveLater();
+
+	if (m_journal.isNull()) {
+		saveLater();
+		return;
+	}
+
+	// the snapshot is empty now, no reason to journal every removal
+	if (m_timerRunning) {
+		m_timer.stop();
+		m_timerRunning = false;
+	}
+	saveUnlocked();
 }
 
 void FileCredentialsStorage::load()
@@ -99,6 +129,138 @@ void FileCredentialsStorage::load()
 		logger().warning("could not load credentials due to an I/O error",
 			__FILE__, __LINE__);
 	}
+
+	try {
+		replayJournal();
+	} catch (const Exception &e) {
+		logger().log(e, __FILE__, __LINE__);
+		logger().warning("credentials journal is disabled, changes are saved after "
+			+ to_string(m_saveDelayTime.totalSeconds()) + " s",
+			__FILE__, __LINE__);
+
+		m_journal = nullptr;
+	}
+}
+
+void FileCredentialsStorage::replayJournal()
+{
+	Journal::Ptr journal = new Journal(m_file + ".journal");
+	journal->checkExisting();
+	journal->createEmpty();
+	journal->load(true);
+
+	RWLock::ScopedWriteLock guard(lock());
+
+	size_t count = 0;
+
+	for (const auto &record : journal->records()) {
+		try {
+			const DeviceID id = DeviceID::parse(record.key);
+
+			if (record.value == REMOVED)
+				removeUnlocked(id);
+			else
+				insertOrUpdateUnlocked(id, parseChange(record.value));
+
+			count += 1;
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	}
+
+	m_journal = journal;
+
+	if (count > 0) {
+		logger().information("replayed " + to_string(count)
+			+ " credentials changes from journal",
+			__FILE__, __LINE__);
+
+		// compact the replayed changes later
+		saveLater();
+	}
+}
+
+void FileCredentialsStorage::journalChange(
+		const DeviceID &device,
+		const SharedPtr<Credentials> credentials)
+{
+	if (m_journal.isNull()) {
+		saveLater();
+		return;
+	}
+
+	try {
+		if (credentials.isNull())
+			m_journal->append(device.toString(), REMOVED);
+		else
+			m_journal->append(device.toString(), formatChange(device, credentials));
+
+		if (m_journal->committedBytes() > m_journalMaxSize)
+			saveLater();
+	}
+	BEEEON_CATCH_CHAIN_ACTION(logger(),
+		saveLater())
+}
+
+/**
+ * Append all values of the given configuration as <key>=<value> pairs
+ * separated by ';' into the line. Keys and values are URI-encoded to
+ * never contain any of '=', ';', TAB or LF.
+ */
+static void formatValues(
+		AutoPtr<AbstractConfiguration> conf,
+		const string &prefix,
+		string &line)
+{
+	AbstractConfiguration::Keys keys;
+	conf->keys(keys);
+
+	for (const auto &key : keys) {
+		const string name = prefix.empty()? key : prefix + "." + key;
+
+		if (conf->hasValue(key)) {
+			if (!line.empty())
+				line += ";";
+
+			URI::encode(name, "=;", line);
+			line += "=";
+			URI::encode(conf->getRawString(key), "=;", line);
+		}
+
+		formatValues(conf->createView(key), name, line);
+	}
+}
+
+string FileCredentialsStorage::formatChange(
+		const DeviceID &device,
+		const SharedPtr<Credentials> credentials) const
+{
+	AutoPtr<AbstractConfiguration> conf = new MapConfiguration;
+	credentials->save(conf, device, m_confRoot);
+
+	string line;
+	formatValues(conf->createView(m_confRoot + "." + device.toString()), "", line);
+	return line;
+}
+
+SharedPtr<Credentials> FileCredentialsStorage::parseChange(const string &value)
+{
+	AutoPtr<AbstractConfiguration> conf = new MapConfiguration;
+	StringTokenizer pairs(value, ";", StringTokenizer::TOK_IGNORE_EMPTY);
+
+	for (const auto &pair : pairs) {
+		const auto sep = pair.find("=");
+		if (sep == string::npos)
+			throw SyntaxException("malformed credentials record: " + pair);
+
+		string name;
+		string content;
+		URI::decode(pair.substr(0, sep), name);
+		URI::decode(pair.substr(sep + 1), content);
+
+		conf->setString(name, content);
+	}
+
+	return createCredential(conf);
 }
 
 void FileCredentialsStorage::save()
@@ -112,12 +274,30 @@ void FileCredentialsStorage::save()
 	saveUnlocked();
 }
 
-void FileCredentialsStorage::saveUnlocked() const
+bool FileCredentialsStorage::saveScheduled() const
+{
+	return m_timerRunning > 0;
+}
+
+void FileCredentialsStorage::saveUnlocked()
 {
 	ConfigurationSaver saver(m_file);
 	AutoPtr<AbstractConfiguration> conf = saver.config();
 	CredentialsStorage::save(conf, m_confRoot);
 	saver.save();
+
+	if (!m_journal.isNull()) {
+		// all changes are in the snapshot now, replaying the journal
+		// after a crash just here would lead to the same state
+		const string path = m_file + ".journal";
+		File file(path);
+		if (file.exists())
+			file.remove();
+
+		m_journal = new Journal(path);
+		m_journal->createEmpty();
+	}
+
 	poco_information(logger(), "credentials saved");
 }
 
@@ -146,7 +326,7 @@ void FileCredentialsStorage::onSaveLater(Timer &)
 	logger().debug("attempt to autosave");
 
 	try {
-		RWLock::ScopedReadLock guard(lock());
+		RWLock::ScopedWriteLock guard(lock());
 		saveUnlocked();
 		m_timerRunning = false;
 	}
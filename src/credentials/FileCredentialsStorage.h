@@ -4,6 +4,7 @@
 #include <Poco/Timespan.h>
 
 #include "credentials/CredentialsStorage.h"
+#include "util/Journal.h"
 
 namespace BeeeOn{
 
@@ -12,6 +13,15 @@ namespace BeeeOn{
  * methods for saving credentials to file and loading them from it.
  * To load from file, it is necessary to setFile and optionally
  * to setConfigRoot, then call load.
+ *
+ * The file holds a snapshot of all credentials. Every change is
+ * immediately appended into a Journal (<file>.journal) as a single
+ * checksummed record, thus a change costs a write of the changed
+ * credentials only. The journal is replayed over the snapshot while
+ * loading. The snapshot is rewritten and the journal emptied
+ * (compacted) SaveDelayTime after the journal grows over JournalMaxSize.
+ * When the journal is unavailable, every change leads to rewrite of
+ * the snapshot after SaveDelayTime.
  */
 class FileCredentialsStorage : public CredentialsStorage {
 public:
@@ -28,17 +38,28 @@ public:
 	void setConfigRoot(const std::string &root);
 
 	/**
-	 * If a change occurs in Credentials (inserting, updating, or removing),
-	 * FileCredentialsStorage will be automaticly saved after SaveDelayTime
-	 * (from the first change).
+	 * If the journal grows over JournalMaxSize (or a change cannot be
+	 * journaled), FileCredentialsStorage will be automaticly compacted
+	 * into the snapshot after SaveDelayTime.
 	 * Default SaveDelayTime is 30min.
 	 * Passing negative number to this funcion causes disabling of autosave (if
 	 * autosave timer is already running, storage is saved).
 	 */
 	void setSaveDelay(const Poco::Timespan &delay);
+
+	/**
+	 * Size of the journal in bytes that triggers its compaction.
+	 * Default JournalMaxSize is 64 kB.
+	 */
+	void setJournalMaxSize(int bytes);
 	void load();
 	void save();
 
+	/**
+	 * @returns true if the delayed save (compaction) is scheduled
+	 */
+	bool saveScheduled() const;
+
 	void insertOrUpdate(
 		const DeviceID &device,
 		const Poco::SharedPtr<Credentials> credentials) override;
@@ -53,15 +74,38 @@ protected:
 	void saveLater();
 	void onSaveLater(Poco::Timer &);
 
-	void saveUnlocked() const;
+	void saveUnlocked();
+
+	/**
+	 * Append the given change into the journal (if any) and schedule
+	 * compaction when the change cannot be journaled or the journal
+	 * is too big. Failures are only logged as the change is persisted
+	 * by the scheduled save.
+	 * This method must be always called while holding the write-lock.
+	 */
+	void journalChange(
+		const DeviceID &device,
+		const Poco::SharedPtr<Credentials> credentials);
+
+	/**
+	 * Load the journal and apply its records over the loaded snapshot.
+	 */
+	void replayJournal();
+
+	std::string formatChange(
+		const DeviceID &device,
+		const Poco::SharedPtr<Credentials> credentials) const;
+	Poco::SharedPtr<Credentials> parseChange(const std::string &value);
 
 private:
 	std::string m_file;
 	std::string m_confRoot;
+	Journal::Ptr m_journal;
 	Poco::Timer m_timer;
 	Poco::TimerCallback<FileCredentialsStorage> m_callback;
 	Poco::AtomicCounter m_timerRunning;
 	Poco::Timespan m_saveDelayTime;
+	size_t m_journalMaxSize;
 };
 
 }
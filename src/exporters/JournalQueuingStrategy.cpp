@@ -1,3 +1,4 @@
+#include <Poco/Clock.h>
 #include <Poco/DateTimeFormat.h>
 #include <Poco/DateTimeFormatter.h>
 #include <Poco/DigestStream.h>
@@ -43,7 +44,12 @@ JournalQueuingStrategy::JournalQueuingStrategy():
 	m_gcDisabled(false),
 	m_neverDropOldest(false),
 	m_bytesLimit(-1),
-	m_ignoreIndexErrors(true)
+	m_ignoreIndexErrors(true),
+	m_pushed(m_metrics.counter("journal.pushed")),
+	m_pushedBytes(m_metrics.counter("journal.pushed_bytes")),
+	m_popped(m_metrics.counter("journal.popped")),
+	m_pushLatency(m_metrics.histogram("journal.push_us",
+		{1000, 10000, 100000, 1000000}))
 {
 }
 
@@ -307,12 +313,18 @@ Journal::Ptr JournalQueuingStrategy::index() const
 
 void JournalQueuingStrategy::push(const vector<SensorData> &data)
 {
+	const Clock started;
+
 	const string &buffer = FileBuffer::formatEntries(data);
 	if (!garbageCollect(buffer.size()))
 		dropOldestBuffers(buffer.size());
 
 	const auto &name = writeData(buffer);
 	m_index->append(name, "0");
+
+	m_pushed->add(data.size());
+	m_pushedBytes->add(buffer.size());
+	m_pushLatency->observe(started.elapsed());
 }
 
 size_t JournalQueuingStrategy::readEntries(
@@ -468,6 +480,8 @@ void JournalQueuingStrategy::pop(size_t count)
 	k = 0;
 	for (auto it = m_entryCache.begin(); k < cacheCount; ++k)
 		it = m_entryCache.erase(it);
+
+	m_popped->add(total);
 }
 
 void JournalQueuingStrategy::collectReferenced(set<string> &referenced) const
@@ -859,8 +873,8 @@ string JournalQueuingStrategy::FileBuffer::formatEntries(
 	string buffer;
 
 	for (const auto &one : data) {
-		buffer += formatter.format(one);
-		buffer += "\n";
+		formatter.formatTo(one, buffer);
+		buffer += '\n';
 	}
 
 	return buffer;
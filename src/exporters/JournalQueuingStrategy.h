@@ -13,6 +13,7 @@
 #include "exporters/QueuingStrategy.h"
 #include "util/Journal.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
@@ -392,6 +393,12 @@ private:
 	 * @brief Peeked entries waiting to be popped.
 	 */
 	std::list<Entry> m_entryCache;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_pushed;
+	CounterMetric::Ptr m_pushedBytes;
+	CounterMetric::Ptr m_popped;
+	HistogramMetric::Ptr m_pushLatency;
 };
 
 }
@@ -4,15 +4,20 @@
 
 #include "di/Injectable.h"
 #include "exporters/MqttExporter.h"
+#include "util/JSONSensorDataFormatter.h"
 #include "util/NullSensorDataFormatter.h"
 #include "util/SensorDataFormatter.h"
 
 BEEEON_OBJECT_BEGIN(BeeeOn, MqttExporter)
 BEEEON_OBJECT_CASTABLE(Exporter)
+BEEEON_OBJECT_CASTABLE(StoppableRunnable)
 BEEEON_OBJECT_PROPERTY("topic", &MqttExporter::setTopic)
 BEEEON_OBJECT_PROPERTY("qos", &MqttExporter::setQos)
 BEEEON_OBJECT_PROPERTY("formatter", &MqttExporter::setFormatter)
 BEEEON_OBJECT_PROPERTY("mqttClient", &MqttExporter::setMqttClient)
+BEEEON_OBJECT_PROPERTY("batchSize", &MqttExporter::setBatchSize)
+BEEEON_OBJECT_PROPERTY("batchBytes", &MqttExporter::setBatchBytes)
+BEEEON_OBJECT_PROPERTY("batchDelay", &MqttExporter::setBatchDelay)
 BEEEON_OBJECT_END(BeeeOn, MqttExporter)
 
 using namespace BeeeOn;
@@ -21,12 +26,22 @@ using namespace std;
 
 const static string DEFAULT_TOPIC = "BeeeOnOut";
 const static string DEFAULT_CLIENT_ID = "GatewayExporterClient";
+const static size_t DEFAULT_BATCH_BYTES = 64 * 1024;
+const static Timespan DEFAULT_BATCH_DELAY = 1 * Timespan::SECONDS;
 
 MqttExporter::MqttExporter():
 	m_topic(DEFAULT_TOPIC),
 	m_qos(MqttMessage::EXACTLY_ONCE),
-	m_clientID(DEFAULT_CLIENT_ID)
+	m_clientID(DEFAULT_CLIENT_ID),
+	m_batchSize(0),
+	m_batchBytes(DEFAULT_BATCH_BYTES),
+	m_batchDelay(DEFAULT_BATCH_DELAY),
+	m_jsonBatch(false),
+	m_batchRecords(0),
+	m_stop(false)
 {
+	m_messages = m_metrics.counter("exporter.MqttExporter.messages");
+	m_records = m_metrics.counter("exporter.MqttExporter.records");
 }
 
 MqttExporter::~MqttExporter()
@@ -46,13 +61,107 @@ void MqttExporter::setMqttClient(MqttClient::Ptr client)
 void MqttExporter::setFormatter(const SharedPtr<SensorDataFormatter> formatter)
 {
 	m_formatter = formatter;
+	m_jsonBatch = !formatter.cast<JSONSensorDataFormatter>().isNull();
+}
+
+void MqttExporter::setBatchSize(int size)
+{
+	if (size < 0)
+		throw InvalidArgumentException("batchSize must not be negative");
+
+	m_batchSize = size;
+}
+
+void MqttExporter::setBatchBytes(int bytes)
+{
+	if (bytes < 1)
+		throw InvalidArgumentException("batchBytes must be positive");
+
+	m_batchBytes = bytes;
+}
+
+void MqttExporter::setBatchDelay(const Timespan &delay)
+{
+	if (delay < 0)
+		throw InvalidArgumentException("batchDelay must not be negative");
+
+	m_batchDelay = delay;
+}
+
+bool MqttExporter::batched() const
+{
+	return m_batchSize > 1;
+}
+
+bool MqttExporter::batchFull() const
+{
+	return m_batchRecords >= m_batchSize || m_batch.size() >= m_batchBytes;
 }
 
 bool MqttExporter::ship(const SensorData &data)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (!batched()) {
+		m_record.clear();
+		m_formatter->formatTo(data, m_record);
+
+		return publish(m_record, 1);
+	}
+
+	// back-pressure: the full batch could not be published yet
+	if (m_batchRecords > 0 && batchFull() && !flushBatch())
+		return false;
+
+	if (m_batchRecords == 0) {
+		m_batch.clear();
+
+		if (m_jsonBatch)
+			m_batch += '[';
+
+		m_batchStarted.update();
+		m_condition.signal();
+	}
+	else {
+		m_batch += m_jsonBatch ? ',' : '\n';
+	}
+
+	m_formatter->formatTo(data, m_batch);
+	m_batchRecords += 1;
+
+	// the record is accepted even if the publish fails
+	if (batchFull() || m_batchStarted.isElapsed(m_batchDelay.totalMicroseconds()))
+		flushBatch();
+
+	return true;
+}
+
+bool MqttExporter::flushBatch()
+{
+	if (m_batchRecords == 0)
+		return true;
+
+	if (m_jsonBatch)
+		m_batch += ']';
+
+	if (!publish(m_batch, m_batchRecords)) {
+		// keep the batch open for further appending
+		if (m_jsonBatch)
+			m_batch.pop_back();
+
+		return false;
+	}
+
+	m_batch.clear();
+	m_batchRecords = 0;
+	return true;
+}
+
+bool MqttExporter::publish(const string &payload, size_t records)
 {
 	MqttMessage msg = {
 		m_topic,
-		m_formatter->format(data),
+		payload,
 		m_qos
 	};
 
@@ -64,9 +173,66 @@ bool MqttExporter::ship(const SensorData &data)
 		return false;
 	}
 
+	m_messages->add();
+	m_records->add(records);
+
 	return true;
 }
 
+void MqttExporter::run()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	while (!m_stop) {
+		if (m_batchRecords == 0) {
+			m_condition.wait(m_lock);
+			continue;
+		}
+
+		const Timespan age = m_batchStarted.elapsed();
+
+		if (age < m_batchDelay) {
+			const Timespan remaining = m_batchDelay - age;
+			m_condition.tryWait(m_lock, max<long>(1, remaining.totalMilliseconds()));
+			continue;
+		}
+
+		if (!flushBatch()) {
+			// try again after another delay
+			m_condition.tryWait(m_lock, max<long>(1, m_batchDelay.totalMilliseconds()));
+		}
+	}
+
+	if (!flushBatch()) {
+		logger().warning(
+			"dropping " + to_string(m_batchRecords) + " unpublished records",
+			__FILE__, __LINE__);
+
+		m_batch.clear();
+		m_batchRecords = 0;
+	}
+
+	m_stop = false;
+}
+
+void MqttExporter::stop()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_stop = true;
+	m_condition.broadcast();
+}
+
+uint64_t MqttExporter::publishedMessages() const
+{
+	return m_messages->value();
+}
+
+uint64_t MqttExporter::publishedRecords() const
+{
+	return m_records->value();
+}
+
 void MqttExporter::setQos(const int qos)
 {
 	switch (qos) {
@@ -2,19 +2,45 @@
 
 #include <string>
 
+#include <Poco/Clock.h>
+#include <Poco/Condition.h>
 #include <Poco/Logger.h>
+#include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
 
 #include "core/Exporter.h"
+#include "loop/StoppableRunnable.h"
 #include "net/MqttClient.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
 class SensorDataFormatter;
 
+/**
+ * @brief MqttExporter publishes the exported SensorData to the configured
+ * MQTT topic. By default, each SensorData is published as a separate
+ * message.
+ *
+ * In the batched mode (batchSize > 1), the formatted records are collected
+ * and published together as a single message. When using the
+ * JSONSensorDataFormatter, the message is a JSON array of the records,
+ * otherwise the records are separated by new lines. A batch is published
+ * when it contains batchSize records, when it exceeds batchBytes or when
+ * its oldest record is older than batchDelay. The delay is watched by the
+ * run() method that must be executed by a dedicated thread.
+ *
+ * When a full batch cannot be published, ship() returns false and the
+ * caller is expected to retry later.
+ *
+ * The number of published messages and records is available as metrics
+ * exporter.MqttExporter.messages and exporter.MqttExporter.records.
+ */
 class MqttExporter :
 	public Exporter,
+	public StoppableRunnable,
 	protected Loggable {
 public:
 	MqttExporter();
@@ -30,12 +56,67 @@ public:
 
 	void setFormatter(const Poco::SharedPtr<SensorDataFormatter> formatter);
 
+	/**
+	 * @brief Max number of records published in a single message.
+	 * Value 0 or 1 disables the batched mode.
+	 */
+	void setBatchSize(int size);
+
+	/**
+	 * @brief Max size of a batch in bytes. A batch exceeding this size
+	 * is published immediately.
+	 */
+	void setBatchBytes(int bytes);
+
+	/**
+	 * @brief Max time a record can wait in a batch before publishing.
+	 */
+	void setBatchDelay(const Poco::Timespan &delay);
+
+	/**
+	 * @brief Publish batches delayed for too long.
+	 */
+	void run() override;
+	void stop() override;
+
+	uint64_t publishedMessages() const;
+	uint64_t publishedRecords() const;
+
+protected:
+	bool batched() const;
+
+	bool batchFull() const;
+
+	/**
+	 * @brief Publish the current batch. The m_lock must be held.
+	 * @returns false when publishing has failed, the batch is kept
+	 */
+	bool flushBatch();
+
+	bool publish(const std::string &payload, size_t records);
+
 private:
 	std::string m_topic;
 	MqttMessage::QoS m_qos;
 	std::string m_clientID;
 	Poco::SharedPtr<SensorDataFormatter> m_formatter;
 	MqttClient::Ptr m_mqtt;
+	size_t m_batchSize;
+	size_t m_batchBytes;
+	Poco::Timespan m_batchDelay;
+
+	bool m_jsonBatch;
+	std::string m_batch;
+	size_t m_batchRecords;
+	Poco::Clock m_batchStarted;
+	std::string m_record;
+	bool m_stop;
+	Poco::FastMutex m_lock;
+	Poco::Condition m_condition;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_messages;
+	CounterMetric::Ptr m_records;
 };
 
 }
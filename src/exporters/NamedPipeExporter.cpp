@@ -1,11 +1,15 @@
 #include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <Poco/Exception.h>
+#include <Poco/NumberFormatter.h>
 
 #include "di/Injectable.h"
 #include "exporters/NamedPipeExporter.h"
@@ -18,41 +22,276 @@ BEEEON_OBJECT_BEGIN(BeeeOn, NamedPipeExporter)
 BEEEON_OBJECT_CASTABLE(Exporter)
 BEEEON_OBJECT_PROPERTY("filePath", &NamedPipeExporter::setFilePath)
 BEEEON_OBJECT_PROPERTY("formatter", &NamedPipeExporter::setFormatter)
+BEEEON_OBJECT_PROPERTY("persistent", &NamedPipeExporter::setPersistent)
+BEEEON_OBJECT_PROPERTY("batchSize", &NamedPipeExporter::setBatchSize)
+BEEEON_OBJECT_PROPERTY("statsInterval", &NamedPipeExporter::setStatsInterval)
 BEEEON_OBJECT_END(BeeeOn, NamedPipeExporter)
 
 using namespace BeeeOn;
 using namespace Poco;
 using namespace std;
 
+static const size_t DEFAULT_BATCH_SIZE = 64;
+
+/**
+ * Write to the given descriptor while SIGPIPE is blocked for the calling
+ * thread. If the reader has disappeared, the generated SIGPIPE is consumed
+ * and the writev() fails with EPIPE instead of terminating the process.
+ */
+static ssize_t writevNoSignal(int fd, const struct iovec *iov, int count)
+{
+	sigset_t pipeMask;
+	sigset_t oldMask;
+	sigset_t pending;
+
+	sigemptyset(&pipeMask);
+	sigaddset(&pipeMask, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipeMask, &oldMask);
+
+	sigpending(&pending);
+	const bool wasPending = sigismember(&pending, SIGPIPE);
+
+	const ssize_t ret = writev(fd, iov, count);
+	const int error = errno;
+
+	if (ret < 0 && error == EPIPE && !wasPending) {
+		const struct timespec zero = {0, 0};
+		sigtimedwait(&pipeMask, NULL, &zero);
+	}
+
+	pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+
+	errno = error;
+	return ret;
+}
+
 NamedPipeExporter::NamedPipeExporter() :
-	m_formatter(&NullSensorDataFormatter::instance())
+	m_formatter(&NullSensorDataFormatter::instance()),
+	m_persistent(false),
+	m_batchSize(DEFAULT_BATCH_SIZE),
+	m_statsInterval(0),
+	m_fd(-1),
+	m_pendingOffset(0),
+	m_stats(new IOStats),
+	m_writeCalls(0),
+	m_lastReported({0, 0, 0, 0, 0, 0}),
+	m_lastReportedCalls(0)
 {
+	m_metrics.ioStats("exporter.NamedPipeExporter.io", m_stats);
 }
 
 NamedPipeExporter::~NamedPipeExporter()
 {
+	if (m_fd >= 0) {
+		try {
+			flushPending();
+		}
+		BEEEON_CATCH_CHAIN(logger())
+
+		if (!m_pending.empty()) {
+			logger().warning(
+				"dropping " + to_string(m_pending.size())
+				+ " pending records",
+				__FILE__, __LINE__);
+		}
+
+		closePipe();
+	}
+
 	if (!m_pipePath.empty())
 		remove(m_pipePath.c_str());
 }
 
 bool NamedPipeExporter::ship(const SensorData &data)
 {
+	if (m_persistent) {
+		const bool shipped = shipPersistent(data);
+		reportStats();
+		return shipped;
+	}
+
 	int fd = openPipe();
 
-	if (fd < 0 && errno == ENXIO)
+	if (fd < 0 && errno == ENXIO) {
+		// no reader, the record is not even formatted
+		m_stats->lost(0);
+		reportStats();
 		return true;
+	}
 	if (fd < 0 && errno == EINTR)
 		return false;
 
 	poco_assert(fd >= 0);
 
+	bool shipped;
+
 	try {
-		return writeAndClose(fd, m_formatter->format(data) + "\n");
+		m_buffer.clear();
+		m_formatter->formatTo(data, m_buffer);
+		m_buffer += '\n';
+
+		shipped = writeAndClose(fd, m_buffer);
 	}
 	catch (...) {
 		close(fd);
 		throw;
 	}
+
+	reportStats();
+	return shipped;
+}
+
+bool NamedPipeExporter::shipPersistent(const SensorData &data)
+{
+	if (m_fd < 0) {
+		const int fd = openPipe();
+
+		if (fd < 0 && errno == ENXIO) {
+			m_stats->lost(0);
+			return true;
+		}
+		if (fd < 0 && errno == EINTR)
+			return false;
+
+		poco_assert(fd >= 0);
+		m_fd = fd;
+
+		if (logger().debug()) {
+			logger().debug(
+				"named pipe " + m_pipePath + " opened",
+				__FILE__, __LINE__);
+		}
+	}
+
+	if (m_pending.size() >= m_batchSize) {
+		flushPending();
+
+		// the reader is too slow, try again later
+		if (m_pending.size() >= m_batchSize)
+			return false;
+	}
+
+	string record;
+	m_formatter->formatTo(data, record);
+	record += '\n';
+
+	m_pending.emplace_back(std::move(record));
+	flushPending();
+
+	return true;
+}
+
+void NamedPipeExporter::flushPending()
+{
+	struct iovec iov[IOV_MAX];
+
+	while (!m_pending.empty() && m_fd >= 0) {
+		int count = 0;
+
+		for (const auto &record : m_pending) {
+			if (count >= IOV_MAX)
+				break;
+
+			const size_t offset = count == 0 ? m_pendingOffset : 0;
+			iov[count].iov_base = const_cast<char *>(record.data() + offset);
+			iov[count].iov_len = record.size() - offset;
+			++count;
+		}
+
+		ssize_t written = writevNoSignal(m_fd, iov, count);
+
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return;
+
+		if (written < 0 && errno == EPIPE) {
+			logger().information(
+				"reader of " + m_pipePath + " has disappeared",
+				__FILE__, __LINE__);
+
+			closePipe();
+			return;
+		}
+
+		if (written < 0) {
+			const string error = strerror(errno);
+			closePipe();
+
+			throw IOException(
+				"failed to write fifo: " + error);
+		}
+
+		m_writeCalls += 1;
+
+		while (written > 0) {
+			const size_t rest = m_pending.front().size() - m_pendingOffset;
+
+			if (size_t(written) < rest) {
+				m_pendingOffset += written;
+				break;
+			}
+
+			written -= rest;
+			m_stats->written(m_pending.front().size());
+			m_pending.pop_front();
+			m_pendingOffset = 0;
+		}
+	}
+}
+
+void NamedPipeExporter::dropPending()
+{
+	for (const auto &record : m_pending)
+		m_stats->lost(record.size());
+
+	m_pending.clear();
+	m_pendingOffset = 0;
+}
+
+void NamedPipeExporter::closePipe()
+{
+	if (m_fd < 0)
+		return;
+
+	dropPending();
+
+	close(m_fd);
+	m_fd = -1;
+}
+
+void NamedPipeExporter::reportStats()
+{
+	if (m_statsInterval <= 0)
+		return;
+
+	if (!m_lastReport.isElapsed(m_statsInterval.totalMicroseconds()))
+		return;
+
+	const IOStats::Data current = m_stats->data();
+	const uint64_t calls = m_writeCalls;
+	const double seconds = m_lastReport.elapsed() / 1000000.0;
+
+	const double bytesPerSecond =
+		(current.writtenBytes - m_lastReported.writtenBytes) / seconds;
+	const double recordsPerSecond =
+		(current.writtenPdu - m_lastReported.writtenPdu) / seconds;
+	const double recordsPerCall = calls == m_lastReportedCalls ? 0 :
+		double(current.writtenPdu - m_lastReported.writtenPdu)
+			/ (calls - m_lastReportedCalls);
+
+	logger().information(
+		"written/lost: " + current.toString()
+		+ "; write calls: " + to_string(calls)
+		+ " (" + NumberFormatter::format(recordsPerCall, 1) + " records/call)"
+		+ "; throughput: "
+		+ NumberFormatter::format(recordsPerSecond, 1) + " records/s, "
+		+ NumberFormatter::format(bytesPerSecond, 1) + " B/s",
+		__FILE__, __LINE__);
+
+	m_lastReported = current;
+	m_lastReportedCalls = calls;
+	m_lastReport.update();
 }
 
 void NamedPipeExporter::setFilePath(const string &path)
@@ -65,6 +304,44 @@ void NamedPipeExporter::setFormatter(SensorDataFormatter *formatter)
 	m_formatter = formatter;
 }
 
+void NamedPipeExporter::setPersistent(bool persistent)
+{
+	m_persistent = persistent;
+}
+
+void NamedPipeExporter::setBatchSize(int size)
+{
+	if (size < 1 || size > IOV_MAX) {
+		throw InvalidArgumentException(
+			"batchSize must be in range 1.." + to_string(IOV_MAX));
+	}
+
+	m_batchSize = size;
+}
+
+void NamedPipeExporter::setStatsInterval(const Timespan &interval)
+{
+	if (interval < 0)
+		throw InvalidArgumentException("statsInterval must not be negative");
+
+	m_statsInterval = interval;
+}
+
+IOStats::Data NamedPipeExporter::stats() const
+{
+	return m_stats->data();
+}
+
+uint64_t NamedPipeExporter::writeCalls() const
+{
+	return m_writeCalls;
+}
+
+size_t NamedPipeExporter::pending() const
+{
+	return m_pending.size();
+}
+
 int NamedPipeExporter::openPipe()
 {
 	unsigned int attempts = ATTEMPTS_CREATE_PIPE;
@@ -151,9 +428,13 @@ bool NamedPipeExporter::writeAndClose(int fd, const string &msg)
 				+ string(strerror(errno)));
 		}
 
+		m_writeCalls += 1;
 		restLength += writtenLength;
 	} while(restLength < totalLength);
 
+	if (restLength >= totalLength)
+		m_stats->written(totalLength);
+
 	if (logger().debug()) {
 		logger().debug(
 			"written " + to_string(restLength) + "/"
@@ -1,15 +1,41 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <string>
+
+#include <Poco/Clock.h>
 #include <Poco/Logger.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
 
 #include "core/Exporter.h"
+#include "io/IOStats.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
 class SensorDataFormatter;
 
+/**
+ * @brief NamedPipeExporter writes formatted SensorData into a named
+ * pipe (FIFO), one record per line. When there is no reader, the data
+ * are dropped.
+ *
+ * By default, the pipe is opened and closed for every single record.
+ * In the persistent mode, the pipe is kept open. Records that cannot be
+ * written immediately (the reader is slow) are kept pending and written
+ * later together by a single writev(2). If the number of pending records
+ * reaches the batchSize, the ship() returns false to apply back-pressure
+ * to the caller instead of blocking it. When the reader disappears,
+ * the pending records are dropped and the pipe is reopened by the next
+ * ship().
+ *
+ * The I/O statistics (records, bytes, number of write calls and
+ * throughput) can be logged periodically. The written and lost records
+ * are also available as metric exporter.NamedPipeExporter.io.
+ */
 class NamedPipeExporter :
 	public Exporter,
 	public Loggable {
@@ -33,6 +59,38 @@ public:
 	 */
 	void setFormatter(SensorDataFormatter * formatter);
 
+	/**
+	 * @brief Keep the named pipe open between ship() calls.
+	 */
+	void setPersistent(bool persistent);
+
+	/**
+	 * @brief Maximal number of records pending in the persistent
+	 * mode. At least 1, at most IOV_MAX.
+	 */
+	void setBatchSize(int size);
+
+	/**
+	 * @brief Interval of logging the I/O statistics. Zero
+	 * disables the logging.
+	 */
+	void setStatsInterval(const Poco::Timespan &interval);
+
+	/**
+	 * @returns statistics of written and lost records
+	 */
+	IOStats::Data stats() const;
+
+	/**
+	 * @returns number of write system calls issued so far
+	 */
+	uint64_t writeCalls() const;
+
+	/**
+	 * @returns number of records pending in the persistent mode
+	 */
+	size_t pending() const;
+
 private:
 	/**
 	 * Create pipe file (mkfifo)
@@ -48,8 +106,48 @@ private:
 	 */
 	bool writeAndClose(int fd, const std::string &msg);
 
+	/**
+	 * @brief Ship the given data via the persistently opened pipe.
+	 */
+	bool shipPersistent(const SensorData &data);
+
+	/**
+	 * @brief Write as many pending records as possible by writev(2).
+	 * If the reader has disappeared, the pipe is closed and the pending
+	 * records are dropped.
+	 * @throw IOException, when cannot write
+	 */
+	void flushPending();
+	void dropPending();
+	void closePipe();
+
+	/**
+	 * @brief Log the I/O statistics if the statsInterval has elapsed.
+	 */
+	void reportStats();
+
 	std::string m_pipePath;
 	SensorDataFormatter *m_formatter;
+	bool m_persistent;
+	size_t m_batchSize;
+	Poco::Timespan m_statsInterval;
+
+	int m_fd;
+	std::deque<std::string> m_pending;
+	size_t m_pendingOffset;
+
+	/**
+	 * Reused for formatting of records in the non-persistent mode.
+	 */
+	std::string m_buffer;
+
+	Poco::SharedPtr<IOStats> m_stats;
+	std::atomic<uint64_t> m_writeCalls;
+	Poco::Clock m_lastReport;
+	IOStats::Data m_lastReported;
+	uint64_t m_lastReportedCalls;
+
+	MetricsScope m_metrics;
 };
 
 }
@@ -0,0 +1,237 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+
+#include "di/Injectable.h"
+#include "hotplug/HotplugReactor.h"
+#include "util/ThreadNamer.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, HotplugReactor)
+BEEEON_OBJECT_CASTABLE(StoppableRunnable)
+BEEEON_OBJECT_PROPERTY("sources", &HotplugReactor::addSource)
+BEEEON_OBJECT_PROPERTY("retryInterval", &HotplugReactor::setRetryInterval)
+BEEEON_OBJECT_END(BeeeOn, HotplugReactor)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+static const int MAX_EVENTS = 8;
+
+/**
+ * Index of the wakeup eventfd in the epoll data. Sources are
+ * identified by their index in m_entries.
+ */
+static const uint32_t WAKEUP_INDEX = UINT32_MAX;
+
+HotplugReactor::HotplugReactor():
+	m_retryInterval(100 * Timespan::MILLISECONDS),
+	m_stop(false),
+	m_epoll(-1),
+	m_wakeup(-1)
+{
+	m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+	if (m_epoll < 0)
+		throwFromErrno("epoll_create1");
+
+	m_wakeup = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (m_wakeup < 0) {
+		::close(m_epoll);
+		throwFromErrno("eventfd");
+	}
+
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u32 = WAKEUP_INDEX;
+
+	if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event) < 0) {
+		::close(m_wakeup);
+		::close(m_epoll);
+		throwFromErrno("epoll_ctl");
+	}
+}
+
+HotplugReactor::~HotplugReactor()
+{
+	::close(m_wakeup);
+	::close(m_epoll);
+}
+
+void HotplugReactor::throwFromErrno(const string &name)
+{
+	if (errno)
+		throw SystemException(name + ": " + ::strerror(errno));
+
+	throw IOException(name + " has failed");
+}
+
+void HotplugReactor::addSource(HotplugSource::Ptr source)
+{
+	m_owned.emplace_back(source);
+	attach(*source);
+}
+
+void HotplugReactor::attach(HotplugSource &source)
+{
+	m_entries.push_back({&source, -1});
+}
+
+void HotplugReactor::setRetryInterval(const Timespan &interval)
+{
+	if (interval < 1 * Timespan::MILLISECONDS)
+		throw InvalidArgumentException("retryInterval must be at least 1 ms");
+
+	m_retryInterval = interval;
+}
+
+bool HotplugReactor::openSources()
+{
+	bool allOpen = true;
+
+	for (size_t i = 0; i < m_entries.size(); ++i) {
+		Entry &entry = m_entries[i];
+
+		if (entry.fd >= 0)
+			continue;
+
+		try {
+			entry.fd = entry.source->openSource();
+		}
+		BEEEON_CATCH_CHAIN(logger())
+
+		if (entry.fd < 0) {
+			allOpen = false;
+			continue;
+		}
+
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+
+		if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, entry.fd, &event) < 0) {
+			logger().error(string("epoll_ctl: ") + ::strerror(errno),
+				__FILE__, __LINE__);
+
+			closeSource(entry);
+			allOpen = false;
+		}
+	}
+
+	return allOpen;
+}
+
+void HotplugReactor::closeSource(Entry &entry)
+{
+	if (entry.fd < 0)
+		return;
+
+	// closing the fd would remove it from epoll implicitly, however,
+	// the source might keep it open (dup) so we remove it explicitly
+	::epoll_ctl(m_epoll, EPOLL_CTL_DEL, entry.fd, nullptr);
+	entry.fd = -1;
+
+	try {
+		entry.source->closeSource();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void HotplugReactor::closeSources()
+{
+	for (auto &entry : m_entries)
+		closeSource(entry);
+}
+
+void HotplugReactor::dispatch(Entry &entry, uint32_t events)
+{
+	bool healthy = true;
+
+	if (events & EPOLLIN) {
+		try {
+			healthy = entry.source->onReadable();
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	}
+
+	if (!healthy || (events & (EPOLLERR | EPOLLHUP))) {
+		if (logger().debug()) {
+			logger().debug("reopening hotplug source",
+				__FILE__, __LINE__);
+		}
+
+		closeSource(entry);
+	}
+}
+
+void HotplugReactor::run()
+{
+	ThreadNamer namer("hotplug-reactor");
+
+	logger().information("starting hotplug reactor with "
+		+ to_string(m_entries.size()) + " sources",
+		__FILE__, __LINE__);
+
+	while (!m_stop) {
+		const bool allOpen = openSources();
+
+		struct epoll_event events[MAX_EVENTS];
+		const int timeout = allOpen ? -1 : m_retryInterval.totalMilliseconds();
+
+		const int count = ::epoll_wait(m_epoll, events, MAX_EVENTS, timeout);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+
+			logger().critical(string("epoll_wait: ") + ::strerror(errno),
+				__FILE__, __LINE__);
+			break;
+		}
+
+		for (int i = 0; i < count && !m_stop; ++i) {
+			const uint32_t index = events[i].data.u32;
+
+			if (index == WAKEUP_INDEX) {
+				uint64_t value;
+				if (::read(m_wakeup, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+					logger().warning(string("read: ") + ::strerror(errno),
+						__FILE__, __LINE__);
+				}
+
+				continue;
+			}
+
+			Entry &entry = m_entries.at(index);
+
+			// the source might have been closed by previous events
+			if (entry.fd < 0)
+				continue;
+
+			dispatch(entry, events[i].events);
+		}
+	}
+
+	closeSources();
+
+	logger().information("stopping hotplug reactor",
+		__FILE__, __LINE__);
+
+	m_stop = false;
+}
+
+void HotplugReactor::stop()
+{
+	m_stop = true;
+
+	const uint64_t value = 1;
+	if (::write(m_wakeup, &value, sizeof(value)) < 0) {
+		logger().warning(string("write: ") + ::strerror(errno),
+			__FILE__, __LINE__);
+	}
+}
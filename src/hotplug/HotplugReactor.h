@@ -0,0 +1,82 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <Poco/AtomicCounter.h>
+#include <Poco/Timespan.h>
+
+#include "hotplug/HotplugSource.h"
+#include "loop/StoppableRunnable.h"
+#include "util/Loggable.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief HotplugReactor serves any number of hotplug sources from
+ * a single thread. It waits via epoll for any of the sources to become
+ * readable and dispatches to it immediately, there is no periodic
+ * wake up while all sources are open.
+ *
+ * A source that cannot be opened or that fails (hangs up, reports
+ * an error or asks for reopening) is closed and its opening is retried
+ * periodically according to the retryInterval.
+ */
+class HotplugReactor : public StoppableRunnable, protected Loggable {
+public:
+	HotplugReactor();
+	~HotplugReactor();
+
+	/**
+	 * @brief Register the given source to be served. Sources
+	 * must be registered before the reactor is started.
+	 */
+	void addSource(HotplugSource::Ptr source);
+
+	/**
+	 * @brief Register a source owned by the caller.
+	 */
+	void attach(HotplugSource &source);
+
+	/**
+	 * @brief Set interval of retrying to open sources that are
+	 * not available.
+	 */
+	void setRetryInterval(const Poco::Timespan &interval);
+
+	void run() override;
+	void stop() override;
+
+protected:
+	struct Entry {
+		HotplugSource *source;
+		int fd;
+	};
+
+	/**
+	 * @brief Try to open all closed sources and add them to epoll.
+	 * @returns true if all sources are open
+	 */
+	bool openSources();
+
+	void closeSource(Entry &entry);
+	void closeSources();
+
+	/**
+	 * @brief Dispatch the event from epoll to the appropriate source.
+	 */
+	void dispatch(Entry &entry, uint32_t events);
+
+	void throwFromErrno(const std::string &name);
+
+private:
+	std::list<HotplugSource::Ptr> m_owned;
+	std::vector<Entry> m_entries;
+	Poco::Timespan m_retryInterval;
+	Poco::AtomicCounter m_stop;
+	int m_epoll;
+	int m_wakeup;
+};
+
+}
@@ -0,0 +1,7 @@
+#include "hotplug/HotplugSource.h"
+
+using namespace BeeeOn;
+
+HotplugSource::~HotplugSource()
+{
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Poco/SharedPtr.h>
+
+namespace BeeeOn {
+
+/**
+ * @brief HotplugSource is a source of hotplug events backed by a file
+ * descriptor. It is served by the HotplugReactor that polls the file
+ * descriptor and calls onReadable() whenever there are data to process.
+ */
+class HotplugSource {
+public:
+	typedef Poco::SharedPtr<HotplugSource> Ptr;
+
+	virtual ~HotplugSource();
+
+	/**
+	 * @brief Open the source.
+	 * @returns file descriptor to be polled or -1 when the source
+	 * is not available at the moment and opening should be retried
+	 * later
+	 */
+	virtual int openSource() = 0;
+
+	/**
+	 * @brief Process data available on the file descriptor.
+	 * @returns false if the source is broken and should be reopened
+	 */
+	virtual bool onReadable() = 0;
+
+	/**
+	 * @brief Close the source opened by openSource().
+	 */
+	virtual void closeSource() = 0;
+};
+
+}
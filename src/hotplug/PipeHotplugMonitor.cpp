@@ -17,8 +17,8 @@
 
 BEEEON_OBJECT_BEGIN(BeeeOn, PipeHotplugMonitor)
 BEEEON_OBJECT_CASTABLE(StoppableRunnable)
+BEEEON_OBJECT_CASTABLE(HotplugSource)
 BEEEON_OBJECT_PROPERTY("pipePath", &PipeHotplugMonitor::setPipePath)
-BEEEON_OBJECT_PROPERTY("pollTimeout", &PipeHotplugMonitor::setPollTimeout)
 BEEEON_OBJECT_PROPERTY("listeners", &PipeHotplugMonitor::registerListener)
 BEEEON_OBJECT_END(BeeeOn, PipeHotplugMonitor)
 
@@ -26,14 +26,12 @@ using namespace std;
 using namespace Poco;
 using namespace BeeeOn;
 
-static const Timespan WAIT_PIPE_TIMEOUT = 100 * Timespan::MILLISECONDS;
 static const string DEFAULT_PATH = "/var/run/beeeon-gateway.hotplug";
 
 PipeHotplugMonitor::PipeHotplugMonitor():
-	m_pipePath(DEFAULT_PATH),
-	m_pollTimeout(WAIT_PIPE_TIMEOUT),
-	m_stop(false)
+	m_pipePath(DEFAULT_PATH)
 {
+	m_reactor.attach(*this);
 }
 
 PipeHotplugMonitor::~PipeHotplugMonitor()
@@ -74,9 +72,6 @@ bool PipeHotplugMonitor::skipEvent(FdInputStream &input) const
 	string line;
 
 	while (getline(input, line)) {
-		if (m_stop)
-			return false;
-
 		// if empty line reached, try next event
 		if (line.empty())
 			return true;
@@ -99,12 +94,6 @@ bool PipeHotplugMonitor::processEvent(FdInputStream &input)
 			       __FILE__, __LINE__);
 		}
 
-		if (m_stop) {
-			logger().debug("detected stop request",
-					__FILE__, __LINE__);
-			return false;
-		}
-
 		// end of event
 		if (line.empty())
 			break;
@@ -184,51 +173,35 @@ void PipeHotplugMonitor::fireEvent(const HotplugEvent &event, const string &acti
 	}
 }
 
-int PipeHotplugMonitor::openPipe()
+int PipeHotplugMonitor::openSource()
 {
-	int fd = -1;
+	const int fd = ::open(m_pipePath.c_str(), O_RDONLY | O_NONBLOCK);
+	if (fd < 0)
+		return -1;
 
-	while (!m_stop) {
-		fd = ::open(m_pipePath.c_str(), O_RDONLY | O_NONBLOCK);
+	m_input = new FdInputStream(fd);
+	m_input->setBlocking(false);
 
-		if (fd >= 0)
-			break;
-
-		if (m_waitPipe.tryWait(WAIT_PIPE_TIMEOUT.totalMilliseconds()))
-			break;
-	}
+	logger().debug("pipe ready for polling",
+			__FILE__, __LINE__);
 
 	return fd;
 }
 
-void PipeHotplugMonitor::pollForEvents(FdInputStream &input)
+bool PipeHotplugMonitor::onReadable()
 {
-	while (!m_stop && input.good()) {
-		try {
-			if (!input.poll(m_pollTimeout))
-				continue;
-
-			// we are readable, process as much events as possible
-			while (!m_stop && processEvent(input))
-				/* nothing */;
-		}
-		catch (const FileException &e) {
-			if (logger().debug())
-				logger().log(e, __FILE__, __LINE__);
+	// we are readable, process as much events as possible
+	while (processEvent(*m_input))
+		/* nothing */;
 
-			break; // poll failed, reopen pipe
-		}
-		catch (const Exception &e) {
-			logger().log(e, __FILE__, __LINE__);
-		}
-		catch (const exception &e) {
-			logger().critical(e.what(), __FILE__, __LINE__);
-		}
-		catch (...) {
-			logger().critical("unknown failure",
-					  __FILE__, __LINE__);
-		}
-	}
+	// reading would block, EOF is reported as hangup
+	m_input->clear();
+	return true;
+}
+
+void PipeHotplugMonitor::closeSource()
+{
+	m_input = nullptr;
 }
 
 void PipeHotplugMonitor::run()
@@ -240,54 +213,17 @@ void PipeHotplugMonitor::run()
 		+ " for hotplug events",
 		__FILE__, __LINE__);
 
-	while (!m_stop) {
-		const int fd = openPipe();
-
-		if (fd < 0)
-			break;
-
-		FdInputStream input(fd);
-		input.setBlocking(false);
-
-		logger().debug("pipe ready for polling",
-				__FILE__, __LINE__);
-
-		pollForEvents(input);
-	}
+	m_reactor.run();
 
 	logger().notice("stopping hotplug monitoring");
-	m_stop = false;
-	m_waitPipe.reset();
 }
 
 void PipeHotplugMonitor::stop()
 {
-	m_stop = true;
-	m_waitPipe.set();
+	m_reactor.stop();
 }
 
 void PipeHotplugMonitor::setPipePath(const string &pipePath)
 {
 	m_pipePath = pipePath;
 }
-
-void PipeHotplugMonitor::setPollTimeout(const Timespan &timeout)
-{
-	// 0 ... non-blocking
-	// negative ... blocking
-	// positive ... blocking with timeout
-
-	if (timeout < 0) {
-		m_pollTimeout = -1 * Timespan::MILLISECONDS;
-	}
-	else if (timeout == 0) {
-		m_pollTimeout = 0;
-	}
-	else if (timeout < 1 * Timespan::MILLISECONDS) {
-		throw InvalidArgumentException(
-			"pollTimeout must be at least 1 ms");
-	}
-	else {
-		m_pollTimeout = timeout;
-	}
-}
@@ -4,12 +4,12 @@
 #include <set>
 #include <string>
 
-#include <Poco/AtomicCounter.h>
-#include <Poco/Event.h>
-#include <Poco/Timespan.h>
+#include <Poco/SharedPtr.h>
 
 #include "loop/StoppableRunnable.h"
 #include "hotplug/AbstractHotplugMonitor.h"
+#include "hotplug/HotplugReactor.h"
+#include "hotplug/HotplugSource.h"
 
 namespace BeeeOn {
 
@@ -37,10 +37,15 @@ class FdInputStream;
  * DRIVER=serial_ftdi<LF>
  * <LF|EOF>
  * </pre>
+ *
+ * The PipeHotplugMonitor is a HotplugSource and thus it can be served
+ * by a shared HotplugReactor. When used as a StoppableRunnable, it runs
+ * its own HotplugReactor.
  */
 class PipeHotplugMonitor :
 		public StoppableRunnable,
-		public AbstractHotplugMonitor {
+		public AbstractHotplugMonitor,
+		public HotplugSource {
 public:
 	PipeHotplugMonitor();
 	~PipeHotplugMonitor();
@@ -48,6 +53,10 @@ public:
 	void run() override;
 	void stop() override;
 
+	int openSource() override;
+	bool onReadable() override;
+	void closeSource() override;
+
 	/**
 	 * Set path to the pipe providing hotplug events.
 	 * If the pipe does not exist, the PipeHotplugMonitor waits
@@ -55,25 +64,7 @@ public:
 	 */
 	void setPipePath(const std::string &path);
 
-	/**
-	 * Poll timeout determines how long to block while polling for
-	 * new events. Negative value leads to blocking mode. A positive
-	 * value leads to time-limited blocking and 0 denotes non-blocking.
-	 * The timeout is expected at least in milliseconds.
-	 */
-	void setPollTimeout(const Poco::Timespan &timeout);
-
 protected:
-	/**
-	 * Open the pipe for receiving hotplug events.
-	 */
-	int openPipe();
-
-	/**
-	 * Poll and read new events from the input.
-	 */
-	void pollForEvents(FdInputStream &input);
-
 	/**
 	 * Read a single hotplug event from the input.
 	 * @return false when EOF was reached
@@ -101,9 +92,8 @@ protected:
 
 private:
 	std::string m_pipePath;
-	Poco::Event m_waitPipe;
-	Poco::Timespan m_pollTimeout;
-	Poco::AtomicCounter m_stop;
+	Poco::SharedPtr<FdInputStream> m_input;
+	HotplugReactor m_reactor;
 };
 
 }
@@ -2,7 +2,6 @@
 #include <cstring>
 
 #include <libudev.h>
-#include <poll.h>
 
 #include <Poco/Exception.h>
 #include <Poco/Logger.h>
@@ -14,8 +13,8 @@
 
 BEEEON_OBJECT_BEGIN(BeeeOn, UDevMonitor)
 BEEEON_OBJECT_CASTABLE(StoppableRunnable)
+BEEEON_OBJECT_CASTABLE(HotplugSource)
 BEEEON_OBJECT_PROPERTY("matches", &UDevMonitor::setMatches)
-BEEEON_OBJECT_PROPERTY("pollTimeout", &UDevMonitor::setPollTimeout)
 BEEEON_OBJECT_PROPERTY("includeParents", &UDevMonitor::setIncludeParents)
 BEEEON_OBJECT_PROPERTY("listeners", &UDevMonitor::registerListener)
 BEEEON_OBJECT_HOOK("done", &UDevMonitor::initialScan)
@@ -26,18 +25,27 @@ using namespace Poco;
 using namespace BeeeOn;
 
 UDevMonitor::UDevMonitor():
-	m_stop(0),
-	m_pollTimeout(1000 * Timespan::MILLISECONDS),
 	m_includeParents(false),
-	m_udev(NULL)
+	m_udev(NULL),
+	m_monitor(NULL),
+	m_scanning(false)
 {
 	m_udev = ::udev_new();
 	if (m_udev == NULL)
 		throwFromErrno("udev_new");
+
+	m_reactor.attach(*this);
 }
 
 UDevMonitor::~UDevMonitor()
 {
+	try {
+		m_scanThread.join();
+	}
+	BEEEON_CATCH_CHAIN(logger())
+
+	closeSource();
+
 	if (m_udev != NULL)
 		::udev_unref(m_udev);
 }
@@ -57,28 +65,6 @@ void UDevMonitor::setMatches(const list<string> &matches)
 		m_matches.emplace(m);
 }
 
-void UDevMonitor::setPollTimeout(const Timespan &timeout)
-{
-	// we do not check the ms value because:
-	// * poll(..., 0) is non-blocking
-	// * poll(..., negative) is blocking
-	// * poll(..., positive) is blocking with timeout
-
-	if (timeout < 0) {
-		m_pollTimeout = -1 * Timespan::MILLISECONDS;
-	}
-	else if (timeout == 0) {
-		m_pollTimeout = 0;
-	}
-	else if (timeout < 1 * Timespan::MILLISECONDS) {
-		throw InvalidArgumentException(
-			"pollTimeout must be at least 1 ms");
-	}
-	else {
-		m_pollTimeout = timeout;
-	}
-}
-
 void UDevMonitor::setIncludeParents(bool enable)
 {
 	m_includeParents = enable;
@@ -132,6 +118,42 @@ HotplugEvent UDevMonitor::createEvent(struct udev_device *dev) const
 }
 
 void UDevMonitor::initialScan()
+{
+	if (m_scanThread.isRunning()) {
+		logger().warning("initial scan is already running", __FILE__, __LINE__);
+		return;
+	}
+
+	// start receiving events before enumerating the devices, the events
+	// are buffered by the monitor until the reactor starts serving it
+	{
+		FastMutex::ScopedLock guard(m_monitorLock);
+
+		if (m_monitor == NULL)
+			m_monitor = createMonitor();
+	}
+
+	{
+		FastMutex::ScopedLock guard(m_eventLock);
+
+		m_scanning = true;
+		m_liveSeen.clear();
+	}
+
+	m_scanThread.startFunc([this]() {
+		try {
+			scanDevices();
+		}
+		BEEEON_CATCH_CHAIN(logger())
+
+		FastMutex::ScopedLock guard(m_eventLock);
+
+		m_scanning = false;
+		m_liveSeen.clear();
+	});
+}
+
+void UDevMonitor::scanDevices()
 {
 	logger().information("initial subsystem udev scan", __FILE__, __LINE__);
 
@@ -162,6 +184,7 @@ void UDevMonitor::initialScan()
 		if (syspath == NULL) {
 			logger().critical("no syspath for udev entry",
 					  __FILE__, __LINE__);
+			continue;
 		}
 
 		struct udev_device *dev;
@@ -174,6 +197,12 @@ void UDevMonitor::initialScan()
 		const HotplugEvent &event = createEvent(dev);
 		::udev_device_unref(dev);
 
+		FastMutex::ScopedLock guard(m_eventLock);
+
+		// a live event has already reported a more recent state
+		if (m_liveSeen.find(syspath) != m_liveSeen.end())
+			continue;
+
 		logEvent(event, "initial");
 
 		fireAddEvent(event);
@@ -182,17 +211,8 @@ void UDevMonitor::initialScan()
 	::udev_enumerate_unref(en);
 }
 
-void UDevMonitor::scanDevice(struct udev_monitor *mon)
+void UDevMonitor::receiveDevice(struct udev_monitor *mon)
 {
-	int fd = ::udev_monitor_get_fd(mon);
-	struct pollfd pollfd = {fd, POLLIN, 0};
-
-	int ret = poll(&pollfd, 1, m_pollTimeout.totalMilliseconds());
-	if (ret < 0)
-		throwFromErrno("poll");
-	else if (ret == 0)
-		return;
-
 	struct udev_device *dev = ::udev_monitor_receive_device(mon);
 	if (dev == NULL) {
 		if (errno) {
@@ -214,6 +234,13 @@ void UDevMonitor::scanDevice(struct udev_monitor *mon)
 	}
 
 	const HotplugEvent &event = createEvent(dev);
+	const char *syspath = ::udev_device_get_syspath(dev);
+
+	FastMutex::ScopedLock guard(m_eventLock);
+
+	if (m_scanning && syspath != NULL)
+		m_liveSeen.emplace(syspath);
+
 	logEvent(event, action);
 
 	if (!::strcmp(action, "add"))
@@ -261,35 +288,48 @@ struct udev_monitor *UDevMonitor::createMonitor()
 	return NULL;
 }
 
-void UDevMonitor::run()
+int UDevMonitor::openSource()
 {
-	struct udev_monitor *mon = createMonitor();
-	if (mon == NULL) {
-		logger().critical("leaving udev monitoring early",
-				 __FILE__, __LINE__);
+	FastMutex::ScopedLock guard(m_monitorLock);
 
-		return;
-	}
+	if (m_monitor == NULL)
+		m_monitor = createMonitor();
+
+	if (m_monitor == NULL)
+		return -1;
 
 	logger().information("start udev monitoring",
 			     __FILE__, __LINE__);
 
-	while (!m_stop) {
-		try {
-			scanDevice(mon);
-		}
-		BEEEON_CATCH_CHAIN(logger())
-	}
+	return ::udev_monitor_get_fd(m_monitor);
+}
 
-	::udev_monitor_unref(mon);
+bool UDevMonitor::onReadable()
+{
+	receiveDevice(m_monitor);
+	return true;
+}
+
+void UDevMonitor::closeSource()
+{
+	FastMutex::ScopedLock guard(m_monitorLock);
+
+	if (m_monitor == NULL)
+		return;
+
+	::udev_monitor_unref(m_monitor);
+	m_monitor = NULL;
 
 	logger().information("stop udev monitoring",
 			     __FILE__, __LINE__);
+}
 
-	m_stop = false;
+void UDevMonitor::run()
+{
+	m_reactor.run();
 }
 
 void UDevMonitor::stop()
 {
-	m_stop = true;
+	m_reactor.stop();
 }
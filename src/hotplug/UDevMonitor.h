@@ -4,10 +4,12 @@
 #include <set>
 #include <string>
 
-#include <Poco/AtomicCounter.h>
-#include <Poco/Timespan.h>
+#include <Poco/Mutex.h>
+#include <Poco/Thread.h>
 
 #include "hotplug/AbstractHotplugMonitor.h"
+#include "hotplug/HotplugReactor.h"
+#include "hotplug/HotplugSource.h"
 #include "loop/StoppableRunnable.h"
 
 struct udev;
@@ -16,7 +18,20 @@ struct udev_monitor;
 
 namespace BeeeOn {
 
-class UDevMonitor : public StoppableRunnable, public AbstractHotplugMonitor {
+/**
+ * @brief UDevMonitor reports hotplug events from udev. It is a HotplugSource
+ * and thus it can be served by a shared HotplugReactor. When used as
+ * a StoppableRunnable, it runs its own HotplugReactor.
+ *
+ * The initial scan is performed in a separate thread. The udev monitor
+ * is created before the scan starts, thus live events occurring during
+ * the scan are not lost. A device already reported by a live event is
+ * not reported again by the scan.
+ */
+class UDevMonitor :
+		public StoppableRunnable,
+		public AbstractHotplugMonitor,
+		public HotplugSource {
 public:
 	UDevMonitor();
 	~UDevMonitor();
@@ -25,26 +40,44 @@ public:
 	void stop() override;
 
 	void setMatches(const std::list<std::string> &matches);
-	void setPollTimeout(const Poco::Timespan &timeout);
 	void setIncludeParents(bool enable);
 
+	/**
+	 * @brief Start receiving live events and enumerate the existing
+	 * devices in a separate thread.
+	 */
 	void initialScan();
 
+	int openSource() override;
+	bool onReadable() override;
+	void closeSource() override;
+
 private:
 	struct udev_monitor *createMonitor();
 	struct udev_monitor *doCreateMonitor();
 	void collectProperties(
 		HotplugEvent::Properties &event, struct udev_device *dev) const;
 	HotplugEvent createEvent(struct udev_device *dev) const;
-	void scanDevice(struct udev_monitor *mon);
+	void receiveDevice(struct udev_monitor *mon);
+	void scanDevices();
 	void throwFromErrno(const std::string &name);
 
 private:
 	std::set<std::string> m_matches;
-	Poco::AtomicCounter m_stop;
-	Poco::Timespan m_pollTimeout;
 	bool m_includeParents;
 	struct udev *m_udev;
+	struct udev_monitor *m_monitor;
+	Poco::FastMutex m_monitorLock;
+
+	HotplugReactor m_reactor;
+	Poco::Thread m_scanThread;
+
+	/**
+	 * Serializes delivery of live events and events of the initial scan.
+	 */
+	Poco::FastMutex m_eventLock;
+	bool m_scanning;
+	std::set<std::string> m_liveSeen;
 };
 
 }
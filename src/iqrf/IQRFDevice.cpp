@@ -1,9 +1,11 @@
 #include <Poco/Clock.h>
+#include <Poco/Exception.h>
 #include <Poco/Logger.h>
 
 #include "iqrf/DPAProtocol.h"
 #include "iqrf/DPAResponse.h"
 #include "iqrf/IQRFDevice.h"
+#include "iqrf/IQRFPollCycle.h"
 #include "iqrf/IQRFUtil.h"
 #include "iqrf/request/DPAOSPeripheralInfoRequest.h"
 #include "iqrf/response/DPAOSPeripheralInfoResponse.h"
@@ -27,10 +29,7 @@ IQRFDevice::IQRFDevice(
 	m_address(address),
 	m_protocol(protocol),
 	m_refreshTime(refreshTime),
-	m_refreshTimePeripheralInfo(refreshTimePeripheralInfo),
-	m_remainingValueTime(0),
-	m_remainingPeripheralInfoTime(0),
-	m_remaining(1 * Timespan::SECONDS)
+	m_refreshTimePeripheralInfo(refreshTimePeripheralInfo)
 {
 }
 
@@ -249,14 +248,19 @@ DPAProtocol::ProductInfo IQRFDevice::detectProductInfo(
 
 SensorData IQRFDevice::obtainValues() const
 {
-	const IQRFJsonResponse::Ptr valueResponse =
+	return parseValues(
 		IQRFUtil::makeRequest(
 			m_connector,
 			m_protocol->dpaValueRequest(m_address, m_modules),
 			m_receiveTimeout
-		);
+		)
+	);
+}
+
+SensorData IQRFDevice::parseValues(const IQRFJsonResponse::Ptr response) const
+{
 	DPAResponse::Ptr dpaValue =
-		DPAResponse::fromRaw(valueResponse->response());
+		DPAResponse::fromRaw(response->response());
 
 	SensorData sensorData =
 		m_protocol->parseValue(
@@ -270,17 +274,29 @@ SensorData IQRFDevice::obtainValues() const
 
 SensorData IQRFDevice::obtainPeripheralInfo() const
 {
-	ModuleID batteryID = batteryModuleID();
-	ModuleID rssiID = rssiModuleID();
-
-	const IQRFJsonResponse::Ptr peripheralResponse =
+	return parsePeripheralInfo(
 		IQRFUtil::makeRequest(
 			m_connector,
 			new DPAOSPeripheralInfoRequest(m_address),
 			m_receiveTimeout
-		);
+		)
+	);
+}
+
+SensorData IQRFDevice::parsePeripheralInfo(
+		const IQRFJsonResponse::Ptr response) const
+{
+	ModuleID batteryID = batteryModuleID();
+	ModuleID rssiID = rssiModuleID();
+
 	DPAOSPeripheralInfoResponse::Ptr dpaPeripheral =
-		DPAResponse::fromRaw(peripheralResponse->response()).cast<DPAOSPeripheralInfoResponse>();
+		DPAResponse::fromRaw(response->response()).cast<DPAOSPeripheralInfoResponse>();
+
+	if (dpaPeripheral.isNull()) {
+		throw ProtocolException(
+			"unexpected response to peripheral info request: "
+			+ response->response());
+	}
 
 	SensorData sensorData;
 	sensorData.setDeviceID(id());
@@ -290,30 +306,74 @@ SensorData IQRFDevice::obtainPeripheralInfo() const
 	return sensorData;
 }
 
-RefreshTime IQRFDevice::refresh() const
+vector<IQRFDevice::PollRequest> IQRFDevice::duePollRequests(const Clock &now)
 {
-	return RefreshTime::fromSeconds(m_remaining.totalSeconds());
+	vector<PollRequest> requests;
+
+	if (m_nextValues <= now) {
+		m_nextValues = now + m_refreshTime.time().totalMicroseconds();
+		requests.push_back({
+			POLL_VALUES,
+			m_protocol->dpaValueRequest(m_address, m_modules)
+		});
+	}
+
+	if (m_nextPeripheralInfo <= now) {
+		m_nextPeripheralInfo = now
+			+ m_refreshTimePeripheralInfo.time().totalMicroseconds();
+		requests.push_back({
+			POLL_PERIPHERAL_INFO,
+			new DPAOSPeripheralInfoRequest(m_address)
+		});
+	}
+
+	return requests;
 }
 
-void IQRFDevice::poll(Distributor::Ptr distributor)
+SensorData IQRFDevice::parsePollResponse(
+		const PollRequest &request,
+		const IQRFJsonResponse::Ptr response) const
 {
-	if (m_remainingValueTime.totalSeconds() <= 0) {
-		m_remainingValueTime = m_refreshTime;
-		distributor->exportData(obtainValues());
+	switch (request.kind) {
+	case POLL_VALUES:
+		return parseValues(response);
+	case POLL_PERIPHERAL_INFO:
+		return parsePeripheralInfo(response);
 	}
 
-	if (m_remainingPeripheralInfoTime.totalSeconds() <= 0) {
-		m_remainingPeripheralInfoTime = m_refreshTimePeripheralInfo;
-		distributor->exportData(obtainPeripheralInfo());
-	}
+	throw IllegalStateException(
+		"unexpected poll request kind: " + to_string(request.kind));
+}
+
+Timespan IQRFDevice::untilNextPoll(const Clock &now) const
+{
+	const Clock &next = m_nextValues < m_nextPeripheralInfo ?
+		m_nextValues : m_nextPeripheralInfo;
+
+	if (next <= now)
+		return 0;
+
+	return next - now;
+}
 
-	Timespan remainingTime;
-	if (m_remainingValueTime < m_remainingPeripheralInfoTime)
-		remainingTime = m_remainingValueTime;
-	else
-		remainingTime = m_remainingPeripheralInfoTime;
+RefreshTime IQRFDevice::refresh() const
+{
+	const Timespan remaining = untilNextPoll();
+	const int seconds = (remaining.totalMicroseconds()
+			+ Timespan::SECONDS - 1) / Timespan::SECONDS;
+
+	return RefreshTime::fromSeconds(seconds < 1 ? 1 : seconds);
+}
+
+void IQRFDevice::setPollStats(IQRFPollStats::Ptr stats)
+{
+	m_pollStats = stats;
+}
+
+void IQRFDevice::poll(Distributor::Ptr distributor)
+{
+	IQRFPollCycle cycle(m_connector, m_receiveTimeout, m_pollStats);
 
-	m_remainingValueTime -= remainingTime;
-	m_remainingPeripheralInfoTime -= remainingTime;
-	m_remaining = remainingTime;
+	cycle.add(*this);
+	cycle.execute(distributor);
 }
@@ -2,7 +2,9 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
+#include <Poco/Clock.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
 
@@ -10,6 +12,7 @@
 #include "iqrf/DPAMessage.h"
 #include "iqrf/DPAProtocol.h"
 #include "iqrf/IQRFMqttConnector.h"
+#include "iqrf/IQRFPollStats.h"
 #include "model/DeviceID.h"
 #include "model/ModuleType.h"
 #include "model/RefreshTime.h"
@@ -31,6 +34,23 @@ class IQRFDevice : public PollableDevice, Loggable {
 public:
 	typedef Poco::SharedPtr<IQRFDevice> Ptr;
 
+	/**
+	 * @brief Kinds of requests performed while polling.
+	 */
+	enum PollKind {
+		POLL_VALUES,
+		POLL_PERIPHERAL_INFO,
+	};
+
+	/**
+	 * @brief Single DPA request to be issued while polling
+	 * the device.
+	 */
+	struct PollRequest {
+		PollKind kind;
+		DPARequest::Ptr request;
+	};
+
 	IQRFDevice(
 		IQRFMqttConnector::Ptr connector,
 		const Poco::Timespan &receiveTimeout,
@@ -82,8 +102,40 @@ public:
 	std::string productName() const;
 
 	RefreshTime refresh() const override;
+
+	/**
+	 * @brief Obtain all due values of the device. The due requests
+	 * are sent together (pipelined) via IQRFPollCycle.
+	 */
 	void poll(Distributor::Ptr distributor) override;
 
+	/**
+	 * @brief Set statistics to be updated by each poll() call.
+	 */
+	void setPollStats(IQRFPollStats::Ptr stats);
+
+	/**
+	 * @brief Collect requests that are due at the given time and plan
+	 * the next polling of the affected values. The returned requests
+	 * must be processed by parsePollResponse().
+	 */
+	std::vector<PollRequest> duePollRequests(
+		const Poco::Clock &now = {});
+
+	/**
+	 * @brief Convert the response to the given poll request into
+	 * SensorData.
+	 */
+	SensorData parsePollResponse(
+		const PollRequest &request,
+		const IQRFJsonResponse::Ptr response) const;
+
+	/**
+	 * @returns time remaining until any request of the device
+	 * becomes due, 0 if there is a due request
+	 */
+	Poco::Timespan untilNextPoll(const Poco::Clock &now = {}) const;
+
 
 	/**
 	* @brief Converts all device parameters into one string for
@@ -140,6 +192,10 @@ private:
 	ModuleID batteryModuleID() const;
 	ModuleID rssiModuleID() const;
 
+	SensorData parseValues(const IQRFJsonResponse::Ptr response) const;
+	SensorData parsePeripheralInfo(
+		const IQRFJsonResponse::Ptr response) const;
+
 private:
 	IQRFMqttConnector::Ptr m_connector;
 	Poco::Timespan m_receiveTimeout;
@@ -148,9 +204,9 @@ private:
 	RefreshTime m_refreshTime;
 	RefreshTime m_refreshTimePeripheralInfo;
 
-	mutable Poco::Timespan m_remainingValueTime;
-	mutable Poco::Timespan m_remainingPeripheralInfoTime;
-	mutable Poco::Timespan m_remaining;
+	Poco::Clock m_nextValues;
+	Poco::Clock m_nextPeripheralInfo;
+	IQRFPollStats::Ptr m_pollStats;
 
 	uint32_t m_mid;
 	std::list<ModuleType> m_modules;
@@ -41,6 +41,7 @@ BEEEON_OBJECT_PROPERTY("mqttConnector", &IQRFDeviceManager::setMqttConnector)
 BEEEON_OBJECT_PROPERTY("devicesRetryTimeout", &IQRFDeviceManager::setIQRFDevicesRetryTimeout)
 BEEEON_OBJECT_PROPERTY("coordinatorReset", &IQRFDeviceManager::setCoordinatorReset)
 BEEEON_OBJECT_PROPERTY("devicePoller", &IQRFDeviceManager::setDevicePoller)
+BEEEON_OBJECT_PROPERTY("batchPolling", &IQRFDeviceManager::setBatchPolling)
 BEEEON_OBJECT_END(BeeeOn, IQRFDeviceManager)
 
 using namespace BeeeOn;
@@ -57,6 +58,8 @@ IQRFDeviceManager::IQRFDeviceManager():
 		typeid(DeviceAcceptCommand),
 		typeid(DeviceUnpairCommand),
 	}),
+	m_pollStats(new IQRFPollStats),
+	m_batchPolling(false),
 	m_refreshTime(RefreshTime::fromSeconds(60)),
 	m_refreshTimePeripheralInfo(RefreshTime::fromSeconds(300)),
 	m_receiveTimeout(1 * Timespan::SECONDS),
@@ -128,6 +131,11 @@ void IQRFDeviceManager::setDevicePoller(DevicePoller::Ptr poller)
 	m_pollingKeeper.setDevicePoller(poller);
 }
 
+void IQRFDeviceManager::setBatchPolling(bool batch)
+{
+	m_batchPolling = batch;
+}
+
 void IQRFDeviceManager::stop()
 {
 	answerQueue().dispose();
@@ -177,6 +185,12 @@ void IQRFDeviceManager::dongleAvailable()
 		}
 
 		m_stopControl.waitStoppable(m_devicesRetryTimeout);
+
+		if (m_pollStats->cycles() > 0) {
+			logger().information(
+				"polling: " + m_pollStats->toString(),
+				__FILE__, __LINE__);
+		}
 	}
 
 	logger().notice(
@@ -231,14 +245,14 @@ void IQRFDeviceManager::syncBondedNodes(const Timespan &methodTimeout)
 	for (const auto &device : obtainedDevices) {
 		if (deviceCache()->paired(device.first)) {
 			m_devices.emplace(device.first, device.second);
-			m_pollingKeeper.schedule(device.second);
+			schedulePolling(device.second);
 		}
 	}
 
 	for (auto deviceIt = begin(m_devices); deviceIt != end(m_devices); ++deviceIt) {
 		auto nodeIt = bondedNodes.find(deviceIt->second->networkAddress());
 		if (nodeIt == bondedNodes.end()) {
-			m_pollingKeeper.cancel(deviceIt->first);
+			cancelPolling(deviceIt->first);
 			deviceIt = m_devices.erase(deviceIt);
 		}
 	}
@@ -411,7 +425,7 @@ void IQRFDeviceManager::handleAccept(const DeviceAcceptCommand::Ptr cmd)
 		}
 	}
 	else {
-		m_pollingKeeper.schedule(device->second);
+		schedulePolling(device->second);
 	}
 
 	DeviceManager::handleAccept(cmd);
@@ -491,7 +505,7 @@ AsyncWork<set<DeviceID>>::Ptr IQRFDeviceManager::startUnpair(
 	}
 
 	const auto address = it->second->networkAddress();
-	m_pollingKeeper.cancel(id);
+	cancelPolling(id);
 
 	DPABatchRequest::Ptr request = new DPABatchRequest(address);
 	request->append(new DPANodeRemoveBondRequest(address));
@@ -611,5 +625,43 @@ void IQRFDeviceManager::eraseAllDevices()
 {
 	FastMutex::ScopedLock guard(m_lock);
 	m_pollingKeeper.cancelAll();
+
+	if (!m_networkPoller.isNull())
+		m_networkPoller->clear();
+
 	m_devices.clear();
 }
+
+void IQRFDeviceManager::schedulePolling(IQRFDevice::Ptr device)
+{
+	device->setPollStats(m_pollStats);
+
+	if (!m_batchPolling) {
+		m_pollingKeeper.schedule(device);
+		return;
+	}
+
+	if (m_networkPoller.isNull()) {
+		m_networkPoller = new IQRFNetworkPoller(
+			m_connector, m_receiveTimeout, m_pollStats);
+	}
+
+	m_networkPoller->add(device);
+	m_pollingKeeper.schedule(m_networkPoller);
+}
+
+void IQRFDeviceManager::cancelPolling(const DeviceID &id)
+{
+	if (!m_batchPolling) {
+		m_pollingKeeper.cancel(id);
+		return;
+	}
+
+	if (m_networkPoller.isNull())
+		return;
+
+	m_networkPoller->remove(id);
+
+	if (m_networkPoller->empty())
+		m_pollingKeeper.cancel(m_networkPoller->id());
+}
@@ -16,6 +16,8 @@
 #include "iqrf/DPAProtocol.h"
 #include "iqrf/IQRFDevice.h"
 #include "iqrf/IQRFMqttConnector.h"
+#include "iqrf/IQRFNetworkPoller.h"
+#include "iqrf/IQRFPollStats.h"
 #include "model/RefreshTime.h"
 
 namespace BeeeOn {
@@ -68,6 +70,14 @@ public:
 	void setMqttConnector(IQRFMqttConnector::Ptr connector);
 	void setDevicePoller(DevicePoller::Ptr poller);
 
+	/**
+	 * @brief If enabled, all IQRF devices are polled together via
+	 * IQRFNetworkPoller. All due requests are sent in a single cycle
+	 * and their responses are collected afterwards. Otherwise, each
+	 * device is polled on its own.
+	 */
+	void setBatchPolling(bool batch);
+
 	/**
 	 * @brief Recognizes compatible dongle by testing HotplugEvent
 	 * property as <code>iqrf.BEEEON_DONGLE = iqrf</code>.
@@ -174,11 +184,21 @@ private:
 	 */
 	void coordinatorResetProcess();
 
+	/**
+	 * @brief Schedule polling of the given device either on its
+	 * own or as a part of the IQRFNetworkPoller.
+	 */
+	void schedulePolling(IQRFDevice::Ptr device);
+	void cancelPolling(const DeviceID &id);
+
 private:
 	Poco::FastMutex m_lock;
 	std::vector<DPAProtocol::Ptr> m_dpaProtocols;
 	std::map<DeviceID, IQRFDevice::Ptr> m_devices;
 	PollingKeeper m_pollingKeeper;
+	IQRFNetworkPoller::Ptr m_networkPoller;
+	IQRFPollStats::Ptr m_pollStats;
+	bool m_batchPolling;
 
 	IQRFMqttConnector::Ptr m_connector;
 	RefreshTime m_refreshTime;
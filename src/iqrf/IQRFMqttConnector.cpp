@@ -1,3 +1,4 @@
+#include <Poco/Exception.h>
 #include <Poco/Logger.h>
 
 #include "di/Injectable.h"
@@ -11,12 +12,19 @@ BEEEON_OBJECT_BEGIN(BeeeOn, IQRFMqttConnector)
 BEEEON_OBJECT_CASTABLE(StoppableRunnable)
 BEEEON_OBJECT_PROPERTY("mqttClient", &IQRFMqttConnector::setMqttClient)
 BEEEON_OBJECT_PROPERTY("publishTopic", &IQRFMqttConnector::setPublishTopic)
+BEEEON_OBJECT_PROPERTY("receiveTopic", &IQRFMqttConnector::setReceiveTopic)
 BEEEON_OBJECT_PROPERTY("dataTimeout", &IQRFMqttConnector::setDataTimeout)
 BEEEON_OBJECT_PROPERTY("receiveTimeout", &IQRFMqttConnector::setReceiveTimeout)
 BEEEON_OBJECT_HOOK("done", &IQRFMqttConnector::checkPublishTopic)
 BEEEON_OBJECT_END(BeeeOn, IQRFMqttConnector)
 
+IQRFMqttConnector::Slot::Slot():
+	waiting(false)
+{
+}
+
 IQRFMqttConnector::IQRFMqttConnector():
+	m_expiry(100 * Timespan::MILLISECONDS, 128),
 	m_messageTimeout(10 * Timespan::SECONDS),
 	m_receiveTimeout(10 * Timespan::SECONDS)
 {
@@ -32,6 +40,11 @@ void IQRFMqttConnector::setPublishTopic(const string &topic)
 	m_publishTopic = topic;
 }
 
+void IQRFMqttConnector::setReceiveTopic(const string &topic)
+{
+	m_receiveTopic = topic;
+}
+
 void IQRFMqttConnector::setDataTimeout(const Timespan &timeout)
 {
 	if (timeout < 1 * Timespan::MILLISECONDS)
@@ -62,48 +75,51 @@ void IQRFMqttConnector::run()
 		MqttMessage msg;
 
 		try {
-			msg = m_mqttClient->receive(m_receiveTimeout);
+			if (m_receiveTopic.empty())
+				msg = m_mqttClient->receive(m_receiveTimeout);
+			else
+				msg = m_mqttClient->receiveFrom(m_receiveTopic, m_receiveTimeout);
 		}
 		catch (const TimeoutException &) {
+			removeExpiredMessages();
 			continue;
 		}
+		catch (const NotFoundException &e) {
+			// the client does not subscribe the receiveTopic,
+			// retrying would never succeed
+			logger().critical(
+				"cannot receive from " + m_receiveTopic
+				+ ": " + e.displayText(),
+				__FILE__, __LINE__);
+
+			stop();
+			throw;
+		}
 		BEEEON_CATCH_CHAIN(logger())
 
-		removeExpiredMessages(m_messageTimeout);
+		removeExpiredMessages();
 
 		if (msg.message().empty())
 			continue;
 
-		IQRFJsonResponse::Ptr response;
 		try {
 			auto iqrfJsonMsg = IQRFJsonResponse::parse(msg.message());
-			response = iqrfJsonMsg.cast<IQRFJsonResponse>();
-		}
-		BEEEON_CATCH_CHAIN_ACTION(logger(), continue)
-
-		FastMutex::ScopedLock guard(m_dataLock);
-		const ReceivedData data = {Clock(), response};
-
-		auto it = m_data.emplace(
-			GlobalID::parse(response->messageID()),
-			data);
-
-		if (!it.second) {
-			logger().warning(
-				"duplicated message id " + response->messageID(),
-				__FILE__, __LINE__);
-
-			continue;
+			deliver(iqrfJsonMsg.cast<IQRFJsonResponse>());
 		}
-
-		m_waitCondition.broadcast();
+		BEEEON_CATCH_CHAIN(logger())
 	}
 }
 
 void IQRFMqttConnector::stop()
 {
 	m_stopControl.requestStop();
-	m_waitCondition.broadcast();
+
+	FastMutex::ScopedLock guard(m_dataLock);
+
+	for (auto &pair : m_slots) {
+		if (pair.second->waiting)
+			pair.second->ready.set();
+	}
 }
 
 void IQRFMqttConnector::send(const string &msg)
@@ -111,52 +127,107 @@ void IQRFMqttConnector::send(const string &msg)
 	m_mqttClient->publish({m_publishTopic, msg});
 }
 
+void IQRFMqttConnector::deliver(IQRFJsonResponse::Ptr response)
+{
+	const GlobalID id = GlobalID::parse(response->messageID());
+
+	FastMutex::ScopedLock guard(m_dataLock);
+
+	auto it = m_slots.find(id);
+	if (it == m_slots.end()) {
+		Slot::Ptr slot = new Slot;
+		slot->message = response;
+
+		m_slots.emplace(id, slot);
+		m_expiry.schedule(id, m_messageTimeout);
+		return;
+	}
+
+	Slot::Ptr slot = it->second;
+
+	if (!slot->message.isNull()) {
+		logger().warning(
+			"duplicated message id " + response->messageID(),
+			__FILE__, __LINE__);
+
+		return;
+	}
+
+	slot->message = response;
+	slot->receivedAt.update();
+	slot->ready.set();
+}
+
 IQRFJsonResponse::Ptr IQRFMqttConnector::receive(
 		const GlobalID &id,
 		const Timespan &timeout)
 {
-	const Clock now;
-
-	while (!m_stopControl.shouldStop()) {
-		ScopedLockWithUnlock<FastMutex> guard(m_dataLock);
+	Slot::Ptr slot;
 
-		auto it = m_data.find(id);
-		if (it != m_data.end()) {
-			const auto message = it->second.message;
-			m_data.erase(it);
+	ScopedLockWithUnlock<FastMutex> guard(m_dataLock);
 
-			return message;
+	auto it = m_slots.find(id);
+	if (it != m_slots.end()) {
+		if (it->second->waiting) {
+			throw IllegalStateException(
+				"message " + id.toString() + " is already awaited");
 		}
-		guard.unlock();
 
-		if (timeout < 0) {
-			m_waitCondition.wait();
-		}
-		else {
-			Timespan waitTime = timeout.totalMicroseconds() - now.elapsed();
+		const auto message = it->second->message;
+		m_slots.erase(it);
 
-			if (waitTime <= 0)
-				throw TimeoutException("receive timeout expired");
+		return message;
+	}
 
-			if (waitTime.totalMilliseconds() < 1)
-				waitTime = 1 * Timespan::MILLISECONDS;
+	if (m_stopControl.shouldStop())
+		return {};
 
-			m_waitCondition.wait(waitTime);
-		}
+	slot = new Slot;
+	slot->waiting = true;
+	m_slots.emplace(id, slot);
+
+	guard.unlock();
+
+	bool ready = true;
+
+	if (timeout < 0) {
+		slot->ready.wait();
+	}
+	else {
+		const long ms = timeout.totalMilliseconds();
+		ready = slot->ready.tryWait(ms < 1 ? 1 : ms);
 	}
 
+	FastMutex::ScopedLock eraseGuard(m_dataLock);
+	m_slots.erase(id);
+
+	if (!slot->message.isNull())
+		return slot->message;
+
+	if (!ready)
+		throw TimeoutException("receive timeout expired");
+
 	return {};
 }
 
-void IQRFMqttConnector::removeExpiredMessages(const Timespan &timeout)
+void IQRFMqttConnector::removeExpiredMessages()
 {
 	FastMutex::ScopedLock guard(m_dataLock);
 
-	for (auto it = begin(m_data); it != end(m_data);) {
-		const auto &insertedAt = it->second.receivedAt;
-		if (insertedAt.isElapsed(timeout.totalMicroseconds()))
-			it = m_data.erase(it);
-		else
-			++it;
-	}
+	m_expiry.advance(Clock(), [&](const GlobalID &id) {
+		auto it = m_slots.find(id);
+		if (it == m_slots.end())
+			return;
+
+		if (it->second->waiting)
+			return;
+
+		if (logger().debug()) {
+			logger().debug(
+				"dropping unclaimed message " + id.toString(),
+				__FILE__, __LINE__);
+		}
+
+		m_slots.erase(it);
+	});
 }
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <map>
 #include <string>
+#include <unordered_map>
 
 #include <Poco/Clock.h>
+#include <Poco/Event.h>
 #include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
@@ -14,7 +15,7 @@
 #include "model/GlobalID.h"
 #include "net/MqttClient.h"
 #include "util/Loggable.h"
-#include "util/WaitCondition.h"
+#include "util/TimingWheel.h"
 
 namespace BeeeOn {
 
@@ -23,6 +24,12 @@ namespace BeeeOn {
  * During data receiving, it is necessary to know identification of
  * JSON message (GlobalID). The identification of message is used
  * to bring sent and received message together.
+ *
+ * Each pending request is represented by a slot indexed by its GlobalID.
+ * An incoming response wakes up only the thread waiting for the particular
+ * slot. Responses that arrive without any waiter are kept until the
+ * dataTimeout expires. The expiration is maintained by a TimingWheel
+ * so its cost does not depend on the number of pending requests.
  */
 class IQRFMqttConnector final:
 	public StoppableRunnable,
@@ -37,6 +44,14 @@ public:
 
 	void setPublishTopic(const std::string &topic);
 
+	/**
+	 * @brief Subscription topic of the MQTT client delivering the DPA
+	 * responses. When set, the connector is not woken up by messages
+	 * of other subscriptions of the client. If the client does not
+	 * subscribe the topic, the connector fails on the first receive.
+	 */
+	void setReceiveTopic(const std::string &topic);
+
 	void setMqttClient(
 		MqttClient::Ptr mqttClient);
 
@@ -56,29 +71,49 @@ public:
 	IQRFJsonResponse::Ptr receive(
 		const GlobalID &id, const Poco::Timespan &timeout);
 
-private:
-	void removeExpiredMessages(const Poco::Timespan &timeout);
-
 private:
 	/**
-	 * @brief Represents a received JSON message and time.
+	 * @brief Represents a pending request or a received JSON message
+	 * that has not been claimed yet. The event is set when the message
+	 * is delivered (or when stopping).
 	 */
-	struct ReceivedData {
+	struct Slot {
+		typedef Poco::SharedPtr<Slot> Ptr;
+
+		Slot();
+
+		bool waiting;
 		Poco::Clock receivedAt;
 		IQRFJsonResponse::Ptr message;
+		Poco::Event ready;
 	};
 
+	typedef std::unordered_map<GlobalID, Slot::Ptr, GlobalID::Hash> SlotMap;
+
+	/**
+	 * @brief Deliver the given response to its waiting slot or store it
+	 * to be claimed later.
+	 */
+	void deliver(IQRFJsonResponse::Ptr response);
+
+	/**
+	 * @brief Remove received messages not claimed within the dataTimeout.
+	 * Only the wheel slots of the passed ticks are visited.
+	 */
+	void removeExpiredMessages();
+
 private:
 	StopControl m_stopControl;
-	std::map<GlobalID, ReceivedData> m_data;
+	SlotMap m_slots;
+	TimingWheel<GlobalID> m_expiry;
 	Poco::Timespan m_messageTimeout;
 	Poco::Timespan m_receiveTimeout;
 
-	WaitCondition m_waitCondition;
 	Poco::FastMutex m_dataLock;
 
 	MqttClient::Ptr m_mqttClient;
 	std::string m_publishTopic;
+	std::string m_receiveTopic;
 };
 
 }
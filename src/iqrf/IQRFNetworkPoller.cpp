@@ -0,0 +1,104 @@
+#include <Poco/Clock.h>
+#include <Poco/Logger.h>
+
+#include "iqrf/IQRFNetworkPoller.h"
+#include "iqrf/IQRFPollCycle.h"
+
+using namespace BeeeOn;
+using namespace Poco;
+using namespace std;
+
+IQRFNetworkPoller::IQRFNetworkPoller(
+		IQRFMqttConnector::Ptr connector,
+		const Timespan &receiveTimeout,
+		IQRFPollStats::Ptr stats):
+	m_connector(connector),
+	m_receiveTimeout(receiveTimeout),
+	m_stats(stats)
+{
+}
+
+void IQRFNetworkPoller::add(IQRFDevice::Ptr device)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_devices.emplace(device->id(), device);
+}
+
+void IQRFNetworkPoller::remove(const DeviceID &id)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_devices.erase(id);
+}
+
+void IQRFNetworkPoller::clear()
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_devices.clear();
+}
+
+size_t IQRFNetworkPoller::size() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_devices.size();
+}
+
+bool IQRFNetworkPoller::empty() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_devices.empty();
+}
+
+DeviceID IQRFNetworkPoller::id() const
+{
+	return DeviceID(DevicePrefix::PREFIX_IQRF, 0);
+}
+
+RefreshTime IQRFNetworkPoller::refresh() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	const Clock now;
+	Timespan remaining = -1;
+
+	for (const auto &pair : m_devices) {
+		const Timespan next = pair.second->untilNextPoll(now);
+
+		if (remaining < 0 || next < remaining)
+			remaining = next;
+	}
+
+	if (remaining < 0)
+		return RefreshTime::fromSeconds(1);
+
+	const int seconds = (remaining.totalMicroseconds()
+			+ Timespan::SECONDS - 1) / Timespan::SECONDS;
+
+	return RefreshTime::fromSeconds(seconds < 1 ? 1 : seconds);
+}
+
+void IQRFNetworkPoller::poll(Distributor::Ptr distributor)
+{
+	vector<IQRFDevice::Ptr> devices;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+
+		for (const auto &pair : m_devices)
+			devices.emplace_back(pair.second);
+	}
+
+	const Clock now;
+	IQRFPollCycle cycle(m_connector, m_receiveTimeout, m_stats);
+
+	for (auto device : devices)
+		cycle.add(*device, now);
+
+	if (logger().debug()) {
+		logger().debug(
+			"polling " + to_string(cycle.size()) + " requests of "
+			+ to_string(devices.size()) + " devices",
+			__FILE__, __LINE__);
+	}
+
+	cycle.execute(distributor);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "core/PollableDevice.h"
+#include "iqrf/IQRFDevice.h"
+#include "iqrf/IQRFMqttConnector.h"
+#include "iqrf/IQRFPollStats.h"
+#include "util/Loggable.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief IQRFNetworkPoller polls all registered IQRF devices as
+ * a single pollable unit. On each poll(), all due requests of all
+ * the devices are grouped into a single IQRFPollCycle. Thus, instead
+ * of one request-response round-trip per node and per value, there
+ * is a single cycle per refresh period for the whole network.
+ *
+ * The IQRFNetworkPoller is identified by the ID of the IQRF
+ * coordinator (prefix IQRF, ident 0) that is never assigned
+ * to any real IQRF device.
+ */
+class IQRFNetworkPoller : public PollableDevice, Loggable {
+public:
+	typedef Poco::SharedPtr<IQRFNetworkPoller> Ptr;
+
+	IQRFNetworkPoller(
+		IQRFMqttConnector::Ptr connector,
+		const Poco::Timespan &receiveTimeout,
+		IQRFPollStats::Ptr stats = nullptr);
+
+	void add(IQRFDevice::Ptr device);
+	void remove(const DeviceID &id);
+	void clear();
+
+	size_t size() const;
+	bool empty() const;
+
+	DeviceID id() const override;
+
+	/**
+	 * @returns time until the earliest due request of all
+	 * registered devices (at least 1 second)
+	 */
+	RefreshTime refresh() const override;
+	void poll(Distributor::Ptr distributor) override;
+
+private:
+	IQRFMqttConnector::Ptr m_connector;
+	Poco::Timespan m_receiveTimeout;
+	IQRFPollStats::Ptr m_stats;
+	std::map<DeviceID, IQRFDevice::Ptr> m_devices;
+	mutable Poco::FastMutex m_lock;
+};
+
+}
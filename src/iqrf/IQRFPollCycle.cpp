@@ -0,0 +1,90 @@
+#include <Poco/Logger.h>
+
+#include "iqrf/IQRFPollCycle.h"
+#include "iqrf/IQRFUtil.h"
+
+using namespace BeeeOn;
+using namespace Poco;
+using namespace std;
+
+IQRFPollCycle::IQRFPollCycle(
+		IQRFMqttConnector::Ptr connector,
+		const Timespan &receiveTimeout,
+		IQRFPollStats::Ptr stats):
+	m_connector(connector),
+	m_receiveTimeout(receiveTimeout),
+	m_stats(stats)
+{
+}
+
+size_t IQRFPollCycle::add(IQRFDevice &device, const Clock &now)
+{
+	const auto requests = device.duePollRequests(now);
+
+	for (const auto &request : requests)
+		m_entries.push_back({&device, request, {}, false});
+
+	return requests.size();
+}
+
+size_t IQRFPollCycle::size() const
+{
+	return m_entries.size();
+}
+
+bool IQRFPollCycle::empty() const
+{
+	return m_entries.empty();
+}
+
+size_t IQRFPollCycle::execute(Distributor::Ptr distributor)
+{
+	if (m_entries.empty())
+		return 0;
+
+	const Clock started;
+	size_t failures = 0;
+
+	for (auto &entry : m_entries) {
+		try {
+			entry.messageID = IQRFUtil::sendRequest(
+				m_connector,
+				entry.request.request,
+				m_receiveTimeout);
+			entry.sent = true;
+		}
+		BEEEON_CATCH_CHAIN_ACTION(logger(), failures += 1)
+	}
+
+	for (auto &entry : m_entries) {
+		if (!entry.sent)
+			continue;
+
+		try {
+			const auto response = IQRFUtil::receiveResponse(
+				m_connector,
+				entry.messageID,
+				m_receiveTimeout);
+
+			distributor->exportData(
+				entry.device->parsePollResponse(entry.request, response));
+		}
+		BEEEON_CATCH_CHAIN_ACTION(logger(), failures += 1)
+	}
+
+	const Timespan latency = started.elapsed();
+
+	if (logger().debug()) {
+		logger().debug(
+			"poll cycle of " + to_string(m_entries.size())
+			+ " requests finished in "
+			+ to_string(latency.totalMilliseconds()) + " ms ("
+			+ to_string(failures) + " failed)",
+			__FILE__, __LINE__);
+	}
+
+	if (!m_stats.isNull())
+		m_stats->record(m_entries.size(), failures, latency);
+
+	return failures;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Timespan.h>
+
+#include "core/Distributor.h"
+#include "iqrf/IQRFDevice.h"
+#include "iqrf/IQRFMqttConnector.h"
+#include "iqrf/IQRFPollStats.h"
+#include "util/Loggable.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief IQRFPollCycle groups DPA requests of possibly multiple IQRF
+ * devices to be performed at once. All requests of the cycle are sent
+ * to the IQRF daemon before waiting for any response. The daemon thus
+ * always has the next request to be transmitted queued and the RF link
+ * is not idle during the MQTT round-trips between the gateway and
+ * the daemon. Responses are collected by their message IDs afterwards.
+ *
+ * Note that DPA OS Batch cannot be used for this purpose as it does
+ * not return responses of the embedded requests.
+ *
+ * Failure of a single request does not affect the others. Each failure
+ * is logged and counted in the IQRFPollStats (if any).
+ *
+ * The devices added into the cycle must outlive it.
+ */
+class IQRFPollCycle : Loggable {
+public:
+	IQRFPollCycle(
+		IQRFMqttConnector::Ptr connector,
+		const Poco::Timespan &receiveTimeout,
+		IQRFPollStats::Ptr stats = nullptr);
+
+	/**
+	 * @brief Add all due requests of the given device.
+	 * @returns number of the added requests
+	 */
+	size_t add(IQRFDevice &device, const Poco::Clock &now = {});
+
+	/**
+	 * @returns number of requests in the cycle
+	 */
+	size_t size() const;
+	bool empty() const;
+
+	/**
+	 * @brief Send all requests, wait for their responses and export
+	 * the obtained data via the given distributor.
+	 *
+	 * @returns number of failed requests
+	 */
+	size_t execute(Distributor::Ptr distributor);
+
+private:
+	struct Entry {
+		IQRFDevice *device;
+		IQRFDevice::PollRequest request;
+		GlobalID messageID;
+		bool sent;
+	};
+
+	IQRFMqttConnector::Ptr m_connector;
+	Poco::Timespan m_receiveTimeout;
+	IQRFPollStats::Ptr m_stats;
+	std::vector<Entry> m_entries;
+};
+
+}
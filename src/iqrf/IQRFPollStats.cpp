@@ -0,0 +1,123 @@
+#include "iqrf/IQRFPollStats.h"
+
+using namespace BeeeOn;
+using namespace Poco;
+using namespace std;
+
+IQRFPollStats::IQRFPollStats():
+	m_cycles(0),
+	m_requests(0),
+	m_failures(0)
+{
+}
+
+void IQRFPollStats::record(
+		size_t requests,
+		size_t failures,
+		const Timespan &latency)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_cycles == 0 || latency < m_minLatency)
+		m_minLatency = latency;
+	if (m_cycles == 0 || latency > m_maxLatency)
+		m_maxLatency = latency;
+
+	m_cycles += 1;
+	m_requests += requests;
+	m_failures += failures;
+	m_totalLatency += latency;
+	m_lastLatency = latency;
+}
+
+size_t IQRFPollStats::cycles() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_cycles;
+}
+
+size_t IQRFPollStats::requests() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_requests;
+}
+
+size_t IQRFPollStats::failures() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_failures;
+}
+
+Timespan IQRFPollStats::minLatency() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_minLatency;
+}
+
+Timespan IQRFPollStats::maxLatency() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_maxLatency;
+}
+
+Timespan IQRFPollStats::avgLatency() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_cycles == 0)
+		return 0;
+
+	return m_totalLatency.totalMicroseconds() / m_cycles;
+}
+
+Timespan IQRFPollStats::lastLatency() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_lastLatency;
+}
+
+Timespan IQRFPollStats::avgRequestLatency() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_requests == 0)
+		return 0;
+
+	return m_totalLatency.totalMicroseconds() / m_requests;
+}
+
+void IQRFPollStats::reset()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_cycles = 0;
+	m_requests = 0;
+	m_failures = 0;
+	m_minLatency = 0;
+	m_maxLatency = 0;
+	m_totalLatency = 0;
+	m_lastLatency = 0;
+}
+
+string IQRFPollStats::toString() const
+{
+	string repr;
+
+	repr += "cycles: ";
+	repr += to_string(cycles());
+	repr += "; requests: ";
+	repr += to_string(requests());
+	repr += "; failures: ";
+	repr += to_string(failures());
+	repr += "; latency min/avg/max: ";
+	repr += to_string(minLatency().totalMilliseconds());
+	repr += "/";
+	repr += to_string(avgLatency().totalMilliseconds());
+	repr += "/";
+	repr += to_string(maxLatency().totalMilliseconds());
+	repr += " ms; per request: ";
+	repr += to_string(avgRequestLatency().totalMilliseconds());
+	repr += " ms";
+
+	return repr;
+}
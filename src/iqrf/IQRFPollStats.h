@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+namespace BeeeOn {
+
+/**
+ * @brief IQRFPollStats collects statistics of polling cycles
+ * performed over the IQRF network. A cycle is a group of DPA
+ * requests that are sent at once and whose responses are
+ * collected together. For each cycle, its latency (time from
+ * sending the first request until the last response is received
+ * or timeouted) and the number of requests and failures are recorded.
+ *
+ * The class is thread-safe.
+ */
+class IQRFPollStats {
+public:
+	typedef Poco::SharedPtr<IQRFPollStats> Ptr;
+
+	IQRFPollStats();
+
+	/**
+	 * @brief Record a finished polling cycle.
+	 */
+	void record(
+		size_t requests,
+		size_t failures,
+		const Poco::Timespan &latency);
+
+	size_t cycles() const;
+	size_t requests() const;
+	size_t failures() const;
+
+	Poco::Timespan minLatency() const;
+	Poco::Timespan maxLatency() const;
+	Poco::Timespan avgLatency() const;
+	Poco::Timespan lastLatency() const;
+
+	/**
+	 * @returns average latency of a single request in a cycle
+	 */
+	Poco::Timespan avgRequestLatency() const;
+
+	/**
+	 * @brief Forget all recorded cycles.
+	 */
+	void reset();
+
+	/**
+	 * @returns human-readable summary of the statistics
+	 */
+	std::string toString() const;
+
+private:
+	size_t m_cycles;
+	size_t m_requests;
+	size_t m_failures;
+	Poco::Timespan m_minLatency;
+	Poco::Timespan m_maxLatency;
+	Poco::Timespan m_totalLatency;
+	Poco::Timespan m_lastLatency;
+	mutable Poco::FastMutex m_lock;
+};
+
+}
@@ -8,6 +8,15 @@ IQRFJsonResponse::Ptr IQRFUtil::makeRequest(
 		IQRFMqttConnector::Ptr connector,
 		DPARequest::Ptr dpa,
 		const Timespan &receiveTimeout)
+{
+	const GlobalID messageID = sendRequest(connector, dpa, receiveTimeout);
+	return receiveResponse(connector, messageID, receiveTimeout);
+}
+
+GlobalID IQRFUtil::sendRequest(
+		IQRFMqttConnector::Ptr connector,
+		DPARequest::Ptr dpa,
+		const Timespan &receiveTimeout)
 {
 	const GlobalID messageID = GlobalID::random();
 
@@ -31,11 +40,21 @@ IQRFJsonResponse::Ptr IQRFUtil::makeRequest(
 			+ to_string(request.size()) + " B",
 			__FILE__, __LINE__);
 	}
-	connector->send(json->toString());
+	connector->send(request);
+	return messageID;
+}
 
+IQRFJsonResponse::Ptr IQRFUtil::receiveResponse(
+		IQRFMqttConnector::Ptr connector,
+		const GlobalID &messageID,
+		const Timespan &receiveTimeout)
+{
 	auto jsonResponse = connector->receive(messageID, receiveTimeout);
-	string response = jsonResponse->toString();
+	if (jsonResponse.isNull())
+		throw IllegalStateException("connector has been stopped");
+
 	if (logger().trace()) {
+		const string &response = jsonResponse->toString();
 		logger().dump(
 			"received response of size "
 			+ to_string(response.size()) + " B",
@@ -44,6 +63,7 @@ IQRFJsonResponse::Ptr IQRFUtil::makeRequest(
 			Message::PRIO_TRACE);
 	}
 	else if (logger().debug()) {
+		const string &response = jsonResponse->toString();
 		logger().debug(
 			"received response of size "
 			+ to_string(response.size()) + " B",
@@ -9,6 +9,7 @@
 #include "iqrf/DPARequest.h"
 #include "iqrf/IQRFJsonResponse.h"
 #include "iqrf/IQRFMqttConnector.h"
+#include "model/GlobalID.h"
 
 namespace BeeeOn {
 
@@ -28,6 +29,32 @@ public:
 			const Poco::Timespan &receiveTimeout
 	);
 
+	/**
+	 * @brief Send DPA request without waiting for its response.
+	 * This allows to have multiple requests in flight and collect
+	 * their responses later via IQRFUtil::receiveResponse().
+	 *
+	 * @returns identification of the sent JSON message
+	 */
+	static GlobalID sendRequest(
+			IQRFMqttConnector::Ptr connector,
+			DPARequest::Ptr dpa,
+			const Poco::Timespan &receiveTimeout
+	);
+
+	/**
+	 * @brief Wait for JSON response to the request of the given
+	 * message ID.
+	 *
+	 * @throws Poco::IllegalStateException when the response reports
+	 * an error
+	 */
+	static IQRFJsonResponse::Ptr receiveResponse(
+			IQRFMqttConnector::Ptr connector,
+			const GlobalID &messageID,
+			const Poco::Timespan &receiveTimeout
+	);
+
 private:
 	static Poco::Logger &logger();
 };
@@ -155,10 +155,21 @@ void JablotronController::startIO()
 	m_ioThread = new Thread;
 	m_joiner = new Joiner(*m_ioThread);
 
-	while (!m_responses.empty())
-		m_responses.pop();
-	while (!m_reports.empty())
-		m_reports.pop();
+	m_ring.clear();
+
+	{
+		FastMutex::ScopedLock guard(m_responseLock);
+
+		while (!m_responses.empty())
+			m_responses.pop();
+	}
+
+	{
+		FastMutex::ScopedLock guard(m_reportLock);
+
+		while (!m_reports.empty())
+			m_reports.pop();
+	}
 
 	m_requestEvent.reset();
 	m_pollEvent.reset();
@@ -275,19 +286,23 @@ string JablotronController::command(const string &request, const Timespan &timeo
 	FastMutex::ScopedLock guard(m_requestLock);
 	ScopedLockWithUnlock<FastMutex> tmpGuard(m_lock);
 
-	if (!m_responses.empty()) {
-		logger().warning("responses in queue before issuing a command: "
-			+ to_string(m_responses.size()));
-	}
+	{
+		FastMutex::ScopedLock responseGuard(m_responseLock);
 
-	while (!m_responses.empty())
-		m_responses.pop();
+		if (!m_responses.empty()) {
+			logger().warning("responses in queue before issuing a command: "
+				+ to_string(m_responses.size()));
+		}
+
+		while (!m_responses.empty())
+			m_responses.pop();
+	}
 
 	writePort(CMD_BEGIN + request + CMD_END);
 	tmpGuard.unlock();
 
 	while (!m_stopControl.shouldStop()) {
-		ScopedLockWithUnlock<FastMutex> tmp2guard(m_lock);
+		ScopedLockWithUnlock<FastMutex> tmp2guard(m_responseLock);
 
 		if (!m_responses.empty())
 			break;
@@ -312,7 +327,7 @@ string JablotronController::command(const string &request, const Timespan &timeo
 
 string JablotronController::popResponse()
 {
-	FastMutex::ScopedLock guard(m_lock);
+	FastMutex::ScopedLock guard(m_responseLock);
 
 	if (m_responses.empty())
 		throw IllegalStateException("no response in the queue");
@@ -349,7 +364,7 @@ JablotronReport JablotronController::pollReport(
 
 JablotronReport JablotronController::popReport()
 {
-	FastMutex::ScopedLock guard(m_lock);
+	FastMutex::ScopedLock guard(m_reportLock);
 
 	if (m_reports.empty()) {
 		if (logger().debug())
@@ -367,68 +382,49 @@ JablotronReport JablotronController::popReport()
 	return report;
 }
 
-void JablotronController::processMessage(const string &message)
+void JablotronController::processMessage(const char *message, size_t length)
 {
-	static const RegularExpression report("\\[([0-9]{8})\\] ([^ ]+) ([^\\n]+)");
-
-	RegularExpression::MatchVec m;
-
-	if (report.match(message, 0, m)) {
-		const auto address = NumberParser::parseUnsigned(
-			message.substr(m[1].offset, m[1].length));
-		const auto product = message.substr(m[2].offset, m[2].length);
-		const auto data = message.substr(m[3].offset, m[3].length);
-
-		FastMutex::ScopedLock guard(m_lock);
-
-		const JablotronReport report = {address, product, data};
+	const JablotronReport report = JablotronReport::parse(message, length);
 
+	if (report) {
 		if (logger().debug()) {
 			logger().debug(
 				"received report " + report.toString(),
 				__FILE__, __LINE__);
 		}
 
+		FastMutex::ScopedLock guard(m_reportLock);
+
 		m_reports.emplace(report);
 		m_pollEvent.set();
 	}
 	else {
-		FastMutex::ScopedLock guard(m_lock);
-
 		if (logger().debug()) {
 			logger().debug(
-				"received response of size " + to_string(message.size()),
+				"received response of size " + to_string(length),
 				__FILE__, __LINE__);
 		}
 
-		m_responses.emplace(message);
+		FastMutex::ScopedLock guard(m_responseLock);
+
+		m_responses.emplace(message, length);
 		m_requestEvent.set();
 	}
 }
 
 void JablotronController::readAndProcess()
 {
-	static const RegularExpression pattern("\\n([^\\n]+)\\n");
-
-	string buffer;
-	size_t offset = 0;
-	RegularExpression::MatchVec m;
+	readPort(m_ioReadTimeout);
 
-	while (!pattern.match(buffer, 0, m)) {
-		buffer += readPort(m_ioReadTimeout);
-		m.clear();
-	}
+	const char *message;
+	size_t length;
 
-	do {
+	while (m_ring.next(message, length)) {
 		try {
-			processMessage(buffer.substr(m[1].offset, m[1].length));
+			processMessage(message, length);
 		}
 		BEEEON_CATCH_CHAIN(logger())
-
-		offset += m[0].length;
-		m.clear();
 	}
-	while (pattern.match(buffer, offset, m));
 }
 
 void JablotronController::ioLoop()
@@ -473,11 +469,11 @@ void JablotronController::probePort(const string &dev)
 	m_port.open();
 	m_port.flush();
 
-	string buffer;
+	m_ring.clear();
 
 	try {
 		// try to read and drop welcome message
-		buffer = readPort(m_probeTimeout);
+		readPort(m_probeTimeout);
 	}
 	catch (const TimeoutException &) {
 	}
@@ -486,31 +482,34 @@ void JablotronController::probePort(const string &dev)
 
 	for (size_t i = 0; i < m_maxProbeAttempts; ++i) {
 		try {
-			buffer += readPort(m_probeTimeout);
+			readPort(m_probeTimeout);
 		}
 		catch (const TimeoutException &) {
 			continue;
 		}
 
-		if (receivedVersion(buffer))
+		if (receivedVersion())
 			return;
 	}
 
 	throw TimeoutException("probe failed, version response was not received");
 }
 
-bool JablotronController::receivedVersion(const string &response)
+bool JablotronController::receivedVersion()
 {
-	static const RegularExpression pattern("\\n([A-Z ]+V[0-9]\\.[0-9])( [A-Z]+)?\\n");
+	static const RegularExpression pattern("^([A-Z ]+V[0-9]\\.[0-9])( [A-Z]+)?$");
 	RegularExpression::MatchVec m;
-	size_t offset = 0;
 
-	while (pattern.match(response, offset, m)) {
-		offset += m[0].length;
-		const auto message = response.substr(m[1].offset, m[1].length);
+	const char *data;
+	size_t length;
+
+	while (m_ring.next(data, length)) {
+		const string message(data, length);
 
-		logger().notice("detected dongle " + message);
-		return true;
+		if (pattern.match(message, 0, m)) {
+			logger().notice("detected dongle " + message.substr(m[1].offset, m[1].length));
+			return true;
+		}
 	}
 
 	return false;
@@ -536,27 +535,30 @@ void JablotronController::writePort(const string &request)
 	m_port.write(request);
 }
 
-string JablotronController::readPort(const Timespan &timeout)
+size_t JablotronController::readPort(const Timespan &timeout)
 {
-	const auto data = m_port.read(timeout);
+	size_t size;
+	char *buffer = m_ring.writable(size);
 
-	if (data.empty())
-		return "";
+	const auto count = m_port.read(buffer, size, timeout);
+	if (count == 0)
+		return 0;
 
 	if (logger().trace()) {
 		logger().dump(
 			"reading from port " + m_port.devicePath() + " "
-			+ to_string(data.size()) + " B",
-			data.data(),
-			data.size(),
+			+ to_string(count) + " B",
+			buffer,
+			count,
 			Message::PRIO_TRACE);
 	}
 	else if (logger().debug()) {
 		logger().debug(
 			"reading from port " + m_port.devicePath() + " "
-			+ to_string(data.size()) + " B",
+			+ to_string(count) + " B",
 			__FILE__, __LINE__);
 	}
 
-	return data;
+	m_ring.commit(count);
+	return count;
 }
@@ -13,6 +13,7 @@
 
 #include "io/SerialPort.h"
 #include "jablotron/JablotronReport.h"
+#include "jablotron/JablotronRingBuffer.h"
 #include "loop/StopControl.h"
 #include "util/Joiner.h"
 #include "util/Loggable.h"
@@ -23,6 +24,12 @@ namespace BeeeOn {
  * @brief JablotronController provides access to the Turris Dongle
  * that is connected via a serial port. The Turris Dongle must be
  * probed to start an internal I/O thread that handles incoming messages.
+ *
+ * The I/O thread reads the serial port directly into a ring buffer
+ * where the messages are framed in place. Reports are parsed directly
+ * from the ring buffer. Reports and responses are handed over via
+ * separate queues with separate locks, thus a burst of reports does
+ * not delay responses awaited by command().
  */
 class JablotronController : Loggable {
 public:
@@ -190,10 +197,11 @@ protected:
 	void probePort(const std::string &dev);
 
 	/**
-	 * @brief Parse the response to be the version string.
+	 * @brief Check whether any message received in the ring buffer
+	 * is the version string.
 	 * @returns true if the version string was recognized
 	 */
-	bool receivedVersion(const std::string &response);
+	bool receivedVersion();
 
 	/**
 	 * @brief Pop the most recent received response. All
@@ -211,8 +219,8 @@ protected:
 	JablotronReport popReport();
 
 	/**
-	 * @brief Read the serial port and process all received
-	 * messages in order.
+	 * @brief Read the serial port and process all complete
+	 * messages in the ring buffer in order.
 	 * @throws Poco::TimeoutException is ioReadTimeout exceeds
 	 * while reading from the serial port
 	 */
@@ -226,7 +234,7 @@ protected:
 	 * All non-report messages are appended into the m_responses
 	 * queue and the m_requestEvent is signalized.
 	 */
-	void processMessage(const std::string &message);
+	void processMessage(const char *message, size_t length);
 
 	/**
 	 * @brief The entry into the I/O thread loop. It periodically
@@ -238,13 +246,21 @@ protected:
 	void ioLoop();
 
 	void writePort(const std::string &request);
-	std::string readPort(const Poco::Timespan &timeout);
+
+	/**
+	 * @brief Read the serial port directly into the ring buffer.
+	 * @returns number of bytes read
+	 */
+	size_t readPort(const Poco::Timespan &timeout);
 
 private:
 	SerialPort m_port;
+	JablotronRingBuffer m_ring;
 	std::queue<std::string> m_responses;
+	Poco::FastMutex m_responseLock;
 	Poco::Event m_requestEvent;
 	std::queue<JablotronReport> m_reports;
+	Poco::FastMutex m_reportLock;
 	Poco::Event m_pollEvent;
 
 	size_t m_maxProbeAttempts;
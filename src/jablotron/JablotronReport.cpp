@@ -1,3 +1,6 @@
+#include <cctype>
+#include <cstring>
+
 #include <Poco/Exception.h>
 #include <Poco/NumberFormatter.h>
 #include <Poco/NumberParser.h>
@@ -93,3 +96,42 @@ JablotronReport JablotronReport::invalid()
 {
 	return {0, "", ""};
 }
+
+JablotronReport JablotronReport::parse(const char *message, size_t length)
+{
+	static const size_t ADDRESS_DIGITS = 8;
+
+	const char *end = message + length;
+	const char *at = static_cast<const char *>(::memchr(message, '[', length));
+
+	for (; at != nullptr; at = static_cast<const char *>(::memchr(at + 1, '[', end - at - 1))) {
+		const char *p = at + 1;
+		uint32_t address = 0;
+
+		if (end - p < static_cast<ptrdiff_t>(ADDRESS_DIGITS + 2))
+			break;
+
+		size_t digits = 0;
+		for (; digits < ADDRESS_DIGITS && ::isdigit(static_cast<unsigned char>(p[digits])); ++digits)
+			address = address * 10 + (p[digits] - '0');
+
+		if (digits != ADDRESS_DIGITS)
+			continue;
+
+		p += ADDRESS_DIGITS;
+		if (*p++ != ']' || *p++ != ' ')
+			continue;
+
+		const char *type = p;
+		while (p < end && *p != ' ')
+			++p;
+
+		// type must be non-empty and followed by a non-empty payload
+		if (p == type || end - p < 2)
+			continue;
+
+		return {address, string(type, p - type), string(p + 1, end - p - 1)};
+	}
+
+	return invalid();
+}
@@ -83,6 +83,14 @@ struct JablotronReport {
 	 * @returns an invalid report
 	 */
 	static JablotronReport invalid();
+
+	/**
+	 * @brief Parse report from the given message in format
+	 * <code>[AAAAAAAA] TYPE PAYLOAD</code> without any intermediate
+	 * copies of the message.
+	 * @returns an invalid report if the message is not a report
+	 */
+	static JablotronReport parse(const char *message, size_t length);
 };
 
 }
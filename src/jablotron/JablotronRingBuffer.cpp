@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstring>
+
+#include <Poco/Exception.h>
+
+#include "jablotron/JablotronRingBuffer.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+JablotronRingBuffer::JablotronRingBuffer(size_t capacity):
+	m_buffer(capacity),
+	m_linear(capacity),
+	m_head(0),
+	m_tail(0),
+	m_scan(0),
+	m_synced(false),
+	m_overflows(0)
+{
+	if (capacity == 0)
+		throw InvalidArgumentException("ring buffer capacity must not be 0");
+}
+
+char *JablotronRingBuffer::writable(size_t &size)
+{
+	if (m_tail - m_head == m_buffer.size()) {
+		m_overflows += 1;
+		clear();
+	}
+
+	const size_t offset = m_tail % m_buffer.size();
+	const size_t free = m_buffer.size() - (m_tail - m_head);
+
+	size = min(free, m_buffer.size() - offset);
+	return m_buffer.data() + offset;
+}
+
+void JablotronRingBuffer::commit(size_t size)
+{
+	if (size > m_buffer.size() - (m_tail - m_head))
+		throw InvalidArgumentException("committing more than free space");
+
+	m_tail += size;
+}
+
+bool JablotronRingBuffer::findDelimiter(size_t &at)
+{
+	while (m_scan < m_tail) {
+		const size_t offset = m_scan % m_buffer.size();
+		const size_t length = min(m_tail - m_scan, m_buffer.size() - offset);
+		const char *start = m_buffer.data() + offset;
+		const char *found = static_cast<const char *>(::memchr(start, '\n', length));
+
+		if (found != nullptr) {
+			at = m_scan + (found - start);
+			m_scan = at + 1;
+			return true;
+		}
+
+		m_scan += length;
+	}
+
+	return false;
+}
+
+bool JablotronRingBuffer::next(const char *&data, size_t &length)
+{
+	size_t at;
+
+	while (findDelimiter(at)) {
+		const size_t begin = m_head;
+		m_head = at + 1;
+
+		if (!m_synced) {
+			m_synced = true;
+			continue;
+		}
+
+		if (at == begin)
+			continue;
+
+		const size_t offset = begin % m_buffer.size();
+		length = at - begin;
+
+		if (offset + length <= m_buffer.size()) {
+			data = m_buffer.data() + offset;
+			return true;
+		}
+
+		const size_t first = m_buffer.size() - offset;
+		::memcpy(m_linear.data(), m_buffer.data() + offset, first);
+		::memcpy(m_linear.data() + first, m_buffer.data(), length - first);
+
+		data = m_linear.data();
+		return true;
+	}
+
+	return false;
+}
+
+void JablotronRingBuffer::clear()
+{
+	m_head = 0;
+	m_tail = 0;
+	m_scan = 0;
+	m_synced = false;
+}
+
+size_t JablotronRingBuffer::size() const
+{
+	return m_tail - m_head;
+}
+
+size_t JablotronRingBuffer::capacity() const
+{
+	return m_buffer.size();
+}
+
+size_t JablotronRingBuffer::overflows() const
+{
+	return m_overflows;
+}
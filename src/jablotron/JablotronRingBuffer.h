@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace BeeeOn {
+
+/**
+ * @brief Fixed-size ring buffer for data received from the Turris Dongle.
+ * Data are read from the serial port directly into the buffer (see
+ * writable() and commit()) and messages are framed in place by next().
+ *
+ * Each message is a non-empty line terminated by '\n'. Data preceding
+ * the first '\n' are dropped because they might be a tail of a message
+ * that has been received only partially. Empty lines are ignored.
+ *
+ * If the buffer becomes full without containing any complete message,
+ * its contents are dropped and the framing starts over.
+ */
+class JablotronRingBuffer {
+public:
+	JablotronRingBuffer(size_t capacity = 4096);
+
+	/**
+	 * @brief Returns pointer to the contiguous free space of the buffer
+	 * and stores its length into size. The size is never 0 (a full
+	 * buffer is dropped first).
+	 */
+	char *writable(size_t &size);
+
+	/**
+	 * @brief Mark size bytes of the space returned by writable() as
+	 * filled with valid data.
+	 */
+	void commit(size_t size);
+
+	/**
+	 * @brief Find the next complete message. The data pointer is valid
+	 * until the next call to writable(), commit() or next(). A message
+	 * that wraps around the end of the buffer is linearized first.
+	 *
+	 * @returns false if there is no complete message
+	 */
+	bool next(const char *&data, size_t &length);
+
+	/**
+	 * @brief Drop all data and start framing from scratch.
+	 */
+	void clear();
+
+	/**
+	 * @returns number of bytes currently held in the buffer
+	 */
+	size_t size() const;
+
+	size_t capacity() const;
+
+	/**
+	 * @returns number of times the buffer has been dropped because
+	 * it was full without any complete message
+	 */
+	size_t overflows() const;
+
+private:
+	/**
+	 * @brief Find the '\n' at position of at least m_scan.
+	 * @returns true when found and its position is stored into at
+	 */
+	bool findDelimiter(size_t &at);
+
+private:
+	std::vector<char> m_buffer;
+	std::vector<char> m_linear;
+	size_t m_head;
+	size_t m_tail;
+	size_t m_scan;
+	bool m_synced;
+	size_t m_overflows;
+};
+
+}
@@ -1,4 +1,3 @@
-#include <Poco/Clock.h>
 #include <Poco/Error.h>
 #include <Poco/Exception.h>
 #include <Poco/Logger.h>
@@ -16,6 +15,8 @@ BEEEON_OBJECT_PROPERTY("host", &MosquittoClient::setHost)
 BEEEON_OBJECT_PROPERTY("clientID", &MosquittoClient::setClientID)
 BEEEON_OBJECT_PROPERTY("reconnectTimeout", &MosquittoClient::setReconnectTimeout)
 BEEEON_OBJECT_PROPERTY("subTopics", &MosquittoClient::setSubTopics)
+BEEEON_OBJECT_PROPERTY("queueCapacity", &MosquittoClient::setQueueCapacity)
+BEEEON_OBJECT_PROPERTY("overflowPolicy", &MosquittoClient::setOverflowPolicy)
 BEEEON_OBJECT_END(BeeeOn, MosquittoClient)
 
 using namespace BeeeOn;
@@ -91,49 +92,21 @@ void MosquittoClient::connect()
 		throwMosquittoError(ret);
 }
 
-MqttMessage MosquittoClient::nextMessage()
+MqttMessage MosquittoClient::receive(const Timespan &timeout)
 {
-	FastMutex::ScopedLock guard(m_queueMutex);
-	MqttMessage msg;
-
-	if (m_msgQueue.empty())
-		return msg;
-
-	msg = m_msgQueue.front();
-	m_msgQueue.pop();
-
-	return msg;
+	return m_queues.pop(timeout);
 }
 
-MqttMessage MosquittoClient::receive(const Timespan &timeout)
+MqttMessage MosquittoClient::receiveFrom(
+		const string &subscription,
+		const Timespan &timeout)
 {
-	const Poco::Clock now;
-
-	while (!m_stop) {
-		if (now.isElapsed(timeout.totalMicroseconds()) && timeout > 0)
-			throw TimeoutException("receive timeout expired");
-
-		MqttMessage msg = nextMessage();
-		if (!msg.isEmpty())
-			return msg;
-
-		if (timeout < 0) {
-			m_receiveEvent.wait();
-		}
-		else {
-			Timespan waitTime = timeout.totalMicroseconds() - now.elapsed();
-
-			if (waitTime <= 0)
-				throw TimeoutException("receive timeout expired");
-
-			if (waitTime.totalMilliseconds() < 1)
-				waitTime = 1 * Timespan::MILLISECONDS;
-
-			m_receiveEvent.wait(waitTime.totalMilliseconds());
-		}
-	}
+	return m_queues.pop(subscription, timeout);
+}
 
-	return {};
+map<string, MqttTopicQueues::Stats> MosquittoClient::queueStats() const
+{
+	return m_queues.stats();
 }
 
 void MosquittoClient::on_message(const struct mosquitto_message *message)
@@ -145,13 +118,17 @@ void MosquittoClient::on_message(const struct mosquitto_message *message)
 			+ ") was exceeded");
 	}
 
-	FastMutex::ScopedLock guard(m_queueMutex);
-	m_msgQueue.push({
+	const bool queued = m_queues.push({
 		message->topic,
 		string(reinterpret_cast<const char *>(message->payload), message->payloadlen)
 	});
 
-	m_receiveEvent.set();
+	if (!queued && logger().debug()) {
+		logger().debug(
+			"queue is full, dropped message of topic "
+			+ string(message->topic),
+			__FILE__, __LINE__);
+	}
 }
 
 void MosquittoClient::run()
@@ -177,7 +154,7 @@ void MosquittoClient::run()
 void MosquittoClient::stop()
 {
 	m_stop = true;
-	m_receiveEvent.set();
+	m_queues.stop();
 	m_reconnectEvent.set();
 }
 
@@ -191,9 +168,24 @@ void MosquittoClient::setSubTopics(const list<string> &subTopics)
 				+ topic,
 				__FILE__, __LINE__);
 		}
+
+		m_queues.addFilter(topic);
 	}
 }
 
+void MosquittoClient::setQueueCapacity(int capacity)
+{
+	if (capacity < 1)
+		throw InvalidArgumentException("queueCapacity must be at least 1");
+
+	m_queues.setCapacity(capacity);
+}
+
+void MosquittoClient::setOverflowPolicy(const string &policy)
+{
+	m_queues.setOverflowPolicy(MqttTopicQueues::parsePolicy(policy));
+}
+
 void MosquittoClient::subscribeToAll()
 {
 	for (const auto &topic : m_subTopics) {
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <list>
-#include <queue>
+#include <map>
 #include <set>
 #include <string>
 
@@ -15,6 +15,7 @@
 
 #include "loop/StoppableRunnable.h"
 #include "net/MqttClient.h"
+#include "net/MqttTopicQueues.h"
 #include "util/Loggable.h"
 
 namespace BeeeOn {
@@ -27,6 +28,11 @@ namespace BeeeOn {
  *  - port: default 1883
  *  - reconnect wait timeout: 5 s
  *  - client id: default - empty
+ *
+ * Received messages are kept in a separate bounded queue for each
+ * subscription topic. Consumers can wait for messages of a particular
+ * subscription via receiveFrom() without being woken up by messages
+ * of other subscriptions.
  */
 class MosquittoClient:
 	Loggable,
@@ -55,6 +61,17 @@ public:
 	 */
 	void setSubTopics(const std::list<std::string> &subTopics);
 
+	/**
+	 * Max number of messages queued for each subscription.
+	 */
+	void setQueueCapacity(int capacity);
+
+	/**
+	 * Policy applied when a queue is full: drop-oldest (default)
+	 * or drop-newest.
+	 */
+	void setOverflowPolicy(const std::string &policy);
+
 	/**
 	 * Timeout between reconnecting to the server when server
 	 * connection is lost.
@@ -84,6 +101,19 @@ public:
 	 */
 	MqttMessage receive(const Poco::Timespan &timeout) override;
 
+	/**
+	 * Waiting for a new message received via the given subscription
+	 * (as given to setSubTopics()).
+	 */
+	MqttMessage receiveFrom(
+		const std::string &subscription,
+		const Poco::Timespan &timeout) override;
+
+	/**
+	 * Statistics of messages received via each subscription.
+	 */
+	std::map<std::string, MqttTopicQueues::Stats> queueStats() const;
+
 protected:
 	virtual std::string buildClientID() const;
 
@@ -112,11 +142,6 @@ private:
 	 */
 	void on_message(const struct mosquitto_message *message) override;
 
-	/**
-	 * Returns message from queue.
-	 */
-	MqttMessage nextMessage();
-
 private:
 	std::string m_clientID;
 	std::string m_host;
@@ -124,10 +149,8 @@ private:
 	int m_port;
 	std::set<std::string> m_subTopics;
 	Poco::AtomicCounter m_stop;
-	Poco::Event m_receiveEvent;
 	Poco::Event m_reconnectEvent;
-	Poco::FastMutex m_queueMutex;
-	std::queue<MqttMessage> m_msgQueue;
+	MqttTopicQueues m_queues;
 };
 
 }
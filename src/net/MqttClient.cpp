@@ -1,7 +1,14 @@
 #include "net/MqttClient.h"
 
+using namespace std;
+using namespace Poco;
 using namespace BeeeOn;
 
 MqttClient::~MqttClient()
 {
 }
+
+MqttMessage MqttClient::receiveFrom(const string &, const Timespan &timeout)
+{
+	return receive(timeout);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <Poco/SharedPtr.h>
 #include <Poco/Timespan.h>
 
@@ -32,6 +34,18 @@ public:
 	 *  - positive blocking with timeout
 	 */
 	virtual MqttMessage receive(const Poco::Timespan &timeout) = 0;
+
+	/**
+	 * Waiting for a new message received via the given subscription
+	 * topic filter. Messages of other subscriptions are left for other
+	 * consumers. The timeout semantics is the same as of receive().
+	 *
+	 * The default implementation ignores the filter and calls
+	 * receive().
+	 */
+	virtual MqttMessage receiveFrom(
+		const std::string &subscription,
+		const Poco::Timespan &timeout);
 };
 
 }
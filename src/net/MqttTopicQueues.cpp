@@ -0,0 +1,314 @@
+#include <vector>
+
+#include <Poco/Exception.h>
+
+#include "net/MqttTopicQueues.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+static const size_t DEFAULT_CAPACITY = 256;
+static const size_t MAX_ROUTES = 1024;
+
+MqttTopicQueues::MqttTopicQueues():
+	m_capacity(DEFAULT_CAPACITY),
+	m_policy(DROP_OLDEST),
+	m_sequence(0),
+	m_stop(false)
+{
+	createQueue("");
+}
+
+void MqttTopicQueues::setCapacity(size_t capacity)
+{
+	if (capacity < 1)
+		throw InvalidArgumentException("queue capacity must be at least 1");
+
+	FastMutex::ScopedLock guard(m_lock);
+	m_capacity = capacity;
+}
+
+void MqttTopicQueues::setOverflowPolicy(OverflowPolicy policy)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_policy = policy;
+}
+
+MqttTopicQueues::OverflowPolicy MqttTopicQueues::parsePolicy(const string &policy)
+{
+	if (policy == "drop-oldest")
+		return DROP_OLDEST;
+	if (policy == "drop-newest")
+		return DROP_NEWEST;
+
+	throw InvalidArgumentException("unsupported overflow policy: " + policy);
+}
+
+void MqttTopicQueues::addFilter(const string &filter)
+{
+	if (filter.empty())
+		throw InvalidArgumentException("topic filter must not be empty");
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_queues.find(filter) != m_queues.end())
+		return;
+
+	createQueue(filter);
+	m_routes.clear();
+}
+
+MqttTopicQueues::Queue &MqttTopicQueues::createQueue(const string &filter)
+{
+	const string name = filter.empty() ? "mqtt.topic.unmatched" : "mqtt.topic." + filter;
+
+	Queue &queue = m_queues[filter];
+	queue.received = m_metrics.counter(name + ".received");
+	queue.dropped = m_metrics.counter(name + ".dropped");
+
+	return queue;
+}
+
+MqttTopicQueues::Queue &MqttTopicQueues::route(const string &topic)
+{
+	auto cached = m_routes.find(topic);
+	if (cached != m_routes.end())
+		return *cached->second;
+
+	Queue *target = &m_queues.at("");
+	const string *best = nullptr;
+
+	for (auto &pair : m_queues) {
+		if (pair.first.empty() || !matches(pair.first, topic))
+			continue;
+
+		if (best == nullptr || moreSpecific(pair.first, *best)) {
+			best = &pair.first;
+			target = &pair.second;
+		}
+	}
+
+	// avoid unbounded growth when topics are generated dynamically
+	if (m_routes.size() >= MAX_ROUTES)
+		m_routes.clear();
+
+	m_routes.emplace(topic, target);
+	return *target;
+}
+
+bool MqttTopicQueues::push(const MqttMessage &msg)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	Queue &queue = route(msg.topic());
+	queue.received->add();
+
+	bool dropped = false;
+
+	if (queue.entries.size() >= m_capacity) {
+		queue.dropped->add();
+		dropped = true;
+
+		if (m_policy == DROP_NEWEST)
+			return false;
+
+		queue.entries.pop_front();
+	}
+
+	queue.entries.push_back({m_sequence++, msg});
+
+	queue.condition.signal();
+	m_anyCondition.signal();
+
+	return !dropped;
+}
+
+MqttTopicQueues::Queue *MqttTopicQueues::oldestNonEmpty()
+{
+	Queue *oldest = nullptr;
+
+	for (auto &pair : m_queues) {
+		Queue &queue = pair.second;
+
+		if (queue.entries.empty())
+			continue;
+
+		if (oldest == nullptr
+				|| queue.entries.front().sequence < oldest->entries.front().sequence)
+			oldest = &queue;
+	}
+
+	return oldest;
+}
+
+void MqttTopicQueues::waitFor(
+		Condition &condition,
+		const Clock &started,
+		const Timespan &timeout)
+{
+	if (timeout < 0) {
+		condition.wait(m_lock);
+		return;
+	}
+
+	const Timespan remaining = timeout.totalMicroseconds() - started.elapsed();
+	if (remaining <= 0)
+		throw TimeoutException("receive timeout expired");
+
+	const long ms = remaining.totalMilliseconds();
+	condition.tryWait(m_lock, ms < 1 ? 1 : ms);
+}
+
+MqttMessage MqttTopicQueues::pop(const Timespan &timeout)
+{
+	const Clock started;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	while (!m_stop) {
+		Queue *queue = oldestNonEmpty();
+
+		if (queue != nullptr) {
+			const MqttMessage msg = queue->entries.front().message;
+			queue->entries.pop_front();
+			return msg;
+		}
+
+		waitFor(m_anyCondition, started, timeout);
+	}
+
+	return {};
+}
+
+MqttMessage MqttTopicQueues::pop(const string &filter, const Timespan &timeout)
+{
+	const Clock started;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	auto it = m_queues.find(filter);
+	if (it == m_queues.end())
+		throw NotFoundException("no queue for topic filter " + filter);
+
+	Queue &queue = it->second;
+
+	while (!m_stop) {
+		if (!queue.entries.empty()) {
+			const MqttMessage msg = queue.entries.front().message;
+			queue.entries.pop_front();
+			return msg;
+		}
+
+		waitFor(queue.condition, started, timeout);
+	}
+
+	return {};
+}
+
+void MqttTopicQueues::stop()
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_stop = true;
+
+	for (auto &pair : m_queues)
+		pair.second.condition.broadcast();
+
+	m_anyCondition.broadcast();
+}
+
+map<string, MqttTopicQueues::Stats> MqttTopicQueues::stats() const
+{
+	map<string, Stats> result;
+
+	FastMutex::ScopedLock guard(m_lock);
+
+	const double seconds = m_created.elapsed() / 1000000.0;
+
+	for (const auto &pair : m_queues) {
+		const Queue &queue = pair.second;
+		const uint64_t received = queue.received->value();
+
+		result.emplace(pair.first, Stats{
+			received,
+			queue.dropped->value(),
+			queue.entries.size(),
+			seconds > 0 ? received / seconds : 0.0,
+		});
+	}
+
+	return result;
+}
+
+static vector<string> splitLevels(const string &topic)
+{
+	vector<string> levels;
+	size_t start = 0;
+
+	while (true) {
+		const size_t end = topic.find('/', start);
+		levels.emplace_back(topic.substr(start, end - start));
+
+		if (end == string::npos)
+			break;
+
+		start = end + 1;
+	}
+
+	return levels;
+}
+
+bool MqttTopicQueues::matches(const string &filter, const string &topic)
+{
+	// wildcards do not match topics starting with $ (e.g. $SYS)
+	if (!topic.empty() && topic[0] == '$'
+			&& !filter.empty() && (filter[0] == '+' || filter[0] == '#'))
+		return false;
+
+	const vector<string> filterLevels = splitLevels(filter);
+	const vector<string> topicLevels = splitLevels(topic);
+
+	for (size_t i = 0; i < filterLevels.size(); ++i) {
+		// matches also the parent level, e.g. a/# matches a
+		if (filterLevels[i] == "#")
+			return true;
+
+		if (i >= topicLevels.size())
+			return false;
+
+		if (filterLevels[i] != "+" && filterLevels[i] != topicLevels[i])
+			return false;
+	}
+
+	return filterLevels.size() == topicLevels.size();
+}
+
+/**
+ * Specificity of a single level of a topic filter.
+ */
+static int levelRank(const string &level)
+{
+	if (level == "#")
+		return 0;
+	if (level == "+")
+		return 1;
+
+	return 2;
+}
+
+bool MqttTopicQueues::moreSpecific(const string &a, const string &b)
+{
+	const vector<string> aLevels = splitLevels(a);
+	const vector<string> bLevels = splitLevels(b);
+
+	for (size_t i = 0; i < aLevels.size() && i < bLevels.size(); ++i) {
+		const int aRank = levelRank(aLevels[i]);
+		const int bRank = levelRank(bLevels[i]);
+
+		if (aRank != bRank)
+			return aRank > bRank;
+	}
+
+	return aLevels.size() > bLevels.size();
+}
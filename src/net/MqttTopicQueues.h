@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <Poco/Clock.h>
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "net/MqttMessage.h"
+#include "util/MetricsRegistry.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief MqttTopicQueues holds incoming MQTT messages in separate bounded
+ * queues, one for each subscription topic filter. An incoming message is
+ * put into the queue of the most specific filter matching its topic (see
+ * moreSpecific()). Thus, a consumer of Iqrf/DpaResponse receives its
+ * messages even if Iqrf/# is subscribed as well. Messages not matching
+ * any filter are put into a common queue of an empty filter.
+ *
+ * Each queue has its own wakeup. Thus, a consumer waiting for messages
+ * of a certain filter is not woken up by messages of other filters.
+ * A consumer waiting for messages of any filter is woken up by all
+ * messages and receives them in order of their arrival.
+ *
+ * When a queue is full, either the oldest queued message or the incoming
+ * message is dropped. Received and dropped messages are counted for each
+ * queue and exported as metrics mqtt.topic.<filter>.received and
+ * mqtt.topic.<filter>.dropped.
+ */
+class MqttTopicQueues {
+public:
+	typedef Poco::SharedPtr<MqttTopicQueues> Ptr;
+
+	enum OverflowPolicy {
+		DROP_OLDEST,
+		DROP_NEWEST,
+	};
+
+	struct Stats {
+		uint64_t received;
+		uint64_t dropped;
+		size_t queued;
+		double receivedPerSecond;
+	};
+
+	MqttTopicQueues();
+
+	void setCapacity(size_t capacity);
+	void setOverflowPolicy(OverflowPolicy policy);
+
+	/**
+	 * @brief Parse policy name "drop-oldest" or "drop-newest".
+	 */
+	static OverflowPolicy parsePolicy(const std::string &policy);
+
+	/**
+	 * @brief Create a queue for the given topic filter.
+	 */
+	void addFilter(const std::string &filter);
+
+	/**
+	 * @brief Put the message into the queue of its topic.
+	 * @returns false if a message has been dropped
+	 */
+	bool push(const MqttMessage &msg);
+
+	/**
+	 * @brief Pop the oldest message of any queue. The timeout semantics
+	 * follows MqttClient::receive(). An empty message is returned after
+	 * stop() has been called.
+	 *
+	 * @throws Poco::TimeoutException
+	 */
+	MqttMessage pop(const Poco::Timespan &timeout);
+
+	/**
+	 * @brief Pop the oldest message of the queue of the given filter.
+	 *
+	 * @throws Poco::NotFoundException when there is no such filter
+	 * @throws Poco::TimeoutException
+	 */
+	MqttMessage pop(const std::string &filter, const Poco::Timespan &timeout);
+
+	/**
+	 * @brief Wake up all waiting consumers and make them return
+	 * an empty message.
+	 */
+	void stop();
+
+	std::map<std::string, Stats> stats() const;
+
+	/**
+	 * @brief Test whether the given topic matches the given MQTT
+	 * topic filter possibly containing wildcards + and #.
+	 */
+	static bool matches(const std::string &filter, const std::string &topic);
+
+	/**
+	 * @brief Test whether the filter a is more specific than the filter b.
+	 * The filters are compared level by level from the left. A plain
+	 * level is more specific than +, which is more specific than #.
+	 * When all the compared levels are equally specific, the filter
+	 * with more levels is more specific.
+	 */
+	static bool moreSpecific(const std::string &a, const std::string &b);
+
+protected:
+	struct Entry {
+		uint64_t sequence;
+		MqttMessage message;
+	};
+
+	struct Queue {
+		std::deque<Entry> entries;
+		Poco::Condition condition;
+		CounterMetric::Ptr received;
+		CounterMetric::Ptr dropped;
+	};
+
+	Queue &createQueue(const std::string &filter);
+	Queue &route(const std::string &topic);
+
+	/**
+	 * @brief Wait for the condition until the given deadline.
+	 * The m_lock must be held.
+	 * @throws Poco::TimeoutException
+	 */
+	void waitFor(
+		Poco::Condition &condition,
+		const Poco::Clock &started,
+		const Poco::Timespan &timeout);
+
+	Queue *oldestNonEmpty();
+
+private:
+	size_t m_capacity;
+	OverflowPolicy m_policy;
+	std::map<std::string, Queue> m_queues;
+	std::unordered_map<std::string, Queue *> m_routes;
+	uint64_t m_sequence;
+	bool m_stop;
+	Poco::Clock m_created;
+	Poco::Condition m_anyCondition;
+	mutable Poco::FastMutex m_lock;
+	MetricsScope m_metrics;
+};
+
+}
@@ -66,6 +66,7 @@ void GWSCommandHandler::handleDeviceList(ServerDeviceListCommand::Ptr cmd, Answe
 {
 	GWDeviceListRequest::Ptr request = new GWDeviceListRequest;
 	request->setDevicePrefix(cmd->devicePrefix());
+	request->setKnownVersion(cmd->knownVersion());
 
 	sendRequest(request, new ServerDeviceListResult(answer));
 }
@@ -190,6 +191,13 @@ void GWSCommandHandler::onDeviceListResponse(
 	ServerDeviceListResult::Ptr specificResult = result.cast<ServerDeviceListResult>();
 	poco_assert_msg(!specificResult.isNull(), "expected ServerDeviceListResult");
 
+	specificResult->setVersion(response->version());
+
+	if (response->unchanged()) {
+		specificResult->setUnchanged(true);
+		return;
+	}
+
 	ServerDeviceListResult::DeviceValues values;
 
 	for (const auto &id : response->devices())
@@ -55,8 +55,10 @@ GWSConnectorImpl::GWSConnectorImpl():
 	m_sendTimeout(1 * Timespan::SECONDS),
 	m_reconnectDelay(5 * Timespan::SECONDS),
 	m_keepAliveTimeout(30 * Timespan::SECONDS),
-	m_receiveFailed(0)
+	m_receiveFailed(0),
+	m_ioStats(new IOStats)
 {
+	m_metrics.ioStats("gws.io", m_ioStats);
 }
 
 void GWSConnectorImpl::setHost(const string &host)
@@ -459,6 +461,7 @@ void GWSConnectorImpl::sendFrame(
 	}
 
 	socket.sendFrame(payload.data(), payload.size(), flags);
+	m_ioStats->written(payload.size());
 }
 
 int GWSConnectorImpl::receiveFrame(
@@ -485,6 +488,7 @@ GWMessage::Ptr GWSConnectorImpl::receiveMessage(WebSocket &socket) const
 		return nullptr;
 
 	const string payload(buffer.begin(), ret);
+	m_ioStats->read(payload.size());
 
 	if (logger().trace()) {
 		logger().dump(
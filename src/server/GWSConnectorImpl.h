@@ -9,10 +9,12 @@
 #include <Poco/Net/WebSocket.h>
 
 #include "core/GatewayInfo.h"
+#include "io/IOStats.h"
 #include "loop/StoppableRunnable.h"
 #include "loop/StopControl.h"
 #include "server/AbstractGWSConnector.h"
 #include "ssl/SSLClient.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
@@ -27,6 +29,8 @@ namespace BeeeOn {
  * - sending messages,
  * - receiving messages,
  * - keep alive ping-pong.
+ *
+ * Traffic of all frames is accounted in the metric gws.io.
  */
 class GWSConnectorImpl :
 	public AbstractGWSConnector,
@@ -112,6 +116,9 @@ private:
 
 	Poco::Clock m_lastPing;
 	Poco::AtomicCounter m_receiveFailed;
+
+	mutable Poco::SharedPtr<IOStats> m_ioStats;
+	MetricsScope m_metrics;
 };
 
 }
@@ -1,12 +1,87 @@
+#include <map>
+
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+#include <Poco/NumberParser.h>
+
 #include "server/GWSOutputQueue.h"
 
 using namespace std;
 using namespace Poco;
 using namespace BeeeOn;
 
+GWSOutputQueue::LaneQueue::LaneQueue():
+	depth(0),
+	limit(0),
+	weight(1),
+	m_head(&m_stub),
+	m_tail(&m_stub)
+{
+	m_stub.next.store(nullptr);
+}
+
+GWSOutputQueue::LaneQueue::~LaneQueue()
+{
+	while (Node *node = pop())
+		delete node;
+}
+
+void GWSOutputQueue::LaneQueue::push(Node *node)
+{
+	node->next.store(nullptr, memory_order_relaxed);
+	Node *prev = m_head.exchange(node, memory_order_acq_rel);
+	prev->next.store(node, memory_order_release);
+}
+
+GWSOutputQueue::Node *GWSOutputQueue::LaneQueue::pop()
+{
+	Node *tail = m_tail;
+	Node *next = tail->next.load(memory_order_acquire);
+
+	if (tail == &m_stub) {
+		if (next == nullptr)
+			return nullptr;
+
+		m_tail = next;
+		tail = next;
+		next = next->next.load(memory_order_acquire);
+	}
+
+	if (next != nullptr) {
+		m_tail = next;
+		return tail;
+	}
+
+	// a producer is between exchange() and linking of its node
+	if (tail != m_head.load(memory_order_acquire))
+		return nullptr;
+
+	push(&m_stub);
+
+	next = tail->next.load(memory_order_acquire);
+	if (next != nullptr) {
+		m_tail = next;
+		return tail;
+	}
+
+	return nullptr;
+}
+
 GWSOutputQueue::GWSOutputQueue(Event &enqueueEvent):
+	m_policy(DRAIN_STRICT),
 	m_enqueueEvent(enqueueEvent)
 {
+	for (int i = 0; i < LANE_COUNT; ++i) {
+		const string prefix = "gws.output." + laneName(static_cast<Lane>(i));
+		LaneQueue &lane = m_lanes[i];
+
+		lane.depthMetric = m_metrics.gauge(prefix + ".depth");
+		lane.waitMetric = m_metrics.histogram(prefix + ".wait_us",
+			{1000, 10000, 100000, 1000000, 10000000});
+		lane.rejectedMetric = m_metrics.counter(prefix + ".rejected");
+
+		m_credits[i] = lane.weight;
+	}
 }
 
 GWSOutputQueue::~GWSOutputQueue()
@@ -14,45 +89,239 @@ GWSOutputQueue::~GWSOutputQueue()
 	clear();
 }
 
-void GWSOutputQueue::enqueue(GWMessageContext::Ptr context)
+GWSOutputQueue::Lane GWSOutputQueue::laneOf(const GWMessageContext::Ptr context)
 {
-	FastMutex::ScopedLock guard(m_mutex);
-	m_queue.push(context);
+	const int priority = context->priority();
+
+	if (priority >= RESPONSE_PRIO)
+		return LANE_RESPONSE;
+	if (priority >= RESPONSEWITHACK_PRIO)
+		return LANE_RESPONSEWITHACK;
+	if (priority >= REQUEST_PRIO)
+		return LANE_REQUEST;
+
+	return LANE_DATA;
+}
+
+string GWSOutputQueue::laneName(Lane lane)
+{
+	switch (lane) {
+	case LANE_RESPONSE:
+		return "response";
+	case LANE_RESPONSEWITHACK:
+		return "responsewithack";
+	case LANE_REQUEST:
+		return "request";
+	case LANE_DATA:
+		return "data";
+	default:
+		break;
+	}
+
+	throw InvalidArgumentException("invalid lane " + to_string(lane));
+}
+
+GWSOutputQueue::Lane GWSOutputQueue::parseLane(const string &name)
+{
+	for (int i = 0; i < LANE_COUNT; ++i) {
+		const Lane lane = static_cast<Lane>(i);
+
+		if (laneName(lane) == name)
+			return lane;
+	}
+
+	throw InvalidArgumentException("no such output lane: " + name);
+}
+
+static map<GWSOutputQueue::Lane, size_t> parseLaneValues(
+		const list<string> &entries,
+		const string &what)
+{
+	map<GWSOutputQueue::Lane, size_t> parsed;
+
+	for (const auto &entry : entries) {
+		if (entry.empty())
+			continue;
+
+		const auto sep = entry.find(':');
+		if (sep == string::npos)
+			throw InvalidArgumentException("invalid lane " + what + ": " + entry);
+
+		const GWSOutputQueue::Lane lane =
+			GWSOutputQueue::parseLane(entry.substr(0, sep));
+		parsed[lane] = NumberParser::parseUnsigned(entry.substr(sep + 1));
+	}
+
+	return parsed;
+}
+
+void GWSOutputQueue::setLaneLimits(const list<string> &limits)
+{
+	const auto parsed = parseLaneValues(limits, "limit");
+
+	for (int i = 0; i < LANE_COUNT; ++i) {
+		auto it = parsed.find(static_cast<Lane>(i));
+		m_lanes[i].limit = it == parsed.end() ? 0 : it->second;
+	}
+}
+
+void GWSOutputQueue::setLaneWeights(const list<string> &weights)
+{
+	const auto parsed = parseLaneValues(weights, "weight");
+
+	for (const auto &pair : parsed) {
+		if (pair.second < 1) {
+			throw InvalidArgumentException(
+				"weight of lane " + laneName(pair.first) + " must be at least 1");
+		}
+	}
+
+	FastMutex::ScopedLock guard(m_consumerLock);
+
+	for (int i = 0; i < LANE_COUNT; ++i) {
+		auto it = parsed.find(static_cast<Lane>(i));
+		m_lanes[i].weight = it == parsed.end() ? 1 : it->second;
+		m_credits[i] = m_lanes[i].weight;
+	}
+}
+
+void GWSOutputQueue::setDrainPolicy(const string &policy)
+{
+	FastMutex::ScopedLock guard(m_consumerLock);
+
+	if (policy == "strict")
+		m_policy = DRAIN_STRICT;
+	else if (policy == "weighted")
+		m_policy = DRAIN_WEIGHTED;
+	else
+		throw InvalidArgumentException("invalid drain policy: " + policy);
+}
+
+void GWSOutputQueue::push(Lane lane, GWMessageContext::Ptr context)
+{
+	Node *node = new Node;
+	node->context = context;
+
+	m_lanes[lane].push(node);
+	m_lanes[lane].depthMetric->add();
 	m_enqueueEvent.set();
 }
 
-GWMessageContext::Ptr GWSOutputQueue::dequeue()
+void GWSOutputQueue::enqueue(GWMessageContext::Ptr context)
+{
+	const Lane lane = laneOf(context);
+
+	m_lanes[lane].depth.fetch_add(1);
+	push(lane, context);
+}
+
+bool GWSOutputQueue::tryEnqueue(GWMessageContext::Ptr context)
+{
+	const Lane lane = laneOf(context);
+	LaneQueue &queue = m_lanes[lane];
+
+	size_t depth = queue.depth.load();
+
+	do {
+		const size_t limit = queue.limit;
+
+		if (limit > 0 && depth >= limit) {
+			queue.rejectedMetric->add();
+			return false;
+		}
+	} while (!queue.depth.compare_exchange_weak(depth, depth + 1));
+
+	push(lane, context);
+	return true;
+}
+
+GWSOutputQueue::Node *GWSOutputQueue::popLane(Lane lane)
+{
+	LaneQueue &queue = m_lanes[lane];
+
+	Node *node = queue.pop();
+	if (node == nullptr)
+		return nullptr;
+
+	queue.depth.fetch_sub(1);
+	queue.depthMetric->sub();
+	queue.waitMetric->observe(node->enqueued.elapsed());
+
+	return node;
+}
+
+GWSOutputQueue::Node *GWSOutputQueue::popNext()
 {
-	GWMessageContext::Ptr context;
+	if (m_policy == DRAIN_STRICT) {
+		for (int i = 0; i < LANE_COUNT; ++i) {
+			if (Node *node = popLane(static_cast<Lane>(i)))
+				return node;
+		}
 
-	FastMutex::ScopedLock guard(m_mutex);
+		return nullptr;
+	}
+
+	// second round is necessary when only lanes without credits are not empty
+	for (int round = 0; round < 2; ++round) {
+		for (int i = 0; i < LANE_COUNT; ++i) {
+			if (m_credits[i] == 0)
+				continue;
+
+			if (Node *node = popLane(static_cast<Lane>(i))) {
+				m_credits[i] -= 1;
+				return node;
+			}
+		}
 
-	if (!m_queue.empty()) {
-		context = m_queue.top();
-		m_queue.pop();
+		for (int i = 0; i < LANE_COUNT; ++i)
+			m_credits[i] = m_lanes[i].weight;
 	}
 
+	return nullptr;
+}
+
+GWMessageContext::Ptr GWSOutputQueue::dequeue()
+{
+	FastMutex::ScopedLock guard(m_consumerLock);
+
+	Node *node = popNext();
+	if (node == nullptr)
+		return nullptr;
+
+	GWMessageContext::Ptr context = node->context;
+	delete node;
+
 	return context;
 }
 
+size_t GWSOutputQueue::depth(Lane lane) const
+{
+	return m_lanes[lane].depth.load();
+}
+
 void GWSOutputQueue::clear()
 {
-	FastMutex::ScopedLock guard(m_mutex);
+	FastMutex::ScopedLock guard(m_consumerLock);
 
-	poco_debug(logger(), "clearing queue with " + to_string(m_queue.size()) + " contexts enqueued");
+	for (int i = 0; i < LANE_COUNT; ++i) {
+		const Lane lane = static_cast<Lane>(i);
 
-	while(!m_queue.empty()) {
-		GWMessageContext::Ptr context = m_queue.top();
-		poco_debug(logger(), "clearing context id: " + context->id().toString()
-				+ " type: " + context->message()->type().toString());
+		poco_debug(logger(), "clearing lane " + laneName(lane) + " with "
+				+ to_string(depth(lane)) + " contexts enqueued");
 
-		GWRequestContext::Ptr requestContext = context.cast<GWRequestContext>();
-		if (!requestContext.isNull()) {
-			poco_debug(logger(), "setting status FAILED for context id: " + context->id().toString()
+		while (Node *node = popLane(lane)) {
+			GWMessageContext::Ptr context = node->context;
+			delete node;
+
+			poco_debug(logger(), "clearing context id: " + context->id().toString()
 					+ " type: " + context->message()->type().toString());
-			requestContext->result()->setStatus(Result::Status::FAILED);
-		}
 
-		m_queue.pop();
+			GWRequestContext::Ptr requestContext = context.cast<GWRequestContext>();
+			if (!requestContext.isNull()) {
+				poco_debug(logger(), "setting status FAILED for context id: " + context->id().toString()
+						+ " type: " + context->message()->type().toString());
+				requestContext->result()->setStatus(Result::Status::FAILED);
+			}
+		}
 	}
 }
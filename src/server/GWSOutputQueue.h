@@ -1,38 +1,160 @@
 #pragma once
 
-#include <queue>
+#include <atomic>
+#include <list>
+#include <string>
 
+#include <Poco/Clock.h>
 #include <Poco/Event.h>
 #include <Poco/Mutex.h>
 #include <Poco/SharedPtr.h>
 
 #include "server/GWMessageContext.h"
 #include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
 
 namespace BeeeOn {
 
 /**
  * @brief Queue for all outgoing messages. Must be initialized with
  * Poco::Event reference, which is notified on item enqueue.
+ *
+ * The queue consists of one lane per priority class of GWMessageContext
+ * (response, responsewithack, request, data). Each lane is a lock-free
+ * multi-producer/single-consumer FIFO, thus producers (exporters, command
+ * answers, resend timers) never contend on a lock. Only the consumer side
+ * (dequeue(), clear()) is serialized.
+ *
+ * Each lane can have a depth limit. The limit is applied only by
+ * tryEnqueue(), enqueue() always succeeds (it is used for contexts that
+ * must not be lost, e.g. resent ones). By default, the lanes are drained
+ * with a strict priority. In the weighted mode, each non-empty lane gets
+ * a number of dequeues per round given by its weight (the lanes are still
+ * visited in the order of priority).
+ *
+ * Depth, wait time and rejections per lane are available as metrics
+ * gws.output.<lane>.{depth,wait_us,rejected}.
  */
 class GWSOutputQueue : public Loggable {
 public:
+	enum Lane {
+		LANE_RESPONSE = 0,
+		LANE_RESPONSEWITHACK,
+		LANE_REQUEST,
+		LANE_DATA,
+		LANE_COUNT
+	};
+
+	enum DrainPolicy {
+		DRAIN_STRICT,
+		DRAIN_WEIGHTED
+	};
+
 	GWSOutputQueue(Poco::Event &enqueueEvent);
 	virtual ~GWSOutputQueue();
 
+	/**
+	 * @brief Depth limits of lanes given as a list of entries
+	 * in form <lane>:<limit>. Zero means unlimited (default).
+	 */
+	void setLaneLimits(const std::list<std::string> &limits);
+
+	/**
+	 * @brief Weights of lanes given as a list of entries in form
+	 * <lane>:<weight>. Weights are used only in the weighted mode.
+	 * The default weight is 1.
+	 */
+	void setLaneWeights(const std::list<std::string> &weights);
+
+	/**
+	 * @brief Set drain policy "strict" or "weighted".
+	 */
+	void setDrainPolicy(const std::string &policy);
+
+	/**
+	 * @brief Enqueue the given context regardless the depth limit.
+	 */
 	void enqueue(GWMessageContext::Ptr context);
 
+	/**
+	 * @brief Enqueue the given context unless its lane is full.
+	 * @returns false if the lane is full
+	 */
+	bool tryEnqueue(GWMessageContext::Ptr context);
+
 	GWMessageContext::Ptr dequeue();
 
 	void clear();
 
+	/**
+	 * @returns current number of contexts in the given lane
+	 */
+	size_t depth(Lane lane) const;
+
+	static Lane laneOf(const GWMessageContext::Ptr context);
+	static std::string laneName(Lane lane);
+	static Lane parseLane(const std::string &name);
+
+protected:
+	struct Node {
+		std::atomic<Node *> next;
+		GWMessageContext::Ptr context;
+		Poco::Clock enqueued;
+	};
+
+	/**
+	 * @brief Intrusive MPSC queue (by D. Vyukov). Producers only
+	 * exchange the head pointer, the single consumer walks from tail.
+	 */
+	class LaneQueue {
+	public:
+		LaneQueue();
+		~LaneQueue();
+
+		void push(Node *node);
+
+		/**
+		 * @returns the oldest node or nullptr if the queue is empty
+		 * (or a producer is just in the middle of push). Must be called
+		 * by a single consumer at a time.
+		 */
+		Node *pop();
+
+		std::atomic<size_t> depth;
+		std::atomic<size_t> limit;
+		size_t weight;
+		GaugeMetric::Ptr depthMetric;
+		HistogramMetric::Ptr waitMetric;
+		CounterMetric::Ptr rejectedMetric;
+
+	private:
+		std::atomic<Node *> m_head;
+		Node *m_tail;
+		Node m_stub;
+	};
+
+	void push(Lane lane, GWMessageContext::Ptr context);
+
+	/**
+	 * @brief Pop the oldest node of the given lane and update
+	 * its statistics. The m_consumerLock must be held.
+	 */
+	Node *popLane(Lane lane);
+
+	/**
+	 * @brief Pop the next node from a lane selected according to the drain
+	 * policy. The m_consumerLock must be held.
+	 */
+	Node *popNext();
+
 private:
-	std::priority_queue<GWMessageContext::Ptr,
-			std::vector<GWMessageContext::Ptr>,
-			ContextPriorityComparator> m_queue;
+	LaneQueue m_lanes[LANE_COUNT];
+	DrainPolicy m_policy;
+	size_t m_credits[LANE_COUNT];
 
-	Poco::FastMutex m_mutex;
+	Poco::FastMutex m_consumerLock;
 	Poco::Event &m_enqueueEvent;
+	MetricsScope m_metrics;
 };
 
 }
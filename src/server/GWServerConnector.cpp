@@ -40,6 +40,9 @@ BEEEON_OBJECT_PROPERTY("inactiveMultiplier", &GWServerConnector::setInactiveMult
 BEEEON_OBJECT_PROPERTY("sslConfig", &GWServerConnector::setSSLConfig)
 BEEEON_OBJECT_PROPERTY("gatewayInfo", &GWServerConnector::setGatewayInfo)
 BEEEON_OBJECT_PROPERTY("commandDispatcher", &GWServerConnector::setCommandDispatcher)
+BEEEON_OBJECT_PROPERTY("outputLaneLimits", &GWServerConnector::setOutputLaneLimits)
+BEEEON_OBJECT_PROPERTY("outputLaneWeights", &GWServerConnector::setOutputLaneWeights)
+BEEEON_OBJECT_PROPERTY("outputDrainPolicy", &GWServerConnector::setOutputDrainPolicy)
 BEEEON_OBJECT_END(BeeeOn, GWServerConnector)
 
 using namespace std;
@@ -519,6 +522,21 @@ void GWServerConnector::setInactiveMultiplier(int multiplier)
 	m_inactiveMultiplier = multiplier;
 }
 
+void GWServerConnector::setOutputLaneLimits(const list<string> &limits)
+{
+	m_outputQueue.setLaneLimits(limits);
+}
+
+void GWServerConnector::setOutputLaneWeights(const list<string> &weights)
+{
+	m_outputQueue.setLaneWeights(weights);
+}
+
+void GWServerConnector::setOutputDrainPolicy(const string &policy)
+{
+	m_outputQueue.setDrainPolicy(policy);
+}
+
 bool GWServerConnector::ship(const SensorData &data)
 {
 	if (!m_isConnected)
@@ -534,7 +552,14 @@ bool GWServerConnector::ship(const SensorData &data)
 
 	exportContext->setMessage(exportMessage);
 
-	m_outputQueue.enqueue(exportContext);
+	if (!m_outputQueue.tryEnqueue(exportContext)) {
+		if (logger().debug()) {
+			logger().debug("output queue is full, data " + id.toString()
+				+ " not shipped", __FILE__, __LINE__);
+		}
+
+		return false;
+	}
 
 	return true;
 }
@@ -582,6 +607,7 @@ void GWServerConnector::doDeviceListCommand(
 	GWDeviceListRequest::Ptr request = new GWDeviceListRequest;
 	request->setID(id);
 	request->setDevicePrefix(cmd->devicePrefix());
+	request->setKnownVersion(cmd->knownVersion());
 
 	m_outputQueue.enqueue(new GWRequestContext(request, result));
 }
@@ -712,6 +738,13 @@ void GWServerConnector::handleResponse(GWResponse::Ptr response)
 			map<DeviceID, map<ModuleID, double>> data;
 			GWDeviceListResponse::Ptr dlResponse = response.cast<GWDeviceListResponse>();
 
+			deviceListResult->setVersion(dlResponse->version());
+
+			if (dlResponse->unchanged()) {
+				deviceListResult->setUnchanged(true);
+				break;
+			}
+
 			for (const auto id : dlResponse->devices())
 				data.emplace(id, dlResponse->modulesValues(id));
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <list>
+#include <string>
+
 #include <Poco/AtomicCounter.h>
 #include <Poco/AutoPtr.h>
 #include <Poco/Event.h>
@@ -73,6 +76,14 @@ public:
 	void setSSLConfig(Poco::SharedPtr<SSLClient> config);
 	void setInactiveMultiplier(int multiplier);
 
+	/**
+	 * @brief Depth limits of output lanes (see GWSOutputQueue).
+	 * Exported data are dropped when the data lane is full.
+	 */
+	void setOutputLaneLimits(const std::list<std::string> &limits);
+	void setOutputLaneWeights(const std::list<std::string> &weights);
+	void setOutputDrainPolicy(const std::string &policy);
+
 	bool accept(const Command::Ptr cmd) override;
 	void handle(Command::Ptr cmd, Answer::Ptr answer) override;
 
@@ -1,6 +1,5 @@
 #include <string>
 
-#include <Poco/NumberFormatter.h>
 #include <Poco/Timestamp.h>
 
 #include "util/CSVSensorDataFormatter.h"
@@ -19,24 +18,50 @@ using namespace BeeeOn;
 using namespace Poco;
 using namespace std;
 
-CSVSensorDataFormatter::CSVSensorDataFormatter() :
-	m_separator(DEFAULT_SEPARATOR)
+CSVSensorDataFormatter::CSVSensorDataFormatter()
 {
+	setSeparator(DEFAULT_SEPARATOR);
 }
 
-string CSVSensorDataFormatter::format(const SensorData &data)
+void CSVSensorDataFormatter::setSeparator(const string &separator)
 {
-	string output = "";
-	string device = data.deviceID().toString();
-	string timestamp = to_string(data.timestamp().value().epochTime());
-
-	for (auto item : data) {
-		if (!output.empty())
-			output += '\n';
-		output += "sensor" + separator() + timestamp + separator() + device + separator();
-		output += item.moduleID().toString() + separator();
-		output += NumberFormatter::format(item.value(), PRECISION_OF_VALUE) + separator();
-	}
+	m_separator = separator;
+	m_recordPrefix = "sensor" + separator;
+}
 
+string CSVSensorDataFormatter::format(const SensorData &data)
+{
+	string output;
+	formatTo(data, output);
 	return output;
 }
+
+void CSVSensorDataFormatter::formatTo(const SensorData &data, string &buffer)
+{
+	// the common part of each record: sensor;timestamp;deviceID;
+	size_t headerOffset = 0;
+	size_t headerLength = 0;
+
+	for (const auto &item : data) {
+		if (headerLength == 0) {
+			headerOffset = buffer.size();
+
+			buffer += m_recordPrefix;
+			appendUnsigned(buffer, (UInt64) data.timestamp().value().epochTime());
+			buffer += m_separator;
+			appendDeviceID(buffer, data.deviceID());
+			buffer += m_separator;
+
+			headerLength = buffer.size() - headerOffset;
+		}
+		else {
+			buffer += '\n';
+			buffer.append(buffer, headerOffset, headerLength);
+		}
+
+		appendUnsigned(buffer, item.moduleID().value());
+		buffer += m_separator;
+		appendFixed(buffer, item.value(), PRECISION_OF_VALUE);
+		buffer += m_separator;
+	}
+}
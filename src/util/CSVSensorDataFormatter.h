@@ -21,25 +21,29 @@ public:
 	 */
 	std::string format(const SensorData &data) override;
 
+	/**
+	 * Append records in csv format to the given buffer. The parts
+	 * common to all records of the data are formatted only once.
+	 */
+	void formatTo(const SensorData &data, std::string &buffer) override;
+
 	/**
 	 * Optional custom separator
 	 */
-	void setSeparator(const std::string &separator)
-	{
-		m_separator = separator;
-	}
+	void setSeparator(const std::string &separator);
 
 	/**
 	 * @brief separator
 	 * @return actual separator for csv
 	 */
-	const std::string separator() const
+	const std::string &separator() const
 	{
 		return m_separator;
 	}
 
 private:
 	std::string m_separator;
+	std::string m_recordPrefix;
 };
 
 }
@@ -1,5 +1,4 @@
 #include <Poco/Checksum.h>
-#include <Poco/NumberFormatter.h>
 
 #include "di/Injectable.h"
 #include "util/ChecksumSensorDataFormatter.h"
@@ -37,11 +36,31 @@ void ChecksumSensorDataFormatter::setFormatter(SensorDataFormatter::Ptr formatte
 
 string ChecksumSensorDataFormatter::format(const SensorData &data)
 {
+	string output;
+	formatTo(data, output);
+	return output;
+}
+
+void ChecksumSensorDataFormatter::formatTo(const SensorData &data, string &buffer)
+{
+	static const char DIGITS[] = "0123456789ABCDEF";
+	static const size_t CHECKSUM_LENGTH = 8;
+
+	// reserve space for the checksum to be filled in later
+	const size_t checksumOffset = buffer.size();
+	buffer.append(CHECKSUM_LENGTH, '0');
+	buffer += m_delimiter;
+
+	const size_t contentOffset = buffer.size();
+	m_formatter->formatTo(data, buffer);
+
 	Checksum csum(Checksum::TYPE_CRC32);
+	csum.update(buffer.data() + contentOffset, buffer.size() - contentOffset);
 
-	const auto &content = m_formatter->format(data);
-	csum.update(content);
+	UInt32 value = csum.checksum();
 
-	return NumberFormatter::formatHex(csum.checksum(), 8)
-		+ m_delimiter + content;
+	for (size_t i = CHECKSUM_LENGTH; i > 0; --i) {
+		buffer[checksumOffset + i - 1] = DIGITS[value & 0xf];
+		value >>= 4;
+	}
 }
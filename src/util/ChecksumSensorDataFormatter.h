@@ -33,6 +33,13 @@ public:
 	 */
 	std::string format(const SensorData &data) override;
 
+	/**
+	 * @brief Append the checksum, the delimiter and the data formatted
+	 * by the wrapped formatter directly into the given buffer. The
+	 * checksum is computed over the appended data in place.
+	 */
+	void formatTo(const SensorData &data, std::string &buffer) override;
+
 private:
 	std::string m_delimiter;
 	SensorDataFormatter::Ptr m_formatter;
@@ -1,9 +1,6 @@
-#include <iomanip>
-#include <sstream>
+#include <cmath>
 #include <string>
 
-#include <Poco/JSON/PrintHandler.h>
-#include <Poco/NumberFormatter.h>
 #include <Poco/Timestamp.h>
 
 #include "di/Injectable.h"
@@ -14,49 +11,61 @@ BEEEON_OBJECT_BEGIN(BeeeOn, JSONSensorDataFormatter)
 BEEEON_OBJECT_CASTABLE(SensorDataFormatter)
 BEEEON_OBJECT_END(BeeeOn, JSONSensorDataFormatter)
 
+#define PRECISION_OF_VALUE 3
+
 using namespace BeeeOn;
-using namespace Poco::JSON;
 using namespace Poco;
 using namespace std;
 
+static const string DEVICE_ID_PREFIX = R"({"device_id":")";
+static const string TIMESTAMP_PREFIX = R"(","timestamp":)";
+static const string DATA_PREFIX = R"(,"data":[)";
+static const string MODULE_ID_PREFIX = R"({"module_id":)";
+static const string VALUE_PREFIX = R"(,"value":)";
+static const string NULL_VALUE = "null";
+static const string DATA_SUFFIX = "]}";
+
 JSONSensorDataFormatter::JSONSensorDataFormatter()
 {
 }
 
 string JSONSensorDataFormatter::format(const SensorData &data)
 {
-	stringstream output;
-	output.setf(ios::fixed);
-	output.precision(3);
-	PrintHandler json(output);
+	string output;
+	formatTo(data, output);
+	return output;
+}
+
+void JSONSensorDataFormatter::formatTo(const SensorData &data, string &buffer)
+{
+	buffer += DEVICE_ID_PREFIX;
+	appendDeviceID(buffer, data.deviceID());
+	buffer += TIMESTAMP_PREFIX;
+	appendUnsigned(buffer, (UInt64) data.timestamp().value().epochMicroseconds());
+	buffer += DATA_PREFIX;
 
-	json.startObject();
+	bool first = true;
 
-	json.key("device_id");
-	json.value(data.deviceID().toString());
-	json.key("timestamp");
-	json.value((UInt64)data.timestamp().value().epochMicroseconds());
+	for (const auto &item : data) {
+		if (!first)
+			buffer += ',';
 
-	json.key("data");
-	json.startArray();
+		first = false;
 
-	for (auto item : data) {
-		json.startObject();
-		json.key("module_id");
-		json.value(item.moduleID());
+		buffer += MODULE_ID_PREFIX;
+		appendUnsigned(buffer, item.moduleID().value());
 
 		if (item.isValid()) {
-			json.key("value");
+			buffer += VALUE_PREFIX;
+
 			if (std::isinf(item.value()) || std::isnan(item.value()))
-				json.null();
+				buffer += NULL_VALUE;
 			else
-				json.value(item.value());
+				appendFixed(buffer, item.value(), PRECISION_OF_VALUE);
 		}
 
-		json.endObject();
+		buffer += '}';
 	}
 
-	json.endArray();
-	json.endObject();
-	return output.str();
+	buffer += DATA_SUFFIX;
 }
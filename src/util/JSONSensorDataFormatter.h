@@ -16,6 +16,12 @@ public:
 	 * Convert data from struct SensorData to JSON format
 	 */
 	std::string format(const SensorData &data) override;
+
+	/**
+	 * Append JSON representation of the data to the given buffer
+	 * without any intermediate allocations.
+	 */
+	void formatTo(const SensorData &data, std::string &buffer) override;
 };
 
 }
@@ -27,7 +27,8 @@ Journal::Journal(
 	m_file(file),
 	m_duplicatesFactor(duplicatesFactor),
 	m_minimalRewriteSize(minimalRewritesSize),
-	m_dirty(false)
+	m_dirty(false),
+	m_committedBytes(0)
 {
 	if (m_duplicatesFactor < 1.0)
 		throw InvalidArgumentException("duplicatesFactor must be at least 1");
@@ -120,6 +121,7 @@ void Journal::load(istream &in, bool recover)
 	m_records.clear();
 	m_records.insert(m_records.end(), records.begin(), records.end());
 	m_dirty.clear();
+	recount();
 }
 
 void Journal::checkConsistent() const
@@ -200,8 +202,6 @@ void Journal::drop(const set<string> &keys, bool flush)
 {
 	Mutex::ScopedLock guard(m_lock);
 
-	list<Record> records = this->records();
-
 	for (auto it = keys.begin(); it != keys.end();) {
 		const auto &key = *it;
 		++it;
@@ -213,7 +213,7 @@ void Journal::flush()
 {
 	Mutex::ScopedLock guard(m_lock);
 
-	const auto factor = duplicatesFactor(m_records);
+	const auto factor = committedDuplicatesFactor();
 
 	if (factor > m_duplicatesFactor && overMinimalSize())
 		interpretAndFlush();
@@ -225,7 +225,33 @@ double Journal::currentDuplicatesFactor() const
 {
 	Mutex::ScopedLock guard(m_lock);
 
-	return duplicatesFactor(m_records);
+	return committedDuplicatesFactor();
+}
+
+size_t Journal::committedBytes() const
+{
+	Mutex::ScopedLock guard(m_lock);
+
+	return m_committedBytes;
+}
+
+double Journal::committedDuplicatesFactor() const
+{
+	if (m_committedKeys.empty())
+		return 1.0;
+
+	return static_cast<double>(m_records.size())
+		/ static_cast<double>(m_committedKeys.size());
+}
+
+void Journal::recount()
+{
+	m_committedKeys.clear();
+
+	for (const auto &r : m_records)
+		m_committedKeys.emplace(r.key);
+
+	m_committedBytes = bytes(m_records);
 }
 
 double Journal::duplicatesFactor(const list<Record> &records) const
@@ -244,7 +270,7 @@ double Journal::duplicatesFactor(const list<Record> &records) const
 
 bool Journal::overMinimalSize() const
 {
-	return bytes(m_records) + bytes(m_dirty) > m_minimalRewriteSize;
+	return m_committedBytes + bytes(m_dirty) > m_minimalRewriteSize;
 }
 
 void Journal::interpret(list<Record> &records) const
@@ -308,6 +334,7 @@ void Journal::rewriteAndFlush(const list<Record> &records)
 	m_records.clear();
 	m_records.insert(m_records.end(), records.begin(), records.end());
 	m_dirty.clear();
+	recount();
 }
 
 void Journal::appendFlush()
@@ -325,6 +352,8 @@ void Journal::appendFlush()
 		handleFailure(fout);
 
 		m_records.emplace_back(*it);
+		m_committedKeys.emplace(it->key);
+		m_committedBytes += format(*it, true).size() + 1;
 		it = m_dirty.erase(it);
 	}
 }
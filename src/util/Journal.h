@@ -199,6 +199,12 @@ public:
 	 */
 	double currentDuplicatesFactor() const;
 
+	/**
+	 * @returns size of the journal main records in bytes
+	 * (waiting records are not counted)
+	 */
+	size_t committedBytes() const;
+
 protected:
 	void parseStream(std::istream &in, std::list<Record> &records) const;
 	void parseStreamRecover(std::istream &in, std::list<Record> &records) const;
@@ -206,7 +212,9 @@ protected:
 	void dropInPlace(std::list<Record> &records, const std::string &key) const;
 
 	double duplicatesFactor(const std::list<Record> &records) const;
+	double committedDuplicatesFactor() const;
 	bool overMinimalSize() const;
+	void recount();
 	std::list<Record> recordsRaw() const;
 	void interpret(std::list<Record> &records) const;
 	void interpretAndFlush();
@@ -230,6 +238,13 @@ private:
 	size_t m_minimalRewriteSize;
 	std::list<Record> m_records;
 	std::list<Record> m_dirty;
+
+	/**
+	 * Statistics of m_records maintained incrementally to avoid
+	 * scanning all the records on every flush.
+	 */
+	std::set<std::string> m_committedKeys;
+	size_t m_committedBytes;
 };
 
 }
@@ -1,6 +1,11 @@
+#include <Poco/NumberFormatter.h>
+
+#include "model/DeviceID.h"
 #include "util/NullSensorDataFormatter.h"
 #include "util/SensorDataFormatter.h"
 
+using namespace std;
+using namespace Poco;
 using namespace BeeeOn;
 
 SensorDataFormatter::SensorDataFormatter()
@@ -10,3 +15,47 @@ SensorDataFormatter::SensorDataFormatter()
 SensorDataFormatter::~SensorDataFormatter()
 {
 }
+
+void SensorDataFormatter::formatTo(const SensorData &data, string &buffer)
+{
+	buffer += format(data);
+}
+
+void SensorDataFormatter::appendDeviceID(string &buffer, const DeviceID &id)
+{
+	static const char DIGITS[] = "0123456789abcdef";
+
+	uint64_t value = id;
+	if (id.is32bit())
+		value &= 0xffffffffUL;
+
+	char tmp[16];
+	size_t i = sizeof(tmp);
+
+	do {
+		tmp[--i] = DIGITS[value & 0xf];
+		value >>= 4;
+	} while (value > 0);
+
+	buffer.append("0x", 2);
+	buffer.append(tmp + i, sizeof(tmp) - i);
+}
+
+void SensorDataFormatter::appendUnsigned(string &buffer, uint64_t value)
+{
+	char tmp[20];
+	size_t i = sizeof(tmp);
+
+	do {
+		tmp[--i] = '0' + value % 10;
+		value /= 10;
+	} while (value > 0);
+
+	buffer.append(tmp + i, sizeof(tmp) - i);
+}
+
+void SensorDataFormatter::appendFixed(string &buffer, double value, int precision)
+{
+	// formats into a local buffer by the double-conversion algorithm
+	NumberFormatter::append(buffer, value, precision);
+}
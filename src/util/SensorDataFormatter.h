@@ -1,11 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include <Poco/SharedPtr.h>
 
 namespace BeeeOn {
 
+class DeviceID;
 class SensorData;
 
 class SensorDataFormatter {
@@ -19,6 +21,32 @@ public:
 	 * Convert data from struct SensorData to some formatted text
 	 */
 	virtual std::string format(const SensorData &data) = 0;
+
+	/**
+	 * @brief Append the formatted data to the given buffer. The buffer
+	 * is not cleared, thus a caller can reuse a single buffer to avoid
+	 * allocation of a new string for each record. The default
+	 * implementation appends the result of format().
+	 */
+	virtual void formatTo(const SensorData &data, std::string &buffer);
+
+protected:
+	/**
+	 * @brief Append the given device ID in the same form as
+	 * DeviceID::toString() does.
+	 */
+	static void appendDeviceID(std::string &buffer, const DeviceID &id);
+
+	/**
+	 * @brief Append the given number in decimal.
+	 */
+	static void appendUnsigned(std::string &buffer, uint64_t value);
+
+	/**
+	 * @brief Append the given number in the fixed-point notation
+	 * with the given count of decimal places.
+	 */
+	static void appendFixed(std::string &buffer, double value, int precision);
 };
 
 }
@@ -0,0 +1,354 @@
+#include <algorithm>
+
+#include <Poco/Exception.h>
+#include <Poco/Logger.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/Timestamp.h>
+
+#include "di/Injectable.h"
+#include "model/SensorData.h"
+#include "vdev/VirtualLoadGenerator.h"
+
+BEEEON_OBJECT_BEGIN(BeeeOn, VirtualLoadGenerator)
+BEEEON_OBJECT_CASTABLE(StoppableRunnable)
+BEEEON_OBJECT_CASTABLE(Exporter)
+BEEEON_OBJECT_PROPERTY("distributor", &VirtualLoadGenerator::setDistributor)
+BEEEON_OBJECT_PROPERTY("devices", &VirtualLoadGenerator::setDevices)
+BEEEON_OBJECT_PROPERTY("modules", &VirtualLoadGenerator::setModules)
+BEEEON_OBJECT_PROPERTY("interval", &VirtualLoadGenerator::setInterval)
+BEEEON_OBJECT_PROPERTY("burstPeriod", &VirtualLoadGenerator::setBurstPeriod)
+BEEEON_OBJECT_PROPERTY("burstLength", &VirtualLoadGenerator::setBurstLength)
+BEEEON_OBJECT_PROPERTY("burstFactor", &VirtualLoadGenerator::setBurstFactor)
+BEEEON_OBJECT_PROPERTY("reportInterval", &VirtualLoadGenerator::setReportInterval)
+BEEEON_OBJECT_HOOK("cleanup", &VirtualLoadGenerator::cleanup)
+BEEEON_OBJECT_END(BeeeOn, VirtualLoadGenerator)
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+/**
+ * Idents of the simulated devices start here to not collide
+ * with virtual devices configured via virtual-devices.ini.
+ */
+static const uint64_t IDENT_BASE = 0x10000000;
+
+/**
+ * Maximal number of devices served before checking for stop.
+ */
+static const size_t BATCH_LIMIT = 1024;
+
+/**
+ * Maximal number of latency samples kept per report interval.
+ */
+static const size_t LATENCY_SAMPLES = 65536;
+
+VirtualLoadGenerator::VirtualLoadGenerator():
+	m_devices(1000),
+	m_modules({"temperature", "humidity"}),
+	m_interval(10 * Timespan::SECONDS),
+	m_burstPeriod(0),
+	m_burstLength(0),
+	m_burstFactor(1),
+	m_reportInterval(10 * Timespan::SECONDS),
+	m_generated(0),
+	m_received(0),
+	m_observed(0),
+	m_maxLatency(0)
+{
+	m_generatedMetric = m_metrics.counter("vdev.load.generated");
+	m_receivedMetric = m_metrics.counter("vdev.load.received");
+	m_latencyMetric = m_metrics.histogram("vdev.load.latency_us",
+		{1000, 10000, 100000, 1000000, 10000000});
+
+	m_latencies.reserve(LATENCY_SAMPLES);
+}
+
+void VirtualLoadGenerator::setDistributor(Distributor::Ptr distributor)
+{
+	m_distributor = distributor;
+}
+
+void VirtualLoadGenerator::setDevices(int devices)
+{
+	if (devices < 1)
+		throw InvalidArgumentException("devices must be at least 1");
+
+	m_devices = devices;
+}
+
+void VirtualLoadGenerator::setModules(const list<string> &modules)
+{
+	if (modules.empty())
+		throw InvalidArgumentException("at least one module is required");
+
+	for (const auto &type : modules)
+		ModuleType::parse(type);
+
+	m_modules = modules;
+}
+
+void VirtualLoadGenerator::setInterval(const Timespan &interval)
+{
+	if (interval < 1 * Timespan::MILLISECONDS)
+		throw InvalidArgumentException("interval must be at least 1 ms");
+
+	m_interval = interval;
+}
+
+void VirtualLoadGenerator::setBurstPeriod(const Timespan &period)
+{
+	if (period < 0)
+		throw InvalidArgumentException("burstPeriod must not be negative");
+
+	m_burstPeriod = period;
+}
+
+void VirtualLoadGenerator::setBurstLength(const Timespan &length)
+{
+	if (length < 0)
+		throw InvalidArgumentException("burstLength must not be negative");
+
+	m_burstLength = length;
+}
+
+void VirtualLoadGenerator::setBurstFactor(int factor)
+{
+	if (factor < 1)
+		throw InvalidArgumentException("burstFactor must be at least 1");
+
+	m_burstFactor = factor;
+}
+
+void VirtualLoadGenerator::setReportInterval(const Timespan &interval)
+{
+	if (interval < 1 * Timespan::MILLISECONDS)
+		throw InvalidArgumentException("reportInterval must be at least 1 ms");
+
+	m_reportInterval = interval;
+}
+
+void VirtualLoadGenerator::createDevices()
+{
+	m_simulated.clear();
+
+	while (!m_queue.empty())
+		m_queue.pop();
+
+	for (size_t i = 0; i < m_devices; ++i) {
+		VirtualDevice::Ptr device = new VirtualDevice;
+		device->setID(DeviceID(DevicePrefix::PREFIX_VIRTUAL_DEVICE, IDENT_BASE + i));
+
+		unsigned int id = 0;
+		for (const auto &type : m_modules) {
+			VirtualModule::Ptr module = new VirtualModule(ModuleType::parse(type));
+			module->setModuleID(id++);
+			module->setMin(0);
+			module->setMax(100);
+			module->setGenerator("random");
+			device->addModule(module);
+		}
+
+		m_simulated.emplace_back(device);
+
+		// spread the devices evenly over the interval
+		const Timespan::TimeDiff offset =
+			(m_interval.totalMicroseconds() * i) / m_devices;
+		m_queue.push({m_started + offset, i});
+	}
+}
+
+Timespan VirtualLoadGenerator::intervalAt(const Timespan &sinceStart) const
+{
+	if (m_burstPeriod <= 0 || m_burstFactor == 1)
+		return m_interval;
+
+	const auto phase = sinceStart.totalMicroseconds()
+		% m_burstPeriod.totalMicroseconds();
+
+	if (phase < m_burstLength.totalMicroseconds()) {
+		return max<Timespan::TimeDiff>(1,
+			m_interval.totalMicroseconds() / m_burstFactor);
+	}
+
+	return m_interval;
+}
+
+void VirtualLoadGenerator::generateDue(const Clock &now, size_t limit)
+{
+	for (size_t i = 0; i < limit; ++i) {
+		if (m_queue.empty() || m_queue.top().at > now)
+			break;
+
+		const Due due = m_queue.top();
+		m_queue.pop();
+
+		SensorData data = m_simulated[due.index]->generate();
+
+		// planned time of generation, latency includes any lag
+		Timestamp at;
+		at -= now - due.at;
+		data.setTimestamp(at);
+
+		try {
+			m_distributor->exportData(data);
+		}
+		BEEEON_CATCH_CHAIN(logger())
+
+		{
+			FastMutex::ScopedLock guard(m_statsLock);
+			m_generated += 1;
+		}
+
+		m_generatedMetric->add();
+
+		const Timespan interval = intervalAt(due.at - m_started);
+		m_queue.push({due.at + interval.totalMicroseconds(), due.index});
+	}
+}
+
+void VirtualLoadGenerator::run()
+{
+	StopControl::Run run(m_stopControl);
+
+	if (m_distributor.isNull())
+		throw IllegalStateException("no distributor to generate load into");
+
+	m_started.update();
+	createDevices();
+	report();
+
+	logger().information("generating load of "
+		+ to_string(m_devices) + " devices every "
+		+ to_string(m_interval.totalMilliseconds()) + " ms",
+		__FILE__, __LINE__);
+
+	Clock nextReport = m_started + m_reportInterval.totalMicroseconds();
+
+	while (run) {
+		const Clock now;
+
+		generateDue(now, BATCH_LIMIT);
+
+		if (nextReport <= now) {
+			logReport(report());
+			nextReport += m_reportInterval.totalMicroseconds();
+		}
+
+		Clock next = nextReport;
+		if (!m_queue.empty() && m_queue.top().at < next)
+			next = m_queue.top().at;
+
+		const Clock after;
+		if (next > after)
+			run.waitStoppable(next - after);
+	}
+
+	logReport(report());
+}
+
+void VirtualLoadGenerator::stop()
+{
+	m_stopControl.requestStop();
+}
+
+void VirtualLoadGenerator::cleanup()
+{
+	m_distributor = nullptr;
+}
+
+bool VirtualLoadGenerator::ship(const SensorData &data)
+{
+	const DeviceID id = data.deviceID();
+
+	if (id.prefix() != DevicePrefix::PREFIX_VIRTUAL_DEVICE)
+		return true;
+	if (id.ident() < IDENT_BASE || id.ident() >= IDENT_BASE + m_devices)
+		return true;
+
+	const Timespan::TimeDiff latency =
+		max<Timespan::TimeDiff>(0, data.timestamp().value().elapsed());
+
+	m_receivedMetric->add();
+	m_latencyMetric->observe(latency);
+
+	FastMutex::ScopedLock guard(m_statsLock);
+
+	m_received += 1;
+	m_observed += 1;
+
+	// the reservoir does not necessarily contain the maximum
+	if (latency > m_maxLatency)
+		m_maxLatency = latency;
+
+	// reservoir sampling keeps the memory bounded
+	if (m_latencies.size() < LATENCY_SAMPLES) {
+		m_latencies.emplace_back(latency);
+	}
+	else {
+		const size_t index = m_random.next(m_observed);
+		if (index < LATENCY_SAMPLES)
+			m_latencies[index] = latency;
+	}
+
+	return true;
+}
+
+static Timespan percentile(
+		const vector<Timespan::TimeDiff> &sorted,
+		unsigned int percent)
+{
+	if (sorted.empty())
+		return 0;
+
+	const size_t index = ((sorted.size() - 1) * percent) / 100;
+	return sorted[index];
+}
+
+VirtualLoadGenerator::Report VirtualLoadGenerator::report()
+{
+	vector<Timespan::TimeDiff> latencies;
+	latencies.reserve(LATENCY_SAMPLES);
+
+	Report report;
+
+	{
+		FastMutex::ScopedLock guard(m_statsLock);
+
+		report.duration = m_reportStarted.elapsed();
+		report.generated = m_generated;
+		report.received = m_received;
+		report.max = m_maxLatency;
+
+		latencies.swap(m_latencies);
+
+		m_reportStarted.update();
+		m_generated = 0;
+		m_received = 0;
+		m_observed = 0;
+		m_maxLatency = 0;
+	}
+
+	sort(latencies.begin(), latencies.end());
+
+	report.throughput = report.duration > 0?
+		report.received / (report.duration.totalMicroseconds() / 1000000.0) : 0;
+	report.p50 = percentile(latencies, 50);
+	report.p90 = percentile(latencies, 90);
+	report.p99 = percentile(latencies, 99);
+
+	return report;
+}
+
+void VirtualLoadGenerator::logReport(const Report &report) const
+{
+	logger().information("generated " + to_string(report.generated)
+		+ ", received " + to_string(report.received)
+		+ " in " + to_string(report.duration.totalMilliseconds()) + " ms"
+		+ " (" + NumberFormatter::format(report.throughput, 1) + " /s)"
+		+ ", latency p50 " + to_string(report.p50.totalMicroseconds()) + " us"
+		+ ", p90 " + to_string(report.p90.totalMicroseconds()) + " us"
+		+ ", p99 " + to_string(report.p99.totalMicroseconds()) + " us"
+		+ ", max " + to_string(report.max.totalMicroseconds()) + " us",
+		__FILE__, __LINE__);
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <Poco/Clock.h>
+#include <Poco/Mutex.h>
+#include <Poco/Random.h>
+#include <Poco/SharedPtr.h>
+#include <Poco/Timespan.h>
+
+#include "core/Distributor.h"
+#include "core/Exporter.h"
+#include "loop/StopControl.h"
+#include "loop/StoppableRunnable.h"
+#include "util/Loggable.h"
+#include "util/MetricsRegistry.h"
+#include "vdev/VirtualDevice.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief VirtualLoadGenerator simulates a large number of virtual
+ * devices to measure capacity of the gateway without any real radio.
+ * Each device periodically generates random values of the configured
+ * module types and exports them via the given Distributor. Thus, the
+ * whole pipeline (filters, queuing, exporters) is exercised.
+ *
+ * All devices are served by a single thread using a queue ordered
+ * by the time of the next generation. The devices are spread evenly
+ * over the interval to avoid artificial peaks. When the burst period
+ * is set, every burst period starts with a burst of the given length
+ * during which all devices generate burstFactor-times faster.
+ *
+ * The generator should be registered as an Exporter of the same
+ * Distributor. It receives the generated data back after distribution
+ * and measures the latency since the planned time of generation.
+ * Achieved throughput and latency percentiles are logged every report
+ * interval. The latency is available as metric vdev.load.latency_us,
+ * counts as vdev.load.generated and vdev.load.received.
+ */
+class VirtualLoadGenerator :
+	public StoppableRunnable,
+	public Exporter,
+	protected Loggable {
+public:
+	typedef Poco::SharedPtr<VirtualLoadGenerator> Ptr;
+
+	/**
+	 * @brief Statistics of a single report interval.
+	 */
+	struct Report {
+		Poco::Timespan duration;
+		size_t generated;
+		size_t received;
+		double throughput;
+		Poco::Timespan p50;
+		Poco::Timespan p90;
+		Poco::Timespan p99;
+		Poco::Timespan max;
+	};
+
+	VirtualLoadGenerator();
+
+	void setDistributor(Distributor::Ptr distributor);
+
+	/**
+	 * @brief Number of simulated devices.
+	 */
+	void setDevices(int devices);
+
+	/**
+	 * @brief Module types of every simulated device
+	 * (e.g. temperature, humidity).
+	 */
+	void setModules(const std::list<std::string> &modules);
+
+	/**
+	 * @brief Interval of generation per single device.
+	 */
+	void setInterval(const Poco::Timespan &interval);
+
+	/**
+	 * @brief Period of bursts, zero disables bursts.
+	 */
+	void setBurstPeriod(const Poco::Timespan &period);
+	void setBurstLength(const Poco::Timespan &length);
+	void setBurstFactor(int factor);
+
+	void setReportInterval(const Poco::Timespan &interval);
+
+	void run() override;
+	void stop() override;
+
+	/**
+	 * @brief Release the distributor. The generator is usually
+	 * its exporter, thus they refer each other.
+	 */
+	void cleanup();
+
+	/**
+	 * @brief Receive the distributed data and measure its latency.
+	 * Data of other devices are ignored.
+	 */
+	bool ship(const SensorData &data) override;
+
+	/**
+	 * @brief Compute statistics since the previous report and
+	 * start a new report interval.
+	 */
+	Report report();
+
+protected:
+	struct Due {
+		Poco::Clock at;
+		size_t index;
+
+		bool operator >(const Due &other) const
+		{
+			return at > other.at;
+		}
+	};
+
+	void createDevices();
+
+	/**
+	 * @returns interval of generation for the given time since start,
+	 * it is shorter during bursts
+	 */
+	Poco::Timespan intervalAt(const Poco::Timespan &sinceStart) const;
+
+	/**
+	 * @brief Generate and export data of all devices that are due.
+	 * At most the given number of devices is served at once.
+	 */
+	void generateDue(const Poco::Clock &now, size_t limit);
+
+	void logReport(const Report &report) const;
+
+private:
+	Distributor::Ptr m_distributor;
+	size_t m_devices;
+	std::list<std::string> m_modules;
+	Poco::Timespan m_interval;
+	Poco::Timespan m_burstPeriod;
+	Poco::Timespan m_burstLength;
+	int m_burstFactor;
+	Poco::Timespan m_reportInterval;
+	StopControl m_stopControl;
+
+	std::vector<VirtualDevice::Ptr> m_simulated;
+	std::priority_queue<Due, std::vector<Due>, std::greater<Due>> m_queue;
+	Poco::Clock m_started;
+
+	Poco::FastMutex m_statsLock;
+	Poco::Clock m_reportStarted;
+	size_t m_generated;
+	size_t m_received;
+	size_t m_observed;
+	std::vector<Poco::Timespan::TimeDiff> m_latencies;
+	Poco::Timespan::TimeDiff m_maxLatency;
+	Poco::Random m_random;
+
+	MetricsScope m_metrics;
+	CounterMetric::Ptr m_generatedMetric;
+	CounterMetric::Ptr m_receivedMetric;
+	HistogramMetric::Ptr m_latencyMetric;
+};
+
+}
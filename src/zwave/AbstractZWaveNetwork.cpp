@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Poco/Clock.h>
 #include <Poco/DateTimeFormatter.h>
 #include <Poco/Exception.h>
@@ -9,7 +11,10 @@ using namespace std;
 using namespace Poco;
 using namespace BeeeOn;
 
-AbstractZWaveNetwork::AbstractZWaveNetwork()
+AbstractZWaveNetwork::AbstractZWaveNetwork():
+	m_statisticsInterval(10 * Timespan::SECONDS),
+	m_statisticsBudget(20 * Timespan::MILLISECONDS),
+	m_statisticsRunning(false)
 {
 }
 
@@ -106,3 +111,140 @@ void AbstractZWaveNetwork::interrupt()
 	m_eventsQueue.emplace_back(none);
 	m_event.set();
 }
+
+void AbstractZWaveNetwork::setStatisticsInterval(const Timespan &interval)
+{
+	if (interval <= 0) {
+		throw InvalidArgumentException(
+			"statistics interval must be a positive number");
+	}
+
+	m_statisticsInterval = interval;
+}
+
+void AbstractZWaveNetwork::setStatisticsBudget(const Timespan &budget)
+{
+	if (budget < 0) {
+		throw InvalidArgumentException(
+			"statistics budget must not be negative");
+	}
+
+	m_statisticsBudget = budget;
+}
+
+void AbstractZWaveNetwork::collectStatistics()
+{
+	if (!m_statisticsRunning) {
+		if (Clock() < m_nextStatistics)
+			return;
+
+		startStatisticsCycle();
+	}
+
+	const Clock started;
+
+	while (!m_pendingNodes.empty()) {
+		const auto next = m_pendingNodes.front();
+		m_pendingNodes.pop_front();
+
+		collectNode(next.first, next.second);
+
+		if (started.elapsed() >= m_statisticsBudget.totalMicroseconds())
+			break;
+	}
+
+	if (logger().trace()) {
+		logger().trace(
+			"statistics collected in "
+			+ to_string(started.elapsed()) + " us, remaining nodes: "
+			+ to_string(m_pendingNodes.size()),
+			__FILE__, __LINE__);
+	}
+
+	if (m_pendingNodes.empty())
+		finishStatisticsCycle();
+}
+
+void AbstractZWaveNetwork::startStatisticsCycle()
+{
+	m_statisticsStarted.update();
+	m_nextStatistics = m_statisticsStarted + m_statisticsInterval.totalMicroseconds();
+	m_statisticsRunning = true;
+
+	m_pendingNodes.clear();
+	m_meshStatistics.clear();
+
+	for (const auto &home : statisticsNodes()) {
+		MeshStatistics &mesh = m_meshStatistics[home.first];
+		mesh.nodes.reserve(home.second.size());
+		mesh.summary = {0, 0, 0, 0, 0, 0};
+		mesh.rttSum = 0;
+		mesh.rttCount = 0;
+
+		for (const auto node : home.second)
+			m_pendingNodes.emplace_back(home.first, node);
+	}
+}
+
+void AbstractZWaveNetwork::collectNode(uint32_t home, uint8_t node)
+{
+	try {
+		const ZWaveNodeEvent e = nodeStatistics(home, node);
+		MeshStatistics &mesh = m_meshStatistics[home];
+
+		mesh.summary.sentCount += e.sentCount();
+		mesh.summary.sentFailed += e.sentFailed();
+		mesh.summary.retries += e.retries();
+
+		if (e.sentCount() > 0) {
+			mesh.rttSum += e.averageRequestRTT();
+			mesh.rttCount += 1;
+			mesh.summary.maxRTT = max(mesh.summary.maxRTT, e.averageRequestRTT());
+		}
+
+		mesh.nodes.emplace_back(e);
+	}
+	BEEEON_CATCH_CHAIN(logger())
+}
+
+void AbstractZWaveNetwork::finishStatisticsCycle()
+{
+	const Timespan duration = m_statisticsStarted.elapsed();
+
+	for (auto &home : m_meshStatistics) {
+		MeshStatistics &mesh = home.second;
+
+		if (mesh.rttCount > 0)
+			mesh.summary.averageRTT = mesh.rttSum / mesh.rttCount;
+
+		try {
+			const ZWaveDriverEvent driver = driverStatistics(home.first);
+			mesh.summary.dropped = driver.dropped();
+
+			reportStatistics({home.first, driver, mesh.nodes, mesh.summary, duration});
+		}
+		BEEEON_CATCH_CHAIN(logger())
+	}
+
+	m_meshStatistics.clear();
+	m_statisticsRunning = false;
+}
+
+map<uint32_t, vector<uint8_t>> AbstractZWaveNetwork::statisticsNodes()
+{
+	return {};
+}
+
+ZWaveNodeEvent AbstractZWaveNetwork::nodeStatistics(uint32_t, uint8_t)
+{
+	throw NotImplementedException(__func__);
+}
+
+ZWaveDriverEvent AbstractZWaveNetwork::driverStatistics(uint32_t)
+{
+	throw NotImplementedException(__func__);
+}
+
+void AbstractZWaveNetwork::reportStatistics(const ZWaveMeshEvent &)
+{
+}
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <cstdint>
 #include <deque>
+#include <map>
+#include <utility>
+#include <vector>
 
+#include <Poco/Clock.h>
 #include <Poco/Event.h>
 #include <Poco/Mutex.h>
+#include <Poco/Timespan.h>
 
 #include "util/Loggable.h"
+#include "zwave/ZWaveDriverEvent.h"
+#include "zwave/ZWaveMeshEvent.h"
 #include "zwave/ZWaveNetwork.h"
+#include "zwave/ZWaveNodeEvent.h"
 
 namespace BeeeOn {
 
@@ -15,6 +24,14 @@ namespace BeeeOn {
  * a pre-implemented polling mechanism. It is assumed that exactly one
  * thread calls the method pollEvent() periodically to read the events
  * (using multiple threads might be an issue because we use Poco::Event).
+ *
+ * It also implements incremental collection of statistics. A statistics
+ * cycle collects statistics of all nodes and it is spread over multiple
+ * calls of collectStatistics(). Each call spends at most the statistics
+ * budget (but serves at least one node) and continues where the previous
+ * one has stopped. When the cycle is complete, a single ZWaveMeshEvent
+ * with the mesh-level summary is reported for each Z-Wave network.
+ * It is assumed that collectStatistics() is called from a single thread.
  */
 class AbstractZWaveNetwork :
 	public ZWaveNetwork,
@@ -35,6 +52,17 @@ public:
 	 */
 	void interrupt() override;
 
+	/**
+	 * @brief Set the period of statistics cycles.
+	 */
+	void setStatisticsInterval(const Poco::Timespan &interval);
+
+	/**
+	 * @brief Set the maximal time spent by a single call of
+	 * collectStatistics(). Zero means one node per call.
+	 */
+	void setStatisticsBudget(const Poco::Timespan &budget);
+
 protected:
 	/**
 	 * This method enqueues the given event in the m_eventsQueue and
@@ -42,10 +70,65 @@ protected:
 	 */
 	void notifyEvent(const PollEvent &event);
 
+	/**
+	 * Perform a single step of statistics collection. A new cycle is
+	 * started when the previous one is complete and the statistics
+	 * interval has elapsed since its start.
+	 */
+	void collectStatistics();
+
+	/**
+	 * @returns nodes of each Z-Wave network (home) to collect statistics
+	 * of in the next cycle. The default implementation returns no nodes.
+	 */
+	virtual std::map<uint32_t, std::vector<uint8_t>> statisticsNodes();
+
+	/**
+	 * @returns statistics of the given node
+	 * @throws Poco::NotImplementedException by default
+	 */
+	virtual ZWaveNodeEvent nodeStatistics(uint32_t home, uint8_t node);
+
+	/**
+	 * @returns statistics of the driver of the given Z-Wave network
+	 * @throws Poco::NotImplementedException by default
+	 */
+	virtual ZWaveDriverEvent driverStatistics(uint32_t home);
+
+	/**
+	 * Report statistics of a Z-Wave network collected during the
+	 * just completed cycle. The default implementation does nothing.
+	 */
+	virtual void reportStatistics(const ZWaveMeshEvent &event);
+
+private:
+	/**
+	 * Statistics of a single Z-Wave network collected during
+	 * the current cycle.
+	 */
+	struct MeshStatistics {
+		std::vector<ZWaveNodeEvent> nodes;
+		ZWaveMeshEvent::Summary summary;
+		uint64_t rttSum;
+		size_t rttCount;
+	};
+
+	void startStatisticsCycle();
+	void collectNode(uint32_t home, uint8_t node);
+	void finishStatisticsCycle();
+
 private:
 	std::deque<PollEvent> m_eventsQueue;
 	Poco::Event m_event;
 	mutable Poco::FastMutex m_lock;
+
+	Poco::Timespan m_statisticsInterval;
+	Poco::Timespan m_statisticsBudget;
+	bool m_statisticsRunning;
+	Poco::Clock m_statisticsStarted;
+	Poco::Clock m_nextStatistics;
+	std::deque<std::pair<uint32_t, uint8_t>> m_pendingNodes;
+	std::map<uint32_t, MeshStatistics> m_meshStatistics;
 };
 
 }
@@ -24,8 +24,9 @@
 #include "zwave/OZWNetwork.h"
 #include "zwave/OZWNotificationEvent.h"
 #include "zwave/OZWPocoLoggerAdapter.h"
-#include "zwave/ZWaveNodeEvent.h"
 #include "zwave/ZWaveDriverEvent.h"
+#include "zwave/ZWaveMeshEvent.h"
+#include "zwave/ZWaveNodeEvent.h"
 #include "zwave/ZWaveSerialProber.h"
 
 BEEEON_OBJECT_BEGIN(BeeeOn, OZWNetwork)
@@ -37,6 +38,8 @@ BEEEON_OBJECT_PROPERTY("pollInterval", &OZWNetwork::setPollInterval)
 BEEEON_OBJECT_PROPERTY("intervalBetweenPolls", &OZWNetwork::setIntervalBetweenPolls)
 BEEEON_OBJECT_PROPERTY("retryTimeout", &OZWNetwork::setRetryTimeout)
 BEEEON_OBJECT_PROPERTY("statisticsInterval", &OZWNetwork::setStatisticsInterval)
+BEEEON_OBJECT_PROPERTY("statisticsBudget", &OZWNetwork::setStatisticsBudget)
+BEEEON_OBJECT_PROPERTY("statisticsStep", &OZWNetwork::setStatisticsStep)
 BEEEON_OBJECT_PROPERTY("networkKey", &OZWNetwork::setNetworkKey)
 BEEEON_OBJECT_PROPERTY("controllersToReset", &OZWNetwork::setControllersToReset)
 BEEEON_OBJECT_PROPERTY("executor", &OZWNetwork::setExecutor)
@@ -75,6 +78,7 @@ OpenZWave::ValueID OZWNetwork::OZWNode::operator[] (const CommandClass &cc) cons
 #define OZW_DEFAULT_RETRY_TIMEOUT          (10 * Timespan::SECONDS)
 #define OZW_DEFAULT_ASSUME_AWAKE           false
 #define OZW_DEFAULT_DRIVER_MAX_ATTEMPTS    0
+#define OZW_DEFAULT_STATISTICS_STEP        (1 * Timespan::SECONDS)
 
 OZWNetwork::OZWNetwork():
 	m_configPath("/etc/openzwave"),
@@ -87,6 +91,7 @@ OZWNetwork::OZWNetwork():
 	m_configured(false),
 	m_command(*this)
 {
+	m_statisticsRunner.setInterval(OZW_DEFAULT_STATISTICS_STEP);
 }
 
 OZWNetwork::~OZWNetwork()
@@ -161,14 +166,14 @@ void OZWNetwork::setNetworkKey(const list<string> &bytes)
 	}
 }
 
-void OZWNetwork::setStatisticsInterval(const Timespan &interval)
+void OZWNetwork::setStatisticsStep(const Timespan &step)
 {
-	if (interval <= 0) {
+	if (step <= 0) {
 		throw InvalidArgumentException(
-			"statistics interval must be a positive number");
+			"statistics step must be a positive number");
 	}
 
-	m_statisticsRunner.setInterval(interval);
+	m_statisticsRunner.setInterval(step);
 }
 
 void OZWNetwork::setControllersToReset(const list<string> &homes)
@@ -272,7 +277,7 @@ void OZWNetwork::configure()
 	Log::SetLoggingClass(new OZWPocoLoggerAdapter(ozwLogger));
 
 	m_statisticsRunner.start([&]() {
-		fireStatistics();
+		collectStatistics();
 	});
 
 	Manager::Get()->AddWatcher(&ozwNotification, this);
@@ -751,25 +756,71 @@ void OZWNetwork::valueChanged(const Notification *n)
 
 	FastMutex::ScopedLock guard(m_managerLock);
 
-	string value;
-	Manager::Get()->GetValueAsString(n->GetValueID(), &value);
-
-	const string &unit = Manager::Get()->GetValueUnits(n->GetValueID());
-	const auto cc = buildCommandClass(n->GetValueID());
+	const ZWaveNode::Value &value = extractValue(it->second.id(), n->GetValueID());
 
 	if (logger().debug()) {
-		logger().debug("received data " + value
-				+ " (" + cc.toString() + ") from "
+		logger().debug("received data " + value.value()
+				+ " (" + value.commandClass().toString() + ") from "
 				+ it->second.toString(),
 				__FILE__, __LINE__);
 	}
 
-	notifyEvent(PollEvent::createValue({
-		it->second,
-		cc,
-		value,
-		unit
-	}));
+	notifyEvent(PollEvent::createValue(value));
+}
+
+ZWaveNode::Value OZWNetwork::extractValue(
+		const ZWaveNode::Identity &node,
+		const ValueID &id)
+{
+	const string &unit = Manager::Get()->GetValueUnits(id);
+	const auto cc = buildCommandClass(id);
+
+	switch (id.GetType()) {
+	case ValueID::ValueType_Bool: {
+		bool value;
+		if (Manager::Get()->GetValueAsBool(id, &value))
+			return ZWaveNode::Value::fromBool(node, cc, value, unit);
+		break;
+	}
+	case ValueID::ValueType_Byte: {
+		uint8 value;
+		if (Manager::Get()->GetValueAsByte(id, &value))
+			return ZWaveNode::Value::fromByte(node, cc, value, unit);
+		break;
+	}
+	case ValueID::ValueType_Short: {
+		int16 value;
+		if (Manager::Get()->GetValueAsShort(id, &value))
+			return ZWaveNode::Value::fromInt(node, cc, value, unit);
+		break;
+	}
+	case ValueID::ValueType_Int: {
+		int32 value;
+		if (Manager::Get()->GetValueAsInt(id, &value))
+			return ZWaveNode::Value::fromInt(node, cc, value, unit);
+		break;
+	}
+	case ValueID::ValueType_Decimal: {
+		float value;
+		uint8 precision;
+
+		if (!Manager::Get()->GetValueAsFloat(id, &value))
+			break;
+		if (!Manager::Get()->GetValueFloatPrecision(id, &precision))
+			break;
+		if (precision > ZWaveNode::Value::MAX_SCALE)
+			break;
+
+		return ZWaveNode::Value::fromDecimal(node, cc, value, precision, unit);
+	}
+	default:
+		break;
+	}
+
+	string value;
+	Manager::Get()->GetValueAsString(id, &value);
+
+	return ZWaveNode::Value(node, cc, value, unit);
 }
 
 void OZWNetwork::nodeQueried(const Notification *n)
@@ -989,63 +1040,99 @@ void OZWNetwork::interrupt()
 	AbstractZWaveNetwork::interrupt();
 }
 
-void OZWNetwork::fireStatistics()
+map<uint32_t, vector<uint8_t>> OZWNetwork::statisticsNodes()
 {
-	FastMutex::ScopedLock guard(m_managerLock);
+	FastMutex::ScopedLock guard(m_lock);
+
+	map<uint32_t, vector<uint8_t>> nodes;
 
 	for (const auto &home : m_homes) {
-		Driver::DriverData data;
-		Manager::Get()->GetDriverStatistics(home.first, &data);
-
-		const map<string, uint32_t> stats ={
-			{"SOFCnt", data.m_SOFCnt},
-			{"ACKWaiting", data.m_ACKWaiting},
-			{"readAborts", data.m_readAborts},
-			{"badChecksum", data.m_badChecksum},
-			{"readCnt", data.m_readCnt},
-			{"writeCnt", data.m_writeCnt},
-			{"CANCnt", data.m_CANCnt},
-			{"NAKCnt", data.m_NAKCnt},
-			{"ACKCnt", data.m_ACKCnt},
-			{"OOFCnt", data.m_OOFCnt},
-			{"dropped", data.m_dropped},
-			{"retries", data.m_retries},
-			{"callbacks", data.m_callbacks},
-			{"badroutes", data.m_badroutes},
-			{"noACK", data.m_noack},
-			{"netbusy", data.m_netbusy},
-			{"notidle", data.m_notidle},
-			{"nondelivery", data.m_nondelivery},
-			{"routedbusy", data.m_routedbusy},
-			{"broadcastReadCnt", data.m_broadcastReadCnt},
-			{"broadcastWriteCnt", data.m_broadcastWriteCnt},
-		};
-
-		ZWaveDriverEvent e(stats);
-		m_eventSource.fireEvent(e, &ZWaveListener::onDriverStats);
-
-		for (const auto &node : home.second) {
-			Node::NodeData data;
-			Manager::Get()->GetNodeStatistics(home.first, node.first, &data);
-
-			const map<string, uint32_t> stats = {
-				{"sentCnt",            data.m_sentCnt},
-				{"sentFailed",         data.m_sentFailed},
-				{"retries",            data.m_retries},
-				{"receivedCnt",        data.m_receivedCnt},
-				{"receivedDups",       data.m_receivedDups},
-				{"receivedUnsolicited",data.m_receivedUnsolicited},
-				{"lastRequestRTT",     data.m_lastRequestRTT},
-				{"lastResponseRTT",    data.m_lastResponseRTT},
-				{"averageRequestRTT",  data.m_averageRequestRTT},
-				{"averageResponseRTT", data.m_averageResponseRTT},
-				{"quality",            data.m_quality},
-			};
-
-			ZWaveNodeEvent e(stats, node.first);
-			m_eventSource.fireEvent(e, &ZWaveListener::onNodeStats);
-		}
+		auto &ids = nodes[home.first];
+
+		for (const auto &node : home.second)
+			ids.emplace_back(node.first);
 	}
+
+	return nodes;
+}
+
+ZWaveNodeEvent OZWNetwork::nodeStatistics(uint32_t home, uint8_t node)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	// the node might have been removed since the statistics cycle started,
+	// OZW would leave the data untouched in such case
+	auto it = m_homes.find(home);
+	if (it == m_homes.end())
+		throw NotFoundException("no such home " + homeAsString(home));
+
+	if (it->second.find(node) == it->second.end())
+		throw NotFoundException("no such node " + ZWaveNode::Identity(home, node).toString());
+
+	FastMutex::ScopedLock guardManager(m_managerLock);
+
+	Node::NodeData data{};
+	Manager::Get()->GetNodeStatistics(home, node, &data);
+
+	const map<string, uint32_t> stats = {
+		{"sentCnt",            data.m_sentCnt},
+		{"sentFailed",         data.m_sentFailed},
+		{"retries",            data.m_retries},
+		{"receivedCnt",        data.m_receivedCnt},
+		{"receivedDups",       data.m_receivedDups},
+		{"receivedUnsolicited",data.m_receivedUnsolicited},
+		{"lastRequestRTT",     data.m_lastRequestRTT},
+		{"lastResponseRTT",    data.m_lastResponseRTT},
+		{"averageRequestRTT",  data.m_averageRequestRTT},
+		{"averageResponseRTT", data.m_averageResponseRTT},
+		{"quality",            data.m_quality},
+	};
+
+	return ZWaveNodeEvent(stats, node);
+}
+
+ZWaveDriverEvent OZWNetwork::driverStatistics(uint32_t home)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	if (m_homes.find(home) == m_homes.end())
+		throw NotFoundException("no such home " + homeAsString(home));
+
+	FastMutex::ScopedLock guardManager(m_managerLock);
+
+	Driver::DriverData data{};
+	Manager::Get()->GetDriverStatistics(home, &data);
+
+	const map<string, uint32_t> stats ={
+		{"SOFCnt", data.m_SOFCnt},
+		{"ACKWaiting", data.m_ACKWaiting},
+		{"readAborts", data.m_readAborts},
+		{"badChecksum", data.m_badChecksum},
+		{"readCnt", data.m_readCnt},
+		{"writeCnt", data.m_writeCnt},
+		{"CANCnt", data.m_CANCnt},
+		{"NAKCnt", data.m_NAKCnt},
+		{"ACKCnt", data.m_ACKCnt},
+		{"OOFCnt", data.m_OOFCnt},
+		{"dropped", data.m_dropped},
+		{"retries", data.m_retries},
+		{"callbacks", data.m_callbacks},
+		{"badroutes", data.m_badroutes},
+		{"noACK", data.m_noack},
+		{"netbusy", data.m_netbusy},
+		{"notidle", data.m_notidle},
+		{"nondelivery", data.m_nondelivery},
+		{"routedbusy", data.m_routedbusy},
+		{"broadcastReadCnt", data.m_broadcastReadCnt},
+		{"broadcastWriteCnt", data.m_broadcastWriteCnt},
+	};
+
+	return ZWaveDriverEvent(stats);
+}
+
+void OZWNetwork::reportStatistics(const ZWaveMeshEvent &e)
+{
+	m_eventSource.fireEvent(e, &ZWaveListener::onMeshStats);
 }
 
 void OZWNetwork::postValue(const ZWaveNode::Value &value)
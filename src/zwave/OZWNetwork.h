@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <Poco/AtomicCounter.h>
 #include <Poco/Mutex.h>
@@ -107,9 +108,15 @@ public:
 	void setNetworkKey(const std::list<std::string> &bytes);
 
 	/**
-	 * @brief Set the interval of reporting OZW statistics.
+	 * @brief Set the interval of steps of statistics collection.
+	 * Each step collects statistics of nodes within the statistics
+	 * budget, thus statistics of large networks are collected
+	 * during multiple steps.
+	 *
+	 * @see AbstractZWaveNetwork::setStatisticsInterval()
+	 * @see AbstractZWaveNetwork::setStatisticsBudget()
 	 */
-	void setStatisticsInterval(const Poco::Timespan &interval);
+	void setStatisticsStep(const Poco::Timespan &step);
 
 	/**
 	 * @brief Set controllers (list of home IDs) to be reset
@@ -197,14 +204,32 @@ protected:
 	void prepareDirectory(const Poco::Path &path);
 
 	/**
-	 * @brief Fire Z-Wave statistics. This is called periodically by the
-	 * m_statisticsRunner.
+	 * @brief List nodes of all homes. The statistics are collected
+	 * periodically by the m_statisticsRunner.
+	 *
+	 * @see AbstractZWaveNetwork::collectStatistics()
+	 */
+	std::map<uint32_t, std::vector<uint8_t>> statisticsNodes() override;
+
+	/**
+	 * @brief Read statistics of the given node via OZW Manager.
+	 * @throws Poco::NotFoundException if the node has been removed
+	 */
+	ZWaveNodeEvent nodeStatistics(uint32_t home, uint8_t node) override;
+
+	/**
+	 * @brief Read statistics of the driver of the given home via OZW Manager.
+	 * @throws Poco::NotFoundException if the home has been removed
+	 */
+	ZWaveDriverEvent driverStatistics(uint32_t home) override;
+
+	/**
+	 * @brief Fire the collected statistics to the registered listeners.
 	 *
 	 * @see OZWNetwork::setExecutor()
 	 * @see OZWNetwork::registerListener()
-	 * @see OZWNetwork::setStatisticsInterval()
 	 */
-	void fireStatistics();
+	void reportStatistics(const ZWaveMeshEvent &e) override;
 
 	/**
 	 * @brief Determine hotplugged devices compatible with the OZWNetwork.
@@ -359,6 +384,18 @@ protected:
 	 */
 	void valueChanged(const OpenZWave::Notification *n);
 
+	/**
+	 * @brief Read the current value of the given ValueID. Values of
+	 * types bool, byte, short, int and decimal are read by the typed
+	 * OZW getters and thus no string formatting and parsing is involved.
+	 * Other types are read in the string representation.
+	 *
+	 * The caller is expected to hold the m_managerLock.
+	 */
+	static ZWaveNode::Value extractValue(
+			const ZWaveNode::Identity &node,
+			const OpenZWave::ValueID &id);
+
 	/**
 	 * @brief Called when OZW finishes discovering of a Z-Wave node.
 	 * At this moment, we are sure to know all dynamic information about
@@ -1,4 +1,5 @@
 #include "zwave/ZWaveListener.h"
+#include "zwave/ZWaveMeshEvent.h"
 
 using namespace BeeeOn;
 
@@ -9,3 +10,11 @@ ZWaveListener::ZWaveListener()
 ZWaveListener::~ZWaveListener()
 {
 }
+
+void ZWaveListener::onMeshStats(const ZWaveMeshEvent &e)
+{
+	onDriverStats(e.driver());
+
+	for (const auto &node : e.nodes())
+		onNodeStats(node);
+}
@@ -5,6 +5,7 @@
 namespace BeeeOn {
 
 class ZWaveDriverEvent;
+class ZWaveMeshEvent;
 class ZWaveNodeEvent;
 class OZWNotificationEvent;
 
@@ -30,6 +31,14 @@ public:
 	 */
 	virtual void onNodeStats(const ZWaveNodeEvent &nodeEvent) = 0;
 
+	/**
+	 * This method is called once per statistics cycle for each
+	 * Z-Wave network. The default implementation delivers statistics
+	 * of the driver and of each node via onDriverStats() and
+	 * onNodeStats().
+	 */
+	virtual void onMeshStats(const ZWaveMeshEvent &meshEvent);
+
 	/**
 	 * This method is called for each low-level Z-Wave notification.
 	 */
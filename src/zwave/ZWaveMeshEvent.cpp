@@ -0,0 +1,44 @@
+#include "zwave/ZWaveMeshEvent.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+ZWaveMeshEvent::ZWaveMeshEvent(
+		uint32_t homeID,
+		const ZWaveDriverEvent &driver,
+		const vector<ZWaveNodeEvent> &nodes,
+		const Summary &summary,
+		const Timespan &duration):
+	m_homeID(homeID),
+	m_driver(driver),
+	m_nodes(nodes),
+	m_summary(summary),
+	m_duration(duration)
+{
+}
+
+uint32_t ZWaveMeshEvent::homeID() const
+{
+	return m_homeID;
+}
+
+const ZWaveDriverEvent &ZWaveMeshEvent::driver() const
+{
+	return m_driver;
+}
+
+const vector<ZWaveNodeEvent> &ZWaveMeshEvent::nodes() const
+{
+	return m_nodes;
+}
+
+const ZWaveMeshEvent::Summary &ZWaveMeshEvent::summary() const
+{
+	return m_summary;
+}
+
+Timespan ZWaveMeshEvent::duration() const
+{
+	return m_duration;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Poco/Timespan.h>
+
+#include "zwave/ZWaveDriverEvent.h"
+#include "zwave/ZWaveNodeEvent.h"
+
+namespace BeeeOn {
+
+/**
+ * Statistics of a whole Z-Wave network (home) collected during a single
+ * statistics cycle. It contains statistics of the driver, statistics of
+ * all nodes and the mesh-level summary computed once per cycle.
+ */
+class ZWaveMeshEvent {
+public:
+	/**
+	 * Mesh-level summary of the collected node statistics.
+	 */
+	struct Summary {
+		/**
+		 * Sum of frames sent to all nodes.
+		 */
+		uint64_t sentCount;
+
+		/**
+		 * Sum of frames that have failed to be sent to all nodes.
+		 */
+		uint64_t sentFailed;
+
+		/**
+		 * Sum of retries of all nodes.
+		 */
+		uint64_t retries;
+
+		/**
+		 * Average request RTT over nodes that have sent something (ms).
+		 */
+		uint32_t averageRTT;
+
+		/**
+		 * The highest average request RTT among all nodes (ms).
+		 */
+		uint32_t maxRTT;
+
+		/**
+		 * Frames dropped by the driver.
+		 */
+		uint32_t dropped;
+	};
+
+	ZWaveMeshEvent(
+		uint32_t homeID,
+		const ZWaveDriverEvent &driver,
+		const std::vector<ZWaveNodeEvent> &nodes,
+		const Summary &summary,
+		const Poco::Timespan &duration);
+
+	uint32_t homeID() const;
+	const ZWaveDriverEvent &driver() const;
+	const std::vector<ZWaveNodeEvent> &nodes() const;
+	const Summary &summary() const;
+
+	/**
+	 * Time it took to collect statistics of the whole cycle.
+	 */
+	Poco::Timespan duration() const;
+
+private:
+	uint32_t m_homeID;
+	ZWaveDriverEvent m_driver;
+	std::vector<ZWaveNodeEvent> m_nodes;
+	Summary m_summary;
+	Poco::Timespan m_duration;
+};
+
+}
@@ -75,6 +75,23 @@ bool ZWaveNode::CommandClass::operator <(const CommandClass &cc) const
 	return m_instance < cc.m_instance;
 }
 
+/**
+ * Powers of 10 to convert between fixed-point and floating-point
+ * representation of TYPE_DECIMAL values.
+ */
+static const int64_t DECIMAL_POWERS[ZWaveNode::Value::MAX_SCALE + 1] = {
+	1LL,
+	10LL,
+	100LL,
+	1000LL,
+	10000LL,
+	100000LL,
+	1000000LL,
+	10000000LL,
+	100000000LL,
+	1000000000LL,
+};
+
 ZWaveNode::Value::Value(
 		const ZWaveNode &node,
 		const CommandClass &cc,
@@ -91,11 +108,91 @@ ZWaveNode::Value::Value(
 		const string &unit):
 	m_node(node),
 	m_commandClass(cc),
+	m_type(TYPE_STRING),
 	m_value(value),
+	m_integral(0),
+	m_scale(0),
 	m_unit(unit)
 {
 }
 
+ZWaveNode::Value::Value(
+		const Identity &node,
+		const CommandClass &cc,
+		Type type,
+		int64_t integral,
+		uint8_t scale,
+		const string &unit):
+	m_node(node),
+	m_commandClass(cc),
+	m_type(type),
+	m_integral(integral),
+	m_scale(scale),
+	m_unit(unit)
+{
+}
+
+ZWaveNode::Value ZWaveNode::Value::fromBool(
+		const Identity &node,
+		const CommandClass &cc,
+		bool value,
+		const string &unit)
+{
+	return Value(node, cc, TYPE_BOOL, value ? 1 : 0, 0, unit);
+}
+
+ZWaveNode::Value ZWaveNode::Value::fromByte(
+		const Identity &node,
+		const CommandClass &cc,
+		uint8_t value,
+		const string &unit)
+{
+	return Value(node, cc, TYPE_BYTE, value, 0, unit);
+}
+
+ZWaveNode::Value ZWaveNode::Value::fromInt(
+		const Identity &node,
+		const CommandClass &cc,
+		int32_t value,
+		const string &unit)
+{
+	return Value(node, cc, TYPE_INT, value, 0, unit);
+}
+
+ZWaveNode::Value ZWaveNode::Value::fromDecimal(
+		const Identity &node,
+		const CommandClass &cc,
+		double value,
+		uint8_t scale,
+		const string &unit)
+{
+	if (scale > MAX_SCALE) {
+		throw InvalidArgumentException(
+			"too big scale of decimal value: " + to_string(scale));
+	}
+
+	const int64_t mantissa = ::llround(value * DECIMAL_POWERS[scale]);
+	return Value(node, cc, TYPE_DECIMAL, mantissa, scale, unit);
+}
+
+ZWaveNode::Value::Type ZWaveNode::Value::type() const
+{
+	return m_type;
+}
+
+bool ZWaveNode::Value::isIntegral() const
+{
+	switch (m_type) {
+	case TYPE_BYTE:
+	case TYPE_INT:
+		return true;
+	case TYPE_DECIMAL:
+		return m_scale == 0;
+	default:
+		return false;
+	}
+}
+
 const ZWaveNode::Identity &ZWaveNode::Value::node() const
 {
 	return m_node;
@@ -106,9 +203,42 @@ const ZWaveNode::CommandClass &ZWaveNode::Value::commandClass() const
 	return m_commandClass;
 }
 
+/**
+ * Format the fixed-point number without any floating-point
+ * arithmetics. The result is equivalent to the string as
+ * provided by the OpenZWave library for decimal values.
+ */
+static string formatDecimal(int64_t mantissa, uint8_t scale)
+{
+	const bool negative = mantissa < 0;
+	string digits = to_string(negative ? -mantissa : mantissa);
+
+	if (scale > 0) {
+		if (digits.size() <= scale)
+			digits.insert(0, scale - digits.size() + 1, '0');
+
+		digits.insert(digits.size() - scale, ".");
+	}
+
+	if (negative)
+		digits.insert(0, "-");
+
+	return digits;
+}
+
 string ZWaveNode::Value::value() const
 {
-	return m_value;
+	switch (m_type) {
+	case TYPE_BOOL:
+		return m_integral ? "True" : "False";
+	case TYPE_BYTE:
+	case TYPE_INT:
+		return to_string(m_integral);
+	case TYPE_DECIMAL:
+		return formatDecimal(m_integral, m_scale);
+	default:
+		return m_value;
+	}
 }
 
 string ZWaveNode::Value::unit() const
@@ -118,21 +248,43 @@ string ZWaveNode::Value::unit() const
 
 bool ZWaveNode::Value::asBool() const
 {
-	return NumberParser::parseBool(m_value);
+	if (m_type == TYPE_BOOL || isIntegral())
+		return m_integral != 0;
+
+	return NumberParser::parseBool(value());
 }
 
 uint32_t ZWaveNode::Value::asHex32() const
 {
-	return NumberParser::parseHex(m_value);
+	return NumberParser::parseHex(value());
 }
 
 double ZWaveNode::Value::asDouble() const
 {
-	return NumberParser::parseFloat(m_value);
+	switch (m_type) {
+	case TYPE_BOOL:
+	case TYPE_BYTE:
+	case TYPE_INT:
+		return m_integral;
+	case TYPE_DECIMAL:
+		return static_cast<double>(m_integral) / DECIMAL_POWERS[m_scale];
+	default:
+		return NumberParser::parseFloat(m_value);
+	}
 }
 
 int ZWaveNode::Value::asInt(bool floor) const
 {
+	if (m_type == TYPE_BOOL || isIntegral())
+		return static_cast<int>(m_integral);
+
+	if (m_type == TYPE_DECIMAL) {
+		if (!floor)
+			throw SyntaxException("not an integer: " + value());
+
+		return ::floor(asDouble());
+	}
+
 	if (!floor)
 		return NumberParser::parse(m_value);
 
@@ -145,7 +297,7 @@ int ZWaveNode::Value::asInt(bool floor) const
 
 double ZWaveNode::Value::asCelsius() const
 {
-	double v = NumberParser::parseFloat(m_value);
+	double v = asDouble();
 
 	if (m_unit == "F")
 		return (5.0 * (v - 32.0)) / 9.0;
@@ -160,7 +312,7 @@ double ZWaveNode::Value::asCelsius() const
 
 double ZWaveNode::Value::asLuminance() const
 {
-	double v = NumberParser::parseFloat(m_value);
+	double v = asDouble();
 
 	// convert percent to lux, consider 1000 lux as 100 %
 	// https://github.com/CZ-NIC/domoticz-turris-gadgets/blob/master/hardware/OpenZWave.cpp#L1641
@@ -188,7 +340,7 @@ double ZWaveNode::Value::asPM25() const
 
 Timespan ZWaveNode::Value::asTime() const
 {
-	unsigned long t = NumberParser::parse(m_value);
+	unsigned long t = asInt();
 
 	if (!icompare(m_unit, "seconds"))
 		return t * Timespan::SECONDS;
@@ -205,7 +357,7 @@ string ZWaveNode::Value::toString() const
 		+ " "
 		+ m_commandClass.toString()
 		+ " "
-		+ m_value
+		+ value()
 		+ " ["
 		+ m_unit
 		+ "]";
@@ -98,9 +98,31 @@ public:
 	 * @brief Value coming from the Z-Wave network. It holds some
 	 * data (usually sensor data) and metadata to identify the
 	 * value semantics.
+	 *
+	 * The data can be held either in the raw string format or
+	 * natively typed (bool, byte, int, decimal). The typed values
+	 * are converted directly without any parsing, the string
+	 * representation is constructed only on demand.
 	 */
 	class Value {
 	public:
+		/**
+		 * @brief Type of the underlying data representation.
+		 */
+		enum Type {
+			TYPE_STRING,
+			TYPE_BOOL,
+			TYPE_BYTE,
+			TYPE_INT,
+			TYPE_DECIMAL,
+		};
+
+		/**
+		 * Maximal supported scale (number of digits after
+		 * the decimal point) of TYPE_DECIMAL values.
+		 */
+		static const uint8_t MAX_SCALE = 9;
+
 		Value(const ZWaveNode &node,
 		      const CommandClass &cc,
 		      const std::string &value,
@@ -111,6 +133,52 @@ public:
 			const std::string &value,
 			const std::string &unit = "");
 
+		/**
+		 * @brief Create value of type TYPE_BOOL.
+		 */
+		static Value fromBool(
+			const Identity &node,
+			const CommandClass &cc,
+			bool value,
+			const std::string &unit = "");
+
+		/**
+		 * @brief Create value of type TYPE_BYTE.
+		 */
+		static Value fromByte(
+			const Identity &node,
+			const CommandClass &cc,
+			uint8_t value,
+			const std::string &unit = "");
+
+		/**
+		 * @brief Create value of type TYPE_INT.
+		 */
+		static Value fromInt(
+			const Identity &node,
+			const CommandClass &cc,
+			int32_t value,
+			const std::string &unit = "");
+
+		/**
+		 * @brief Create value of type TYPE_DECIMAL. The given value
+		 * is rounded to the given scale (number of digits after
+		 * the decimal point) and kept as a fixed-point number.
+		 *
+		 * @throw Poco::InvalidArgumentException if scale > MAX_SCALE
+		 */
+		static Value fromDecimal(
+			const Identity &node,
+			const CommandClass &cc,
+			double value,
+			uint8_t scale,
+			const std::string &unit = "");
+
+		/**
+		 * @returns type of the underlying data representation
+		 */
+		Type type() const;
+
 		/**
 		 * @returns the associated node's identity
 		 */
@@ -122,7 +190,8 @@ public:
 		const CommandClass &commandClass() const;
 
 		/**
-		 * @returns value in string format (raw)
+		 * @returns value in string format (raw), for typed values
+		 * the string is constructed on each call
 		 */
 		std::string value() const;
 
@@ -190,10 +259,27 @@ public:
 
 		std::string toString() const;
 
+	protected:
+		Value(const Identity &node,
+			const CommandClass &cc,
+			Type type,
+			int64_t integral,
+			uint8_t scale,
+			const std::string &unit);
+
+		/**
+		 * @returns true if the value holds an integral number
+		 * (TYPE_BYTE, TYPE_INT or TYPE_DECIMAL with zero scale)
+		 */
+		bool isIntegral() const;
+
 	private:
 		Identity m_node;
 		CommandClass m_commandClass;
+		Type m_type;
 		std::string m_value;
+		int64_t m_integral;
+		uint8_t m_scale;
 		std::string m_unit;
 	};
 
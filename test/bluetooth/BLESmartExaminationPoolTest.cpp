@@ -0,0 +1,207 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/AtomicCounter.h>
+#include <Poco/Event.h>
+#include <Poco/Exception.h>
+#include <Poco/Thread.h>
+
+#include "bluetooth/BLESmartExaminationPool.h"
+#include "bluetooth/BeeWiSmartLite.h"
+#include "cppunit/BetterAssert.h"
+#include "model/RefreshTime.h"
+#include "net/MACAddress.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class BLESmartExaminationPoolTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(BLESmartExaminationPoolTest);
+	CPPUNIT_TEST(testExamine);
+	CPPUNIT_TEST(testCacheUnsupported);
+	CPPUNIT_TEST(testCacheFailures);
+	CPPUNIT_TEST(testDeduplicate);
+	CPPUNIT_TEST(testStopCompletesBatches);
+	CPPUNIT_TEST(testNotRunning);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testExamine();
+	void testCacheUnsupported();
+	void testCacheFailures();
+	void testDeduplicate();
+	void testStopCompletesBatches();
+	void testNotRunning();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BLESmartExaminationPoolTest);
+
+static const MACAddress SUPPORTED(0x010203040506UL);
+static const MACAddress UNSUPPORTED(0x0a0b0c0d0e0fUL);
+static const MACAddress BROKEN(0x111111111111UL);
+
+/**
+ * Examination simulating devices around. Only SUPPORTED is a supported
+ * device, BROKEN always fails to connect. The examination can be blocked
+ * until the release event is set.
+ */
+class FakeExamination {
+public:
+	FakeExamination(bool blocking = false):
+		m_release(false)
+	{
+		if (!blocking)
+			m_release.set();
+	}
+
+	BLESmartDevice::Ptr operator ()(const MACAddress &address)
+	{
+		m_calls++;
+		m_release.wait();
+
+		if (address == BROKEN)
+			throw IOException("failed to connect " + address.toString(':'));
+		if (address != SUPPORTED)
+			throw NotFoundException("device not supported");
+
+		return new BeeWiSmartLite(address, 1 * Timespan::SECONDS, RefreshTime::NONE, {});
+	}
+
+	AtomicCounter m_calls;
+	Event m_release;
+};
+
+void BLESmartExaminationPoolTest::testExamine()
+{
+	FakeExamination fake;
+	BLESmartExaminationPool pool;
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	auto batch = pool.examine({SUPPORTED, UNSUPPORTED, BROKEN});
+	CPPUNIT_ASSERT(batch->wait(5 * Timespan::SECONDS));
+
+	CPPUNIT_ASSERT_EQUAL(0, batch->remaining());
+	CPPUNIT_ASSERT_EQUAL(1, batch->devices().size());
+	CPPUNIT_ASSERT(batch->devices().front()->macAddress() == SUPPORTED);
+	CPPUNIT_ASSERT_EQUAL(3, fake.m_calls.value());
+
+	pool.stop();
+}
+
+void BLESmartExaminationPoolTest::testCacheUnsupported()
+{
+	FakeExamination fake;
+	BLESmartExaminationPool pool;
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	CPPUNIT_ASSERT(pool.examine({UNSUPPORTED})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT(pool.cachedNegative(UNSUPPORTED));
+	CPPUNIT_ASSERT_EQUAL(1, fake.m_calls.value());
+
+	// completed immediately without examination
+	auto batch = pool.examine({UNSUPPORTED});
+	CPPUNIT_ASSERT(batch->wait(0));
+	CPPUNIT_ASSERT(batch->devices().empty());
+	CPPUNIT_ASSERT_EQUAL(1, fake.m_calls.value());
+
+	// supported devices are never cached
+	CPPUNIT_ASSERT(pool.examine({SUPPORTED})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT(!pool.cachedNegative(SUPPORTED));
+	CPPUNIT_ASSERT(pool.examine({SUPPORTED})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT_EQUAL(3, fake.m_calls.value());
+
+	pool.stop();
+}
+
+void BLESmartExaminationPoolTest::testCacheFailures()
+{
+	FakeExamination fake;
+	BLESmartExaminationPool pool;
+	pool.setFailureTTL(0);
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	CPPUNIT_ASSERT(pool.examine({BROKEN})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT(!pool.cachedNegative(BROKEN));
+	CPPUNIT_ASSERT(pool.examine({BROKEN})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT_EQUAL(2, fake.m_calls.value());
+
+	pool.stop();
+
+	pool.setFailureTTL(1 * Timespan::HOURS);
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	CPPUNIT_ASSERT(pool.examine({BROKEN})->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT(pool.cachedNegative(BROKEN));
+	CPPUNIT_ASSERT(pool.examine({BROKEN})->wait(0));
+	CPPUNIT_ASSERT_EQUAL(3, fake.m_calls.value());
+
+	pool.stop();
+}
+
+/**
+ * Examination of a device already pending is not performed again,
+ * all batches waiting for it get the same result.
+ */
+void BLESmartExaminationPoolTest::testDeduplicate()
+{
+	FakeExamination fake(true);
+	BLESmartExaminationPool pool;
+	pool.setWorkers(2);
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	auto first = pool.examine({SUPPORTED});
+	auto second = pool.examine({SUPPORTED, SUPPORTED});
+
+	CPPUNIT_ASSERT(!first->wait(10 * Timespan::MILLISECONDS));
+	fake.m_release.set();
+
+	CPPUNIT_ASSERT(first->wait(5 * Timespan::SECONDS));
+	CPPUNIT_ASSERT(second->wait(5 * Timespan::SECONDS));
+
+	CPPUNIT_ASSERT_EQUAL(1, fake.m_calls.value());
+	CPPUNIT_ASSERT_EQUAL(1, first->devices().size());
+	CPPUNIT_ASSERT_EQUAL(2, second->devices().size());
+	CPPUNIT_ASSERT(first->devices().front() == second->devices().front());
+
+	pool.stop();
+}
+
+/**
+ * Stopping the pool finishes the running examination and completes
+ * batches of the queued ones without any device.
+ */
+void BLESmartExaminationPoolTest::testStopCompletesBatches()
+{
+	FakeExamination fake(true);
+	BLESmartExaminationPool pool;
+	pool.setWorkers(1);
+	pool.start([&](const MACAddress &address) {return fake(address);});
+
+	auto batch = pool.examine({SUPPORTED, UNSUPPORTED});
+
+	while (fake.m_calls.value() == 0)
+		Thread::sleep(1);
+
+	CPPUNIT_ASSERT_EQUAL(1, pool.queued());
+
+	Thread stopper;
+	stopper.startFunc([&]() {pool.stop();});
+
+	fake.m_release.set();
+	stopper.join();
+
+	CPPUNIT_ASSERT(batch->wait(0));
+	CPPUNIT_ASSERT_EQUAL(1, batch->devices().size());
+	CPPUNIT_ASSERT_EQUAL(0, pool.queued());
+}
+
+void BLESmartExaminationPoolTest::testNotRunning()
+{
+	BLESmartExaminationPool pool;
+
+	CPPUNIT_ASSERT_THROW(
+		pool.examine({SUPPORTED}),
+		IllegalStateException);
+}
+
+}
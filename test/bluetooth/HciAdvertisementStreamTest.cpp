@@ -0,0 +1,306 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+#include <Poco/Thread.h>
+
+#include "bluetooth/HciAdvertisementStream.h"
+#include "bluetooth/HciInterface.h"
+#include "bluetooth/HciUtil.h"
+#include "cppunit/BetterAssert.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class HciAdvertisementStreamTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(HciAdvertisementStreamTest);
+	CPPUNIT_TEST(testSubscribeAll);
+	CPPUNIT_TEST(testSubscribeAddress);
+	CPPUNIT_TEST(testUnsubscribe);
+	CPPUNIT_TEST(testSeen);
+	CPPUNIT_TEST(testRestart);
+	CPPUNIT_TEST(testMaxAge);
+	CPPUNIT_TEST(testLEDevicesFromStream);
+	CPPUNIT_TEST(testLEDevicesStationary);
+	CPPUNIT_TEST(testLEDevicesWithoutStream);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testSubscribeAll();
+	void testSubscribeAddress();
+	void testUnsubscribe();
+	void testSeen();
+	void testRestart();
+	void testMaxAge();
+	void testLEDevicesFromStream();
+	void testLEDevicesStationary();
+	void testLEDevicesWithoutStream();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HciAdvertisementStreamTest);
+
+static const MACAddress FIRST(0x010203040506UL);
+static const MACAddress SECOND(0x0a0b0c0d0e0fUL);
+
+class CollectingListener : public HciAdvertisementListener {
+public:
+	typedef SharedPtr<CollectingListener> Ptr;
+
+	void onAdvertisement(const HciAdvertisement &advertisement) override
+	{
+		m_received.emplace_back(advertisement);
+	}
+
+	vector<HciAdvertisement> m_received;
+};
+
+/**
+ * HciInterface that does not touch any hardware. Its lescan()
+ * reports the FIRST device and counts how many times it was called.
+ * Advertisements are simulated via advertise().
+ */
+class MockHciInterface : public HciInterface {
+public:
+	MockHciInterface(bool streaming):
+		m_lescanCalls(0)
+	{
+		if (streaming)
+			m_stream = new HciAdvertisementStream;
+	}
+
+	void up() const override
+	{
+	}
+
+	void reset() const override
+	{
+	}
+
+	bool detect(const MACAddress &) const override
+	{
+		return false;
+	}
+
+	map<MACAddress, string> scan() const override
+	{
+		return {};
+	}
+
+	map<MACAddress, string> lescan(const Timespan &) const override
+	{
+		m_lescanCalls += 1;
+		return {{FIRST, "scanned"}};
+	}
+
+	HciInfo info() const override
+	{
+		throw NotImplementedException(__func__);
+	}
+
+	HciConnection::Ptr connect(const MACAddress &, const Timespan &) const override
+	{
+		throw NotImplementedException(__func__);
+	}
+
+	void watch(const MACAddress &, SharedPtr<WatchCallback>) override
+	{
+		throw NotImplementedException(__func__);
+	}
+
+	void unwatch(const MACAddress &) override
+	{
+	}
+
+	HciAdvertisementStream::Ptr advertisements() const override
+	{
+		return m_stream;
+	}
+
+	void advertise(const MACAddress &address, const string &name)
+	{
+		m_stream->publish({address, name, -60, {0x01, 0x02}, {}});
+	}
+
+	mutable size_t m_lescanCalls;
+
+private:
+	HciAdvertisementStream::Ptr m_stream;
+};
+
+void HciAdvertisementStreamTest::testSubscribeAll()
+{
+	HciAdvertisementStream stream;
+	CollectingListener::Ptr listener = new CollectingListener;
+
+	stream.subscribe(listener);
+	stream.publish({FIRST, "first", -50, {}, {}});
+	stream.publish({SECOND, "second", -70, {0xaa}, {}});
+
+	CPPUNIT_ASSERT_EQUAL(2, listener->m_received.size());
+	CPPUNIT_ASSERT(listener->m_received[0].address == FIRST);
+	CPPUNIT_ASSERT_EQUAL(-50, (int) listener->m_received[0].rssi);
+	CPPUNIT_ASSERT(listener->m_received[1].address == SECOND);
+	CPPUNIT_ASSERT_EQUAL(1, listener->m_received[1].manufacturerData.size());
+}
+
+void HciAdvertisementStreamTest::testSubscribeAddress()
+{
+	HciAdvertisementStream stream;
+	CollectingListener::Ptr first = new CollectingListener;
+	CollectingListener::Ptr second = new CollectingListener;
+
+	stream.subscribe(FIRST, first);
+	stream.subscribe(SECOND, second);
+
+	stream.publish({FIRST, "first", -50, {}, {}});
+	stream.publish({FIRST, "first", -55, {}, {}});
+	stream.publish({SECOND, "second", -70, {}, {}});
+
+	CPPUNIT_ASSERT_EQUAL(2, first->m_received.size());
+	CPPUNIT_ASSERT_EQUAL(-55, (int) first->m_received[1].rssi);
+	CPPUNIT_ASSERT_EQUAL(1, second->m_received.size());
+}
+
+void HciAdvertisementStreamTest::testUnsubscribe()
+{
+	HciAdvertisementStream stream;
+	CollectingListener::Ptr all = new CollectingListener;
+	CollectingListener::Ptr first = new CollectingListener;
+	CollectingListener::Ptr other = new CollectingListener;
+
+	stream.subscribe(all);
+	stream.subscribe(FIRST, all);
+	stream.subscribe(FIRST, first);
+	stream.subscribe(FIRST, other);
+
+	stream.publish({FIRST, "first", -50, {}, {}});
+	CPPUNIT_ASSERT_EQUAL(2, all->m_received.size());
+
+	stream.unsubscribe(all);
+	stream.unsubscribe(FIRST);
+
+	stream.publish({FIRST, "first", -50, {}, {}});
+	CPPUNIT_ASSERT_EQUAL(2, all->m_received.size());
+	CPPUNIT_ASSERT_EQUAL(1, first->m_received.size());
+	CPPUNIT_ASSERT_EQUAL(1, other->m_received.size());
+}
+
+void HciAdvertisementStreamTest::testSeen()
+{
+	HciAdvertisementStream stream;
+
+	Timestamp old;
+	old -= 10 * Timespan::SECONDS;
+
+	stream.publish({FIRST, "first", -50, {}, old});
+	stream.publish({SECOND, "second", -70, {}, {}});
+
+	const auto recent = stream.seen(5 * Timespan::SECONDS);
+	CPPUNIT_ASSERT_EQUAL(1, recent.size());
+	CPPUNIT_ASSERT_EQUAL("second", recent.at(SECOND));
+
+	CPPUNIT_ASSERT_EQUAL(2, stream.seen(1 * Timespan::MINUTES).size());
+
+	HciAdvertisement last;
+	CPPUNIT_ASSERT(stream.last(FIRST, last));
+	CPPUNIT_ASSERT(last.at == old);
+}
+
+void HciAdvertisementStreamTest::testRestart()
+{
+	HciAdvertisementStream stream;
+
+	stream.publish({FIRST, "first", -50, {}, {}});
+	CPPUNIT_ASSERT_EQUAL(1, stream.seen(1 * Timespan::MINUTES).size());
+
+	Thread::sleep(5);
+	CPPUNIT_ASSERT(stream.coverage() >= 5 * Timespan::MILLISECONDS);
+
+	stream.restart();
+	CPPUNIT_ASSERT(stream.coverage() < 5 * Timespan::MILLISECONDS);
+	CPPUNIT_ASSERT(stream.seen(1 * Timespan::MINUTES).empty());
+
+	HciAdvertisement last;
+	CPPUNIT_ASSERT(!stream.last(FIRST, last));
+}
+
+/**
+ * Advertisements older than maxAge are forgotten and the stream
+ * never claims to cover more than maxAge.
+ */
+void HciAdvertisementStreamTest::testMaxAge()
+{
+	HciAdvertisementStream stream(1 * Timespan::MINUTES);
+
+	Timestamp old;
+	old -= 2 * Timespan::MINUTES;
+
+	stream.publish({FIRST, "first", -50, {}, old});
+	stream.publish({SECOND, "second", -70, {}, {}});
+
+	HciAdvertisement last;
+	CPPUNIT_ASSERT(!stream.last(FIRST, last));
+	CPPUNIT_ASSERT(stream.last(SECOND, last));
+	CPPUNIT_ASSERT_EQUAL(1, stream.seen(1 * Timespan::HOURS).size());
+
+	CPPUNIT_ASSERT(stream.coverage() <= 1 * Timespan::MINUTES);
+}
+
+/**
+ * When the stream covers the requested window, the devices are taken
+ * from the stream without scanning. Otherwise, lescan() is used.
+ */
+void HciAdvertisementStreamTest::testLEDevicesFromStream()
+{
+	MockHciInterface hci(true);
+
+	auto devices = HciUtil::leDevices(hci, 1 * Timespan::MINUTES);
+	CPPUNIT_ASSERT_EQUAL(1, hci.m_lescanCalls);
+	CPPUNIT_ASSERT_EQUAL("scanned", devices.at(FIRST));
+
+	Thread::sleep(60);
+	hci.advertise(SECOND, "advertised");
+
+	devices = HciUtil::leDevices(hci, 50 * Timespan::MILLISECONDS);
+	CPPUNIT_ASSERT_EQUAL(1, hci.m_lescanCalls);
+	CPPUNIT_ASSERT_EQUAL(1, devices.size());
+	CPPUNIT_ASSERT_EQUAL("advertised", devices.at(SECOND));
+}
+
+/**
+ * A stationary device does not change its RSSI, thus its last
+ * advertisement can be older than the scan window. It is still
+ * available while it is remembered by the stream. Devices with
+ * unknown RSSI are not available.
+ */
+void HciAdvertisementStreamTest::testLEDevicesStationary()
+{
+	MockHciInterface hci(true);
+
+	Timestamp old;
+	old -= 1 * Timespan::SECONDS;
+
+	hci.advertisements()->publish({FIRST, "stationary", -60, {}, old});
+	hci.advertisements()->publish(
+		{SECOND, "gone", HciAdvertisement::RSSI_UNAVAILABLE, {}, {}});
+
+	Thread::sleep(60);
+
+	const auto devices = HciUtil::leDevices(hci, 50 * Timespan::MILLISECONDS);
+	CPPUNIT_ASSERT_EQUAL(0, hci.m_lescanCalls);
+	CPPUNIT_ASSERT_EQUAL(1, devices.size());
+	CPPUNIT_ASSERT_EQUAL("stationary", devices.at(FIRST));
+}
+
+void HciAdvertisementStreamTest::testLEDevicesWithoutStream()
+{
+	MockHciInterface hci(false);
+
+	CPPUNIT_ASSERT(hci.advertisements().isNull());
+
+	const auto devices = HciUtil::leDevices(hci, 0);
+	CPPUNIT_ASSERT_EQUAL(1, hci.m_lescanCalls);
+	CPPUNIT_ASSERT_EQUAL(1, devices.size());
+}
+
+}
@@ -0,0 +1,107 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+
+#include "bluetooth/HciConnection.h"
+#include "cppunit/BetterAssert.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class HciConnectionTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(HciConnectionTest);
+	CPPUNIT_TEST(testExecuteInOrder);
+	CPPUNIT_TEST(testExecuteFailure);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testExecuteInOrder();
+	void testExecuteFailure();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HciConnectionTest);
+
+static const UUID VALUE("00001111-0000-1000-8000-00805f9b34fb");
+static const UUID MISSING("00002222-0000-1000-8000-00805f9b34fb");
+
+/**
+ * Connection holding a single characteristic VALUE. It records
+ * the performed operations to check their order.
+ */
+class FakeHciConnection : public HciConnection {
+public:
+	vector<unsigned char> read(const UUID& uuid) override
+	{
+		check(uuid);
+		m_operations.emplace_back("read");
+		return m_value;
+	}
+
+	void write(const UUID& uuid, const vector<unsigned char>& value) override
+	{
+		check(uuid);
+		m_operations.emplace_back("write");
+		m_value = value;
+	}
+
+	vector<unsigned char> notifiedWrite(
+		const UUID&,
+		const UUID&,
+		const vector<unsigned char>&,
+		const Timespan&) override
+	{
+		throw NotImplementedException(__func__);
+	}
+
+	void check(const UUID& uuid) const
+	{
+		if (uuid != VALUE)
+			throw NotFoundException("no such GATT characteristic " + uuid.toString());
+	}
+
+	vector<unsigned char> m_value;
+	vector<string> m_operations;
+};
+
+void HciConnectionTest::testExecuteInOrder()
+{
+	FakeHciConnection connection;
+
+	const auto results = connection.execute({
+		HciConnection::Request::write(VALUE, {0x01, 0x02}),
+		HciConnection::Request::read(VALUE),
+		HciConnection::Request::write(VALUE, {0x03}),
+		HciConnection::Request::read(VALUE),
+	});
+
+	CPPUNIT_ASSERT_EQUAL(4, results.size());
+	CPPUNIT_ASSERT(results[0].empty());
+	CPPUNIT_ASSERT(results[1] == vector<unsigned char>({0x01, 0x02}));
+	CPPUNIT_ASSERT(results[2].empty());
+	CPPUNIT_ASSERT(results[3] == vector<unsigned char>({0x03}));
+
+	CPPUNIT_ASSERT_EQUAL(4, connection.m_operations.size());
+	CPPUNIT_ASSERT_EQUAL("write", connection.m_operations[0]);
+	CPPUNIT_ASSERT_EQUAL("read", connection.m_operations[1]);
+
+	CPPUNIT_ASSERT(connection.execute({}).empty());
+}
+
+void HciConnectionTest::testExecuteFailure()
+{
+	FakeHciConnection connection;
+
+	CPPUNIT_ASSERT_THROW(
+		connection.execute({
+			HciConnection::Request::write(VALUE, {0x01}),
+			HciConnection::Request::read(MISSING),
+			HciConnection::Request::write(VALUE, {0x02}),
+		}),
+		NotFoundException);
+
+	CPPUNIT_ASSERT_EQUAL(1, connection.m_operations.size());
+	CPPUNIT_ASSERT(connection.m_value == vector<unsigned char>({0x01}));
+}
+
+}
@@ -0,0 +1,144 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+
+#include "bluetooth/HciRequestPipeline.h"
+#include "cppunit/BetterAssert.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class HciRequestPipelineTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(HciRequestPipelineTest);
+	CPPUNIT_TEST(testNextChain);
+	CPPUNIT_TEST(testFirstPerCharacteristic);
+	CPPUNIT_TEST(testResultsInOrder);
+	CPPUNIT_TEST(testFinishStopsAfterError);
+	CPPUNIT_TEST(testFailStopsChain);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testNextChain();
+	void testFirstPerCharacteristic();
+	void testResultsInOrder();
+	void testFinishStopsAfterError();
+	void testFailStopsChain();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HciRequestPipelineTest);
+
+static const UUID FIRST("00001111-0000-1000-8000-00805f9b34fb");
+static const UUID SECOND("00002222-0000-1000-8000-00805f9b34fb");
+
+typedef HciConnection::Request Request;
+
+/**
+ * Requests to the same characteristic are chained in the given order.
+ * The last request of each chain points to size().
+ */
+void HciRequestPipelineTest::testNextChain()
+{
+	HciRequestPipeline pipeline({
+		Request::write(FIRST, {0x01}),
+		Request::read(SECOND),
+		Request::read(FIRST),
+		Request::read(SECOND),
+		Request::write(FIRST, {0x02}),
+	});
+
+	CPPUNIT_ASSERT_EQUAL(5, pipeline.size());
+	CPPUNIT_ASSERT_EQUAL(2, pipeline.next(0));
+	CPPUNIT_ASSERT_EQUAL(3, pipeline.next(1));
+	CPPUNIT_ASSERT_EQUAL(4, pipeline.next(2));
+	CPPUNIT_ASSERT_EQUAL(5, pipeline.next(3));
+	CPPUNIT_ASSERT_EQUAL(5, pipeline.next(4));
+}
+
+/**
+ * Only the first request to each characteristic is sent immediately.
+ */
+void HciRequestPipelineTest::testFirstPerCharacteristic()
+{
+	HciRequestPipeline pipeline({
+		Request::read(FIRST),
+		Request::read(FIRST),
+		Request::read(SECOND),
+		Request::read(FIRST),
+	});
+
+	const vector<size_t> first = pipeline.first();
+
+	CPPUNIT_ASSERT_EQUAL(2, first.size());
+	CPPUNIT_ASSERT_EQUAL(0, first[0]);
+	CPPUNIT_ASSERT_EQUAL(2, first[1]);
+}
+
+/**
+ * Results are returned in order of requests regardless of the order
+ * they have finished in. Each finish() returns the next request
+ * of the same chain.
+ */
+void HciRequestPipelineTest::testResultsInOrder()
+{
+	HciRequestPipeline pipeline({
+		Request::read(FIRST),
+		Request::read(SECOND),
+		Request::read(FIRST),
+	});
+
+	CPPUNIT_ASSERT(!pipeline.wait(1));
+
+	CPPUNIT_ASSERT_EQUAL(3, pipeline.finish(1, {0x0b}, ""));
+	CPPUNIT_ASSERT_EQUAL(2, pipeline.finish(0, {0x0a}, ""));
+	CPPUNIT_ASSERT(!pipeline.wait(1));
+	CPPUNIT_ASSERT_EQUAL(3, pipeline.finish(2, {0x0c}, ""));
+
+	CPPUNIT_ASSERT(pipeline.wait(1));
+
+	const auto results = pipeline.results();
+	CPPUNIT_ASSERT_EQUAL(3, results.size());
+	CPPUNIT_ASSERT(results[0] == vector<unsigned char>({0x0a}));
+	CPPUNIT_ASSERT(results[1] == vector<unsigned char>({0x0b}));
+	CPPUNIT_ASSERT(results[2] == vector<unsigned char>({0x0c}));
+}
+
+/**
+ * The first error finishes the pipeline immediately and no other
+ * request is to be sent even when a pending one succeeds.
+ */
+void HciRequestPipelineTest::testFinishStopsAfterError()
+{
+	HciRequestPipeline pipeline({
+		Request::read(FIRST),
+		Request::read(SECOND),
+		Request::read(FIRST),
+		Request::read(SECOND),
+	});
+
+	CPPUNIT_ASSERT_EQUAL(4, pipeline.finish(0, {}, "read failed"));
+	CPPUNIT_ASSERT(pipeline.wait(1));
+
+	CPPUNIT_ASSERT_EQUAL(4, pipeline.finish(1, {0x0b}, ""));
+	CPPUNIT_ASSERT_THROW(pipeline.results(), IOException);
+}
+
+/**
+ * Failing the pipeline (e.g. on timeout) stops sending of the rest
+ * of requests.
+ */
+void HciRequestPipelineTest::testFailStopsChain()
+{
+	HciRequestPipeline pipeline({
+		Request::read(FIRST),
+		Request::read(FIRST),
+	});
+
+	pipeline.fail("timeout");
+	CPPUNIT_ASSERT(pipeline.wait(1));
+
+	CPPUNIT_ASSERT_EQUAL(2, pipeline.finish(0, {0x0a}, ""));
+	CPPUNIT_ASSERT_THROW(pipeline.results(), IOException);
+}
+
+}
@@ -1,6 +1,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <Poco/Event.h>
+#include <Poco/Mutex.h>
 #include <Poco/Thread.h>
 
 #include "commands/ServerDeviceListCommand.h"
@@ -19,6 +20,7 @@ class DeviceStatusFetcherTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testSingleHandler);
 	CPPUNIT_TEST(testMultipleHandlers);
 	CPPUNIT_TEST(testNoDevicesForHandlers);
+	CPPUNIT_TEST(testIncrementalRefresh);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void setUp();
@@ -26,6 +28,7 @@ public:
 	void testSingleHandler();
 	void testMultipleHandlers();
 	void testNoDevicesForHandlers();
+	void testIncrementalRefresh();
 
 private:
 	DeviceStatusFetcher::Ptr m_fetcher;
@@ -78,14 +81,28 @@ protected:
 		ServerDeviceListCommand::Ptr request = cmd.cast<ServerDeviceListCommand>();
 
 		answer->setHandlersCount(1);
+
+		FastMutex::ScopedLock guard(lock);
 		const auto devices = this->devices;
+		const auto version = this->version;
+
+		knownVersions.emplace_back(request->knownVersion());
 
-		m_thread.startFunc([request, answer, devices]() mutable
+		m_thread.startFunc([request, answer, devices, version]() mutable
 		{
 			ServerDeviceListResult::Ptr result =
 				new ServerDeviceListResult(answer);
 			vector<DeviceID> list;
 
+			result->setVersion(version);
+
+			if (!version.empty() && request->knownVersion() == version) {
+				result->setUnchanged(true);
+				result->setStatus(Result::Status::SUCCESS);
+				answer->addResult(result);
+				return;
+			}
+
 			for (const auto &id : devices) {
 				if (id.prefix() != request->devicePrefix())
 					continue;
@@ -102,7 +119,10 @@ protected:
 	}
 
 public:
+	FastMutex lock;
 	set<DeviceID> devices;
+	string version;
+	vector<string> knownVersions;
 	Thread m_thread;
 };
 
@@ -248,4 +268,67 @@ void DeviceStatusFetcherTest::testNoDevicesForHandlers()
 	CPPUNIT_ASSERT_NO_THROW(thread.join(10000));
 }
 
+/**
+ * @brief Test that the paired devices are re-fetched periodically
+ * in the incremental mode. The known version is sent to the server
+ * and unchanged lists are not delivered to the handlers again.
+ */
+void DeviceStatusFetcherTest::testIncrementalRefresh()
+{
+	Thread thread;
+	TestingDeviceStatusHandler::Ptr handler =
+		new TestingDeviceStatusHandler(DevicePrefix::PREFIX_VIRTUAL_DEVICE);
+	TestingCommandDispatcherForFetcher::Ptr dispatcher =
+		new TestingCommandDispatcherForFetcher;
+
+	m_fetcher->setRefreshPeriod(50 * Timespan::MILLISECONDS);
+	m_fetcher->setIncremental(true);
+	m_fetcher->registerHandler(handler);
+	m_fetcher->setCommandDispatcher(dispatcher);
+
+	dispatcher->version = "1";
+	dispatcher->devices = {
+		0xa300000000000001,
+		0xa300000000000002,
+	};
+
+	thread.start(*m_fetcher);
+
+	CPPUNIT_ASSERT(handler->handled.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL(2, handler->handledPaired.size());
+
+	for (int i = 0; i < 100; ++i) {
+		const auto stats = m_fetcher->syncStats();
+		if (stats.at(DevicePrefix::PREFIX_VIRTUAL_DEVICE).unchanged >= 2)
+			break;
+
+		Thread::sleep(50);
+	}
+
+	const auto unchanged = m_fetcher->syncStats().at(DevicePrefix::PREFIX_VIRTUAL_DEVICE);
+	CPPUNIT_ASSERT(unchanged.unchanged >= 2);
+	CPPUNIT_ASSERT_EQUAL(1, unchanged.delivered);
+	CPPUNIT_ASSERT_EQUAL(0, unchanged.lastDevices);
+	CPPUNIT_ASSERT(!handler->handled.tryWait(0));
+
+	{
+		FastMutex::ScopedLock guard(dispatcher->lock);
+
+		CPPUNIT_ASSERT(dispatcher->knownVersions.at(0).empty());
+		CPPUNIT_ASSERT_EQUAL("1", dispatcher->knownVersions.at(1));
+
+		dispatcher->version = "2";
+		dispatcher->devices.emplace(0xa300000000000003);
+	}
+
+	CPPUNIT_ASSERT(handler->handled.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL(3, handler->handledPaired.size());
+
+	m_fetcher->stop();
+	CPPUNIT_ASSERT_NO_THROW(thread.join(10000));
+
+	const auto changed = m_fetcher->syncStats().at(DevicePrefix::PREFIX_VIRTUAL_DEVICE);
+	CPPUNIT_ASSERT_EQUAL(2, changed.delivered);
+}
+
 }
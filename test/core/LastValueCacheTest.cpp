@@ -0,0 +1,236 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Timestamp.h>
+
+#include "cppunit/BetterAssert.h"
+#include "cppunit/FileTestFixture.h"
+
+#include "commands/ServerDeviceListCommand.h"
+#include "commands/ServerLastValueCommand.h"
+#include "commands/ServerLastValueResult.h"
+#include "core/AnswerQueue.h"
+#include "core/LastValueCache.h"
+#include "model/SensorData.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class LastValueCacheTest : public FileTestFixture {
+	CPPUNIT_TEST_SUITE(LastValueCacheTest);
+	CPPUNIT_TEST(testAnswerLocally);
+	CPPUNIT_TEST(testFallbackOnMiss);
+	CPPUNIT_TEST(testFallbackOnStale);
+	CPPUNIT_TEST(testFailWithoutFallback);
+	CPPUNIT_TEST(testForwardOtherCommands);
+	CPPUNIT_TEST(testSaveAndLoad);
+	CPPUNIT_TEST(testLoadSkipsInvalid);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testAnswerLocally();
+	void testFallbackOnMiss();
+	void testFallbackOnStale();
+	void testFailWithoutFallback();
+	void testForwardOtherCommands();
+	void testSaveAndLoad();
+	void testLoadSkipsInvalid();
+
+private:
+	AnswerQueue m_queue;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LastValueCacheTest);
+
+static const DeviceID DEVICE(0xa300000000000001UL);
+
+/**
+ * Handler simulating the remote server. It answers every
+ * ServerLastValueCommand with value 42.
+ */
+class FakeServerHandler : public CommandHandler {
+public:
+	FakeServerHandler():
+		m_handled(0)
+	{
+	}
+
+	bool accept(const Command::Ptr cmd) override
+	{
+		return cmd->is<ServerLastValueCommand>()
+			|| cmd->is<ServerDeviceListCommand>();
+	}
+
+	void handle(Command::Ptr cmd, Answer::Ptr answer) override
+	{
+		m_handled += 1;
+
+		if (cmd->is<ServerLastValueCommand>()) {
+			ServerLastValueResult::Ptr result = new ServerLastValueResult(answer);
+			result->setValue(42);
+			result->setStatus(Result::Status::SUCCESS);
+		}
+		else {
+			Result::Ptr result = new Result(answer);
+			result->setStatus(Result::Status::SUCCESS);
+		}
+	}
+
+	size_t m_handled;
+};
+
+static double lastValue(Answer::Ptr answer)
+{
+	CPPUNIT_ASSERT_EQUAL(1, answer->resultsCount());
+
+	ServerLastValueResult::Ptr result = answer->at(0).cast<ServerLastValueResult>();
+	CPPUNIT_ASSERT(!result.isNull());
+	CPPUNIT_ASSERT_EQUAL(Result::Status::SUCCESS, result->status().raw());
+
+	return result->value();
+}
+
+void LastValueCacheTest::testAnswerLocally()
+{
+	SharedPtr<FakeServerHandler> server = new FakeServerHandler;
+	LastValueCache cache;
+	cache.setFallback(server);
+	cache.load();
+
+	cache.onExport(SensorData(DEVICE, Timestamp(), {{0, 20.5}, {1, 60}}));
+	CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+	Command::Ptr cmd = new ServerLastValueCommand(DEVICE, 1);
+	CPPUNIT_ASSERT(cache.accept(cmd));
+
+	Answer::Ptr answer = new Answer(m_queue);
+	cache.handle(cmd, answer);
+
+	CPPUNIT_ASSERT_EQUAL(60.0, lastValue(answer));
+	CPPUNIT_ASSERT_EQUAL(0, server->m_handled);
+	CPPUNIT_ASSERT_EQUAL(1, cache.hits());
+}
+
+void LastValueCacheTest::testFallbackOnMiss()
+{
+	SharedPtr<FakeServerHandler> server = new FakeServerHandler;
+	LastValueCache cache;
+	cache.setFallback(server);
+	cache.load();
+
+	cache.onExport(SensorData(DEVICE, Timestamp(), {{0, 20.5}}));
+
+	Answer::Ptr answer = new Answer(m_queue);
+	cache.handle(new ServerLastValueCommand(DEVICE, 3), answer);
+
+	CPPUNIT_ASSERT_EQUAL(42.0, lastValue(answer));
+	CPPUNIT_ASSERT_EQUAL(1, server->m_handled);
+	CPPUNIT_ASSERT_EQUAL(1, cache.misses());
+}
+
+void LastValueCacheTest::testFallbackOnStale()
+{
+	SharedPtr<FakeServerHandler> server = new FakeServerHandler;
+	LastValueCache cache;
+	cache.setFallback(server);
+	cache.setMaxAge(1 * Timespan::HOURS);
+	cache.load();
+
+	Timestamp old;
+	old -= 2 * Timespan::HOURS;
+
+	cache.onExport(SensorData(DEVICE, old, {{0, 20.5}}));
+
+	Answer::Ptr answer = new Answer(m_queue);
+	cache.handle(new ServerLastValueCommand(DEVICE, 0), answer);
+
+	CPPUNIT_ASSERT_EQUAL(42.0, lastValue(answer));
+	CPPUNIT_ASSERT_EQUAL(1, server->m_handled);
+	CPPUNIT_ASSERT_EQUAL(1, cache.stale());
+}
+
+void LastValueCacheTest::testFailWithoutFallback()
+{
+	LastValueCache cache;
+	cache.load();
+
+	Command::Ptr cmd = new ServerLastValueCommand(DEVICE, 0);
+	CPPUNIT_ASSERT(cache.accept(cmd));
+
+	Answer::Ptr answer = new Answer(m_queue);
+	cache.handle(cmd, answer);
+
+	CPPUNIT_ASSERT_EQUAL(1, answer->resultsCount());
+	CPPUNIT_ASSERT_EQUAL(Result::Status::FAILED, answer->at(0)->status().raw());
+}
+
+/**
+ * Commands other than ServerLastValueCommand are accepted only when
+ * there is a fallback handler and they are handled by it.
+ */
+void LastValueCacheTest::testForwardOtherCommands()
+{
+	SharedPtr<FakeServerHandler> server = new FakeServerHandler;
+	LastValueCache cache;
+
+	Command::Ptr cmd = new ServerDeviceListCommand(DevicePrefix::PREFIX_VIRTUAL_DEVICE);
+	CPPUNIT_ASSERT(!cache.accept(cmd));
+
+	cache.setFallback(server);
+	CPPUNIT_ASSERT(cache.accept(cmd));
+
+	Answer::Ptr answer = new Answer(m_queue);
+	cache.handle(cmd, answer);
+	CPPUNIT_ASSERT_EQUAL(1, server->m_handled);
+}
+
+void LastValueCacheTest::testSaveAndLoad()
+{
+	const Timestamp at = Timestamp::fromEpochTime(1500000000);
+
+	{
+		LastValueCache cache;
+		cache.setFile(testingPath().toString());
+		cache.setSaveDelay(-1);
+		cache.load();
+
+		cache.onExport(SensorData(DEVICE, at, {{0, 20.5}, {2, -3.25}}));
+		cache.save();
+	}
+
+	LastValueCache cache;
+	cache.setFile(testingPath().toString());
+	cache.load();
+
+	CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+	double value;
+	Timestamp when;
+
+	CPPUNIT_ASSERT(cache.lookup(DEVICE, 0, value, when));
+	CPPUNIT_ASSERT_EQUAL(20.5, value);
+	CPPUNIT_ASSERT(at == when);
+
+	CPPUNIT_ASSERT(!cache.lookup(DEVICE, 1, value, when));
+
+	CPPUNIT_ASSERT(cache.lookup(DEVICE, 2, value, when));
+	CPPUNIT_ASSERT_EQUAL(-3.25, value);
+}
+
+void LastValueCacheTest::testLoadSkipsInvalid()
+{
+	writeFile(testingFile(),
+		"0xa300000000000001 0 20.5 1500000000000000\n"
+		"garbage\n"
+		"0xa300000000000001 x 1 1500000000000000\n"
+		"\n"
+		"0xa300000000000001 1 7 1500000000000000\n");
+
+	LastValueCache cache;
+	cache.setFile(testingPath().toString());
+	cache.load();
+
+	CPPUNIT_ASSERT_EQUAL(2, cache.size());
+}
+
+}
@@ -0,0 +1,223 @@
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Event.h>
+#include <Poco/Exception.h>
+#include <Poco/Mutex.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "core/PrefixPollExecutor.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class PrefixPollExecutorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(PrefixPollExecutorTest);
+	CPPUNIT_TEST(testInvalidLaneLimits);
+	CPPUNIT_TEST(testSlowLaneDoesNotBlockOthers);
+	CPPUNIT_TEST(testLaneLimits);
+	CPPUNIT_TEST(testRoundRobinBetweenLanes);
+	CPPUNIT_TEST(testDeadlineMiss);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void tearDown() override;
+
+	void testInvalidLaneLimits();
+	void testSlowLaneDoesNotBlockOthers();
+	void testLaneLimits();
+	void testRoundRobinBetweenLanes();
+	void testDeadlineMiss();
+
+protected:
+	void start();
+
+private:
+	PrefixPollExecutor m_executor;
+	Thread m_thread;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PrefixPollExecutorTest);
+
+static const DeviceID HUE_DEVICE(DevicePrefix::PREFIX_PHILIPS_HUE, 1);
+static const DeviceID HUE_DEVICE2(DevicePrefix::PREFIX_PHILIPS_HUE, 2);
+static const DeviceID VPT_DEVICE(DevicePrefix::PREFIX_VPT, 1);
+
+void PrefixPollExecutorTest::setUp()
+{
+	m_executor.setWorkers(4);
+	m_executor.setLaneLimit(1);
+}
+
+void PrefixPollExecutorTest::tearDown()
+{
+	if (m_thread.isRunning()) {
+		m_executor.stop();
+		m_thread.join();
+	}
+}
+
+void PrefixPollExecutorTest::start()
+{
+	m_thread.start(m_executor);
+}
+
+void PrefixPollExecutorTest::testInvalidLaneLimits()
+{
+	CPPUNIT_ASSERT_THROW(
+		m_executor.setLaneLimits({"philips_hue"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		m_executor.setLaneLimits({"philips_hue:0"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		m_executor.setLaneLimits({"unknown:2"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_NO_THROW(
+		m_executor.setLaneLimits({"philips_hue:2", "default:3"}));
+}
+
+/**
+ * A poll blocked in the philips_hue lane must not delay the poll
+ * in the vpt lane. The second poll of the philips_hue lane waits
+ * until the first one finishes.
+ */
+void PrefixPollExecutorTest::testSlowLaneDoesNotBlockOthers()
+{
+	Event release;
+	Event hueStarted;
+	Event hue2Done;
+	Event vptDone;
+
+	start();
+
+	m_executor.invoke(HUE_DEVICE, 0, [&]() {
+		hueStarted.set();
+		release.wait();
+	});
+	m_executor.invoke(HUE_DEVICE2, 0, [&]() {
+		hue2Done.set();
+	});
+	m_executor.invoke(VPT_DEVICE, 0, [&]() {
+		vptDone.set();
+	});
+
+	CPPUNIT_ASSERT(hueStarted.tryWait(5000));
+	CPPUNIT_ASSERT(vptDone.tryWait(5000));
+	CPPUNIT_ASSERT(!hue2Done.tryWait(100));
+
+	const auto blocked = m_executor.stats();
+	CPPUNIT_ASSERT_EQUAL(1, blocked.at("philips_hue").running);
+	CPPUNIT_ASSERT_EQUAL(1, blocked.at("philips_hue").queued);
+	CPPUNIT_ASSERT_EQUAL(1, blocked.at("vpt").executed);
+
+	release.set();
+	CPPUNIT_ASSERT(hue2Done.tryWait(5000));
+}
+
+/**
+ * Lane with a higher limit executes more polls concurrently.
+ */
+void PrefixPollExecutorTest::testLaneLimits()
+{
+	m_executor.setLaneLimits({"philips_hue:2"});
+
+	Event release;
+	Event firstStarted;
+	Event secondStarted;
+
+	start();
+
+	m_executor.invoke(HUE_DEVICE, 0, [&]() {
+		firstStarted.set();
+		release.wait();
+	});
+	m_executor.invoke(HUE_DEVICE2, 0, [&]() {
+		secondStarted.set();
+		release.wait();
+	});
+
+	CPPUNIT_ASSERT(firstStarted.tryWait(5000));
+	CPPUNIT_ASSERT(secondStarted.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL(2, m_executor.stats().at("philips_hue").running);
+
+	release.set();
+}
+
+/**
+ * A single worker must alternate between lanes instead of draining
+ * the lane that was filled first.
+ */
+void PrefixPollExecutorTest::testRoundRobinBetweenLanes()
+{
+	m_executor.setWorkers(1);
+
+	FastMutex lock;
+	vector<string> order;
+	Event done;
+
+	for (int i = 0; i < 3; ++i) {
+		m_executor.invoke(HUE_DEVICE, 0, [&]() {
+			FastMutex::ScopedLock guard(lock);
+			order.emplace_back("philips_hue");
+		});
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		m_executor.invoke(VPT_DEVICE, 0, [&]() {
+			FastMutex::ScopedLock guard(lock);
+			order.emplace_back("vpt");
+
+			if (order.size() == 6)
+				done.set();
+		});
+	}
+
+	start();
+	CPPUNIT_ASSERT(done.tryWait(5000));
+
+	FastMutex::ScopedLock guard(lock);
+	CPPUNIT_ASSERT_EQUAL(6, order.size());
+
+	for (size_t i = 1; i < order.size(); ++i)
+		CPPUNIT_ASSERT(order[i - 1] != order[i]);
+}
+
+/**
+ * Polls exceeding their budget are counted as deadline misses
+ * of their lane. Polls without budget never miss.
+ */
+void PrefixPollExecutorTest::testDeadlineMiss()
+{
+	Event done;
+
+	start();
+
+	m_executor.invoke(VPT_DEVICE, 1 * Timespan::MILLISECONDS, []() {
+		Thread::sleep(20);
+	});
+	m_executor.invoke(HUE_DEVICE, 0, []() {
+		Thread::sleep(20);
+	});
+	m_executor.invoke(VPT_DEVICE, 5 * Timespan::SECONDS, [&]() {
+		done.set();
+	});
+
+	CPPUNIT_ASSERT(done.tryWait(5000));
+	Thread::sleep(50);
+
+	const auto stats = m_executor.stats();
+	CPPUNIT_ASSERT_EQUAL(2, stats.at("vpt").executed);
+	CPPUNIT_ASSERT_EQUAL(1, stats.at("vpt").deadlineMisses);
+	CPPUNIT_ASSERT(stats.at("vpt").maxLateness >= 15 * Timespan::MILLISECONDS);
+	CPPUNIT_ASSERT_EQUAL(0, stats.at("philips_hue").deadlineMisses);
+}
+
+}
@@ -0,0 +1,374 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+#include <Poco/Path.h>
+#include <Poco/Timestamp.h>
+
+#include "cppunit/BetterAssert.h"
+#include "cppunit/FileTestFixture.h"
+#include "core/SensorDataFilter.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class SensorDataFilterTest : public FileTestFixture {
+	CPPUNIT_TEST_SUITE(SensorDataFilterTest);
+	CPPUNIT_TEST(testInvalidRule);
+	CPPUNIT_TEST(testNoRulesPassThrough);
+	CPPUNIT_TEST(testDeadband);
+	CPPUNIT_TEST(testMinInterval);
+	CPPUNIT_TEST(testHeartbeat);
+	CPPUNIT_TEST(testValidityChange);
+	CPPUNIT_TEST(testPartialDrop);
+	CPPUNIT_TEST(testDefaultRule);
+	CPPUNIT_TEST(testDefaultRuleForKnownTypes);
+	CPPUNIT_TEST(testDiscreteChange);
+	CPPUNIT_TEST(testUnknownTypeChange);
+	CPPUNIT_TEST(testTypesPersisted);
+	CPPUNIT_TEST(testMaxDevices);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+
+	void testInvalidRule();
+	void testNoRulesPassThrough();
+	void testDeadband();
+	void testMinInterval();
+	void testHeartbeat();
+	void testValidityChange();
+	void testPartialDrop();
+	void testDefaultRule();
+	void testDefaultRuleForKnownTypes();
+	void testDiscreteChange();
+	void testUnknownTypeChange();
+	void testTypesPersisted();
+	void testMaxDevices();
+
+protected:
+	SensorDataFilterRule::Ptr createRule(
+		const string &type,
+		double deadband,
+		const Timespan &minInterval = 0,
+		const Timespan &heartbeat = 0);
+
+	SensorData data(
+		const Timespan &offset,
+		const vector<SensorValue> &values,
+		const DeviceID &id = DEVICE) const;
+
+	static const DeviceID DEVICE;
+
+private:
+	Timestamp m_start;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SensorDataFilterTest);
+
+const DeviceID SensorDataFilterTest::DEVICE(0xa300000000000001UL);
+
+void SensorDataFilterTest::setUp()
+{
+	setUpAsDirectory();
+	m_start = Timestamp::fromEpochTime(1500000000);
+}
+
+SensorDataFilterRule::Ptr SensorDataFilterTest::createRule(
+		const string &type,
+		double deadband,
+		const Timespan &minInterval,
+		const Timespan &heartbeat)
+{
+	SensorDataFilterRule::Ptr rule = new SensorDataFilterRule;
+	rule->setType(type);
+	rule->setDeadband(deadband);
+	rule->setMinInterval(minInterval);
+	rule->setHeartbeat(heartbeat);
+
+	return rule;
+}
+
+SensorData SensorDataFilterTest::data(
+		const Timespan &offset,
+		const vector<SensorValue> &values,
+		const DeviceID &id) const
+{
+	return SensorData(id, m_start + offset.totalMicroseconds(), values);
+}
+
+void SensorDataFilterTest::testInvalidRule()
+{
+	SensorDataFilterRule rule;
+
+	CPPUNIT_ASSERT_THROW(
+		rule.setType("unknown"),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		rule.setDeadband(-1),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		rule.setMinInterval(-1),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		rule.setHeartbeat(-1),
+		InvalidArgumentException);
+}
+
+void SensorDataFilterTest::testNoRulesPassThrough()
+{
+	SensorDataFilter filter;
+	SensorData filtered;
+
+	const SensorData first = data(0, {{0, 20.0}});
+	CPPUNIT_ASSERT(filter.apply(first, filtered));
+	CPPUNIT_ASSERT(first == filtered);
+
+	const SensorData second = data(1 * Timespan::SECONDS, {{0, 20.0}});
+	CPPUNIT_ASSERT(filter.apply(second, filtered));
+	CPPUNIT_ASSERT(second == filtered);
+}
+
+/**
+ * Values within the deadband of the last exported value are dropped.
+ * The deadband is measured against the last exported value, not against
+ * the last seen one, so a slow drift is eventually exported.
+ */
+void SensorDataFilterTest::testDeadband()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("temperature", 0.5));
+	filter.registerDevice(DEVICE, {ModuleType(ModuleType::Type::TYPE_TEMPERATURE)});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(1 * Timespan::SECONDS, {{0, 20.3}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(2 * Timespan::SECONDS, {{0, 19.6}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(3 * Timespan::SECONDS, {{0, 20.5}}), filtered));
+	CPPUNIT_ASSERT_EQUAL(20.5, filtered[0].value());
+
+	CPPUNIT_ASSERT_EQUAL(2, filter.passed());
+	CPPUNIT_ASSERT_EQUAL(2, filter.dropped());
+}
+
+/**
+ * Values coming sooner than minInterval after the last exported
+ * value are dropped even if they differ significantly.
+ */
+void SensorDataFilterTest::testMinInterval()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("temperature", 0, 10 * Timespan::SECONDS));
+	filter.registerDevice(DEVICE, {ModuleType(ModuleType::Type::TYPE_TEMPERATURE)});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(5 * Timespan::SECONDS, {{0, 30.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(10 * Timespan::SECONDS, {{0, 30.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(19 * Timespan::SECONDS, {{0, 40.0}}), filtered));
+}
+
+/**
+ * An unchanged value is exported again after the heartbeat elapses.
+ */
+void SensorDataFilterTest::testHeartbeat()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("temperature", 1, 0, 60 * Timespan::SECONDS));
+	filter.registerDevice(DEVICE, {ModuleType(ModuleType::Type::TYPE_TEMPERATURE)});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(30 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(59 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(60 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(90 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+}
+
+/**
+ * A value becoming invalid (or valid again) is always exported.
+ */
+void SensorDataFilterTest::testValidityChange()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("temperature", 1));
+	filter.registerDevice(DEVICE, {ModuleType(ModuleType::Type::TYPE_TEMPERATURE)});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(1 * Timespan::SECONDS, {SensorValue(0)}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(2 * Timespan::SECONDS, {SensorValue(0)}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(3 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+}
+
+/**
+ * Only the values within their deadband are removed, the rest
+ * of the data is exported with the original timestamp. Values
+ * of types without any rule are never dropped when there is no
+ * default rule.
+ */
+void SensorDataFilterTest::testPartialDrop()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("temperature", 0.5));
+	filter.addRule(createRule("humidity", 2));
+	filter.registerDevice(DEVICE, {
+		ModuleType(ModuleType::Type::TYPE_TEMPERATURE),
+		ModuleType(ModuleType::Type::TYPE_HUMIDITY),
+		ModuleType(ModuleType::Type::TYPE_BATTERY),
+	});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}, {1, 50.0}, {2, 90.0}}), filtered));
+	CPPUNIT_ASSERT_EQUAL(3, filtered.size());
+
+	const SensorData second = data(
+		10 * Timespan::SECONDS, {{0, 20.1}, {1, 55.0}, {2, 90.0}});
+
+	CPPUNIT_ASSERT(filter.apply(second, filtered));
+	CPPUNIT_ASSERT_EQUAL(2, filtered.size());
+	CPPUNIT_ASSERT(second.deviceID() == filtered.deviceID());
+	CPPUNIT_ASSERT(second.timestamp().value() == filtered.timestamp().value());
+	CPPUNIT_ASSERT_EQUAL(1, filtered[0].moduleID().value());
+	CPPUNIT_ASSERT_EQUAL(55.0, filtered[0].value());
+	CPPUNIT_ASSERT_EQUAL(2, filtered[1].moduleID().value());
+}
+
+/**
+ * Devices with unknown module types are subject of the default rule.
+ * Once the types are known, the type-specific rules are applied.
+ */
+void SensorDataFilterTest::testDefaultRule()
+{
+	const DeviceID other(0xa300000000000002UL);
+
+	SensorDataFilter filter;
+	filter.addRule(createRule("default", 5));
+	filter.addRule(createRule("temperature", 0.5));
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}, other), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(1 * Timespan::SECONDS, {{0, 21.0}}, other), filtered));
+
+	filter.registerDevice(other, {ModuleType(ModuleType::Type::TYPE_TEMPERATURE)});
+
+	CPPUNIT_ASSERT(filter.apply(data(2 * Timespan::SECONDS, {{0, 21.0}}, other), filtered));
+}
+
+/**
+ * Values of known types without a specific rule are subject
+ * of the default rule as well.
+ */
+void SensorDataFilterTest::testDefaultRuleForKnownTypes()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("default", 5));
+	filter.addRule(createRule("temperature", 0.5));
+	filter.registerDevice(DEVICE, {
+		ModuleType(ModuleType::Type::TYPE_TEMPERATURE),
+		ModuleType(ModuleType::Type::TYPE_BATTERY),
+	});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}, {1, 90.0}}), filtered));
+
+	CPPUNIT_ASSERT(filter.apply(data(1 * Timespan::SECONDS, {{0, 21.0}, {1, 88.0}}), filtered));
+	CPPUNIT_ASSERT_EQUAL(1, filtered.size());
+	CPPUNIT_ASSERT_EQUAL(0, filtered[0].moduleID().value());
+}
+
+/**
+ * A changed value of a discrete type is never dropped, neither because
+ * of the minInterval nor because of the deadband. An unchanged one is.
+ */
+void SensorDataFilterTest::testDiscreteChange()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("default", 5, 10 * Timespan::SECONDS));
+	filter.registerDevice(DEVICE, {ModuleType(ModuleType::Type::TYPE_ON_OFF)});
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 0.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(1 * Timespan::SECONDS, {{0, 1.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(2 * Timespan::SECONDS, {{0, 1.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(3 * Timespan::SECONDS, {{0, 0.0}}), filtered));
+}
+
+/**
+ * A changed value of an unknown type is not dropped because
+ * of the minInterval, an unchanged one is.
+ */
+void SensorDataFilterTest::testUnknownTypeChange()
+{
+	SensorDataFilter filter;
+	filter.addRule(createRule("default", 0, 10 * Timespan::SECONDS));
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 0.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(1 * Timespan::SECONDS, {{0, 1.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(2 * Timespan::SECONDS, {{0, 1.0}}), filtered));
+}
+
+/**
+ * The learnt module types are known to another instance
+ * loading the same file (e.g. after restart).
+ */
+void SensorDataFilterTest::testTypesPersisted()
+{
+	const string file = Path(testingPath(), "types").toString();
+
+	SensorDataFilter learning;
+	learning.setTypesFile(file);
+	learning.load();
+	learning.registerDevice(DEVICE, {
+		ModuleType(ModuleType::Type::TYPE_HUMIDITY),
+		ModuleType(ModuleType::Type::TYPE_TEMPERATURE),
+	});
+
+	SensorDataFilter filter;
+	filter.setTypesFile(file);
+	filter.addRule(createRule("temperature", 0.5));
+	filter.load();
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 50.0}, {1, 20.0}}), filtered));
+
+	CPPUNIT_ASSERT(filter.apply(data(1 * Timespan::SECONDS, {{0, 50.1}, {1, 20.1}}), filtered));
+	CPPUNIT_ASSERT_EQUAL(1, filtered.size());
+	CPPUNIT_ASSERT_EQUAL(0, filtered[0].moduleID().value());
+}
+
+/**
+ * When too many devices are tracked, some are forgotten and their
+ * next values are exported.
+ */
+void SensorDataFilterTest::testMaxDevices()
+{
+	const DeviceID other(0xa300000000000002UL);
+
+	SensorDataFilter filter;
+	filter.setMaxDevices(1);
+	filter.addRule(createRule("default", 5));
+
+	SensorData filtered;
+
+	CPPUNIT_ASSERT(filter.apply(data(0, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(!filter.apply(data(1 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(2 * Timespan::SECONDS, {{0, 20.0}}, other), filtered));
+	CPPUNIT_ASSERT(filter.apply(data(3 * Timespan::SECONDS, {{0, 20.0}}), filtered));
+}
+
+}
@@ -0,0 +1,203 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/Util/MapConfiguration.h>
+
+#include "cppunit/BetterAssert.h"
+#include "cppunit/FileTestFixture.h"
+#include "credentials/FileCredentialsStorage.h"
+#include "credentials/PasswordCredentials.h"
+#include "credentials/PinCredentials.h"
+
+using namespace std;
+using namespace Poco;
+using namespace Poco::Util;
+
+namespace BeeeOn {
+
+class FileCredentialsStorageTest : public FileTestFixture {
+	CPPUNIT_TEST_SUITE(FileCredentialsStorageTest);
+	CPPUNIT_TEST(testJournalChanges);
+	CPPUNIT_TEST(testCompaction);
+	CPPUNIT_TEST(testReplayOverSnapshot);
+	CPPUNIT_TEST(testCompactOversizedJournal);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void testJournalChanges();
+	void testCompaction();
+	void testReplayOverSnapshot();
+	void testCompactOversizedJournal();
+
+protected:
+	Path snapshotPath() const;
+	Path journalPath() const;
+	void setupStorage(FileCredentialsStorage &storage) const;
+	string saved(SharedPtr<Credentials> credentials, const string &key) const;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FileCredentialsStorageTest);
+
+static const DeviceID FIRST(0xa300000000000001UL);
+static const DeviceID SECOND(0xa300000000000002UL);
+
+void FileCredentialsStorageTest::setUp()
+{
+	setUpAsDirectory();
+}
+
+Path FileCredentialsStorageTest::snapshotPath() const
+{
+	return Path(testingPath(), "credentials.properties");
+}
+
+Path FileCredentialsStorageTest::journalPath() const
+{
+	return Path(testingPath(), "credentials.properties.journal");
+}
+
+void FileCredentialsStorageTest::setupStorage(FileCredentialsStorage &storage) const
+{
+	storage.setFile(snapshotPath().toString());
+	storage.setSaveDelay(-1);
+	storage.load();
+}
+
+string FileCredentialsStorageTest::saved(
+		SharedPtr<Credentials> credentials,
+		const string &key) const
+{
+	AutoPtr<AbstractConfiguration> conf = new MapConfiguration;
+	credentials->save(conf, FIRST, "test");
+	return conf->getString("test." + FIRST.toString() + "." + key);
+}
+
+/**
+ * Each change is appended into the journal immediately while the
+ * snapshot is left untouched. Another instance loading the same file
+ * sees all the changes including values with special characters.
+ */
+void FileCredentialsStorageTest::testJournalChanges()
+{
+	FileCredentialsStorage storage;
+	setupStorage(storage);
+
+	SharedPtr<PasswordCredentials> password = new PasswordCredentials;
+	password->setRawUsername("user=1;");
+	password->setRawPassword("abc%20\ndef\t");
+
+	SharedPtr<PinCredentials> pin = new PinCredentials;
+	pin->setRawPin("1234");
+
+	storage.insertOrUpdate(FIRST, password);
+	storage.insertOrUpdate(SECOND, pin);
+	storage.remove(SECOND);
+
+	CPPUNIT_ASSERT_FILE_NOT_EXISTS(File(snapshotPath()));
+	CPPUNIT_ASSERT_FILE_EXISTS(File(journalPath()));
+
+	FileCredentialsStorage other;
+	setupStorage(other);
+
+	CPPUNIT_ASSERT(other.find(SECOND).isNull());
+
+	SharedPtr<Credentials> found = other.find(FIRST);
+	CPPUNIT_ASSERT(!found.isNull());
+	CPPUNIT_ASSERT_EQUAL("user=1;", saved(found, "username"));
+	CPPUNIT_ASSERT_EQUAL("abc%20\ndef\t", saved(found, "password"));
+}
+
+/**
+ * Saving writes all credentials into the snapshot and empties the journal.
+ */
+void FileCredentialsStorageTest::testCompaction()
+{
+	FileCredentialsStorage storage;
+	setupStorage(storage);
+
+	SharedPtr<PinCredentials> pin = new PinCredentials;
+	pin->setRawPin("1234");
+
+	storage.insertOrUpdate(FIRST, pin);
+	CPPUNIT_ASSERT(File(journalPath()).getSize() > 0);
+
+	storage.save();
+
+	CPPUNIT_ASSERT_FILE_EXISTS(File(snapshotPath()));
+	CPPUNIT_ASSERT(File(journalPath()).getSize() == 0);
+
+	FileCredentialsStorage other;
+	setupStorage(other);
+
+	SharedPtr<Credentials> found = other.find(FIRST);
+	CPPUNIT_ASSERT(!found.isNull());
+	CPPUNIT_ASSERT_EQUAL("1234", saved(found, "pin"));
+}
+
+/**
+ * The journal is applied over the snapshot, thus credentials removed
+ * after the last save do not appear again.
+ */
+void FileCredentialsStorageTest::testReplayOverSnapshot()
+{
+	SharedPtr<PinCredentials> pin = new PinCredentials;
+	pin->setRawPin("1234");
+
+	FileCredentialsStorage storage;
+	setupStorage(storage);
+
+	storage.insertOrUpdate(FIRST, pin);
+	storage.insertOrUpdate(SECOND, pin);
+	storage.save();
+
+	storage.remove(FIRST);
+
+	SharedPtr<PinCredentials> updated = new PinCredentials;
+	updated->setRawPin("5678");
+	storage.insertOrUpdate(SECOND, updated);
+
+	FileCredentialsStorage other;
+	setupStorage(other);
+
+	CPPUNIT_ASSERT(other.find(FIRST).isNull());
+	CPPUNIT_ASSERT(!other.find(SECOND).isNull());
+
+	AutoPtr<AbstractConfiguration> conf = new MapConfiguration;
+	other.find(SECOND)->save(conf, SECOND, "test");
+	CPPUNIT_ASSERT_EQUAL("5678", conf->getString("test." + SECOND.toString() + ".pin"));
+}
+
+/**
+ * Changes do not lead to compaction until the journal grows over
+ * the journalMaxSize.
+ */
+void FileCredentialsStorageTest::testCompactOversizedJournal()
+{
+	FileCredentialsStorage storage;
+	storage.setFile(snapshotPath().toString());
+	// the scheduled save never fires during the test
+	storage.setSaveDelay(1 * Timespan::HOURS);
+	storage.setJournalMaxSize(1024);
+	storage.load();
+
+	SharedPtr<PinCredentials> pin = new PinCredentials;
+	pin->setRawPin("1234");
+
+	storage.insertOrUpdate(FIRST, pin);
+	CPPUNIT_ASSERT(!storage.saveScheduled());
+
+	while (File(journalPath()).getSize() <= 1024)
+		storage.insertOrUpdate(SECOND, pin);
+
+	CPPUNIT_ASSERT(storage.saveScheduled());
+	CPPUNIT_ASSERT_FILE_NOT_EXISTS(File(snapshotPath()));
+
+	storage.save();
+
+	CPPUNIT_ASSERT(!storage.saveScheduled());
+	CPPUNIT_ASSERT_FILE_EXISTS(File(snapshotPath()));
+	CPPUNIT_ASSERT(File(journalPath()).getSize() == 0);
+}
+
+}
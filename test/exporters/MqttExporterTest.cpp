@@ -0,0 +1,210 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Clock.h>
+#include <Poco/Exception.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "exporters/MqttExporter.h"
+#include "model/SensorData.h"
+#include "net/MockMqttClient.h"
+#include "util/CSVSensorDataFormatter.h"
+#include "util/JSONSensorDataFormatter.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+/**
+ * Broker stand-in that can be switched to reject all publishes.
+ */
+class FailingMqttClient : public MockMqttClient {
+public:
+	FailingMqttClient():
+		m_fail(false)
+	{
+	}
+
+	void publish(const MqttMessage &msg) override
+	{
+		if (m_fail)
+			throw IOException("broker is not available");
+
+		MockMqttClient::publish(msg);
+	}
+
+	void setFail(bool fail)
+	{
+		m_fail = fail;
+	}
+
+private:
+	bool m_fail;
+};
+
+class MqttExporterTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(MqttExporterTest);
+	CPPUNIT_TEST(testUnbatched);
+	CPPUNIT_TEST(testBatchBySize);
+	CPPUNIT_TEST(testBatchByBytes);
+	CPPUNIT_TEST(testBatchByDelay);
+	CPPUNIT_TEST(testBackPressure);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void tearDown() override;
+
+	void testUnbatched();
+	void testBatchBySize();
+	void testBatchByBytes();
+	void testBatchByDelay();
+	void testBackPressure();
+
+private:
+	SharedPtr<FailingMqttClient> m_client;
+	MqttExporter m_exporter;
+	Thread m_thread;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MqttExporterTest);
+
+static SensorData makeData(unsigned int module)
+{
+	SensorData data;
+	data.setDeviceID(0x4100000001020304);
+	data.insertValue(SensorValue(ModuleID(module), module));
+	return data;
+}
+
+void MqttExporterTest::setUp()
+{
+	m_client = new FailingMqttClient;
+
+	m_exporter.setMqttClient(m_client);
+	m_exporter.setFormatter(new JSONSensorDataFormatter);
+	m_exporter.setTopic("test");
+	m_exporter.setBatchDelay(1 * Timespan::HOURS);
+}
+
+void MqttExporterTest::tearDown()
+{
+	if (m_thread.isRunning()) {
+		m_exporter.stop();
+		m_thread.join();
+	}
+}
+
+void MqttExporterTest::testUnbatched()
+{
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(1)));
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(2)));
+
+	const auto published = m_client->published();
+	CPPUNIT_ASSERT_EQUAL(2, published.size());
+	CPPUNIT_ASSERT_EQUAL("test", published.front().topic());
+	CPPUNIT_ASSERT_EQUAL(
+		JSONSensorDataFormatter().format(makeData(1)),
+		published.front().message());
+
+	CPPUNIT_ASSERT_EQUAL(2, m_exporter.publishedMessages());
+	CPPUNIT_ASSERT_EQUAL(2, m_exporter.publishedRecords());
+}
+
+/**
+ * Records are published as a single JSON array when the batch
+ * reaches batchSize records.
+ */
+void MqttExporterTest::testBatchBySize()
+{
+	JSONSensorDataFormatter formatter;
+
+	m_exporter.setBatchSize(3);
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(1)));
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(2)));
+	CPPUNIT_ASSERT(m_client->published().empty());
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(3)));
+
+	const auto published = m_client->published();
+	CPPUNIT_ASSERT_EQUAL(1, published.size());
+	CPPUNIT_ASSERT_EQUAL(
+		"[" + formatter.format(makeData(1))
+		+ "," + formatter.format(makeData(2))
+		+ "," + formatter.format(makeData(3)) + "]",
+		published.front().message());
+
+	CPPUNIT_ASSERT_EQUAL(1, m_exporter.publishedMessages());
+	CPPUNIT_ASSERT_EQUAL(3, m_exporter.publishedRecords());
+}
+
+/**
+ * Batch exceeding batchBytes is published even when it does not
+ * contain batchSize records. Records of non-JSON formatters are
+ * separated by new lines.
+ */
+void MqttExporterTest::testBatchByBytes()
+{
+	CSVSensorDataFormatter formatter;
+
+	m_exporter.setFormatter(new CSVSensorDataFormatter);
+	m_exporter.setBatchSize(100);
+	m_exporter.setBatchBytes(formatter.format(makeData(1)).size() + 1);
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(1)));
+	CPPUNIT_ASSERT(m_client->published().empty());
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(2)));
+
+	const auto published = m_client->published();
+	CPPUNIT_ASSERT_EQUAL(1, published.size());
+	CPPUNIT_ASSERT_EQUAL(
+		formatter.format(makeData(1)) + "\n" + formatter.format(makeData(2)),
+		published.front().message());
+}
+
+/**
+ * Incomplete batch is published by run() after batchDelay.
+ */
+void MqttExporterTest::testBatchByDelay()
+{
+	m_exporter.setBatchSize(100);
+	m_exporter.setBatchDelay(50 * Timespan::MILLISECONDS);
+	m_thread.start(m_exporter);
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(1)));
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(2)));
+
+	const Clock started;
+	while (m_client->published().empty() && !started.isElapsed(5 * Timespan::SECONDS))
+		Thread::sleep(10);
+
+	CPPUNIT_ASSERT_EQUAL(1, m_client->published().size());
+	CPPUNIT_ASSERT_EQUAL(1, m_exporter.publishedMessages());
+	CPPUNIT_ASSERT_EQUAL(2, m_exporter.publishedRecords());
+}
+
+/**
+ * When a full batch cannot be published, ship() refuses new data
+ * until the broker accepts the batch again.
+ */
+void MqttExporterTest::testBackPressure()
+{
+	m_exporter.setBatchSize(2);
+	m_client->setFail(true);
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(1)));
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(2)));
+	CPPUNIT_ASSERT(!m_exporter.ship(makeData(3)));
+	CPPUNIT_ASSERT(!m_exporter.ship(makeData(3)));
+
+	m_client->setFail(false);
+
+	CPPUNIT_ASSERT(m_exporter.ship(makeData(3)));
+	CPPUNIT_ASSERT_EQUAL(1, m_client->published().size());
+	CPPUNIT_ASSERT_EQUAL(1, m_exporter.publishedMessages());
+	CPPUNIT_ASSERT_EQUAL(2, m_exporter.publishedRecords());
+}
+
+}
@@ -0,0 +1,226 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+
+#include "cppunit/BetterAssert.h"
+#include "cppunit/FileTestFixture.h"
+#include "exporters/NamedPipeExporter.h"
+#include "model/SensorData.h"
+#include "util/SensorDataFormatter.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class NamedPipeExporterTest : public FileTestFixture {
+	CPPUNIT_TEST_SUITE(NamedPipeExporterTest);
+	CPPUNIT_TEST(testNoReader);
+	CPPUNIT_TEST(testPersistentWrite);
+	CPPUNIT_TEST(testBackPressureAndCoalescing);
+	CPPUNIT_TEST(testReaderDisappears);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void tearDown() override;
+
+	void testNoReader();
+	void testPersistentWrite();
+	void testBackPressureAndCoalescing();
+	void testReaderDisappears();
+
+protected:
+	void openReader();
+	string readAll();
+
+private:
+	string m_pipePath;
+	int m_reader;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NamedPipeExporterTest);
+
+/**
+ * Formatter generating records of fixed length.
+ */
+class FixedSizeFormatter : public SensorDataFormatter {
+public:
+	FixedSizeFormatter(size_t size):
+		m_size(size)
+	{
+	}
+
+	string format(const SensorData &) override
+	{
+		return string(m_size, 'x');
+	}
+
+private:
+	size_t m_size;
+};
+
+void NamedPipeExporterTest::setUp()
+{
+	setUpAsDirectory();
+
+	m_pipePath = Path(testingPath(), "pipe").toString();
+	m_reader = -1;
+}
+
+void NamedPipeExporterTest::tearDown()
+{
+	if (m_reader >= 0)
+		close(m_reader);
+
+	FileTestFixture::tearDown();
+}
+
+void NamedPipeExporterTest::openReader()
+{
+	m_reader = open(m_pipePath.c_str(), O_RDONLY | O_NONBLOCK);
+	CPPUNIT_ASSERT(m_reader >= 0);
+}
+
+string NamedPipeExporterTest::readAll()
+{
+	string result;
+	char buffer[4096];
+
+	while (true) {
+		const ssize_t ret = read(m_reader, buffer, sizeof(buffer));
+		if (ret <= 0)
+			break;
+
+		result.append(buffer, ret);
+	}
+
+	return result;
+}
+
+/**
+ * Without a reader, the data are dropped and reported as lost.
+ */
+void NamedPipeExporterTest::testNoReader()
+{
+	FixedSizeFormatter formatter(10);
+	NamedPipeExporter exporter;
+	exporter.setFilePath(m_pipePath);
+	exporter.setFormatter(&formatter);
+	exporter.setPersistent(true);
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT(File(m_pipePath).exists());
+
+	CPPUNIT_ASSERT_EQUAL(0, exporter.stats().writtenPdu);
+	CPPUNIT_ASSERT_EQUAL(1, exporter.stats().lostPdu);
+	CPPUNIT_ASSERT_EQUAL(0, exporter.writeCalls());
+}
+
+/**
+ * Records are written via the opened pipe one by one while
+ * the reader keeps up.
+ */
+void NamedPipeExporterTest::testPersistentWrite()
+{
+	FixedSizeFormatter formatter(10);
+	NamedPipeExporter exporter;
+	exporter.setFilePath(m_pipePath);
+	exporter.setFormatter(&formatter);
+	exporter.setPersistent(true);
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	openReader();
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT(exporter.ship({}));
+
+	CPPUNIT_ASSERT_EQUAL(
+		"xxxxxxxxxx\nxxxxxxxxxx\nxxxxxxxxxx\n",
+		readAll());
+
+	CPPUNIT_ASSERT_EQUAL(3, exporter.stats().writtenPdu);
+	CPPUNIT_ASSERT_EQUAL(33, exporter.stats().writtenBytes);
+	CPPUNIT_ASSERT_EQUAL(1, exporter.stats().lostPdu);
+	CPPUNIT_ASSERT_EQUAL(3, exporter.writeCalls());
+	CPPUNIT_ASSERT_EQUAL(0, exporter.pending());
+}
+
+/**
+ * When the pipe is full, records are kept pending up to the batchSize.
+ * Then, ship() returns false. When the reader drains the pipe, all
+ * pending records are written by a single call.
+ */
+void NamedPipeExporterTest::testBackPressureAndCoalescing()
+{
+	FixedSizeFormatter formatter(999);
+	NamedPipeExporter exporter;
+	exporter.setFilePath(m_pipePath);
+	exporter.setFormatter(&formatter);
+	exporter.setPersistent(true);
+	exporter.setBatchSize(8);
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	openReader();
+
+	size_t accepted = 0;
+	for (; accepted < 100000; ++accepted) {
+		if (!exporter.ship({}))
+			break;
+	}
+
+	CPPUNIT_ASSERT(accepted < 100000);
+	CPPUNIT_ASSERT_EQUAL(8, exporter.pending());
+
+	const uint64_t calls = exporter.writeCalls();
+	const string content = readAll();
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT_EQUAL(0, exporter.pending());
+	CPPUNIT_ASSERT_EQUAL(calls + 2, exporter.writeCalls());
+
+	const string rest = readAll();
+	CPPUNIT_ASSERT_EQUAL((accepted + 1) * 1000, content.size() + rest.size());
+	CPPUNIT_ASSERT_EQUAL(accepted + 1, exporter.stats().writtenPdu);
+}
+
+/**
+ * When the reader disappears, the pending records are dropped and
+ * the exporter does not die on SIGPIPE.
+ */
+void NamedPipeExporterTest::testReaderDisappears()
+{
+	FixedSizeFormatter formatter(10);
+	NamedPipeExporter exporter;
+	exporter.setFilePath(m_pipePath);
+	exporter.setFormatter(&formatter);
+	exporter.setPersistent(true);
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	openReader();
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT_EQUAL("xxxxxxxxxx\n", readAll());
+
+	close(m_reader);
+	m_reader = -1;
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT_EQUAL(2, exporter.stats().lostPdu);
+	CPPUNIT_ASSERT_EQUAL(11, exporter.stats().lostBytes);
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT_EQUAL(3, exporter.stats().lostPdu);
+
+	openReader();
+
+	CPPUNIT_ASSERT(exporter.ship({}));
+	CPPUNIT_ASSERT_EQUAL("xxxxxxxxxx\n", readAll());
+	CPPUNIT_ASSERT_EQUAL(2, exporter.stats().writtenPdu);
+}
+
+}
@@ -0,0 +1,184 @@
+#include <unistd.h>
+
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/AtomicCounter.h>
+#include <Poco/Event.h>
+#include <Poco/Exception.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "hotplug/HotplugReactor.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class HotplugReactorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(HotplugReactorTest);
+	CPPUNIT_TEST(testDispatchImmediately);
+	CPPUNIT_TEST(testRetryUnavailable);
+	CPPUNIT_TEST(testReopenOnHangup);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testDispatchImmediately();
+	void testRetryUnavailable();
+	void testReopenOnHangup();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HotplugReactorTest);
+
+/**
+ * Source reading from an anonymous pipe. The write end is available
+ * to the test. The source can be made unavailable for a number of
+ * openSource() calls.
+ */
+class PipeSource : public HotplugSource {
+public:
+	PipeSource(int unavailable = 0):
+		m_unavailable(unavailable),
+		m_opened(0),
+		m_read(-1),
+		m_write(-1)
+	{
+	}
+
+	~PipeSource()
+	{
+		closeSource();
+		closeWriter();
+	}
+
+	int openSource() override
+	{
+		m_opened++;
+
+		if (m_unavailable-- > 0)
+			return -1;
+
+		int fds[2];
+		if (::pipe(fds) < 0)
+			throw IOException("pipe failed");
+
+		m_read = fds[0];
+		m_write = fds[1];
+		m_ready.set();
+
+		return m_read;
+	}
+
+	bool onReadable() override
+	{
+		char buffer[64];
+		const ssize_t ret = ::read(m_read, buffer, sizeof(buffer));
+		if (ret > 0) {
+			m_data.append(buffer, ret);
+			m_received.set();
+		}
+
+		return true;
+	}
+
+	void closeSource() override
+	{
+		if (m_read >= 0)
+			::close(m_read);
+
+		m_read = -1;
+	}
+
+	void send(const string &data)
+	{
+		CPPUNIT_ASSERT(::write(m_write, data.data(), data.size()) > 0);
+	}
+
+	void closeWriter()
+	{
+		if (m_write >= 0)
+			::close(m_write);
+
+		m_write = -1;
+	}
+
+	int m_unavailable;
+	AtomicCounter m_opened;
+	int m_read;
+	int m_write;
+	Event m_ready;
+	Event m_received;
+	string m_data;
+};
+
+void HotplugReactorTest::testDispatchImmediately()
+{
+	PipeSource first;
+	PipeSource second;
+	HotplugReactor reactor;
+
+	reactor.attach(first);
+	reactor.attach(second);
+
+	Thread thread;
+	thread.startFunc([&]() {reactor.run();});
+
+	CPPUNIT_ASSERT(first.m_ready.tryWait(5000));
+	CPPUNIT_ASSERT(second.m_ready.tryWait(5000));
+
+	second.send("b");
+	CPPUNIT_ASSERT(second.m_received.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL("b", second.m_data);
+
+	first.send("a");
+	CPPUNIT_ASSERT(first.m_received.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL("a", first.m_data);
+
+	reactor.stop();
+	thread.join();
+
+	CPPUNIT_ASSERT_EQUAL(-1, first.m_read);
+	CPPUNIT_ASSERT_EQUAL(-1, second.m_read);
+}
+
+void HotplugReactorTest::testRetryUnavailable()
+{
+	PipeSource source(2);
+	HotplugReactor reactor;
+	reactor.setRetryInterval(1 * Timespan::MILLISECONDS);
+	reactor.attach(source);
+
+	Thread thread;
+	thread.startFunc([&]() {reactor.run();});
+
+	CPPUNIT_ASSERT(source.m_ready.tryWait(5000));
+	CPPUNIT_ASSERT_EQUAL(3, source.m_opened.value());
+
+	source.send("x");
+	CPPUNIT_ASSERT(source.m_received.tryWait(5000));
+
+	reactor.stop();
+	thread.join();
+}
+
+void HotplugReactorTest::testReopenOnHangup()
+{
+	PipeSource source;
+	HotplugReactor reactor;
+	reactor.attach(source);
+
+	Thread thread;
+	thread.startFunc([&]() {reactor.run();});
+
+	CPPUNIT_ASSERT(source.m_ready.tryWait(5000));
+	source.closeWriter();
+
+	// the hangup leads to closing and opening the source again
+	CPPUNIT_ASSERT(source.m_ready.tryWait(5000));
+	CPPUNIT_ASSERT(source.m_opened.value() >= 2);
+
+	reactor.stop();
+	thread.join();
+}
+
+}
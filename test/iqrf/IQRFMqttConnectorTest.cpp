@@ -0,0 +1,198 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Exception.h>
+#include <Poco/RunnableAdapter.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "iqrf/IQRFJsonResponse.h"
+#include "iqrf/IQRFMqttConnector.h"
+#include "net/MockMqttClient.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class IQRFMqttConnectorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(IQRFMqttConnectorTest);
+	CPPUNIT_TEST(testReceiveAwaited);
+	CPPUNIT_TEST(testReceiveAlreadyDelivered);
+	CPPUNIT_TEST(testReceiveOutOfOrder);
+	CPPUNIT_TEST(testReceiveTimeout);
+	CPPUNIT_TEST(testStopWakesWaiters);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void tearDown() override;
+
+	void testReceiveAwaited();
+	void testReceiveAlreadyDelivered();
+	void testReceiveOutOfOrder();
+	void testReceiveTimeout();
+	void testStopWakesWaiters();
+
+protected:
+	static MqttMessage createResponse(const GlobalID &id, const string &data);
+
+private:
+	MockMqttClient::Ptr m_client;
+	IQRFMqttConnector::Ptr m_connector;
+	Thread m_thread;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IQRFMqttConnectorTest);
+
+void IQRFMqttConnectorTest::setUp()
+{
+	m_client = new MockMqttClient;
+	m_connector = new IQRFMqttConnector;
+	m_connector->setMqttClient(m_client);
+	m_connector->setPublishTopic("Iqrf/DpaRequest");
+	m_connector->setReceiveTimeout(10 * Timespan::MILLISECONDS);
+
+	m_thread.start(*m_connector);
+}
+
+void IQRFMqttConnectorTest::tearDown()
+{
+	m_connector->stop();
+	m_thread.join();
+}
+
+MqttMessage IQRFMqttConnectorTest::createResponse(
+		const GlobalID &id,
+		const string &data)
+{
+	IQRFJsonResponse response;
+	response.setMessageID(id.toString());
+	response.setRequest("00.00.06.03.ff.ff");
+	response.setResponse(data);
+	response.setErrorCode(IQRFJsonResponse::DpaError::STATUS_NO_ERROR);
+
+	return {"Iqrf/DpaResponse", response.toString()};
+}
+
+/**
+ * Response is delivered while the receiver is already waiting for it.
+ */
+void IQRFMqttConnectorTest::testReceiveAwaited()
+{
+	const GlobalID id = GlobalID::random();
+
+	m_client->setResponder([&](const MqttMessage &) {
+		return list<MqttMessage>{createResponse(id, "00.00.06.83.00.00")};
+	});
+
+	m_connector->send("request");
+
+	const auto response = m_connector->receive(id, 1 * Timespan::SECONDS);
+	CPPUNIT_ASSERT(!response.isNull());
+	CPPUNIT_ASSERT_EQUAL(id.toString(), response->messageID());
+	CPPUNIT_ASSERT_EQUAL("00.00.06.83.00.00", response->response());
+
+	CPPUNIT_ASSERT_EQUAL(1, m_client->published().size());
+	CPPUNIT_ASSERT_EQUAL("Iqrf/DpaRequest", m_client->published().front().topic());
+}
+
+/**
+ * Response delivered before anybody asks for it is kept
+ * until claimed.
+ */
+void IQRFMqttConnectorTest::testReceiveAlreadyDelivered()
+{
+	const GlobalID id = GlobalID::random();
+
+	m_client->deliver(createResponse(id, "00.00.06.83.00.01"));
+
+	// the connector handles messages one by one, once the empty
+	// message is received, the response has already been stored
+	m_client->deliver({"Iqrf/DpaResponse", ""});
+	CPPUNIT_ASSERT(m_client->waitDrained(1 * Timespan::SECONDS));
+
+	const auto response = m_connector->receive(id, 1 * Timespan::SECONDS);
+	CPPUNIT_ASSERT(!response.isNull());
+	CPPUNIT_ASSERT_EQUAL("00.00.06.83.00.01", response->response());
+}
+
+/**
+ * Multiple concurrent receivers are each given exactly
+ * the response they wait for regardless of the order
+ * of delivery.
+ */
+void IQRFMqttConnectorTest::testReceiveOutOfOrder()
+{
+	const GlobalID id0 = GlobalID::random();
+	const GlobalID id1 = GlobalID::random();
+	IQRFJsonResponse::Ptr response0;
+	IQRFJsonResponse::Ptr response1;
+
+	class Receiver : public Runnable {
+	public:
+		Receiver(IQRFMqttConnector::Ptr connector,
+				const GlobalID &id,
+				IQRFJsonResponse::Ptr &result):
+			m_connector(connector),
+			m_id(id),
+			m_result(result)
+		{
+		}
+
+		void run() override
+		{
+			m_result = m_connector->receive(m_id, 1 * Timespan::SECONDS);
+		}
+
+	private:
+		IQRFMqttConnector::Ptr m_connector;
+		GlobalID m_id;
+		IQRFJsonResponse::Ptr &m_result;
+	};
+
+	Receiver receiver0(m_connector, id0, response0);
+	Receiver receiver1(m_connector, id1, response1);
+	Thread thread0;
+	Thread thread1;
+
+	thread0.start(receiver0);
+	thread1.start(receiver1);
+
+	m_client->deliver(createResponse(id1, "00.00.06.83.00.11"));
+	m_client->deliver(createResponse(id0, "00.00.06.83.00.10"));
+
+	thread0.join();
+	thread1.join();
+
+	CPPUNIT_ASSERT(!response0.isNull());
+	CPPUNIT_ASSERT(!response1.isNull());
+	CPPUNIT_ASSERT_EQUAL("00.00.06.83.00.10", response0->response());
+	CPPUNIT_ASSERT_EQUAL("00.00.06.83.00.11", response1->response());
+}
+
+void IQRFMqttConnectorTest::testReceiveTimeout()
+{
+	const GlobalID id = GlobalID::random();
+
+	m_client->deliver(createResponse(GlobalID::random(), "00.00.06.83.00.00"));
+
+	CPPUNIT_ASSERT_THROW(
+		m_connector->receive(id, 50 * Timespan::MILLISECONDS),
+		TimeoutException);
+}
+
+void IQRFMqttConnectorTest::testStopWakesWaiters()
+{
+	const GlobalID id = GlobalID::random();
+	IQRFJsonResponse::Ptr response = new IQRFJsonResponse;
+
+	RunnableAdapter<IQRFMqttConnector> stop(*m_connector, &IQRFMqttConnector::stop);
+	Thread stopper;
+
+	stopper.start(stop);
+	response = m_connector->receive(id, -1);
+	stopper.join();
+
+	CPPUNIT_ASSERT(response.isNull());
+}
+
+}
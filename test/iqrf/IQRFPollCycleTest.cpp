@@ -0,0 +1,368 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
+#include <Poco/StringTokenizer.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "core/Distributor.h"
+#include "iqrf/DPAProtocol.h"
+#include "iqrf/IQRFDevice.h"
+#include "iqrf/IQRFJsonRequest.h"
+#include "iqrf/IQRFJsonResponse.h"
+#include "iqrf/IQRFMqttConnector.h"
+#include "iqrf/IQRFNetworkPoller.h"
+#include "iqrf/IQRFPollCycle.h"
+#include "iqrf/IQRFPollStats.h"
+#include "model/SensorData.h"
+#include "net/MockMqttClient.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class IQRFPollCycleTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(IQRFPollCycleTest);
+	CPPUNIT_TEST(testPollDevicePipelined);
+	CPPUNIT_TEST(testPollNothingDue);
+	CPPUNIT_TEST(testNetworkPollerSingleCycle);
+	CPPUNIT_TEST(testFailureDoesNotAffectOthers);
+	CPPUNIT_TEST(testPollStats);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void setUp() override;
+	void tearDown() override;
+
+	void testPollDevicePipelined();
+	void testPollNothingDue();
+	void testNetworkPollerSingleCycle();
+	void testFailureDoesNotAffectOthers();
+	void testPollStats();
+
+protected:
+	IQRFDevice::Ptr createDevice(DPAMessage::NetworkAddress node);
+
+	/**
+	 * Simulate IQRF daemon behind the MQTT broker. Responses
+	 * are held until m_hold requests are received and then
+	 * delivered in the reverse order.
+	 */
+	list<MqttMessage> respond(const MqttMessage &msg);
+
+private:
+	MockMqttClient::Ptr m_client;
+	IQRFMqttConnector::Ptr m_connector;
+	Thread m_thread;
+
+	size_t m_hold;
+	uint8_t m_silentNode;
+	list<MqttMessage> m_held;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IQRFPollCycleTest);
+
+static const uint8_t TEST_PNUM = 0x20;
+static const uint8_t TEST_PING_CMD = 0x01;
+static const uint8_t TEST_MODULES_CMD = 0x02;
+static const uint8_t TEST_PRODUCT_CMD = 0x03;
+static const uint8_t TEST_VALUE_CMD = 0x04;
+static const Timespan RECEIVE_TIMEOUT = 200 * Timespan::MILLISECONDS;
+
+/**
+ * Protocol of a simple temperature sensor reporting its value
+ * as a single byte.
+ */
+class TestingDPAProtocol : public DPAProtocol {
+public:
+	DPARequest::Ptr pingRequest(
+		DPAMessage::NetworkAddress address) const override
+	{
+		return new DPARequest(address, TEST_PNUM, TEST_PING_CMD);
+	}
+
+	DPARequest::Ptr dpaProductInfoRequest(
+		DPAMessage::NetworkAddress address) const override
+	{
+		return new DPARequest(address, TEST_PNUM, TEST_PRODUCT_CMD);
+	}
+
+	ProductInfo extractProductInfo(
+		const vector<uint8_t> &,
+		uint16_t) const override
+	{
+		return {"BeeeOn", "Testing Sensor"};
+	}
+
+	DPARequest::Ptr dpaModulesRequest(
+		DPAMessage::NetworkAddress node) const override
+	{
+		return new DPARequest(node, TEST_PNUM, TEST_MODULES_CMD);
+	}
+
+	list<ModuleType> extractModules(
+		const vector<uint8_t> &) const override
+	{
+		return {
+			{ModuleType::Type::TYPE_TEMPERATURE},
+			{ModuleType::Type::TYPE_BATTERY},
+			{ModuleType::Type::TYPE_RSSI},
+		};
+	}
+
+	DPARequest::Ptr dpaValueRequest(
+		DPAMessage::NetworkAddress node,
+		const list<ModuleType> &) const override
+	{
+		return new DPARequest(node, TEST_PNUM, TEST_VALUE_CMD);
+	}
+
+	SensorData parseValue(
+		const list<ModuleType> &,
+		const vector<uint8_t> &msg) const override
+	{
+		SensorData data;
+		data.insertValue({0, double(msg.at(0))});
+		return data;
+	}
+};
+
+/**
+ * Distributor collecting all exported data.
+ */
+class CollectingDistributor : public Distributor {
+public:
+	typedef SharedPtr<CollectingDistributor> Ptr;
+
+	void exportData(const SensorData &data) override
+	{
+		m_data.emplace_back(data);
+	}
+
+	vector<SensorData> m_data;
+};
+
+void IQRFPollCycleTest::setUp()
+{
+	m_hold = 0;
+	m_silentNode = 0;
+	m_held.clear();
+
+	m_client = new MockMqttClient;
+	m_client->setResponder([&](const MqttMessage &msg) {
+		return respond(msg);
+	});
+
+	m_connector = new IQRFMqttConnector;
+	m_connector->setMqttClient(m_client);
+	m_connector->setPublishTopic("Iqrf/DpaRequest");
+	m_connector->setReceiveTimeout(10 * Timespan::MILLISECONDS);
+
+	m_thread.start(*m_connector);
+}
+
+void IQRFPollCycleTest::tearDown()
+{
+	m_connector->stop();
+	m_thread.join();
+}
+
+list<MqttMessage> IQRFPollCycleTest::respond(const MqttMessage &msg)
+{
+	const auto request = IQRFJsonMessage::parse(msg.message())
+		.cast<IQRFJsonRequest>();
+	const StringTokenizer dpa(request->request(), ".");
+
+	const uint8_t node = NumberParser::parseHex("0x" + dpa[0]);
+	const uint8_t pnum = NumberParser::parseHex("0x" + dpa[2]);
+	const uint8_t cmd = NumberParser::parseHex("0x" + dpa[3]);
+
+	string data = NumberFormatter::formatHex(node, 2)
+		+ ".00." + NumberFormatter::formatHex(pnum, 2)
+		+ "." + NumberFormatter::formatHex(cmd | 0x80, 2)
+		+ ".01.02.00.00";
+
+	if (pnum == DPARequest::DPA_OS_PNUM) {
+		// MID = node, RSSI = -10 dBm, supply voltage
+		data += "." + NumberFormatter::formatHex(node, 2)
+			+ ".00.00.00.00.00.00.00.78.20.00.00";
+	}
+	else if (cmd == TEST_VALUE_CMD) {
+		if (node == m_silentNode)
+			return {};
+
+		data += "." + NumberFormatter::formatHex(node * 10, 2);
+	}
+
+	IQRFJsonResponse response;
+	response.setMessageID(request->messageID());
+	response.setRequest(request->request());
+	response.setResponse(data);
+	response.setErrorCode(IQRFJsonResponse::DpaError::STATUS_NO_ERROR);
+
+	const MqttMessage reply = {"Iqrf/DpaResponse", response.toString()};
+
+	if (m_hold == 0)
+		return {reply};
+
+	m_held.push_front(reply);
+	if (m_held.size() < m_hold)
+		return {};
+
+	list<MqttMessage> replies;
+	replies.swap(m_held);
+	return replies;
+}
+
+IQRFDevice::Ptr IQRFPollCycleTest::createDevice(DPAMessage::NetworkAddress node)
+{
+	IQRFDevice::Ptr device = new IQRFDevice(
+		m_connector,
+		RECEIVE_TIMEOUT,
+		node,
+		new TestingDPAProtocol,
+		RefreshTime::fromSeconds(60),
+		RefreshTime::fromSeconds(300));
+
+	device->probe(5 * Timespan::SECONDS);
+	return device;
+}
+
+/**
+ * Both values and peripheral info are due on the first poll.
+ * The peripheral info request is sent before the response to
+ * the values request arrives. Responses are delivered only
+ * after both requests are sent, in reverse order.
+ */
+void IQRFPollCycleTest::testPollDevicePipelined()
+{
+	IQRFPollStats::Ptr stats = new IQRFPollStats;
+	CollectingDistributor::Ptr distributor = new CollectingDistributor;
+
+	const auto device = createDevice(1);
+	device->setPollStats(stats);
+	const size_t probes = m_client->published().size();
+
+	m_hold = 2;
+	device->poll(distributor);
+
+	CPPUNIT_ASSERT_EQUAL(probes + 2, m_client->published().size());
+	CPPUNIT_ASSERT_EQUAL(2, distributor->m_data.size());
+
+	CPPUNIT_ASSERT(device->id() == distributor->m_data[0].deviceID());
+	CPPUNIT_ASSERT_EQUAL(1, distributor->m_data[0].size());
+	CPPUNIT_ASSERT_EQUAL(10.0, distributor->m_data[0].at(0).value());
+
+	CPPUNIT_ASSERT(device->id() == distributor->m_data[1].deviceID());
+	CPPUNIT_ASSERT_EQUAL(2, distributor->m_data[1].size());
+
+	CPPUNIT_ASSERT_EQUAL(1, stats->cycles());
+	CPPUNIT_ASSERT_EQUAL(2, stats->requests());
+	CPPUNIT_ASSERT_EQUAL(0, stats->failures());
+	CPPUNIT_ASSERT(stats->lastLatency() < RECEIVE_TIMEOUT);
+}
+
+/**
+ * Polling of device without any due request does not
+ * generate any traffic.
+ */
+void IQRFPollCycleTest::testPollNothingDue()
+{
+	CollectingDistributor::Ptr distributor = new CollectingDistributor;
+
+	const auto device = createDevice(1);
+	device->poll(distributor);
+	CPPUNIT_ASSERT_EQUAL(2, distributor->m_data.size());
+
+	const size_t published = m_client->published().size();
+
+	device->poll(distributor);
+	CPPUNIT_ASSERT_EQUAL(published, m_client->published().size());
+	CPPUNIT_ASSERT_EQUAL(2, distributor->m_data.size());
+
+	CPPUNIT_ASSERT(device->refresh() > RefreshTime::fromSeconds(58));
+	CPPUNIT_ASSERT(device->refresh() <= RefreshTime::fromSeconds(60));
+}
+
+/**
+ * All due requests of all nodes are performed in a single
+ * cycle with all requests in flight at once.
+ */
+void IQRFPollCycleTest::testNetworkPollerSingleCycle()
+{
+	IQRFPollStats::Ptr stats = new IQRFPollStats;
+	CollectingDistributor::Ptr distributor = new CollectingDistributor;
+	IQRFNetworkPoller poller(m_connector, RECEIVE_TIMEOUT, stats);
+
+	const auto second = createDevice(2);
+
+	poller.add(createDevice(1));
+	poller.add(second);
+	poller.add(createDevice(3));
+	CPPUNIT_ASSERT_EQUAL(3, poller.size());
+
+	m_hold = 6;
+	poller.poll(distributor);
+
+	CPPUNIT_ASSERT_EQUAL(6, distributor->m_data.size());
+	CPPUNIT_ASSERT_EQUAL(1, stats->cycles());
+	CPPUNIT_ASSERT_EQUAL(6, stats->requests());
+	CPPUNIT_ASSERT_EQUAL(0, stats->failures());
+	CPPUNIT_ASSERT(stats->lastLatency() < RECEIVE_TIMEOUT);
+
+	CPPUNIT_ASSERT(poller.refresh() > RefreshTime::fromSeconds(58));
+
+	poller.remove(second->id());
+	CPPUNIT_ASSERT_EQUAL(2, poller.size());
+}
+
+/**
+ * A node that does not respond is reported as a failure
+ * while data of the others are exported.
+ */
+void IQRFPollCycleTest::testFailureDoesNotAffectOthers()
+{
+	IQRFPollStats::Ptr stats = new IQRFPollStats;
+	CollectingDistributor::Ptr distributor = new CollectingDistributor;
+	IQRFNetworkPoller poller(m_connector, RECEIVE_TIMEOUT, stats);
+
+	poller.add(createDevice(1));
+	poller.add(createDevice(2));
+
+	m_silentNode = 2;
+	poller.poll(distributor);
+
+	CPPUNIT_ASSERT_EQUAL(3, distributor->m_data.size());
+	CPPUNIT_ASSERT_EQUAL(1, stats->cycles());
+	CPPUNIT_ASSERT_EQUAL(4, stats->requests());
+	CPPUNIT_ASSERT_EQUAL(1, stats->failures());
+	CPPUNIT_ASSERT(stats->lastLatency() >= RECEIVE_TIMEOUT);
+}
+
+void IQRFPollCycleTest::testPollStats()
+{
+	IQRFPollStats stats;
+
+	CPPUNIT_ASSERT_EQUAL(0, stats.cycles());
+	CPPUNIT_ASSERT_EQUAL(0, stats.avgLatency().totalMicroseconds());
+
+	stats.record(4, 0, 40 * Timespan::MILLISECONDS);
+	stats.record(2, 1, 100 * Timespan::MILLISECONDS);
+	stats.record(6, 0, 10 * Timespan::MILLISECONDS);
+
+	CPPUNIT_ASSERT_EQUAL(3, stats.cycles());
+	CPPUNIT_ASSERT_EQUAL(12, stats.requests());
+	CPPUNIT_ASSERT_EQUAL(1, stats.failures());
+	CPPUNIT_ASSERT_EQUAL(10, stats.minLatency().totalMilliseconds());
+	CPPUNIT_ASSERT_EQUAL(100, stats.maxLatency().totalMilliseconds());
+	CPPUNIT_ASSERT_EQUAL(50, stats.avgLatency().totalMilliseconds());
+	CPPUNIT_ASSERT_EQUAL(10, stats.lastLatency().totalMilliseconds());
+	CPPUNIT_ASSERT_EQUAL(12500, stats.avgRequestLatency().totalMicroseconds());
+
+	stats.reset();
+	CPPUNIT_ASSERT_EQUAL(0, stats.cycles());
+	CPPUNIT_ASSERT_EQUAL(0, stats.requests());
+}
+
+}
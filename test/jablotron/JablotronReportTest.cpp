@@ -16,12 +16,16 @@ class JablotronReportTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testAC88);
 	CPPUNIT_TEST(testJA80L);
 	CPPUNIT_TEST(testTP82N);
+	CPPUNIT_TEST(testParse);
+	CPPUNIT_TEST(testParseInvalid);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testInvalid();
 	void testAC88();
 	void testJA80L();
 	void testTP82N();
+	void testParse();
+	void testParseInvalid();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(JablotronReportTest);
@@ -141,4 +145,41 @@ void JablotronReportTest::testTP82N()
 	CPPUNIT_ASSERT_EQUAL(100, report4.battery());
 }
 
+void JablotronReportTest::testParse()
+{
+	const string message = "[13631488] JA-80L BEACON BLACKOUT:0";
+	const JablotronReport report = JablotronReport::parse(message.data(), message.size());
+
+	CPPUNIT_ASSERT(static_cast<bool>(report));
+	CPPUNIT_ASSERT_EQUAL(13631488, report.address);
+	CPPUNIT_ASSERT_EQUAL("JA-80L", report.type);
+	CPPUNIT_ASSERT_EQUAL("BEACON BLACKOUT:0", report.data);
+
+	// the message is not terminated, only the given length is parsed
+	const string buffer = "[00000042] AC-88 RELAY:1[00000043]";
+	const JablotronReport relay = JablotronReport::parse(buffer.data(), buffer.size() - 10);
+
+	CPPUNIT_ASSERT_EQUAL(42, relay.address);
+	CPPUNIT_ASSERT_EQUAL("AC-88", relay.type);
+	CPPUNIT_ASSERT_EQUAL("RELAY:1", relay.data);
+}
+
+void JablotronReportTest::testParseInvalid()
+{
+	for (const string message : {
+			"OK",
+			"ERROR",
+			"SLOT:01 [--------]",
+			"[1234567] JA-80L BEACON",
+			"[12345678] JA-80L",
+			"[12345678] JA-80L ",
+			"[12345678]JA-80L BEACON",
+			"[1234567X] JA-80L BEACON",
+			"[12345678",
+	}) {
+		CPPUNIT_ASSERT_MESSAGE(message,
+			!JablotronReport::parse(message.data(), message.size()));
+	}
+}
+
 }
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "cppunit/BetterAssert.h"
+#include "jablotron/JablotronRingBuffer.h"
+
+using namespace std;
+
+namespace BeeeOn {
+
+class JablotronRingBufferTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(JablotronRingBufferTest);
+	CPPUNIT_TEST(testFraming);
+	CPPUNIT_TEST(testPartialMessage);
+	CPPUNIT_TEST(testWrapAround);
+	CPPUNIT_TEST(testOverflow);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testFraming();
+	void testPartialMessage();
+	void testWrapAround();
+	void testOverflow();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JablotronRingBufferTest);
+
+/**
+ * Simulate reading from the serial port, the data are written
+ * into the ring buffer possibly in multiple chunks.
+ */
+static void feed(JablotronRingBuffer &ring, const string &data)
+{
+	size_t offset = 0;
+
+	while (offset < data.size()) {
+		size_t size;
+		char *buffer = ring.writable(size);
+
+		const size_t count = min(size, data.size() - offset);
+		::memcpy(buffer, data.data() + offset, count);
+		ring.commit(count);
+
+		offset += count;
+	}
+}
+
+static bool next(JablotronRingBuffer &ring, string &message)
+{
+	const char *data;
+	size_t length;
+
+	if (!ring.next(data, length))
+		return false;
+
+	message.assign(data, length);
+	return true;
+}
+
+void JablotronRingBufferTest::testFraming()
+{
+	JablotronRingBuffer ring(64);
+	string message;
+
+	feed(ring, "garbage\nOK\n\n[00000042] AC-88 RELAY:1\nERROR\n");
+
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("OK", message);
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("[00000042] AC-88 RELAY:1", message);
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("ERROR", message);
+	CPPUNIT_ASSERT(!next(ring, message));
+
+	CPPUNIT_ASSERT_EQUAL(0, ring.size());
+}
+
+void JablotronRingBufferTest::testPartialMessage()
+{
+	JablotronRingBuffer ring(64);
+	string message;
+
+	feed(ring, "\nSLOT:01 ");
+	CPPUNIT_ASSERT(!next(ring, message));
+	CPPUNIT_ASSERT_EQUAL(8, ring.size());
+
+	feed(ring, "[--------]");
+	CPPUNIT_ASSERT(!next(ring, message));
+
+	feed(ring, "\nO");
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("SLOT:01 [--------]", message);
+	CPPUNIT_ASSERT(!next(ring, message));
+
+	feed(ring, "K\n");
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("OK", message);
+}
+
+void JablotronRingBufferTest::testWrapAround()
+{
+	JablotronRingBuffer ring(16);
+	string message;
+
+	feed(ring, "\n0123456789\n");
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("0123456789", message);
+
+	// the message starts at offset 12 and continues from the beginning
+	feed(ring, "abcdefghij\n");
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("abcdefghij", message);
+
+	CPPUNIT_ASSERT_EQUAL(0, ring.size());
+	CPPUNIT_ASSERT_EQUAL(0, ring.overflows());
+}
+
+void JablotronRingBufferTest::testOverflow()
+{
+	JablotronRingBuffer ring(8);
+	string message;
+
+	feed(ring, "\n0123456789");
+	CPPUNIT_ASSERT(!next(ring, message));
+	CPPUNIT_ASSERT_EQUAL(1, ring.overflows());
+
+	// framing starts over after the overflow
+	feed(ring, "\nOK\n");
+	CPPUNIT_ASSERT(next(ring, message));
+	CPPUNIT_ASSERT_EQUAL("OK", message);
+}
+
+}
@@ -0,0 +1,99 @@
+#include <Poco/Clock.h>
+#include <Poco/Exception.h>
+
+#include "net/MockMqttClient.h"
+
+using namespace std;
+using namespace Poco;
+using namespace BeeeOn;
+
+void MockMqttClient::setResponder(const Responder &responder)
+{
+	FastMutex::ScopedLock guard(m_lock);
+	m_responder = responder;
+}
+
+void MockMqttClient::publish(const MqttMessage &msg)
+{
+	Responder responder;
+
+	{
+		FastMutex::ScopedLock guard(m_lock);
+		m_published.emplace_back(msg);
+		responder = m_responder;
+	}
+
+	if (!responder)
+		return;
+
+	for (const auto &reply : responder(msg))
+		deliver(reply);
+}
+
+MqttMessage MockMqttClient::receive(const Timespan &timeout)
+{
+	const Clock started;
+
+	while (true) {
+		{
+			FastMutex::ScopedLock guard(m_lock);
+
+			if (!m_incoming.empty()) {
+				const MqttMessage msg = m_incoming.front();
+				m_incoming.pop();
+
+				if (m_incoming.empty())
+					m_drainedEvent.set();
+
+				return msg;
+			}
+		}
+
+		if (timeout < 0) {
+			m_incomingEvent.wait();
+			continue;
+		}
+
+		const Timespan remaining = timeout.totalMicroseconds() - started.elapsed();
+		if (remaining <= 0)
+			throw TimeoutException("no message received");
+
+		const long ms = remaining.totalMilliseconds();
+		m_incomingEvent.tryWait(ms < 1 ? 1 : ms);
+	}
+}
+
+void MockMqttClient::deliver(const MqttMessage &msg)
+{
+	FastMutex::ScopedLock guard(m_lock);
+
+	m_incoming.push(msg);
+	m_incomingEvent.set();
+}
+
+bool MockMqttClient::waitDrained(const Timespan &timeout)
+{
+	const Clock started;
+
+	while (true) {
+		{
+			FastMutex::ScopedLock guard(m_lock);
+
+			if (m_incoming.empty())
+				return true;
+		}
+
+		const Timespan remaining = timeout.totalMicroseconds() - started.elapsed();
+		if (remaining <= 0)
+			return false;
+
+		const long ms = remaining.totalMilliseconds();
+		m_drainedEvent.tryWait(ms < 1 ? 1 : ms);
+	}
+}
+
+list<MqttMessage> MockMqttClient::published() const
+{
+	FastMutex::ScopedLock guard(m_lock);
+	return m_published;
+}
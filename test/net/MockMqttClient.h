@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <queue>
+
+#include <Poco/Event.h>
+#include <Poco/Mutex.h>
+#include <Poco/SharedPtr.h>
+
+#include "net/MqttClient.h"
+
+namespace BeeeOn {
+
+/**
+ * @brief MockMqttClient is intended for testing as a local stand-in
+ * of an MQTT broker. All published messages are recorded. A responder
+ * can be installed to generate replies to the published messages
+ * (e.g. simulating a daemon on the other side of the broker).
+ * Other incoming messages can be delivered via MockMqttClient::deliver().
+ */
+class MockMqttClient : public MqttClient {
+public:
+	typedef Poco::SharedPtr<MockMqttClient> Ptr;
+	typedef std::function<std::list<MqttMessage>(const MqttMessage &)> Responder;
+
+	/**
+	 * @brief Set responder called for each published message.
+	 * The returned messages are queued to be received.
+	 */
+	void setResponder(const Responder &responder);
+
+	/**
+	 * @brief Record the given message and pass it to the responder.
+	 */
+	void publish(const MqttMessage &msg) override;
+
+	/**
+	 * @brief Receive the oldest delivered message.
+	 * @throws Poco::TimeoutException
+	 */
+	MqttMessage receive(const Poco::Timespan &timeout) override;
+
+	/**
+	 * @brief Deliver the given message to be received.
+	 */
+	void deliver(const MqttMessage &msg);
+
+	/**
+	 * @brief Wait until all delivered messages are received.
+	 * @returns false when the timeout expires
+	 */
+	bool waitDrained(const Poco::Timespan &timeout);
+
+	/**
+	 * @returns all messages published so far
+	 */
+	std::list<MqttMessage> published() const;
+
+private:
+	Responder m_responder;
+	std::list<MqttMessage> m_published;
+	std::queue<MqttMessage> m_incoming;
+	Poco::Event m_incomingEvent;
+	Poco::Event m_drainedEvent;
+	mutable Poco::FastMutex m_lock;
+};
+
+}
@@ -0,0 +1,240 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Event.h>
+#include <Poco/Exception.h>
+#include <Poco/RunnableAdapter.h>
+#include <Poco/Thread.h>
+
+#include "cppunit/BetterAssert.h"
+#include "net/MqttTopicQueues.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class MqttTopicQueuesTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(MqttTopicQueuesTest);
+	CPPUNIT_TEST(testMatches);
+	CPPUNIT_TEST(testRouting);
+	CPPUNIT_TEST(testRoutingMostSpecific);
+	CPPUNIT_TEST(testPopAnyInArrivalOrder);
+	CPPUNIT_TEST(testDropOldest);
+	CPPUNIT_TEST(testDropNewest);
+	CPPUNIT_TEST(testUnrelatedTrafficDoesNotWakeUp);
+	CPPUNIT_TEST(testStop);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testMatches();
+	void testRouting();
+	void testRoutingMostSpecific();
+	void testPopAnyInArrivalOrder();
+	void testDropOldest();
+	void testDropNewest();
+	void testUnrelatedTrafficDoesNotWakeUp();
+	void testStop();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MqttTopicQueuesTest);
+
+void MqttTopicQueuesTest::testMatches()
+{
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/b", "a/b"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::matches("a/b", "a/b/c"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::matches("a/b/c", "a/b"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/+", "a/b"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/+", "a/"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::matches("a/+", "a"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/+/c", "a/b/c"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/#", "a"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/#", "a/b/c"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("#", "a/b"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::matches("#", "$SYS/broker"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("$SYS/#", "$SYS/broker"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::matches("a/", "a"));
+	CPPUNIT_ASSERT(MqttTopicQueues::matches("a/", "a/"));
+}
+
+/**
+ * Messages are delivered via queue of the matching filter.
+ * Messages not matching any filter end up in the queue of
+ * an empty filter.
+ */
+void MqttTopicQueuesTest::testRouting()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("Iqrf/DpaResponse");
+	queues.addFilter("status/#");
+
+	CPPUNIT_ASSERT(queues.push({"status/a", "1"}));
+	CPPUNIT_ASSERT(queues.push({"Iqrf/DpaResponse", "2"}));
+	CPPUNIT_ASSERT(queues.push({"other", "3"}));
+
+	CPPUNIT_ASSERT_EQUAL("2", queues.pop("Iqrf/DpaResponse", 0).message());
+	CPPUNIT_ASSERT_THROW(queues.pop("Iqrf/DpaResponse", 0), TimeoutException);
+
+	CPPUNIT_ASSERT_EQUAL("1", queues.pop("status/#", 0).message());
+	CPPUNIT_ASSERT_EQUAL("3", queues.pop("", 0).message());
+
+	CPPUNIT_ASSERT_THROW(queues.pop("unknown", 0), NotFoundException);
+
+	const auto stats = queues.stats();
+	CPPUNIT_ASSERT_EQUAL(1, stats.at("Iqrf/DpaResponse").received);
+	CPPUNIT_ASSERT_EQUAL(1, stats.at("status/#").received);
+	CPPUNIT_ASSERT_EQUAL(1, stats.at("").received);
+	CPPUNIT_ASSERT_EQUAL(0, stats.at("").queued);
+}
+
+/**
+ * Messages matching overlapping filters are delivered via queue
+ * of the most specific one.
+ */
+void MqttTopicQueuesTest::testRoutingMostSpecific()
+{
+	CPPUNIT_ASSERT(MqttTopicQueues::moreSpecific("a/b", "a/#"));
+	CPPUNIT_ASSERT(MqttTopicQueues::moreSpecific("a/b", "a/+"));
+	CPPUNIT_ASSERT(MqttTopicQueues::moreSpecific("a/+", "a/#"));
+	CPPUNIT_ASSERT(MqttTopicQueues::moreSpecific("a/#", "#"));
+	CPPUNIT_ASSERT(MqttTopicQueues::moreSpecific("a/b/#", "a/b"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::moreSpecific("a/#", "a/b"));
+	CPPUNIT_ASSERT(!MqttTopicQueues::moreSpecific("a/b", "a/b"));
+
+	MqttTopicQueues queues;
+	queues.addFilter("#");
+	queues.addFilter("Iqrf/#");
+	queues.addFilter("Iqrf/DpaResponse");
+
+	CPPUNIT_ASSERT(queues.push({"Iqrf/DpaResponse", "1"}));
+	CPPUNIT_ASSERT(queues.push({"Iqrf/DpaRequest", "2"}));
+	CPPUNIT_ASSERT(queues.push({"other", "3"}));
+
+	CPPUNIT_ASSERT_EQUAL("1", queues.pop("Iqrf/DpaResponse", 0).message());
+	CPPUNIT_ASSERT_EQUAL("2", queues.pop("Iqrf/#", 0).message());
+	CPPUNIT_ASSERT_EQUAL("3", queues.pop("#", 0).message());
+
+	CPPUNIT_ASSERT_THROW(queues.pop(0), TimeoutException);
+}
+
+void MqttTopicQueuesTest::testPopAnyInArrivalOrder()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("a");
+	queues.addFilter("b");
+
+	queues.push({"b", "1"});
+	queues.push({"a", "2"});
+	queues.push({"b", "3"});
+
+	CPPUNIT_ASSERT_EQUAL("1", queues.pop(0).message());
+	CPPUNIT_ASSERT_EQUAL("2", queues.pop(0).message());
+	CPPUNIT_ASSERT_EQUAL("3", queues.pop(0).message());
+	CPPUNIT_ASSERT_THROW(queues.pop(0), TimeoutException);
+}
+
+void MqttTopicQueuesTest::testDropOldest()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("a");
+	queues.setCapacity(2);
+
+	CPPUNIT_ASSERT(queues.push({"a", "1"}));
+	CPPUNIT_ASSERT(queues.push({"a", "2"}));
+	CPPUNIT_ASSERT(!queues.push({"a", "3"}));
+
+	CPPUNIT_ASSERT_EQUAL("2", queues.pop("a", 0).message());
+	CPPUNIT_ASSERT_EQUAL("3", queues.pop("a", 0).message());
+
+	const auto stats = queues.stats();
+	CPPUNIT_ASSERT_EQUAL(3, stats.at("a").received);
+	CPPUNIT_ASSERT_EQUAL(1, stats.at("a").dropped);
+}
+
+void MqttTopicQueuesTest::testDropNewest()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("a");
+	queues.setCapacity(2);
+	queues.setOverflowPolicy(MqttTopicQueues::parsePolicy("drop-newest"));
+
+	CPPUNIT_ASSERT(queues.push({"a", "1"}));
+	CPPUNIT_ASSERT(queues.push({"a", "2"}));
+	CPPUNIT_ASSERT(!queues.push({"a", "3"}));
+
+	CPPUNIT_ASSERT_EQUAL("1", queues.pop("a", 0).message());
+	CPPUNIT_ASSERT_EQUAL("2", queues.pop("a", 0).message());
+	CPPUNIT_ASSERT_EQUAL(1, queues.stats().at("a").dropped);
+
+	CPPUNIT_ASSERT_THROW(
+		MqttTopicQueues::parsePolicy("drop-all"),
+		InvalidArgumentException);
+}
+
+class TopicReceiver {
+public:
+	TopicReceiver(MqttTopicQueues &queues, const string &filter):
+		m_queues(queues),
+		m_filter(filter)
+	{
+	}
+
+	void run()
+	{
+		m_message = m_queues.pop(m_filter, -1);
+		m_done.set();
+	}
+
+	MqttTopicQueues &m_queues;
+	string m_filter;
+	MqttMessage m_message;
+	Event m_done;
+};
+
+/**
+ * A consumer waiting for its subscription is not affected by
+ * a flood of messages of other subscriptions.
+ */
+void MqttTopicQueuesTest::testUnrelatedTrafficDoesNotWakeUp()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("Iqrf/DpaResponse");
+	queues.addFilter("noise/#");
+
+	TopicReceiver receiver(queues, "Iqrf/DpaResponse");
+	RunnableAdapter<TopicReceiver> runnable(receiver, &TopicReceiver::run);
+	Thread thread;
+	thread.start(runnable);
+
+	for (int i = 0; i < 1000; ++i)
+		queues.push({"noise/" + to_string(i % 10), "x"});
+
+	CPPUNIT_ASSERT(!receiver.m_done.tryWait(50));
+
+	queues.push({"Iqrf/DpaResponse", "response"});
+
+	CPPUNIT_ASSERT(receiver.m_done.tryWait(5000));
+	thread.join();
+
+	CPPUNIT_ASSERT_EQUAL("response", receiver.m_message.message());
+	CPPUNIT_ASSERT_EQUAL(1000, queues.stats().at("noise/#").received);
+}
+
+void MqttTopicQueuesTest::testStop()
+{
+	MqttTopicQueues queues;
+	queues.addFilter("a");
+
+	TopicReceiver receiver(queues, "a");
+	RunnableAdapter<TopicReceiver> runnable(receiver, &TopicReceiver::run);
+	Thread thread;
+	thread.start(runnable);
+
+	queues.stop();
+
+	CPPUNIT_ASSERT(receiver.m_done.tryWait(5000));
+	thread.join();
+
+	CPPUNIT_ASSERT(receiver.m_message.isEmpty());
+	CPPUNIT_ASSERT(queues.pop(0).isEmpty());
+}
+
+}
@@ -0,0 +1,286 @@
+#include <list>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Event.h>
+#include <Poco/Exception.h>
+
+#include "cppunit/BetterAssert.h"
+#include "core/AnswerQueue.h"
+#include "gwmessage/GWDeviceListRequest.h"
+#include "gwmessage/GWResponse.h"
+#include "gwmessage/GWSensorDataExport.h"
+#include "server/GWSOutputQueue.h"
+
+using namespace std;
+using namespace Poco;
+
+namespace BeeeOn {
+
+class GWSOutputQueueTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(GWSOutputQueueTest);
+	CPPUNIT_TEST(testLaneOf);
+	CPPUNIT_TEST(testStrictPriority);
+	CPPUNIT_TEST(testFifoWithinLane);
+	CPPUNIT_TEST(testLaneLimits);
+	CPPUNIT_TEST(testInvalidConfiguration);
+	CPPUNIT_TEST(testWeightedDrain);
+	CPPUNIT_TEST(testConcurrentProducers);
+	CPPUNIT_TEST(testClearFailsRequests);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testLaneOf();
+	void testStrictPriority();
+	void testFifoWithinLane();
+	void testLaneLimits();
+	void testInvalidConfiguration();
+	void testWeightedDrain();
+	void testConcurrentProducers();
+	void testClearFailsRequests();
+
+protected:
+	GWMessageContext::Ptr data() const;
+	GWMessageContext::Ptr request();
+	GWMessageContext::Ptr response() const;
+
+private:
+	AnswerQueue m_answerQueue;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(GWSOutputQueueTest);
+
+GWMessageContext::Ptr GWSOutputQueueTest::data() const
+{
+	GWSensorDataExport::Ptr message = new GWSensorDataExport;
+	message->setID(GlobalID::random());
+
+	GWMessageContext::Ptr context = new GWSensorDataExportContext;
+	context->setMessage(message);
+	return context;
+}
+
+GWMessageContext::Ptr GWSOutputQueueTest::request()
+{
+	GWDeviceListRequest::Ptr message = new GWDeviceListRequest;
+	message->setID(GlobalID::random());
+
+	Answer::Ptr answer = new Answer(m_answerQueue);
+	return new GWRequestContext(message, new Result(answer));
+}
+
+GWMessageContext::Ptr GWSOutputQueueTest::response() const
+{
+	GWResponse::Ptr message = new GWResponse;
+	message->setID(GlobalID::random());
+
+	return new GWResponseContext(message);
+}
+
+void GWSOutputQueueTest::testLaneOf()
+{
+	CPPUNIT_ASSERT_EQUAL(GWSOutputQueue::LANE_DATA,
+		GWSOutputQueue::laneOf(data()));
+	CPPUNIT_ASSERT_EQUAL(GWSOutputQueue::LANE_REQUEST,
+		GWSOutputQueue::laneOf(request()));
+	CPPUNIT_ASSERT_EQUAL(GWSOutputQueue::LANE_RESPONSE,
+		GWSOutputQueue::laneOf(response()));
+
+	CPPUNIT_ASSERT_EQUAL(GWSOutputQueue::LANE_DATA,
+		GWSOutputQueue::parseLane("data"));
+	CPPUNIT_ASSERT_EQUAL(GWSOutputQueue::LANE_RESPONSEWITHACK,
+		GWSOutputQueue::parseLane("responsewithack"));
+}
+
+/**
+ * Higher priority lanes are always drained first.
+ */
+void GWSOutputQueueTest::testStrictPriority()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+
+	const GWMessageContext::Ptr d = data();
+	const GWMessageContext::Ptr q = request();
+	const GWMessageContext::Ptr r = response();
+
+	queue.enqueue(d);
+	queue.enqueue(q);
+	queue.enqueue(r);
+
+	CPPUNIT_ASSERT(event.tryWait(0));
+
+	CPPUNIT_ASSERT(queue.dequeue() == r);
+	CPPUNIT_ASSERT(queue.dequeue() == q);
+	CPPUNIT_ASSERT(queue.dequeue() == d);
+	CPPUNIT_ASSERT(queue.dequeue().isNull());
+}
+
+void GWSOutputQueueTest::testFifoWithinLane()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+
+	vector<GWMessageContext::Ptr> contexts;
+
+	for (int i = 0; i < 10; ++i) {
+		contexts.emplace_back(data());
+		queue.enqueue(contexts.back());
+	}
+
+	CPPUNIT_ASSERT_EQUAL(10, queue.depth(GWSOutputQueue::LANE_DATA));
+
+	for (const auto &context : contexts)
+		CPPUNIT_ASSERT(queue.dequeue() == context);
+
+	CPPUNIT_ASSERT_EQUAL(0, queue.depth(GWSOutputQueue::LANE_DATA));
+}
+
+/**
+ * The limit applies only to tryEnqueue() and only to the configured lane.
+ */
+void GWSOutputQueueTest::testLaneLimits()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+	queue.setLaneLimits({"data:2"});
+
+	CPPUNIT_ASSERT(queue.tryEnqueue(data()));
+	CPPUNIT_ASSERT(queue.tryEnqueue(data()));
+	CPPUNIT_ASSERT(!queue.tryEnqueue(data()));
+	CPPUNIT_ASSERT(queue.tryEnqueue(response()));
+
+	queue.enqueue(data());
+	CPPUNIT_ASSERT_EQUAL(3, queue.depth(GWSOutputQueue::LANE_DATA));
+
+	CPPUNIT_ASSERT(!queue.dequeue().isNull());
+	CPPUNIT_ASSERT(!queue.dequeue().isNull());
+	CPPUNIT_ASSERT(!queue.dequeue().isNull());
+	CPPUNIT_ASSERT(queue.tryEnqueue(data()));
+}
+
+void GWSOutputQueueTest::testInvalidConfiguration()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+
+	CPPUNIT_ASSERT_THROW(
+		queue.setLaneLimits({"unknown:10"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		queue.setLaneLimits({"data"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		queue.setLaneWeights({"data:0"}),
+		InvalidArgumentException);
+
+	CPPUNIT_ASSERT_THROW(
+		queue.setDrainPolicy("random"),
+		InvalidArgumentException);
+}
+
+/**
+ * In the weighted mode, the data lane gets 3 dequeues for each
+ * dequeue of the response lane when both lanes are busy.
+ */
+void GWSOutputQueueTest::testWeightedDrain()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+	queue.setDrainPolicy("weighted");
+	queue.setLaneWeights({"response:1", "data:3"});
+
+	for (int i = 0; i < 8; ++i) {
+		queue.enqueue(data());
+		queue.enqueue(response());
+	}
+
+	string order;
+
+	while (GWMessageContext::Ptr context = queue.dequeue()) {
+		if (GWSOutputQueue::laneOf(context) == GWSOutputQueue::LANE_DATA)
+			order += "d";
+		else
+			order += "r";
+	}
+
+	CPPUNIT_ASSERT_EQUAL(string("rdddrdddrddrrrrr"), order);
+}
+
+/**
+ * Contexts enqueued concurrently by several producers are all
+ * dequeued exactly once and the order of each producer is kept.
+ */
+void GWSOutputQueueTest::testConcurrentProducers()
+{
+	static const int PRODUCERS = 4;
+	static const int COUNT = 500;
+
+	Event event;
+	GWSOutputQueue queue(event);
+
+	vector<vector<GWMessageContext::Ptr>> contexts(PRODUCERS);
+	for (auto &one : contexts) {
+		for (int i = 0; i < COUNT; ++i)
+			one.emplace_back(data());
+	}
+
+	vector<thread> producers;
+	for (auto &one : contexts) {
+		producers.emplace_back([&queue, &one]() {
+			for (const auto &context : one)
+				queue.enqueue(context);
+		});
+	}
+
+	vector<size_t> next(PRODUCERS, 0);
+	int dequeued = 0;
+
+	while (dequeued < PRODUCERS * COUNT) {
+		GWMessageContext::Ptr context = queue.dequeue();
+		if (context.isNull()) {
+			event.tryWait(10);
+			continue;
+		}
+
+		bool found = false;
+
+		for (int p = 0; p < PRODUCERS; ++p) {
+			if (next[p] < COUNT && contexts[p][next[p]] == context) {
+				next[p] += 1;
+				found = true;
+				break;
+			}
+		}
+
+		CPPUNIT_ASSERT(found);
+		dequeued += 1;
+	}
+
+	for (auto &producer : producers)
+		producer.join();
+
+	CPPUNIT_ASSERT(queue.dequeue().isNull());
+	CPPUNIT_ASSERT_EQUAL(0, queue.depth(GWSOutputQueue::LANE_DATA));
+}
+
+void GWSOutputQueueTest::testClearFailsRequests()
+{
+	Event event;
+	GWSOutputQueue queue(event);
+
+	GWRequestContext::Ptr context = request().cast<GWRequestContext>();
+	queue.enqueue(context);
+	queue.enqueue(data());
+
+	queue.clear();
+
+	CPPUNIT_ASSERT_EQUAL(Result::Status::FAILED, context->result()->status().raw());
+	CPPUNIT_ASSERT(queue.dequeue().isNull());
+}
+
+}
@@ -18,12 +18,14 @@ class CSVSensorDataFormatterTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testFormatNaN);
 	CPPUNIT_TEST(testFormatINFINITY);
 	CPPUNIT_TEST(testFormatNoValues);
+	CPPUNIT_TEST(testFormatToAppends);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testFormat();
 	void testFormatNaN();
 	void testFormatINFINITY();
 	void testFormatNoValues();
+	void testFormatToAppends();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(CSVSensorDataFormatterTest);
@@ -92,4 +94,25 @@ void CSVSensorDataFormatterTest::testFormatNoValues()
 	CPPUNIT_ASSERT_EQUAL(expected, str);
 }
 
+void CSVSensorDataFormatterTest::testFormatToAppends()
+{
+	SensorData data;
+	data.setDeviceID(0x4100000001020304);
+	data.insertValue(SensorValue(ModuleID(1), 1));
+	data.insertValue(SensorValue(ModuleID(2), -2.25));
+
+	CSVSensorDataFormatter formatter;
+	formatter.setSeparator(",");
+
+	string buffer = "prefix\n";
+	formatter.formatTo(data, buffer);
+
+	const string timestamp = to_string(data.timestamp().value().epochTime());
+	const string expected = "prefix\n"
+		"sensor," + timestamp + ",0x4100000001020304,1,1.00,\n"
+		+ "sensor," + timestamp + ",0x4100000001020304,2,-2.25,";
+
+	CPPUNIT_ASSERT_EQUAL(expected, buffer);
+}
+
 }
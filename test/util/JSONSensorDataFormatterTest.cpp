@@ -18,12 +18,14 @@ class JSONSensorDataFormatterTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testFormatNaN);
 	CPPUNIT_TEST(testFormatINFINITY);
 	CPPUNIT_TEST(testFormatNoValues);
+	CPPUNIT_TEST(testFormatToAppends);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	void testFormat();
 	void testFormatNaN();
 	void testFormatINFINITY();
 	void testFormatNoValues();
+	void testFormatToAppends();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(JSONSensorDataFormatterTest);
@@ -94,4 +96,24 @@ void JSONSensorDataFormatterTest::testFormatNoValues()
 	CPPUNIT_ASSERT_EQUAL(str, expected);
 }
 
+void JSONSensorDataFormatterTest::testFormatToAppends()
+{
+	SensorData data;
+	data.setDeviceID(0x4100000001020304);
+	data.insertValue(SensorValue(ModuleID(0), -12.5));
+
+	JSONSensorDataFormatter formatter;
+	string buffer = "prefix\n";
+
+	formatter.formatTo(data, buffer);
+	formatter.formatTo(data, buffer);
+
+	const string record = R"({"device_id":"0x4100000001020304","timestamp":)"
+		+ to_string(data.timestamp().value().epochMicroseconds())
+		+ R"(,"data":[{"module_id":0,"value":-12.500}]})";
+
+	CPPUNIT_ASSERT_EQUAL("prefix\n" + record + record, buffer);
+	CPPUNIT_ASSERT_EQUAL(record, formatter.format(data));
+}
+
 }
@@ -0,0 +1,177 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
+
+#include "cppunit/BetterAssert.h"
+#include "model/SensorData.h"
+#include "vdev/VirtualLoadGenerator.h"
+
+using namespace Poco;
+using namespace std;
+
+namespace BeeeOn {
+
+class VirtualLoadGeneratorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(VirtualLoadGeneratorTest);
+	CPPUNIT_TEST(testGenerate);
+	CPPUNIT_TEST(testBurst);
+	CPPUNIT_TEST(testIgnoreForeignData);
+	CPPUNIT_TEST(testMaxLatency);
+	CPPUNIT_TEST(testInvalidSettings);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	void testGenerate();
+	void testBurst();
+	void testIgnoreForeignData();
+	void testMaxLatency();
+	void testInvalidSettings();
+
+protected:
+	VirtualLoadGenerator::Report runFor(
+		VirtualLoadGenerator &generator,
+		const Timespan &duration);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VirtualLoadGeneratorTest);
+
+/**
+ * Distributor that immediately returns the exported data
+ * back to the generator as it would be the only exporter.
+ */
+class LoopbackDistributor : public Distributor {
+public:
+	LoopbackDistributor(VirtualLoadGenerator &generator):
+		m_generator(generator)
+	{
+	}
+
+	void exportData(const SensorData &data) override
+	{
+		m_generator.ship(data);
+	}
+
+private:
+	VirtualLoadGenerator &m_generator;
+};
+
+VirtualLoadGenerator::Report VirtualLoadGeneratorTest::runFor(
+		VirtualLoadGenerator &generator,
+		const Timespan &duration)
+{
+	generator.setDistributor(new LoopbackDistributor(generator));
+	generator.setReportInterval(1 * Timespan::HOURS);
+
+	Thread thread;
+	thread.startFunc([&]() {generator.run();});
+
+	// the run() starts a new report interval
+	Thread::sleep(5);
+	generator.report();
+
+	Thread::sleep(duration.totalMilliseconds());
+	const auto report = generator.report();
+
+	generator.stop();
+	thread.join();
+
+	return report;
+}
+
+void VirtualLoadGeneratorTest::testGenerate()
+{
+	VirtualLoadGenerator generator;
+	generator.setDevices(20);
+	generator.setInterval(10 * Timespan::MILLISECONDS);
+
+	const auto report = runFor(generator, 200 * Timespan::MILLISECONDS);
+
+	// 20 devices every 10 ms for 200 ms gives about 400 samples
+	CPPUNIT_ASSERT(report.generated >= 100);
+	CPPUNIT_ASSERT(report.generated <= 800);
+	CPPUNIT_ASSERT(report.received >= report.generated - 1);
+	CPPUNIT_ASSERT(report.throughput > 0);
+	CPPUNIT_ASSERT(report.p50 <= report.p90);
+	CPPUNIT_ASSERT(report.p90 <= report.p99);
+	CPPUNIT_ASSERT(report.p99 <= report.max);
+}
+
+void VirtualLoadGeneratorTest::testBurst()
+{
+	VirtualLoadGenerator generator;
+	generator.setDevices(1);
+	generator.setInterval(100 * Timespan::MILLISECONDS);
+	generator.setBurstPeriod(1 * Timespan::HOURS);
+	generator.setBurstLength(1 * Timespan::HOURS);
+	generator.setBurstFactor(20);
+
+	const auto report = runFor(generator, 200 * Timespan::MILLISECONDS);
+
+	// without the burst, at most 3 samples would be generated
+	CPPUNIT_ASSERT(report.generated >= 10);
+}
+
+void VirtualLoadGeneratorTest::testIgnoreForeignData()
+{
+	VirtualLoadGenerator generator;
+	generator.setDevices(10);
+
+	SensorData data;
+	data.setDeviceID(DeviceID(DevicePrefix::PREFIX_VIRTUAL_DEVICE, 1));
+	CPPUNIT_ASSERT(generator.ship(data));
+
+	data.setDeviceID(DeviceID(DevicePrefix::PREFIX_JABLOTRON, 0x10000000));
+	CPPUNIT_ASSERT(generator.ship(data));
+
+	data.setDeviceID(DeviceID(DevicePrefix::PREFIX_VIRTUAL_DEVICE, 0x10000000));
+	CPPUNIT_ASSERT(generator.ship(data));
+
+	const auto report = generator.report();
+	CPPUNIT_ASSERT_EQUAL(1, report.received);
+}
+
+/**
+ * The reported max is the exact maximal latency of the report
+ * interval, the next report starts from scratch.
+ */
+void VirtualLoadGeneratorTest::testMaxLatency()
+{
+	VirtualLoadGenerator generator;
+	generator.setDevices(10);
+
+	SensorData data;
+	data.setDeviceID(DeviceID(DevicePrefix::PREFIX_VIRTUAL_DEVICE, 0x10000000));
+
+	Timestamp old;
+	old -= 5 * Timespan::SECONDS;
+	data.setTimestamp(old);
+	CPPUNIT_ASSERT(generator.ship(data));
+
+	for (int i = 0; i < 10; ++i) {
+		data.setTimestamp(Timestamp());
+		CPPUNIT_ASSERT(generator.ship(data));
+	}
+
+	auto report = generator.report();
+	CPPUNIT_ASSERT_EQUAL(11, report.received);
+	CPPUNIT_ASSERT(report.max >= 5 * Timespan::SECONDS);
+
+	data.setTimestamp(Timestamp());
+	CPPUNIT_ASSERT(generator.ship(data));
+
+	report = generator.report();
+	CPPUNIT_ASSERT(report.max < 5 * Timespan::SECONDS);
+}
+
+void VirtualLoadGeneratorTest::testInvalidSettings()
+{
+	VirtualLoadGenerator generator;
+
+	CPPUNIT_ASSERT_THROW(generator.setDevices(0), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(generator.setInterval(0), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(generator.setBurstFactor(0), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(generator.setModules({}), InvalidArgumentException);
+	CPPUNIT_ASSERT_THROW(generator.setModules({"unknown"}), InvalidArgumentException);
+}
+
+}
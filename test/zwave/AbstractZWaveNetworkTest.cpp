@@ -1,5 +1,8 @@
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <map>
+#include <vector>
+
 #include <Poco/Clock.h>
 #include <Poco/Exception.h>
 
@@ -17,10 +20,16 @@ namespace BeeeOn {
 class AbstractZWaveNetworkTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE(AbstractZWaveNetworkTest);
 	CPPUNIT_TEST(testPollTimeout);
+	CPPUNIT_TEST(testStatisticsBudget);
+	CPPUNIT_TEST(testStatisticsSummary);
+	CPPUNIT_TEST(testStatisticsInterval);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
 	void testPollTimeout();
+	void testStatisticsBudget();
+	void testStatisticsSummary();
+	void testStatisticsInterval();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(AbstractZWaveNetworkTest);
@@ -51,6 +60,50 @@ public:
 	{
 		throw NotImplementedException(__func__);
 	}
+
+	using AbstractZWaveNetwork::collectStatistics;
+
+	/**
+	 * Every node reports its ID as the number of retries and
+	 * 10 times its ID as the average request RTT.
+	 */
+	ZWaveNodeEvent nodeStatistics(uint32_t, uint8_t node) override
+	{
+		m_nodeQueries += 1;
+
+		return ZWaveNodeEvent({
+			{"sentCnt",             node == 3 ? 0U : 100U},
+			{"sentFailed",          1},
+			{"retries",             node},
+			{"receivedCnt",         50},
+			{"receivedDups",        0},
+			{"receivedUnsolicited", 0},
+			{"lastRequestRTT",      10U * node},
+			{"lastResponseRTT",     10U * node},
+			{"averageRequestRTT",   10U * node},
+			{"averageResponseRTT",  10U * node},
+			{"quality",             0},
+		}, node);
+	}
+
+	ZWaveDriverEvent driverStatistics(uint32_t home) override
+	{
+		return ZWaveDriverEvent({{"dropped", home}});
+	}
+
+	map<uint32_t, vector<uint8_t>> statisticsNodes() override
+	{
+		return m_nodes;
+	}
+
+	void reportStatistics(const ZWaveMeshEvent &e) override
+	{
+		m_reported.emplace_back(e);
+	}
+
+	map<uint32_t, vector<uint8_t>> m_nodes;
+	vector<ZWaveMeshEvent> m_reported;
+	size_t m_nodeQueries = 0;
 };
 
 void AbstractZWaveNetworkTest::testPollTimeout()
@@ -64,4 +117,78 @@ void AbstractZWaveNetworkTest::testPollTimeout()
 	CPPUNIT_ASSERT(started.elapsed() >= 10 * Timespan::MILLISECONDS);
 }
 
+/**
+ * With zero budget, each call of collectStatistics() serves a single
+ * node. The mesh statistics are reported only after all nodes are served.
+ */
+void AbstractZWaveNetworkTest::testStatisticsBudget()
+{
+	TestableAbstractZWaveNetwork network;
+	network.setStatisticsBudget(0);
+	network.m_nodes = {{0x1234, {1, 2, 3}}};
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(1, network.m_nodeQueries);
+	CPPUNIT_ASSERT(network.m_reported.empty());
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(2, network.m_nodeQueries);
+	CPPUNIT_ASSERT(network.m_reported.empty());
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(3, network.m_nodeQueries);
+	CPPUNIT_ASSERT_EQUAL(1, network.m_reported.size());
+	CPPUNIT_ASSERT_EQUAL(3, network.m_reported[0].nodes().size());
+	CPPUNIT_ASSERT_EQUAL(3, network.m_reported[0].nodes()[2].nodeID());
+}
+
+/**
+ * The summary is computed for each home separately. Nodes that have
+ * not sent anything do not affect the RTT.
+ */
+void AbstractZWaveNetworkTest::testStatisticsSummary()
+{
+	TestableAbstractZWaveNetwork network;
+	network.setStatisticsBudget(1 * Timespan::SECONDS);
+	network.m_nodes = {{0x01, {1, 2, 3}}, {0x02, {4}}};
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(2, network.m_reported.size());
+
+	const auto &first = network.m_reported[0];
+	CPPUNIT_ASSERT_EQUAL(0x01, first.homeID());
+	CPPUNIT_ASSERT_EQUAL(3, first.nodes().size());
+	CPPUNIT_ASSERT_EQUAL(200, first.summary().sentCount);
+	CPPUNIT_ASSERT_EQUAL(3, first.summary().sentFailed);
+	CPPUNIT_ASSERT_EQUAL(6, first.summary().retries);
+	CPPUNIT_ASSERT_EQUAL(15, first.summary().averageRTT);
+	CPPUNIT_ASSERT_EQUAL(20, first.summary().maxRTT);
+	CPPUNIT_ASSERT_EQUAL(1, first.summary().dropped);
+
+	const auto &second = network.m_reported[1];
+	CPPUNIT_ASSERT_EQUAL(0x02, second.homeID());
+	CPPUNIT_ASSERT_EQUAL(1, second.nodes().size());
+	CPPUNIT_ASSERT_EQUAL(4, second.summary().retries);
+	CPPUNIT_ASSERT_EQUAL(40, second.summary().averageRTT);
+	CPPUNIT_ASSERT_EQUAL(2, second.summary().dropped);
+}
+
+/**
+ * A new cycle does not start before the statistics interval elapses.
+ */
+void AbstractZWaveNetworkTest::testStatisticsInterval()
+{
+	TestableAbstractZWaveNetwork network;
+	network.setStatisticsInterval(1 * Timespan::HOURS);
+	network.m_nodes = {{0x01, {1, 2}}};
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(2, network.m_nodeQueries);
+	CPPUNIT_ASSERT_EQUAL(1, network.m_reported.size());
+
+	network.collectStatistics();
+	CPPUNIT_ASSERT_EQUAL(2, network.m_nodeQueries);
+	CPPUNIT_ASSERT_EQUAL(1, network.m_reported.size());
+}
+
 }
@@ -22,6 +22,10 @@ class ZWaveNodeTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testValueAsLuminance);
 	CPPUNIT_TEST(testValueAsPM25);
 	CPPUNIT_TEST(testValueAsTime);
+	CPPUNIT_TEST(testTypedValueString);
+	CPPUNIT_TEST(testTypedValueAsBool);
+	CPPUNIT_TEST(testTypedValueAsDouble);
+	CPPUNIT_TEST(testTypedValueAsInt);
 	CPPUNIT_TEST_SUITE_END();
 public:
 	using Value = ZWaveNode::Value;
@@ -36,6 +40,10 @@ public:
 	void testValueAsLuminance();
 	void testValueAsPM25();
 	void testValueAsTime();
+	void testTypedValueString();
+	void testTypedValueAsBool();
+	void testTypedValueAsDouble();
+	void testTypedValueAsInt();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ZWaveNodeTest);
@@ -341,4 +349,73 @@ void ZWaveNodeTest::testValueAsTime()
 		InvalidArgumentException);
 }
 
+/**
+ * Typed values must be formatted the same way as OpenZWave does
+ * for GetValueAsString().
+ */
+void ZWaveNodeTest::testTypedValueString()
+{
+	CPPUNIT_ASSERT_EQUAL("True", Value::fromBool({0, 0}, {0, 0, 0}, true).value());
+	CPPUNIT_ASSERT_EQUAL("False", Value::fromBool({0, 0}, {0, 0, 0}, false).value());
+	CPPUNIT_ASSERT_EQUAL("255", Value::fromByte({0, 0}, {0, 0, 0}, 255).value());
+	CPPUNIT_ASSERT_EQUAL("-1200", Value::fromInt({0, 0}, {0, 0, 0}, -1200).value());
+	CPPUNIT_ASSERT_EQUAL("21.30", Value::fromDecimal({0, 0}, {0, 0, 0}, 21.3f, 2).value());
+	CPPUNIT_ASSERT_EQUAL("0.05", Value::fromDecimal({0, 0}, {0, 0, 0}, 0.05f, 2).value());
+	CPPUNIT_ASSERT_EQUAL("-0.5", Value::fromDecimal({0, 0}, {0, 0, 0}, -0.5f, 1).value());
+	CPPUNIT_ASSERT_EQUAL("17", Value::fromDecimal({0, 0}, {0, 0, 0}, 17.2f, 0).value());
+
+	CPPUNIT_ASSERT_THROW(
+		Value::fromDecimal({0, 0}, {0, 0, 0}, 1.0, Value::MAX_SCALE + 1),
+		InvalidArgumentException);
+}
+
+void ZWaveNodeTest::testTypedValueAsBool()
+{
+	CPPUNIT_ASSERT(Value::fromBool({0, 0}, {0, 0, 0}, true).asBool());
+	CPPUNIT_ASSERT(!Value::fromBool({0, 0}, {0, 0, 0}, false).asBool());
+	CPPUNIT_ASSERT(Value::fromByte({0, 0}, {0, 0, 0}, 10).asBool());
+	CPPUNIT_ASSERT(!Value::fromInt({0, 0}, {0, 0, 0}, 0).asBool());
+	CPPUNIT_ASSERT(Value::fromDecimal({0, 0}, {0, 0, 0}, 1, 0).asBool());
+
+	CPPUNIT_ASSERT_THROW(
+		Value::fromDecimal({0, 0}, {0, 0, 0}, 11.021, 3).asBool(),
+		SyntaxException);
+}
+
+void ZWaveNodeTest::testTypedValueAsDouble()
+{
+	CPPUNIT_ASSERT_EQUAL(1.0, Value::fromBool({0, 0}, {0, 0, 0}, true).asDouble());
+	CPPUNIT_ASSERT_EQUAL(99.0, Value::fromByte({0, 0}, {0, 0, 0}, 99).asDouble());
+	CPPUNIT_ASSERT_EQUAL(-15.0, Value::fromInt({0, 0}, {0, 0, 0}, -15).asDouble());
+
+	// must be equal to parsing of the equivalent string
+	CPPUNIT_ASSERT_EQUAL(100.13, Value::fromDecimal({0, 0}, {0, 0, 0}, 100.13f, 2).asDouble());
+	CPPUNIT_ASSERT_EQUAL(-12.8, Value::fromDecimal({0, 0}, {0, 0, 0}, -12.8f, 1).asDouble());
+	CPPUNIT_ASSERT_EQUAL(0.1, Value::fromDecimal({0, 0}, {0, 0, 0}, 0.1f, 1).asDouble());
+
+	CPPUNIT_ASSERT_EQUAL(20.0,
+		Value::fromDecimal({0, 0}, {0, 0, 0}, 68.0f, 1, "F").asCelsius());
+	CPPUNIT_ASSERT_EQUAL(500.0,
+		Value::fromByte({0, 0}, {0, 0, 0}, 50, "%").asLuminance());
+}
+
+void ZWaveNodeTest::testTypedValueAsInt()
+{
+	CPPUNIT_ASSERT_EQUAL(1, Value::fromBool({0, 0}, {0, 0, 0}, true).asInt());
+	CPPUNIT_ASSERT_EQUAL(200, Value::fromByte({0, 0}, {0, 0, 0}, 200).asInt());
+	CPPUNIT_ASSERT_EQUAL(-1000, Value::fromInt({0, 0}, {0, 0, 0}, -1000).asInt());
+	CPPUNIT_ASSERT_EQUAL(3600,
+		Value::fromInt({0, 0}, {0, 0, 0}, 3600, "seconds").asTime().totalSeconds());
+	CPPUNIT_ASSERT_EQUAL(21, Value::fromDecimal({0, 0}, {0, 0, 0}, 21, 0).asInt());
+
+	CPPUNIT_ASSERT_THROW(
+		Value::fromDecimal({0, 0}, {0, 0, 0}, 120.5, 1).asInt(),
+		SyntaxException);
+
+	CPPUNIT_ASSERT_EQUAL(120,
+		Value::fromDecimal({0, 0}, {0, 0, 0}, 120.5, 1).asInt(true));
+	CPPUNIT_ASSERT_EQUAL(-121,
+		Value::fromDecimal({0, 0}, {0, 0, 0}, -120.5, 1).asInt(true));
+}
+
 }
@@ -0,0 +1,59 @@
+#! /usr/bin/env python3
+
+"""
+Compare two results of the bench-suite-gateway generated with
+BENCH_FORMAT=json. For each benchmark present in both results,
+print the median times per operation and their relative change.
+Changes of heap allocations per operation are reported as well
+when available in both results.
+
+Usage: bench-compare.py <baseline.json> <current.json> [threshold-%]
+
+Exits with status 1 when any benchmark is slower by more than
+the threshold (default 10 %).
+"""
+
+import json
+import sys
+
+def load(path):
+	with open(path) as f:
+		doc = json.load(f)
+
+	return {b["name"]: b for b in doc["benchmarks"]}
+
+def main(argv):
+	if len(argv) < 3:
+		print(__doc__.strip(), file=sys.stderr)
+		return 2
+
+	baseline = load(argv[1])
+	current = load(argv[2])
+	threshold = float(argv[3]) if len(argv) > 3 else 10.0
+	regressions = 0
+
+	for name in sorted(set(baseline) & set(current)):
+		old = baseline[name]["median_ns_per_op"]
+		new = current[name]["median_ns_per_op"]
+		change = 100.0 * (new - old) / old if old > 0 else 0.0
+		mark = ""
+
+		if change > threshold:
+			mark = " !"
+			regressions += 1
+
+		allocs = ""
+		if "allocs_per_op" in baseline[name] and "allocs_per_op" in current[name]:
+			allocs = "  allocs %.2f -> %.2f" % (
+				baseline[name]["allocs_per_op"],
+				current[name]["allocs_per_op"])
+
+		print("%-56s %14.1f %14.1f %+8.1f %%%s%s" % (name, old, new, change, mark, allocs))
+
+	for name in sorted(set(baseline) - set(current)):
+		print("%-56s missing in %s" % (name, argv[2]))
+
+	return 1 if regressions > 0 else 0
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))